@@ -88,7 +88,9 @@ mkldnn_status_t MKLDNN_API mkldnn_primitive_desc_iterator_destroy(
 /** Creates a @p primitive_desc using @p op_desc, @p engine, and optionally a
  * hint primitive descriptor from forward propagation. The call is equivalent
  * to create a primitive descriptor iterator, instantly fetch a primitive_desc
- * and destroy the iterator. */
+ * and destroy the iterator. The engine might return a copy of a previously
+ * created primitive descriptor if no hint is passed (see
+ * mkldnn_engine_set_primitive_desc_cache_capacity()). */
 mkldnn_status_t MKLDNN_API mkldnn_primitive_desc_create(
         mkldnn_primitive_desc_t *primitive_desc,
         const_mkldnn_op_desc_t op_desc, mkldnn_engine_t engine,
@@ -225,6 +227,20 @@ mkldnn_status_t MKLDNN_API mkldnn_memory_get_data_handle(
 mkldnn_status_t MKLDNN_API mkldnn_memory_set_data_handle(
         mkldnn_primitive_t memory, void *handle);
 
+/** Plans the memory of intermediate memory primitives of @p primitives in a
+ * single slab. The number of primitives is @p n; they must be given in order
+ * of their execution. A memory is intermediate if the primitives write it
+ * before reading it. Memories that are not alive at the same time share the
+ * space of the slab; the output of a ReLU reuses the space of its input, and
+ * concat inputs are placed directly in the concat output. Returns the
+ * required @p slab_size in bytes. If @p slab is not @c NULL, sets the data
+ * handles of the planned memories to point to the @p slab (of at least @p
+ * slab_size bytes). Must be called before the primitives are submitted to a
+ * stream. The contents of the planned memories are unspecified after the
+ * execution. */
+mkldnn_status_t MKLDNN_API mkldnn_memory_plan(size_t n,
+        mkldnn_primitive_t primitives[], void *slab, size_t *slab_size);
+
 /** @} */
 
 /** @addtogroup c_api_reorder Reorder
@@ -254,7 +270,6 @@ mkldnn_status_t MKLDNN_API mkldnn_concat_primitive_desc_create(
         const mkldnn_memory_desc_t *output_desc, int n, int concat_dimension,
         const_mkldnn_primitive_desc_t *input_pds);
 
-#if 0
 /** Creates in-place @p concat_primitive_desc for given @p n @p inputs memory
  * primitive descriptors along @p concat_dimension. All inputs must have the
  * same memory format. Output memory format would be the same. Likewise
@@ -264,7 +279,11 @@ mkldnn_status_t MKLDNN_API mkldnn_concat_primitive_desc_create(
  * @note this primitive is more like a synchronization stub for concatenation,
  * since concat_inplace does no operation during execution.
  *
- * @note since not operation happens user must ensure that input */
+ * @note since no operation happens user must ensure that input @c i of the
+ * primitive lives in the output as described by the source primitive
+ * descriptor @c i (#mkldnn_query_src_pd), e.g. is a view of the output (see
+ * mkldnn_view_primitive_desc_create()), so that its producer writes directly
+ * to the output. */
 mkldnn_status_t MKLDNN_API mkldnn_concat_inplace_by_input_primitive_desc_create(
         mkldnn_primitive_desc_t *concat_primitive_desc,
         int n, int concat_dimension, const_mkldnn_primitive_desc_t *inputs);
@@ -276,12 +295,13 @@ mkldnn_status_t MKLDNN_API mkldnn_concat_inplace_by_input_primitive_desc_create(
  * format does not allow inplace concatenation for given sizes.
  *
  * @note this primitive is more like a synchronization stub for concatenation,
- * since concat_inplace does no operation during execution. */
+ * since concat_inplace does no operation during execution. The same
+ * requirements on the inputs as for
+ * mkldnn_concat_inplace_by_input_primitive_desc_create() apply. */
 mkldnn_status_t MKLDNN_API mkldnn_concat_inplace_by_output_primitive_desc_create(
         mkldnn_primitive_desc_t *concat_primitive_desc,
-        const mkldnn_primitive_desc_t output, int n, int concat_dimension,
-        int *sizes);
-#endif
+        const_mkldnn_primitive_desc_t output, int n, int concat_dimension,
+        const int *sizes);
 
 /** @} */
 
@@ -420,20 +440,20 @@ mkldnn_status_t MKLDNN_API mkldnn_pooling_backward_desc_init(
 /** Initializes an @p lrn_desc for forward propagation using @p prop_kind
  * (possible values are #mkldnn_forward_training or #mkldnn_forward_inference),
  * @p alg_kind, memory descriptor @p data_desc, and regularization
- * parameters @p local_size, @p alpha, and @p beta. */
+ * parameters @p local_size, @p alpha, @p beta, and @p k. */
 mkldnn_status_t MKLDNN_API mkldnn_lrn_forward_desc_init(
         mkldnn_lrn_desc_t *lrn_desc, mkldnn_prop_kind_t prop_kind,
         mkldnn_alg_kind_t alg_kind, const mkldnn_memory_desc_t *data_desc,
-        int local_size, double alpha, double beta);
+        int local_size, double alpha, double beta, double k);
 
 /** Initializes an @p lrn_desc for backward propagation using @p alg_kind,
  * memory descriptors @p data_desc, and @p diff_data_desc, and regularization
- * parameters @p local_size, @p alpha, and @p beta. */
+ * parameters @p local_size, @p alpha, @p beta, and @p k. */
 mkldnn_status_t MKLDNN_API mkldnn_lrn_backward_desc_init(
         mkldnn_lrn_desc_t *lrn_desc, mkldnn_alg_kind_t alg_kind,
         const mkldnn_memory_desc_t *diff_data_desc,
         const mkldnn_memory_desc_t *data_desc, int local_size, double alpha,
-        double beta);
+        double beta, double k);
 
 /** @} */
 
@@ -527,6 +547,23 @@ mkldnn_status_t MKLDNN_API mkldnn_convolution_relu_desc_init(
 
 /** @} */
 
+/** @addtogroup c_api_pooling_inner_product Pooling followed by inner product
+ * A merged primitive to compute a pooling followed by inner product, e.g. the
+ * global average pooling and the fully connected layer of a classifier.
+ * @{ */
+
+/** Initializes a merged pooling-inner product descriptor @p pool_ip_desc for
+ * forward propagation (supported inference mode only) using pooling
+ * descriptor @p pool_desc and inner product descriptor @p ip_desc. The source
+ * of the inner product must have the dimensions of the pooling destination,
+ * or be 2D if the pooling destination is 1x1 spatially. */
+mkldnn_status_t MKLDNN_API mkldnn_pooling_inner_product_desc_init(
+        mkldnn_pooling_inner_product_desc_t *pool_ip_desc,
+        const mkldnn_pooling_desc_t *pool_desc,
+        const mkldnn_inner_product_desc_t *ip_desc);
+
+/** @} */
+
 /** @} */
 
 /** @addtogroup c_api_engine Engine operations
@@ -543,6 +580,16 @@ mkldnn_status_t MKLDNN_API mkldnn_engine_create(mkldnn_engine_t *engine,
 mkldnn_status_t MKLDNN_API mkldnn_engine_get_kind(mkldnn_engine_t engine,
         mkldnn_engine_kind_t *kind);
 
+/** Sets the maximal number of primitive descriptors cached by an @p engine
+ * to @p capacity. The cache is disabled if @p capacity is zero. */
+mkldnn_status_t MKLDNN_API mkldnn_engine_set_primitive_desc_cache_capacity(
+        mkldnn_engine_t engine, size_t capacity);
+
+/** Returns the number of @p hits and @p misses of the cache of primitive
+ * descriptors of an @p engine. */
+mkldnn_status_t MKLDNN_API mkldnn_engine_get_primitive_desc_cache_stats(
+        mkldnn_engine_t engine, size_t *hits, size_t *misses);
+
 /** Destroys an @p engine. */
 mkldnn_status_t MKLDNN_API mkldnn_engine_destroy(mkldnn_engine_t engine);
 
@@ -563,21 +610,55 @@ mkldnn_status_t MKLDNN_API mkldnn_stream_submit(mkldnn_stream_t stream,
         mkldnn_primitive_t *error_primitive);
 
 /** Waits for all primitives in the execution @p stream to finish. Returns
- * immediately if @p block is zero. In case of an error, returns
- * the offending @p error_primitive if it is not @c NULL. */
+ * immediately if @p block is zero: #mkldnn_try_again means that the
+ * computations are still in progress and the function should be called
+ * again. In case of an error, returns the offending @p error_primitive if it
+ * is not @c NULL. */
 mkldnn_status_t MKLDNN_API mkldnn_stream_wait(mkldnn_stream_t stream,
         int block, mkldnn_primitive_t *error_primitive);
 
+/** Checks whether all primitives in the execution @p stream have finished
+ * without blocking. Returns #mkldnn_try_again if the computations are still
+ * in progress (a lazy stream starts them on mkldnn_stream_wait() only),
+ * otherwise the status of the computations. In case of an error, returns the
+ * offending @p error_primitive if it is not @c NULL. Unlike
+ * mkldnn_stream_wait() does not change the state of the @p stream. */
+mkldnn_status_t MKLDNN_API mkldnn_stream_query(mkldnn_stream_t stream,
+        mkldnn_primitive_t *error_primitive);
+
 /** Reruns all the primitives within the @p stream. In case of an error,
  * returns the offending @p error_primitive if it is not @c NULL. */
 mkldnn_status_t MKLDNN_API mkldnn_stream_rerun(mkldnn_stream_t stream,
         mkldnn_primitive_t *error_primitive);
 
+/** Returns the @p size in bytes of the arena a @p stream keeps for the
+ * scratch memory of its primitives, and the number of @p uses of the arena
+ * by executions of the primitives. */
+mkldnn_status_t MKLDNN_API mkldnn_stream_get_scratchpad_stats(
+        mkldnn_stream_t stream, size_t *size, size_t *uses);
+
+/** Returns the number of OpenMP threads the primitives of a @p stream were
+ * last run with, which are the ones of the thread that submitted them, or 0
+ * if none have run yet. */
+mkldnn_status_t MKLDNN_API mkldnn_stream_get_num_threads(
+        mkldnn_stream_t stream, int *num_threads);
+
 /** Destroys an execution @p stream. */
 mkldnn_status_t MKLDNN_API mkldnn_stream_destroy(mkldnn_stream_t stream);
 
 /** @} */
 
+/** @addtogroup c_api_service Service functions
+ * @{ */
+
+/** Returns the number of @p hits and @p misses of the process-wide cache of
+ * just-in-time generated kernels. A miss means that a kernel was generated,
+ * a hit means that a previously generated kernel was reused. */
+mkldnn_status_t MKLDNN_API mkldnn_jit_kernel_cache_get_stats(size_t *hits,
+        size_t *misses);
+
+/** @} */
+
 /** @} */
 
 #ifdef __cplusplus
@@ -269,6 +269,7 @@ struct memory: public primitive  {
         data__undef = c_api::mkldnn_data_type_undef,
         f32 = c_api::mkldnn_f32,
         s32 = c_api::mkldnn_s32,
+        u8 = c_api::mkldnn_u8,
     };
 
     /// Memory format specification. See #mkldnn_memory_format_t
@@ -282,15 +283,21 @@ struct memory: public primitive  {
         nchw = c_api::mkldnn_nchw,
         nhwc = c_api::mkldnn_nhwc,
         nChw8c = c_api::mkldnn_nChw8c,
+        nChw16c = c_api::mkldnn_nChw16c,
         oi = c_api::mkldnn_oi,
         oihw = c_api::mkldnn_oihw,
         oIhw8i = c_api::mkldnn_oIhw8i,
         OIhw8i8o = c_api::mkldnn_OIhw8i8o,
+        OIhw16i16o = c_api::mkldnn_OIhw16i16o,
         OIhw8o8i = c_api::mkldnn_OIhw8o8i,
+        OIhw16o16i = c_api::mkldnn_OIhw16o16i,
         Ohwi8o = c_api::mkldnn_Ohwi8o,
+        Ohwi16o = c_api::mkldnn_Ohwi16o,
         goihw = c_api::mkldnn_goihw,
         gOIhw8i8o = c_api::mkldnn_gOIhw8i8o,
+        gOIhw16i16o = c_api::mkldnn_gOIhw16i16o,
         gOIhw8o8i = c_api::mkldnn_gOIhw8o8i,
+        gOIhw16o16i = c_api::mkldnn_gOIhw16o16i,
     };
 
     /// A memory descriptor.
@@ -422,6 +429,29 @@ struct memory: public primitive  {
                 "could not set native handle");
     }
 
+    /// Plans the memory of intermediate memory primitives of @p primitives
+    /// in a single slab (see mkldnn_memory_plan()).
+    ///
+    /// @param primitives The primitives in order of their execution.
+    /// @param slab If not @c nullptr, the planned memory primitives are
+    ///             set to point to @p slab.
+    /// @returns The size of the slab in bytes.
+    static size_t plan(std::vector<primitive> primitives,
+            void *slab = nullptr) {
+        if (primitives.size() == 0) return 0;
+        std::vector<c_api::mkldnn_primitive_t> c_api_primitives;
+        c_api_primitives.reserve(primitives.size());
+        auto convert_to_c = [](primitive p) { return p.get(); };
+        std::transform(primitives.begin(), primitives.end(),
+                std::back_inserter(c_api_primitives), convert_to_c);
+
+        size_t slab_size;
+        error::wrap_c_api(c_api::mkldnn_memory_plan(c_api_primitives.size(),
+                    &c_api_primitives[0], slab, &slab_size),
+                "could not plan memory");
+        return slab_size;
+    }
+
     // Must go away or be private:
     static c_api::mkldnn_data_type_t convert_to_c(data_type adata_type) {
         return static_cast<c_api::mkldnn_data_type_t>(adata_type);
@@ -452,6 +482,7 @@ enum query {
     batch_normalization_d = c_api::mkldnn_query_batch_normalization_d,
     inner_product_d = c_api::mkldnn_query_inner_product_d,
     convolution_relu_d = c_api::mkldnn_query_convolution_relu_d,
+    pooling_inner_product_d = c_api::mkldnn_query_pooling_inner_product_d,
 
     input_pd = c_api::mkldnn_query_input_pd,
     output_pd = c_api::mkldnn_query_output_pd,
@@ -490,6 +521,7 @@ inline c_api::mkldnn_prop_kind_t convert_to_c(prop_kind kind) {
 
 enum algorithm {
     convolution_direct = c_api::mkldnn_convolution_direct,
+    convolution_winograd = c_api::mkldnn_convolution_winograd,
     lrn_across_channels = c_api::mkldnn_lrn_across_channels,
     lrn_within_channel  = c_api::mkldnn_lrn_within_channel,
     pooling_max = c_api::mkldnn_pooling_max,
@@ -776,6 +808,22 @@ struct stream: public handle<c_api::mkldnn_stream_t> {
         return (status == c_api::mkldnn_success);
     }
 
+    /// Checks whether all computations submitted to the stream have completed
+    /// without blocking.
+    ///
+    /// @returns @c true if all computations completed.
+    /// @returns @c false if not all computations completed.
+    bool query() {
+        c_api::mkldnn_primitive_t c_api_error_primitive;
+        c_api::mkldnn_status_t status = c_api::mkldnn_stream_query(get(),
+                &c_api_error_primitive);
+        if (status != c_api::mkldnn_success
+                && status != c_api::mkldnn_try_again)
+            error::wrap_c_api(status, "could not query a stream",
+                    &c_api_error_primitive);
+        return (status == c_api::mkldnn_success);
+    }
+
     stream &rerun() {
         c_api::mkldnn_primitive_t c_api_error_primitive;
         error::wrap_c_api(
@@ -1091,11 +1139,11 @@ struct lrn_forward : public primitive {
         c_api::mkldnn_lrn_desc_t data;
         desc(prop_kind aprop_kind, algorithm aalgorithm,
             const memory::desc &src_desc,
-            int local_size, double alpha, double beta)
+            int local_size, double alpha, double beta, double k = 1.0)
         {
             error::wrap_c_api(c_api::mkldnn_lrn_forward_desc_init(&data,
                 mkldnn::convert_to_c(aprop_kind), convert_to_c(aalgorithm),
-                &src_desc.data, local_size, alpha, beta),
+                &src_desc.data, local_size, alpha, beta, k),
                 "could not create a lrn forward descriptor");
         }
     };
@@ -1164,11 +1212,12 @@ struct lrn_backward : public primitive {
         desc(algorithm aalgorithm,
             const memory::desc &src_desc,
             const memory::desc &diff_dst_desc,
-            int local_size, double alpha, double beta)
+            int local_size, double alpha, double beta, double k = 1.0)
         {
             error::wrap_c_api(c_api::mkldnn_lrn_backward_desc_init(&data,
                 convert_to_c(aalgorithm),
-                &diff_dst_desc.data, &src_desc.data, local_size, alpha, beta),
+                &diff_dst_desc.data, &src_desc.data, local_size, alpha, beta,
+                k),
                 "could not create a lrn backward descriptor");
         }
     };
@@ -1181,6 +1230,16 @@ struct lrn_backward : public primitive {
                 "could not create a lrn backward primitive descriptor");
             reset(result);
         }
+
+        primitive_desc(const desc &adesc, const engine &aengine,
+                const lrn_forward::primitive_desc &hint_fwd_primitive_desc) {
+            c_api::mkldnn_primitive_desc_t result;
+            error::wrap_c_api(c_api::mkldnn_primitive_desc_create(
+                    &result, &adesc.data, aengine.get(),
+                    hint_fwd_primitive_desc.get()),
+                "could not create a lrn backward primitive descriptor");
+            reset(result);
+        }
     };
 
     lrn_backward(const primitive_desc &aprimitive_desc,
@@ -1920,6 +1979,56 @@ struct inner_product_backward_weights: public primitive {
         reset(result);
     }
 };
+
+struct pooling_inner_product_forward : public primitive {
+    struct desc {
+        c_api::mkldnn_pooling_inner_product_desc_t data;
+        desc(const pooling_forward::desc &pool_desc,
+                const inner_product_forward::desc &ip_desc)
+        {
+            error::wrap_c_api(c_api::mkldnn_pooling_inner_product_desc_init(
+                        &data, &pool_desc.data, &ip_desc.data),
+                    "could not create a pooling_inner_product_forward "
+                    "descriptor");
+        }
+    };
+
+    struct primitive_desc : public handle<c_api::mkldnn_primitive_desc_t>{
+        primitive_desc(const desc &adesc, const engine &aengine) {
+            c_api::mkldnn_primitive_desc_t result;
+            error::wrap_c_api(c_api::mkldnn_primitive_desc_create(
+                    &result, &adesc.data, aengine.get(), nullptr),
+                "could not create a pooling inner product forward "
+                "descriptor");
+            reset(result);
+        }
+    };
+
+    pooling_inner_product_forward(const primitive_desc &aprimitive_desc,
+            const primitive::at &src, const primitive::at &weights,
+            const primitive::at &bias, const memory &dst) {
+        c_api::mkldnn_primitive_t result;
+        c_api::mkldnn_primitive_at_t inputs[] = { src.data, weights.data,
+                bias.data };
+        c_api::const_mkldnn_primitive_t outputs[] = { dst.get() };
+        error::wrap_c_api(c_api::mkldnn_primitive_create(&result,
+                aprimitive_desc.get(), inputs, outputs),
+            "could not create a pooling inner product forward primitive");
+        reset(result);
+    }
+
+    pooling_inner_product_forward(const primitive_desc &aprimitive_desc,
+            const primitive::at &src, const primitive::at &weights,
+            const memory &dst) {
+        c_api::mkldnn_primitive_t result;
+        c_api::mkldnn_primitive_at_t inputs[] = { src.data, weights.data };
+        c_api::const_mkldnn_primitive_t outputs[] = { dst.get() };
+        error::wrap_c_api(c_api::mkldnn_primitive_create(&result,
+                aprimitive_desc.get(), inputs, outputs),
+            "could not create a pooling inner product forward primitive");
+        reset(result);
+    }
+};
 } // namespace mkldnn
 
 #endif
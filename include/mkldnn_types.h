@@ -66,6 +66,8 @@ typedef enum {
     mkldnn_f32 = 1,
     /** 32-bit signed integer. */
     mkldnn_s32 = 2,
+    /** 8-bit unsigned integer. */
+    mkldnn_u8 = 3,
 } mkldnn_data_type_t;
 
 /** Memory format specification.
@@ -111,6 +113,9 @@ typedef enum {
     /** 4D data tensor in the @c nchw format with channels data laid out in
      * memory in 8-element blocks. */
     mkldnn_nChw8c,
+    /** 4D data tensor in the @c nchw format with channels data laid out in
+     * memory in 16-element blocks. */
+    mkldnn_nChw16c,
     /** 2D weights tensor in the format (input channels, output channels). */
     mkldnn_oi,
     /** 4D weights tensor in the format (input channels, output channels,
@@ -119,13 +124,23 @@ typedef enum {
     /** 4D weights tensor in the @c oihw format with both input and output
      * channels data laid out in memory in 8-element blocks. */
     mkldnn_OIhw8i8o,
+    /** 4D weights tensor in the @c oihw format with both input and output
+     * channels data laid out in memory in 16-element blocks. */
+    mkldnn_OIhw16i16o,
     /** 4D weights tensor in the @c oihw format with both input and output
      * channels data laid out in memory in 8-element blocks. */
     mkldnn_OIhw8o8i,
+    /** 4D weights tensor in the @c oihw format with both input and output
+     * channels data laid out in memory in 16-element blocks. */
+    mkldnn_OIhw16o16i,
     /** 4D weights tensor in the format (output channels, width, height, input
      * channels) with output channels data laid out in memory in 8-element
      * blocks. */
     mkldnn_Ohwi8o,
+    /** 4D weights tensor in the format (output channels, width, height, input
+     * channels) with output channels data laid out in memory in 16-element
+     * blocks. */
+    mkldnn_Ohwi16o,
     /** 5D weights tensor in the @c oihw format with extra outer dimension for
      * groups. */
     mkldnn_goihw,
@@ -133,10 +148,18 @@ typedef enum {
      * input and output channels data laid out in memory in 8-element blocks.
      */
     mkldnn_gOIhw8i8o,
+    /** 5D weights tensor in the blocked version of @c goihw format with both
+     * input and output channels data laid out in memory in 16-element blocks.
+     */
+    mkldnn_gOIhw16i16o,
     /** 5D weights tensor in the blocked version of @c goihw format with both
      * input and output channels data laid out in memory in 8-element blocks.
      */
     mkldnn_gOIhw8o8i,
+    /** 5D weights tensor in the blocked version of @c goihw format with both
+     * input and output channels data laid out in memory in 16-element blocks.
+     */
+    mkldnn_gOIhw16o16i,
     /** 4D weights tensor in the oihw format with input channels data laid out
      * in memory in 8-element blocks. */
     mkldnn_oIhw8i = mkldnn_nChw8c,
@@ -205,12 +228,16 @@ typedef enum {
     mkldnn_inner_product,
     /** A convolution primitive merged with relu */
     mkldnn_convolution_relu,
+    /** A pooling primitive merged with inner product */
+    mkldnn_pooling_inner_product,
 } mkldnn_primitive_kind_t;
 
 /** Kinds of algorithms. */
 typedef enum {
     /** Direct convolution */
     mkldnn_convolution_direct = 1,
+    /** Winograd convolution */
+    mkldnn_convolution_winograd = 2,
     /** Max pooling */
     mkldnn_pooling_max = 34,
     /** Average pooling */
@@ -298,7 +325,7 @@ typedef struct {
      * #mkldnn_backward_weights, and #mkldnn_backward_bias. */
     mkldnn_prop_kind_t prop_kind;
     /** The kind of the convolution algorithm. Possible values:
-     * #mkldnn_convolution_direct. */
+     * #mkldnn_convolution_direct and #mkldnn_convolution_winograd. */
     mkldnn_alg_kind_t alg_kind;
     /** Source memory descriptor. */
     mkldnn_memory_desc_t src_desc;
@@ -400,6 +427,8 @@ typedef struct {
     double lrn_alpha;
     /** LRN beta parameter. */
     double lrn_beta;
+    /** LRN k parameter. */
+    double lrn_k;
 } mkldnn_lrn_desc_t;
 
 /** A descriptor of a Batch Normalization operation. */
@@ -465,6 +494,18 @@ typedef struct {
     double negative_slope;
 } mkldnn_convolution_relu_desc_t;
 
+/** A descriptor of a pooling followed by inner product operation. */
+typedef struct {
+    /** The kind of primitive. Used for self identifying the primitive
+     * descriptor. Must be #mkldnn_pooling_inner_product. */
+    mkldnn_primitive_kind_t primitive_kind;
+    /** A descriptor of a pooling operation. */
+    mkldnn_pooling_desc_t pooling_desc;
+    /** A descriptor of an inner product operation, which source is the
+     * destination of the pooling. */
+    mkldnn_inner_product_desc_t inner_product_desc;
+} mkldnn_pooling_inner_product_desc_t;
+
 /** @} */
 
 /** @addtogroup c_api_engine_types Engine
@@ -596,6 +637,8 @@ typedef enum {
     mkldnn_query_batch_normalization_d, /**< batch normalization descriptor */
     mkldnn_query_inner_product_d, /**< inner product descriptor */
     mkldnn_query_convolution_relu_d, /**< convolution-relu descriptor */
+    mkldnn_query_pooling_inner_product_d, /**< pooling-inner product
+                                            descriptor */
 
     /* (memory) primitive descriptor section */
     mkldnn_query_some_pd = 128, /**< stub */
@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -39,7 +40,8 @@ status_t bnrm_desc_init(batch_normalization_desc_t *bnrm_desc,
         && implication(prop_kind & backward, diff_data_desc != nullptr);
     if (!args_ok) return invalid_arguments;
 
-    batch_normalization_desc_t bd = {};
+    batch_normalization_desc_t bd;
+    memset(&bd, 0, sizeof(bd));
     bd.primitive_kind = primitive_kind::batch_normalization;
     bd.prop_kind = prop_kind;
 
@@ -59,6 +59,7 @@ namespace prop_kind {
 using alg_kind_t = mkldnn_alg_kind_t;
 namespace alg_kind {
     const alg_kind_t convolution_direct = mkldnn_convolution_direct;
+    const alg_kind_t convolution_winograd = mkldnn_convolution_winograd;
     const alg_kind_t pooling_max = mkldnn_pooling_max;
     const alg_kind_t pooling_avg = mkldnn_pooling_avg;
     const alg_kind_t lrn_across_channels = mkldnn_lrn_across_channels;
@@ -70,6 +71,7 @@ namespace data_type {
     const data_type_t undef = mkldnn_data_type_undef;
     const data_type_t f32 = mkldnn_f32;
     const data_type_t s32 = mkldnn_s32;
+    const data_type_t u8 = mkldnn_u8;
 }
 
 using memory_format_t = mkldnn_memory_format_t;
@@ -82,15 +84,21 @@ namespace memory_format {
     const memory_format_t nchw = mkldnn_nchw;
     const memory_format_t nhwc = mkldnn_nhwc;
     const memory_format_t nChw8c = mkldnn_nChw8c;
+    const memory_format_t nChw16c = mkldnn_nChw16c;
     const memory_format_t oi = mkldnn_oi;
     const memory_format_t oihw = mkldnn_oihw;
     const memory_format_t oIhw8i = mkldnn_oIhw8i;
     const memory_format_t OIhw8i8o = mkldnn_OIhw8i8o;
+    const memory_format_t OIhw16i16o = mkldnn_OIhw16i16o;
     const memory_format_t OIhw8o8i = mkldnn_OIhw8o8i;
+    const memory_format_t OIhw16o16i = mkldnn_OIhw16o16i;
     const memory_format_t Ohwi8o = mkldnn_Ohwi8o;
+    const memory_format_t Ohwi16o = mkldnn_Ohwi16o;
     const memory_format_t goihw = mkldnn_goihw;
     const memory_format_t gOIhw8i8o = mkldnn_gOIhw8i8o;
+    const memory_format_t gOIhw16i16o = mkldnn_gOIhw16i16o;
     const memory_format_t gOIhw8o8i = mkldnn_gOIhw8o8i;
+    const memory_format_t gOIhw16o16i = mkldnn_gOIhw16o16i;
 }
 
 using padding_kind_t = mkldnn_padding_kind_t;
@@ -120,6 +128,8 @@ namespace primitive_kind {
     const primitive_kind_t batch_normalization = mkldnn_batch_normalization;
     const primitive_kind_t inner_product = mkldnn_inner_product;
     const primitive_kind_t convolution_relu = mkldnn_convolution_relu;
+    const primitive_kind_t pooling_inner_product =
+        mkldnn_pooling_inner_product;
 }
 
 using query_t = mkldnn_query_t;
@@ -144,6 +154,8 @@ namespace query {
     const query_t batch_normalization_d = mkldnn_query_batch_normalization_d;
     const query_t inner_product_d = mkldnn_query_inner_product_d;
     const query_t convolution_relu_d = mkldnn_query_convolution_relu_d;
+    const query_t pooling_inner_product_d =
+        mkldnn_query_pooling_inner_product_d;
 
     const query_t some_pd = mkldnn_query_some_pd;
     const query_t input_pd = mkldnn_query_input_pd;
@@ -167,6 +179,7 @@ using lrn_desc_t = mkldnn_lrn_desc_t;
 using batch_normalization_desc_t = mkldnn_batch_normalization_desc_t;
 using inner_product_desc_t = mkldnn_inner_product_desc_t;
 using convolution_relu_desc_t = mkldnn_convolution_relu_desc_t;
+using pooling_inner_product_desc_t = mkldnn_pooling_inner_product_desc_t;
 
 /* C op_desc_t, which eventually are just (void*) */
 using c_op_desc_t = mkldnn_op_desc_t;
@@ -183,6 +196,7 @@ struct op_desc_t {
         batch_normalization_desc_t batch_normalization;
         inner_product_desc_t inner_product;
         convolution_relu_desc_t convolution_relu;
+        pooling_inner_product_desc_t pooling_inner_product;
     };
 
     op_desc_t(const primitive_kind_t &_): kind(_) {}
@@ -202,6 +216,8 @@ struct op_desc_t {
     DECL_CTOR_AND_CONVERTERS(batch_normalization_desc_t, batch_normalization);
     DECL_CTOR_AND_CONVERTERS(inner_product_desc_t, inner_product);
     DECL_CTOR_AND_CONVERTERS(convolution_relu_desc_t, convolution_relu);
+    DECL_CTOR_AND_CONVERTERS(pooling_inner_product_desc_t,
+            pooling_inner_product);
 
 #   undef DECL_CTOR_AND_CONVERTERS
 };
@@ -224,9 +240,12 @@ using stream_t = mkldnn_stream;
 struct memory_pd_t;
 struct view_pd_t;
 struct concat_pd_t;
+struct concat_inplace_pd_t;
 struct sum_pd_t;
 struct reorder_pd_t;
 
+struct primitive_desc_cache_t;
+
 }
 }
 
@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -38,13 +39,14 @@ status_t conv_desc_init(convolution_desc_t *conv_desc,
     bool args_ok = true
         && !any_null(conv_desc, src_desc, weights_desc, dst_desc, strides,
                 padding_l)
-        && one_of(alg_kind, convolution_direct)
+        && one_of(alg_kind, convolution_direct, convolution_winograd)
         && one_of(padding_kind, padding_kind::padding_zero);
     if (!args_ok) return invalid_arguments;
 
     if (padding_r == nullptr) padding_r = padding_l;
 
-    convolution_desc_t cd = {};
+    convolution_desc_t cd;
+    memset(&cd, 0, sizeof(cd));
     cd.primitive_kind = primitive_kind::convolution;
     cd.prop_kind = prop_kind;
     cd.alg_kind = alg_kind;
@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -33,6 +34,7 @@ status_t mkldnn_convolution_relu_desc_init(
     bool args_ok = !any_null(conv_relu_desc, conv_desc)
         && conv_desc->prop_kind == prop_kind::forward_inference;
     if (!args_ok) return invalid_arguments;
+    memset(conv_relu_desc, 0, sizeof(*conv_relu_desc));
     conv_relu_desc->primitive_kind = primitive_kind::convolution_relu;
     conv_relu_desc->convolution_desc = *conv_desc;
     conv_relu_desc->negative_slope = negative_slope;
@@ -17,6 +17,7 @@
 #include "mkldnn.h"
 #include "engine.hpp"
 #include "nstl.hpp"
+#include "primitive_desc_cache.hpp"
 
 #include "c_types_map.hpp"
 #include "../cpu/cpu_engine.hpp"
@@ -80,6 +81,28 @@ status_t mkldnn_engine_get_kind(engine_t *engine, engine_kind_t *kind) {
     return success;
 }
 
+status_t mkldnn_engine_set_primitive_desc_cache_capacity(engine_t *engine,
+        size_t capacity) {
+    if (engine == nullptr)
+        return invalid_arguments;
+    auto pd_cache = engine->primitive_desc_cache();
+    if (pd_cache == nullptr)
+        return unimplemented;
+    pd_cache->set_capacity(capacity);
+    return success;
+}
+
+status_t mkldnn_engine_get_primitive_desc_cache_stats(engine_t *engine,
+        size_t *hits, size_t *misses) {
+    if (utils::any_null(engine, hits, misses))
+        return invalid_arguments;
+    auto pd_cache = engine->primitive_desc_cache();
+    if (pd_cache == nullptr)
+        return unimplemented;
+    pd_cache->get_stats(hits, misses);
+    return success;
+}
+
 status_t mkldnn_engine_destroy(engine_t *engine) {
     /* TODO: engine->dec_ref_count(); */
     delete engine;
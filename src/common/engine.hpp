@@ -43,6 +43,8 @@ struct mkldnn_engine: public mkldnn::impl::c_compatible {
 
     typedef mkldnn::impl::nstl::vector<mkldnn::impl::event_t *>
         event_vector;
+    typedef mkldnn::impl::nstl::vector<mkldnn::impl::primitive_t *>
+        primitive_vector;
 
 #if 0
     /** reduce ref counting for current engine */
@@ -60,6 +62,10 @@ struct mkldnn_engine: public mkldnn::impl::c_compatible {
      *   resulting event (to be passed to p->execute(e))
      * @param prerequisites (input)
      *   vector of prerequisite events that must be finished before @p p is run
+     * @param scratchpad (input)
+     *   scratch memory of p->pd()->scratchpad_size() bytes (to be passed to
+     *   p->execute(e, scratchpad)), owned by the caller. If nullptr the
+     *   primitive allocates it for this execution itself
      *
      * @return
      *   status of the operation
@@ -84,7 +90,34 @@ struct mkldnn_engine: public mkldnn::impl::c_compatible {
      *   event::aborted primitive @p p would not be executed, its event's @p e
      *   state is automatically set to @c event::aborted */
     virtual mkldnn::impl::status_t submit(mkldnn::impl::primitive_t *p,
-            mkldnn::impl::event_t *e, event_vector &prerequisites) = 0;
+            mkldnn::impl::event_t *e, event_vector &prerequisites,
+            char *scratchpad) = 0;
+
+    /** submits primitives @p prims for execution. Engine is free to run a
+     * primitive as soon as all its prerequisites are finished, concurrently
+     * with the others
+     *
+     * @param events (output)
+     *   resulting events, one per primitive
+     * @param prerequisites (input)
+     *   prerequisite events, one vector per primitive. Each one is either
+     *   finished already or the event of a preceding primitive in @p prims
+     * @param scratchpads (input)
+     *   scratch memories, one per primitive. The ones of primitives which
+     *   may run concurrently are disjoint
+     *
+     * Default implementation submits the primitives one by one */
+    virtual mkldnn::impl::status_t submit(const primitive_vector &prims,
+            event_vector &events,
+            mkldnn::impl::nstl::vector<event_vector> &prerequisites,
+            const mkldnn::impl::nstl::vector<char *> &scratchpads) {
+        for (size_t i = 0; i < prims.size(); ++i) {
+            mkldnn::impl::status_t status = submit(prims[i], events[i],
+                    prerequisites[i], scratchpads[i]);
+            if (status != mkldnn::impl::status::success) return status;
+        }
+        return mkldnn::impl::status::success;
+    }
 
     /* implementation section */
     virtual mkldnn::impl::status_t memory_primitive_desc_create(
@@ -105,6 +138,12 @@ struct mkldnn_engine: public mkldnn::impl::c_compatible {
             int n, int concat_dim, const mkldnn::impl::memory_pd_t **input_pds)
     { return mkldnn::impl::status::unimplemented; }
 
+    virtual mkldnn::impl::status_t concat_inplace_primitive_desc_create(
+            mkldnn::impl::concat_inplace_pd_t **concat_inplace_pd,
+            const mkldnn::impl::memory_pd_t *output_pd,
+            int n, int concat_dim, const int *sizes)
+    { return mkldnn::impl::status::unimplemented; }
+
     virtual mkldnn::impl::status_t sum_primitive_desc_create(
             mkldnn::impl::sum_pd_t **sum_pd,
             const mkldnn::impl::memory_desc_t *output_d,
@@ -128,6 +167,44 @@ struct mkldnn_engine: public mkldnn::impl::c_compatible {
      * NULL-terminated list */
     virtual const primitive_desc_create_f* get_implementation_list() const;
 
+    /** return the cache of primitive descriptors or nullptr if the engine
+     * does not cache them */
+    virtual mkldnn::impl::primitive_desc_cache_t *primitive_desc_cache()
+    { return nullptr; }
+
+    /** optimizes a sequence of primitives @p prims in-place (fuses
+     * primitives, removes redundant reorders, etc)
+     *
+     * @param prims (input/output)
+     *   primitives in order of their execution, all belong to the engine
+     * @param created (output)
+     *   primitives the optimizer has created are appended here. It is up to
+     *   the caller to destroy them once @p prims are not in use anymore
+     *
+     * @note
+     *   user primitives are never modified. The contents of memories that
+     *   are both written and read by @p prims are unspecified after the
+     *   execution of the optimized sequence */
+    virtual mkldnn::impl::status_t optimize(primitive_vector &prims,
+            primitive_vector &created)
+    { UNUSED(prims); UNUSED(created); return mkldnn::impl::status::success; }
+
+    /** plans the memory of intermediate memories of @p prims in a single
+     * slab (see mkldnn_memory_plan())
+     *
+     * @param prims (input)
+     *   primitives in order of their execution, all belong to the engine
+     * @param slab_size (output)
+     *   the size of the slab in bytes
+     * @param slab (input)
+     *   if not nullptr the data handles of the planned memories are set to
+     *   point to @p slab */
+    virtual mkldnn::impl::status_t plan_memory(const primitive_vector &prims,
+            size_t *slab_size, char *slab) {
+        UNUSED(prims); UNUSED(slab_size); UNUSED(slab);
+        return mkldnn::impl::status::unimplemented;
+    }
+
 protected:
     mkldnn::impl::engine_kind_t kind_;
 };
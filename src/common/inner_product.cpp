@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -34,7 +35,8 @@ status_t ip_desc_init(inner_product_desc_t *ip_desc, prop_kind_t prop_kind,
     bool args_ok = !any_null(ip_desc, src_desc, weights_desc, dst_desc);
     if (!args_ok) return invalid_arguments;
 
-    inner_product_desc_t id = {};
+    inner_product_desc_t id;
+    memset(&id, 0, sizeof(id));
     id.primitive_kind = primitive_kind::inner_product;
     id.prop_kind = prop_kind;
 
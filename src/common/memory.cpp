@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "mkldnn.h"
 
@@ -43,10 +44,13 @@ status_t mkldnn_memory_desc_init(memory_desc_t *memory_desc, int ndims,
     /* memory_desc != 0 */
     bool args_ok = !any_null(memory_desc)
         && 0 < ndims && ndims <= TENSOR_MAX_DIMS
-        && one_of(data_type, f32, s32);
+        && one_of(data_type, f32, s32, u8);
     if (!args_ok) return invalid_arguments;
 
+    /* zeroed, so that the unused dims, the layout of the format any and the
+     * padding do not make identical descriptors compare different */
     memory_desc_t md;
+    memset(&md, 0, sizeof(md));
     md.ndims = ndims;
     array_copy(md.dims, dims, ndims);
     md.primitive_kind = primitive_kind::memory;
@@ -63,14 +67,20 @@ status_t mkldnn_memory_desc_init(memory_desc_t *memory_desc, int ndims,
     case nchw:
     case nhwc:
     case nChw8c:
+    case nChw16c:
     case oi:
     case oihw:
     case OIhw8i8o:
+    case OIhw16i16o:
     case OIhw8o8i:
+    case OIhw16o16i:
     case Ohwi8o:
+    case Ohwi16o:
     case goihw:
     case gOIhw8i8o:
+    case gOIhw16i16o:
     case gOIhw8o8i:
+    case gOIhw16o16i:
         status = memory_desc_wrapper::compute_blocking(md);
         break;
     /* not enough information */
@@ -104,7 +114,7 @@ status_t mkldnn_view_primitive_desc_create(primitive_desc_t **view_pd,
         (const memory_pd_t*)memory_pd;
     memory_desc_wrapper md(*mpd->desc());
     for (int d = 0; d < md.ndims(); ++d) {
-        if (offsets[d] < 0 || (offsets[d] + dims[d] >= md.dims()[d]))
+        if (offsets[d] < 0 || (offsets[d] + dims[d] > md.dims()[d]))
             return invalid_arguments;
     }
     return memory_pd->engine()->view_primitive_desc_create(
@@ -152,6 +162,21 @@ status_t mkldnn_memory_set_data_handle(primitive_t *memory, void *handle) {
     return memory->set_data_handle(handle);
 }
 
+status_t mkldnn_memory_plan(size_t n, primitive_t *primitives[], void *slab,
+        size_t *slab_size) {
+    bool args_ok = !any_null(primitives, slab_size) && n > 0;
+    if (!args_ok) return invalid_arguments;
+
+    engine_t::primitive_vector prims;
+    for (size_t i = 0; i < n; ++i) {
+        if (primitives[i] == nullptr
+                || primitives[i]->engine() != primitives[0]->engine())
+            return invalid_arguments;
+        prims.push_back(primitives[i]);
+    }
+    return prims[0]->engine()->plan_memory(prims, slab_size, (char *)slab);
+}
+
 status_t mkldnn_concat_primitive_desc_create(primitive_desc_t **concat_pd,
         const memory_desc_t *output_d, int n, int concat_dim,
         const primitive_desc_t **input_pds) {
@@ -201,6 +226,74 @@ status_t mkldnn_concat_primitive_desc_create(primitive_desc_t **concat_pd,
             (concat_pd_t**)concat_pd, output_d, n, concat_dim, i_mpds);
 }
 
+status_t mkldnn_concat_inplace_by_input_primitive_desc_create(
+        primitive_desc_t **concat_inplace_pd, int n, int concat_dim,
+        const primitive_desc_t **input_pds) {
+    bool args_ok = !any_null(concat_inplace_pd, input_pds) && n > 0;
+    if (!args_ok) return invalid_arguments;
+    for (int i = 0; i < n; ++i) {
+        if (input_pds[i] == nullptr ||
+                input_pds[i]->kind() != primitive_kind::memory)
+            return invalid_arguments;
+    }
+
+    auto i_mpds = (const memory_pd_t **)input_pds;
+    engine_t *engine = i_mpds[0]->engine();
+    const memory_desc_t &i_md = *i_mpds[0]->desc();
+    if (concat_dim < 0 || concat_dim >= i_md.ndims) return invalid_arguments;
+
+    nstl::vector<int> sizes;
+    dims_t dims;
+    array_copy(dims, i_md.dims, i_md.ndims);
+    dims[concat_dim] = 0;
+    for (int i = 0; i < n; ++i) {
+        const memory_desc_t &md = *i_mpds[i]->desc();
+        if (i_mpds[i]->engine() != engine) return invalid_arguments;
+        if (md.ndims != i_md.ndims || md.data_type != i_md.data_type
+                || md.format != i_md.format)
+            return invalid_arguments;
+        for (int d = 0; d < i_md.ndims; ++d) {
+            if (d == concat_dim) continue;
+            if (md.dims[d] != dims[d]) return invalid_arguments;
+        }
+        sizes.push_back(md.dims[concat_dim]);
+        dims[concat_dim] += md.dims[concat_dim];
+    }
+
+    memory_desc_t output_d;
+    CHECK(mkldnn_memory_desc_init(&output_d, i_md.ndims, dims,
+                i_md.data_type, i_md.format));
+    memory_pd_t *output_pd;
+    CHECK(engine->memory_primitive_desc_create(&output_pd, &output_d));
+
+    status_t status = engine->concat_inplace_primitive_desc_create(
+            (concat_inplace_pd_t**)concat_inplace_pd, output_pd, n,
+            concat_dim, &sizes[0]);
+    delete output_pd;
+    return status;
+}
+
+status_t mkldnn_concat_inplace_by_output_primitive_desc_create(
+        primitive_desc_t **concat_inplace_pd, const primitive_desc_t *output,
+        int n, int concat_dim, const int *sizes) {
+    bool args_ok = !any_null(concat_inplace_pd, output, sizes) && n > 0
+        && output->kind() == primitive_kind::memory;
+    if (!args_ok) return invalid_arguments;
+
+    auto o_mpd = (const memory_pd_t *)output;
+    const memory_desc_t &o_md = *o_mpd->desc();
+    if (concat_dim < 0 || concat_dim >= o_md.ndims
+            || !memory_desc_wrapper(o_md).is_defined())
+        return invalid_arguments;
+
+    int concat_dim_sz = 0;
+    for (int i = 0; i < n; ++i) concat_dim_sz += sizes[i];
+    if (concat_dim_sz != o_md.dims[concat_dim]) return invalid_arguments;
+
+    return o_mpd->engine()->concat_inplace_primitive_desc_create(
+            (concat_inplace_pd_t**)concat_inplace_pd, o_mpd, n, concat_dim,
+            sizes);
+}
 
 status_t mkldnn_sum_primitive_desc_create(primitive_desc_t **sum_pd,
         const memory_desc_t *output_d, int n, double* scale,
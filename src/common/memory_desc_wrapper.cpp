@@ -81,7 +81,8 @@ status_t fill_nonblocked(memory_desc_t &md, const int perm[]) {
 
 status_t fill_contiguous_blocked(memory_desc_t &md, const dims_t block_dims,
         const int perm[]) {
-    /* TODO: check for dims[d] % block_dims[d] != 0 */
+    /* the dimensions that are not a multiple of their block are padded up
+     * to the next multiple, the padding is zero-filled */
     const int ndims = md.ndims;
     blocking_desc_t &blk = md.layout_desc.blocking;
     array_copy(blk.block_dims, block_dims, ndims);
@@ -89,14 +90,14 @@ status_t fill_contiguous_blocked(memory_desc_t &md, const dims_t block_dims,
     dim_t unrolled_dims[2*TENSOR_MAX_DIMS];
     stride_t unrolled_strides[2*TENSOR_MAX_DIMS];
     for (int d = 0; d < ndims; ++d) {
-        unrolled_dims[d] = md.dims[d] / block_dims[d];
+        blk.padding_dims[d] = rnd_up(md.dims[d], block_dims[d]);
+        unrolled_dims[d] = blk.padding_dims[d] / block_dims[d];
         unrolled_dims[ndims + d] = block_dims[d];
     }
 
     set_default_strides(unrolled_strides, unrolled_dims, 2*ndims, perm);
     array_copy(blk.strides[0], &unrolled_strides[0], ndims);
     array_copy(blk.strides[1], &unrolled_strides[ndims], ndims);
-    array_copy(blk.padding_dims, md.dims, ndims);
     array_set(blk.offset_padding_to_data, 0, ndims);
     blk.offset_padding = 0;
     return success;
@@ -133,6 +134,16 @@ status_t fill_nChw8c(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_nChw16c(memory_desc_t &md) {
+    if (md.ndims != 4) return invalid_arguments;
+
+    const dims_t block_dims = {1, 16, 1, 1};
+    const int perm[] = {
+        0, 1, 2, 3,
+        4, 5, 6, 7};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 status_t fill_oi(memory_desc_t &md) {
     if (md.ndims != 2) return invalid_arguments;
 
@@ -157,6 +168,16 @@ status_t fill_OIhw8i8o(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_OIhw16i16o(memory_desc_t &md) {
+    if (md.ndims != 4) return invalid_arguments;
+
+    const dims_t block_dims = {16, 16, 1, 1};
+    const int perm[] = {
+        0, 1, 2, 3,
+        5, 4, 6, 7};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 status_t fill_OIhw8o8i(memory_desc_t &md) {
     if (md.ndims != 4) return invalid_arguments;
 
@@ -167,6 +188,16 @@ status_t fill_OIhw8o8i(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_OIhw16o16i(memory_desc_t &md) {
+    if (md.ndims != 4) return invalid_arguments;
+
+    const dims_t block_dims = {16, 16, 1, 1};
+    const int perm[] = {
+        0, 1, 2, 3,
+        4, 5, 6, 7};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 status_t fill_Ohwi8o(memory_desc_t &md) {
     if (md.ndims != 4) return invalid_arguments;
 
@@ -177,6 +208,16 @@ status_t fill_Ohwi8o(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_Ohwi16o(memory_desc_t &md) {
+    if (md.ndims != 4) return invalid_arguments;
+
+    const dims_t block_dims = {16, 1, 1, 1};
+    const int perm[] = {
+        0, 2, 3, 1,
+        4, 5, 6, 7};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 status_t fill_goihw(memory_desc_t &md) {
     if (md.ndims != 5) return invalid_arguments;
 
@@ -194,6 +235,16 @@ status_t fill_gOIhw8i8o(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_gOIhw16i16o(memory_desc_t &md) {
+    if (md.ndims != 5) return invalid_arguments;
+
+    const dims_t block_dims = {1, 16, 16, 1, 1};
+    const int perm[] = {
+        0, 1, 2, 3, 4,
+        5, 7, 6, 8, 9};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 status_t fill_gOIhw8o8i(memory_desc_t &md) {
     if (md.ndims != 5) return invalid_arguments;
 
@@ -204,6 +255,16 @@ status_t fill_gOIhw8o8i(memory_desc_t &md) {
     return fill_contiguous_blocked(md, block_dims, perm);
 }
 
+status_t fill_gOIhw16o16i(memory_desc_t &md) {
+    if (md.ndims != 5) return invalid_arguments;
+
+    const dims_t block_dims = {1, 16, 16, 1, 1};
+    const int perm[] = {
+        0, 1, 2, 3, 4,
+        5, 6, 7, 8, 9};
+    return fill_contiguous_blocked(md, block_dims, perm);
+}
+
 }
 
 status_t memory_desc_wrapper::compute_blocking(memory_desc_t &memory_desc)
@@ -216,14 +277,20 @@ status_t memory_desc_wrapper::compute_blocking(memory_desc_t &memory_desc)
     case nchw: return fill_nchw(memory_desc);
     case nhwc: return fill_nhwc(memory_desc);
     case nChw8c: return fill_nChw8c(memory_desc);
+    case nChw16c: return fill_nChw16c(memory_desc);
     case oi: return fill_oi(memory_desc);
     case oihw: return fill_oihw(memory_desc);
     case OIhw8i8o: return fill_OIhw8i8o(memory_desc);
+    case OIhw16i16o: return fill_OIhw16i16o(memory_desc);
     case OIhw8o8i: return fill_OIhw8o8i(memory_desc);
+    case OIhw16o16i: return fill_OIhw16o16i(memory_desc);
     case Ohwi8o: return fill_Ohwi8o(memory_desc);
+    case Ohwi16o: return fill_Ohwi16o(memory_desc);
     case goihw: return fill_goihw(memory_desc);
     case gOIhw8i8o: return fill_gOIhw8i8o(memory_desc);
+    case gOIhw16i16o: return fill_gOIhw16i16o(memory_desc);
     case gOIhw8o8i: return fill_gOIhw8o8i(memory_desc);
+    case gOIhw16o16i: return fill_gOIhw16o16i(memory_desc);
     default: break;
     }
 
@@ -58,6 +58,9 @@ struct memory_desc_wrapper: public c_compatible {
                 ? blocking_desc().padding_dims : dims(), ndims());
     }
 
+    /** returns true if some dimensions are padded up to their blocks */
+    bool is_padded() const { return nelems(true) != nelems(); }
+
     /** returns true if memory descriptor is zero */
     bool is_zero() const { return ndims() == 0; }
 
@@ -66,9 +69,10 @@ struct memory_desc_wrapper: public c_compatible {
     size_t size() const {
         using namespace mkldnn::impl::memory_format;
         if (is_zero() || format() == memory_format::any) return 0;
-        assert(utils::one_of(format(), x, nc, nchw, nhwc, nChw8c, oi, oihw,
-                    OIhw8i8o, OIhw8o8i, Ohwi8o, goihw, gOIhw8i8o, gOIhw8o8i,
-                    blocked));
+        assert(utils::one_of(format(), x, nc, nchw, nhwc, nChw8c, nChw16c,
+                    oi, oihw, OIhw8i8o, OIhw16i16o, OIhw8o8i, OIhw16o16i,
+                    Ohwi8o, Ohwi16o, goihw, gOIhw8i8o, gOIhw16i16o, gOIhw8o8i,
+                    gOIhw16o16i, blocked));
 
         if (blocking_desc().offset_padding != 0) return 0;
 
@@ -99,8 +99,9 @@ struct view_pd_t: public primitive_desc_t {
     { return index == 0 ? src_pd() : nullptr; }
     virtual const memory_pd_t *output_pd(int index = 0) const override
     { return index == 0 ? dst_pd() : nullptr; }
+    /* a view is a memory itself, hence has no outputs */
     virtual int n_inputs() const override { return 1; }
-    virtual int n_outputs() const override { return 1; }
+    virtual int n_outputs() const override { return 0; }
 };
 
 struct concat_pd_t: public primitive_desc_t {
@@ -115,7 +116,29 @@ struct concat_pd_t: public primitive_desc_t {
     { return index < n_inputs() ? src_pd(index) : nullptr; }
     virtual const memory_pd_t *output_pd(int index = 0) const override
     { return index == 0 ? dst_pd() : nullptr; }
-    virtual int n_inputs() const override { return concat_dim_; }
+    virtual int n_inputs() const override { return n_; }
+    virtual int n_outputs() const override { return 1; }
+
+    int concat_dim() const { return concat_dim_; }
+protected:
+    int n_, concat_dim_;
+};
+
+/** in-place concat: the inputs live in the output, so the primitive does
+ * nothing on execution and only marks the concatenation as complete */
+struct concat_inplace_pd_t: public primitive_desc_t {
+    concat_inplace_pd_t(engine_t *engine, int n, int concat_dim)
+        : primitive_desc_t(engine, primitive_kind::concat_inplace)
+        , n_(n), concat_dim_(concat_dim) {}
+    virtual ~concat_inplace_pd_t() {}
+
+    virtual const op_desc_t *op_desc() const override { return nullptr; }
+
+    virtual const memory_pd_t *input_pd(int index = 0) const override
+    { return index < n_inputs() ? src_pd(index) : nullptr; }
+    virtual const memory_pd_t *output_pd(int index = 0) const override
+    { return index == 0 ? dst_pd() : nullptr; }
+    virtual int n_inputs() const override { return n_; }
     virtual int n_outputs() const override { return 1; }
 protected:
     int n_, concat_dim_;
@@ -34,11 +34,14 @@ template <primitive_kind_t> struct pkind_trait {}; /* ::desc_type, ::query_d */
 
 template <> struct prec_trait<data_type::f32> { typedef float type; };
 template <> struct prec_trait<data_type::s32> { typedef int type; };
+template <> struct prec_trait<data_type::u8> { typedef uint8_t type; };
 
 template <> struct data_trait<float>
 { static constexpr data_type_t data_type = data_type::f32; };
 template <> struct data_trait<int>
 { static constexpr data_type_t data_type = data_type::s32; };
+template <> struct data_trait<uint8_t>
+{ static constexpr data_type_t data_type = data_type::u8; };
 
 #define PKIND_TRAIT_INST(op) \
 template <> struct pkind_trait<primitive_kind::op> { \
@@ -53,6 +56,7 @@ PKIND_TRAIT_INST(lrn);
 PKIND_TRAIT_INST(batch_normalization);
 PKIND_TRAIT_INST(inner_product);
 PKIND_TRAIT_INST(convolution_relu);
+PKIND_TRAIT_INST(pooling_inner_product);
 #undef PKIND_TRAIT_INST
 
 }
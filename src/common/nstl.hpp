@@ -106,6 +106,9 @@ public:
     const_iterator begin() const { return _impl.begin(); }
     iterator end() { return _impl.end(); }
     const_iterator end() const { return _impl.end(); }
+    iterator find(const Key &k) { return _impl.find(k); }
+    const_iterator find(const Key &k) const { return _impl.find(k); }
+    void erase(iterator pos) { _impl.erase(pos); }
     template <typename input_iterator>
     void clear() { _impl.clear(); }
 };
@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -42,7 +43,8 @@ status_t pooling_desc_init(pooling_desc_t *pool_desc,
 
     if (padding_r == nullptr) padding_r = padding_l;
 
-    pooling_desc_t pd = {};
+    pooling_desc_t pd;
+    memset(&pd, 0, sizeof(pd));
     pd.primitive_kind = primitive_kind::pooling;
     pd.prop_kind = prop_kind;
     pd.alg_kind = alg_kind;
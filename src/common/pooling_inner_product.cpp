@@ -0,0 +1,58 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+using namespace mkldnn::impl;
+using namespace mkldnn::impl::utils;
+using namespace mkldnn::impl::status;
+using namespace mkldnn::impl::prop_kind;
+
+status_t mkldnn_pooling_inner_product_desc_init(
+        pooling_inner_product_desc_t *pool_ip_desc,
+        const pooling_desc_t *pool_desc,
+        const inner_product_desc_t *ip_desc) {
+    bool args_ok = !any_null(pool_ip_desc, pool_desc, ip_desc)
+        && pool_desc->prop_kind == forward_inference
+        && ip_desc->prop_kind == forward_inference;
+    if (!args_ok) return invalid_arguments;
+
+    /* the inner product consumes the pooling result as is or, if the latter
+     * is 1x1, as a 2D tensor */
+    const memory_desc_t &p_dst = pool_desc->dst_desc;
+    const memory_desc_t &ip_src = ip_desc->src_desc;
+    bool consistency = false
+        || (ip_src.ndims == 4
+                && array_cmp(ip_src.dims, p_dst.dims, 4))
+        || (ip_src.ndims == 2
+                && array_cmp(ip_src.dims, p_dst.dims, 2)
+                && p_dst.dims[2] == 1 && p_dst.dims[3] == 1);
+    if (!consistency) return invalid_arguments;
+
+    memset(pool_ip_desc, 0, sizeof(*pool_ip_desc));
+    pool_ip_desc->primitive_kind = primitive_kind::pooling_inner_product;
+    pool_ip_desc->pooling_desc = *pool_desc;
+    pool_ip_desc->inner_product_desc = *ip_desc;
+    return success;
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -0,0 +1,116 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef POOLING_INNER_PRODUCT_PD_HPP
+#define POOLING_INNER_PRODUCT_PD_HPP
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "primitive_desc.hpp"
+#include "memory_pd.hpp"
+
+namespace mkldnn {
+namespace impl {
+
+struct pooling_inner_product_fwd_pd_t: public primitive_desc_t {
+    typedef pooling_inner_product_fwd_pd_t base_class;
+    typedef pooling_inner_product_fwd_pd_t hint_class;
+    static constexpr auto base_pkind = primitive_kind::pooling_inner_product;
+
+    pooling_inner_product_fwd_pd_t(mkldnn::impl::engine_t *engine,
+            const pooling_inner_product_desc_t *adesc,
+            const pooling_inner_product_fwd_pd_t *hint_fwd_pd)
+        : primitive_desc_t(engine, base_pkind)
+        , desc_(*adesc), hint_fwd_pd_(hint_fwd_pd) {}
+    virtual ~pooling_inner_product_fwd_pd_t() {}
+
+    const pooling_inner_product_desc_t *desc() const { return &desc_; }
+    inline const pooling_desc_t *pdesc() const
+    { return &desc_.pooling_desc; }
+    inline const inner_product_desc_t *ipdesc() const
+    { return &desc_.inner_product_desc; }
+    virtual const op_desc_t *op_desc() const override
+    { return reinterpret_cast<const op_desc_t *>(this->desc()); }
+
+    virtual const memory_pd_t *input_pd(int index = 0) const override {
+        switch (index) {
+        case 0: return src_pd();
+        case 1: case 2: return weights_pd(index - 1);
+        default: return nullptr;
+        }
+    }
+    virtual const memory_pd_t *output_pd(int index = 0) const override
+    { return index == 0 ? dst_pd() : nullptr; }
+
+    virtual int n_inputs() const override { return 2 + with_bias(); }
+    virtual int n_outputs() const override { return 1; }
+
+    virtual status_t query(query_t what, int idx, void *result) const override
+    {
+        switch (what) {
+        case query::pooling_inner_product_d:
+            *(const pooling_inner_product_desc_t**)result = desc(); break;
+        default: return primitive_desc_t::query(what, idx, result);
+        }
+        return status::success;
+    }
+
+    /* common pooling-inner product aux functions */
+
+    inline int MB() const { return pdesc()->src_desc.dims[0]; }
+    inline int C() const { return pdesc()->src_desc.dims[1]; }
+    inline int IH() const { return pdesc()->src_desc.dims[2]; }
+    inline int IW() const { return pdesc()->src_desc.dims[3]; }
+    inline int OH() const { return pdesc()->dst_desc.dims[2]; }
+    inline int OW() const { return pdesc()->dst_desc.dims[3]; }
+    inline int KH() const { return pdesc()->kernel[0]; }
+    inline int KW() const { return pdesc()->kernel[1]; }
+
+    inline int KSH() const { return pdesc()->strides[0]; }
+    inline int KSW() const { return pdesc()->strides[1]; }
+
+    inline int padT() const { return pdesc()->padding[0][0]; }
+    inline int padB() const { return pdesc()->padding[1][0]; }
+    inline int padL() const { return pdesc()->padding[0][1]; }
+    inline int padR() const { return pdesc()->padding[1][1]; }
+
+    /** is the pooling an average over the whole image */
+    inline bool is_global_avg() const {
+        return true
+            && pdesc()->alg_kind == alg_kind::pooling_avg
+            && KH() == IH() && KW() == IW() && OH() == 1 && OW() == 1
+            && padT() == 0 && padB() == 0 && padL() == 0 && padR() == 0;
+    }
+
+    inline int OC() const { return ipdesc()->dst_desc.dims[1]; }
+    inline int ip_ndims() const { return ipdesc()->src_desc.ndims; }
+    inline bool with_bias() const
+    { return !memory_desc_wrapper(ipdesc()->bias_desc).is_zero(); }
+
+protected:
+    pooling_inner_product_desc_t desc_;
+    const pooling_inner_product_fwd_pd_t *hint_fwd_pd_;
+
+    virtual status_t init() = 0;
+};
+
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -20,12 +20,34 @@
 #include "primitive_desc.hpp"
 #include "primitive.hpp"
 #include "engine.hpp"
+#include "memory_pd.hpp"
 #include "type_helpers.hpp"
 
 using namespace mkldnn::impl;
 using namespace mkldnn::impl::status;
 using namespace mkldnn::impl::primitive_kind;
 
+namespace mkldnn {
+namespace impl {
+
+bool overlap(const primitive_t *m1, const primitive_t *m2) {
+    const primitive_t *b1 = base_memory_of(m1), *b2 = base_memory_of(m2);
+    if (b1 == b2) return true;
+    if (b1->kind() != memory || b2->kind() != memory) return false;
+
+    void *h1, *h2;
+    if (b1->get_data_handle(&h1) != success || h1 == nullptr
+            || b2->get_data_handle(&h2) != success || h2 == nullptr)
+        return false;
+    const char *d1 = (const char *)h1, *d2 = (const char *)h2;
+    const size_t s1 = static_cast<const memory_pd_t *>(b1->pd())->get_size();
+    const size_t s2 = static_cast<const memory_pd_t *>(b2->pd())->get_size();
+    return d1 < d2 + s2 && d2 < d1 + s1;
+}
+
+}
+}
+
 status_t mkldnn_primitive_desc_destroy(primitive_desc_t *primitive_desc) {
     if (primitive_desc) delete primitive_desc;
     return success;
@@ -81,6 +81,15 @@ struct mkldnn_primitive: public mkldnn::impl::c_compatible {
      */
     virtual void execute(mkldnn::impl::event_t *e) = 0;
 
+    /** executes primitive as execute(e) with the scratch memory @p scratchpad
+     * of pd()->scratchpad_size() bytes, which the caller (usually a stream)
+     * owns for this execution only. The primitives which need the scratch
+     * memory override it, the others ignore @p scratchpad */
+    virtual void execute(mkldnn::impl::event_t *e, char *scratchpad) {
+        UNUSED(scratchpad);
+        execute(e);
+    }
+
     /** returns data handle. Applicable for memory primitives only. */
     virtual mkldnn::impl::status_t get_data_handle(void **handle) const {
         UNUSED(handle);
@@ -107,6 +116,34 @@ private:
     mkldnn_primitive &operator=(mkldnn_primitive &&) = delete;
 };
 
+namespace mkldnn {
+namespace impl {
+
+inline bool is_memory_kind(const primitive_t *p) {
+    return p->kind() == primitive_kind::memory
+        || p->kind() == primitive_kind::view;
+}
+
+/** returns the memory primitive @p at refers to */
+inline const primitive_t *memory_of(const primitive_at_t &at) {
+    return is_memory_kind(at.primitive)
+        ? at.primitive : at.primitive->outputs()[at.output_index];
+}
+
+/** returns the memory which actually holds the data of memory @p m, i.e.
+ * resolves views (and other memories living inside another one) */
+inline const primitive_t *base_memory_of(const primitive_t *m) {
+    while (m->inputs().size() == 1) m = memory_of(m->inputs()[0]);
+    return m;
+}
+
+/** returns true if memories @p m1 and @p m2 may share data, i.e. have the
+ * same base memory or overlapping data handles (see mkldnn_memory_plan()) */
+bool overlap(const primitive_t *m1, const primitive_t *m2);
+
+}
+}
+
 #endif
 
 // vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -51,6 +51,9 @@ status_t primitive_desc_t::query(query_t what, int idx, void *result) const {
         case query::num_of_inputs_s32: *(int*)result = n_inputs(); break;
         case query::num_of_outputs_s32: *(int*)result = n_outputs(); break;
 
+        case query::memory_consumption_s64:
+            *(ptrdiff_t*)result = (ptrdiff_t)scratchpad_size(); break;
+
         default: return unimplemented;
     }
     return success;
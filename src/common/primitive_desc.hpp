@@ -51,6 +51,11 @@ struct mkldnn_primitive_desc: public mkldnn::impl::c_compatible {
     virtual int n_inputs() const { return 0; }
     virtual int n_outputs() const { return 0; }
 
+    /** returns the size of the scratch memory (in bytes) the primitive needs
+     * during execution only. The contents of the scratch memory are not
+     * preserved between executions */
+    virtual size_t scratchpad_size() const { return 0; }
+
     virtual mkldnn::impl::status_t query(mkldnn::impl::query_t what, int idx,
             void *result) const;
 
@@ -0,0 +1,103 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "engine.hpp"
+#include "primitive_desc.hpp"
+#include "primitive_desc_cache.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+
+primitive_desc_cache_t::key_t::key_t(const op_desc_t *op_desc)
+    : size_(types::op_desc_size(op_desc->kind)) {
+    /* the rest of the buffer is zeroed, since a user is only required to
+     * provide the operation descriptor of the actual kind */
+    memset(bytes_, 0, sizeof(bytes_));
+    memcpy(bytes_, op_desc, size_);
+}
+
+bool primitive_desc_cache_t::key_t::operator<(const key_t &rhs) const {
+    return memcmp(bytes_, rhs.bytes_, sizeof(bytes_)) < 0;
+}
+
+primitive_desc_t *primitive_desc_cache_t::get(const op_desc_t *op_desc) {
+    key_t key(op_desc);
+    if (!key.is_valid()) return nullptr;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    it->second.last_use = ++tick_;
+    return it->second.pd->clone();
+}
+
+void primitive_desc_cache_t::put(const op_desc_t *op_desc,
+        const primitive_desc_t *pd) {
+    key_t key(op_desc);
+    if (!key.is_valid()) return;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (capacity_ == 0 || entries_.find(key) != entries_.end()) return;
+
+    primitive_desc_t *pd_copy = pd->clone();
+    if (pd_copy == nullptr) return;
+
+    evict(capacity_ - 1);
+    entry_t entry = { pd_copy, ++tick_ };
+    entries_[key] = entry;
+}
+
+void primitive_desc_cache_t::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    capacity_ = capacity;
+    evict(capacity_);
+}
+
+void primitive_desc_cache_t::get_stats(size_t *hits, size_t *misses) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    *hits = hits_;
+    *misses = misses_;
+}
+
+void primitive_desc_cache_t::evict(size_t n_entries) {
+    /* linear search is fine here: eviction only happens on insertion into
+     * a full cache, which is way cheaper than the creation of the primitive
+     * descriptor that has just happened */
+    while (entries_.size() > n_entries) {
+        auto lru = entries_.begin();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it)
+            if (it->second.last_use < lru->second.last_use) lru = it;
+        delete lru->second.pd;
+        entries_.erase(lru);
+    }
+}
+
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
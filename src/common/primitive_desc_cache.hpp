@@ -0,0 +1,92 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef PRIMITIVE_DESC_CACHE_HPP
+#define PRIMITIVE_DESC_CACHE_HPP
+
+#include <mutex>
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+
+/** least recently used cache of primitive descriptors
+ *
+ * maps an operation descriptor to the primitive descriptor of the first
+ * implementation that accepted it, so that creating the same primitive
+ * descriptor once again costs a copy instead of walking the implementation
+ * list and re-initializing every candidate.
+ *
+ * @note
+ *   only descriptors created without a forward hint are cached, since the
+ *   hint is referenced by the resulting primitive descriptor */
+struct primitive_desc_cache_t: public c_compatible {
+    enum { default_capacity = 256 };
+
+    primitive_desc_cache_t(size_t capacity = default_capacity)
+        : capacity_(capacity), tick_(0), hits_(0), misses_(0) {}
+    ~primitive_desc_cache_t() { evict(0); }
+
+    /** returns a copy of the primitive descriptor cached for @p op_desc or
+     * nullptr if there is no such */
+    primitive_desc_t *get(const op_desc_t *op_desc);
+
+    /** puts a copy of @p pd created for @p op_desc to the cache */
+    void put(const op_desc_t *op_desc, const primitive_desc_t *pd);
+
+    /** sets the maximal number of cached primitive descriptors, 0 disables
+     * the cache */
+    void set_capacity(size_t capacity);
+    size_t capacity() const { return capacity_; }
+
+    void get_stats(size_t *hits, size_t *misses) const;
+
+private:
+    struct key_t {
+        key_t(const op_desc_t *op_desc);
+        bool operator<(const key_t &rhs) const;
+        bool is_valid() const { return size_ != 0; }
+
+        size_t size_;
+        char bytes_[sizeof(op_desc_t)];
+    };
+
+    struct entry_t {
+        primitive_desc_t *pd;
+        size_t last_use;
+    };
+
+    /** evicts the least recently used entries until there are at most
+     * @p n_entries left */
+    void evict(size_t n_entries);
+
+    nstl::map<key_t, entry_t> entries_;
+    size_t capacity_;
+    size_t tick_, hits_, misses_;
+    mutable std::mutex mutex_;
+};
+
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
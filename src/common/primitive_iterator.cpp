@@ -15,12 +15,14 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
 #include "engine.hpp"
 #include "primitive_desc.hpp"
+#include "primitive_desc_cache.hpp"
 #include "type_helpers.hpp"
 
 using namespace mkldnn::impl;
@@ -31,10 +33,13 @@ struct mkldnn_primitive_desc_iterator: public c_compatible {
 
     mkldnn_primitive_desc_iterator(engine_t *engine, const op_desc_t *op_desc,
             const primitive_desc_t *hint_fwd_pd)
-        : idx_(-1), engine_(engine), pd_(nullptr), op_desc_(*op_desc)
-        , hint_fwd_pd_(hint_fwd_pd)
+        : idx_(-1), engine_(engine), pd_(nullptr)
+        , op_desc_(primitive_kind::undefined), hint_fwd_pd_(hint_fwd_pd)
         , impl_list_(engine_->get_implementation_list()), last_idx_(0)
     {
+        /* the user only provides the descriptor of the actual kind, which
+         * may be way smaller than op_desc_t */
+        memcpy(&op_desc_, op_desc, types::op_desc_size(op_desc->kind));
         while (impl_list_[last_idx_] != nullptr) ++last_idx_;
     }
     ~mkldnn_primitive_desc_iterator() { if (pd_) delete pd_; }
@@ -127,11 +132,26 @@ status_t mkldnn_primitive_desc_create(primitive_desc_t **primitive_desc,
         const_c_op_desc_t c_op_desc, engine_t *engine,
         const primitive_desc_t *hint_fwd_pd) {
     const op_desc_t *op_desc = (const op_desc_t *)c_op_desc;
+
+    auto pd_cache = hint_fwd_pd == nullptr
+        ? engine->primitive_desc_cache() : nullptr;
+    if (pd_cache != nullptr) {
+        primitive_desc_t *pd = pd_cache->get(op_desc);
+        if (pd != nullptr) {
+            *primitive_desc = pd;
+            return success;
+        }
+    }
+
     mkldnn_primitive_desc_iterator it(engine, op_desc, hint_fwd_pd);
     ++it;
     if (it == it.end()) return unimplemented;
 
-    return safe_ptr_assign<primitive_desc_t>(*primitive_desc, *it);
+    primitive_desc_t *pd = *it;
+    if (pd != nullptr && pd_cache != nullptr)
+        pd_cache->put(op_desc, pd);
+
+    return safe_ptr_assign<primitive_desc_t>(*primitive_desc, pd);
 }
 
 // vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -15,6 +15,7 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -36,7 +37,8 @@ status_t relu_desc_init(relu_desc_t *relu_desc, prop_kind_t prop_kind,
         && implication(prop_kind == backward_data, diff_data_desc != nullptr);
     if (!args_ok) return invalid_arguments;
 
-    relu_desc_t rd = {};
+    relu_desc_t rd;
+    memset(&rd, 0, sizeof(rd));
     rd.primitive_kind = primitive_kind::relu;
     rd.prop_kind = prop_kind;
 
@@ -15,6 +15,9 @@
 *******************************************************************************/
 
 #include <assert.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -53,7 +56,7 @@ bool stream_t::closed() const { return true; }
 
 bool stream_t::closed(const primitive_vector &prims) const { return true; }
 
-status_t stream_t::wait(primitive_t **error_prim) {
+status_t stream_t::wait(primitive_t **error_prim, bool block) {
     if (!closed()) return invalid_arguments; /* XXX: redundant? */
 
     primitive_t *error_primitive_stub;
@@ -61,11 +64,18 @@ status_t stream_t::wait(primitive_t **error_prim) {
 
     modifiable_ = false;
     state_ = stream_t::waiting;
-    status_t status = wait_impl(error_prim);
-    state_ = stream_t::stopped;
+    status_t status = wait_impl(error_prim, block);
+    if (status != try_again) state_ = stream_t::stopped;
     return status;
 }
 
+status_t stream_t::query(primitive_t **error_prim) {
+    primitive_t *error_primitive_stub;
+    if (error_prim == nullptr) error_prim = &error_primitive_stub;
+
+    return query_impl(error_prim);
+}
+
 status_t stream_t::rerun(primitive_t **error_prim) {
     if (state() != stream_t::stopped) return invalid_arguments;
 
@@ -76,6 +86,263 @@ status_t stream_t::rerun(primitive_t **error_prim) {
     return rerun_impl(error_prim);
 }
 
+namespace {
+bool accesses(const primitive_t *p, const primitive_t *m, bool write) {
+    if (is_memory_kind(p)) return false;
+    if (write) {
+        for (size_t i = 0; i < p->outputs().size(); ++i)
+            if (overlap(p->outputs()[i], m)) return true;
+    } else {
+        for (size_t i = 0; i < p->inputs().size(); ++i)
+            if (overlap(memory_of(p->inputs()[i]), m)) return true;
+    }
+    return false;
+}
+}
+
+namespace {
+/* the submitting thread may be inside a parallel region of the user, where
+ * the nested regions are not active anymore and so run by a single thread */
+int submitter_num_threads() {
+#if defined(_OPENMP)
+    if (omp_get_active_level() >= omp_get_max_active_levels()) return 1;
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+bool submitter_dynamic() {
+#if defined(_OPENMP)
+    return omp_get_dynamic();
+#else
+    return false;
+#endif
+}
+}
+
+bool stream_eager_t::depends(const primitive_t *p, const primitive_t *q) {
+    if (is_memory_kind(p) || is_memory_kind(q)) return false;
+
+    for (size_t i = 0; i < p->inputs().size(); ++i)
+        if (p->inputs()[i].primitive == q) return true;
+
+    for (size_t i = 0; i < q->outputs().size(); ++i) {
+        const primitive_t *m = q->outputs()[i];
+        if (accesses(p, m, false) || accesses(p, m, true)) return true;
+    }
+    for (size_t i = 0; i < q->inputs().size(); ++i) {
+        if (accesses(p, memory_of(q->inputs()[i]), true)) return true;
+    }
+    return false;
+}
+
+status_t stream_eager_t::submit_impl(int begin, int end,
+        primitive_t **error_prim) {
+    UNUSED(error_prim);
+
+    const int n = end - begin;
+    nstl::vector<nstl::vector<int>> deps(n);
+    for (int i = 0; i < n; ++i) {
+        primitive_t *p = stream_[begin + i];
+        for (int j = 0; j < begin + i; ++j)
+            if (depends(p, stream_[j])) deps[i].push_back(j);
+    }
+
+    /* after[i][j] tells whether the i-th primitive (transitively) depends
+     * on the j-th one, j < i. Otherwise the engine may run them at once */
+    nstl::vector<nstl::vector<char>> after(n);
+    for (int i = 0; i < n; ++i) {
+        after[i].resize(i);
+        for (size_t d = 0; d < deps[i].size(); ++d) {
+            const int j = deps[i][d] - begin;
+            if (j < 0) continue;
+            after[i][j] = 1;
+            for (int k = 0; k < j; ++k)
+                if (after[j][k]) after[i][k] = 1;
+        }
+    }
+
+    /* deps_ grows here while the worker may be checking it for errors */
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    /* consecutive primitives of the same engine make a task, the engine
+     * runs each of them as soon as its prerequisites are finished. The
+     * primitives which may run at once get disjoint areas of the arena,
+     * the others share it (first fit) */
+    nstl::vector<task_t> tasks;
+    nstl::vector<size_t> offset(n, 0), size(n, 0);
+    size_t arena_size = 0;
+    int task_begin = 0;
+    for (int i = 0; i < n; ++i) {
+        primitive_t *p = stream_[begin + i];
+        if (tasks.size() == 0
+                || p->engine() != tasks[tasks.size() - 1].prims[0]->engine())
+        {
+            task_t task;
+            task.num_threads = submitter_num_threads();
+            task.dynamic = submitter_dynamic();
+            tasks.push_back(task);
+            task_begin = i;
+        }
+        task_t &task = tasks[tasks.size() - 1];
+
+        size[i] = utils::rnd_up(p->pd()->scratchpad_size(),
+                scratchpad_alignment);
+        for (bool moved = size[i] != 0; moved;) {
+            moved = false;
+            for (int j = task_begin; j < i; ++j) {
+                bool overlap = true
+                    && size[j] != 0 && !after[i][j]
+                    && offset[i] < offset[j] + size[j]
+                    && offset[j] < offset[i] + size[i];
+                if (!overlap) continue;
+                offset[i] = offset[j] + size[j];
+                moved = true;
+            }
+        }
+        arena_size = nstl::max(arena_size, offset[i] + size[i]);
+
+        task.prims.push_back(p);
+        task.events.push_back(&deps_[p]);
+        event_vector prereqs;
+        for (size_t d = 0; d < deps[i].size(); ++d)
+            prereqs.push_back(&deps_[stream_[deps[i][d]]]);
+        task.prereqs.push_back(prereqs);
+        task.scratchpad_offsets.push_back(offset[i]);
+    }
+    if (tasks.size() == 0) return success;
+
+    if (arena_size > scratchpad_size_) {
+        /* queued tasks may still use the current arena */
+        char *arena = (char *)malloc(arena_size, scratchpad_alignment);
+        if (arena == nullptr) return out_of_memory;
+        if (scratchpad_) retired_scratchpads_.push_back(scratchpad_);
+        scratchpad_ = arena;
+        scratchpad_size_ = arena_size;
+    }
+    tasks_.insert(tasks_.end(), tasks.begin(), tasks.end());
+    if (!worker_.joinable())
+        worker_ = std::thread(&stream_eager_t::work, this);
+    task_cv_.notify_one();
+
+    return success;
+}
+
+status_t stream_eager_t::wait_impl(primitive_t **error_prim, bool block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!block && tasks_.size() != 0) return try_again;
+    done_cv_.wait(lock, [&]() { return tasks_.size() == 0; });
+    return check_errors(error_prim);
+}
+
+status_t stream_eager_t::query_impl(primitive_t **error_prim) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.size() != 0) return try_again;
+    return check_errors(error_prim);
+}
+
+status_t stream_eager_t::rerun_impl(primitive_t **error_prim) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_ = success;
+        error_prim_ = nullptr;
+        for (auto it = deps_.begin(); it != deps_.end(); ++it)
+            it->second.reset();
+    }
+    return submit_impl(0, stream_.size(), error_prim);
+}
+
+void stream_eager_t::work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        task_cv_.wait(lock,
+                [&]() { return stop_ || next_task_ < tasks_.size(); });
+        if (next_task_ == tasks_.size()) break; /* stopped */
+
+        /* tasks_ may grow while the task is running, so make a copy. The
+         * arena may grow as well, but the current one stays alive until
+         * tasks_ is done */
+        task_t task = tasks_[next_task_];
+        char *arena = scratchpad_;
+        for (size_t i = 0; i < task.prims.size(); ++i)
+            if (task.prims[i]->pd()->scratchpad_size() != 0)
+                ++scratchpad_uses_;
+        num_threads_ = task.num_threads;
+        lock.unlock();
+
+        /* a new thread starts with the default OpenMP settings, while the
+         * primitives must run with the ones of the user */
+#if defined(_OPENMP)
+        omp_set_dynamic(task.dynamic);
+        omp_set_num_threads(task.num_threads);
+#endif
+
+        /* the primitives get the arena for this execution only */
+        nstl::vector<char *> scratchpads(task.prims.size());
+        for (size_t i = 0; i < task.prims.size(); ++i)
+            scratchpads[i] = task.prims[i]->pd()->scratchpad_size() == 0
+                ? nullptr : arena + task.scratchpad_offsets[i];
+        status_t status = task.prims[0]->engine()->submit(task.prims,
+                task.events, task.prereqs, scratchpads);
+        lock.lock();
+
+        if (status != success && status_ == success) {
+            status_ = status;
+            error_prim_ = task.prims[0];
+        }
+        if (++next_task_ == tasks_.size()) {
+            tasks_.clear();
+            next_task_ = 0;
+            release_scratchpads();
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void stream_eager_t::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    task_cv_.notify_one();
+    if (worker_.joinable()) worker_.join();
+}
+
+void stream_eager_t::release_scratchpads() {
+    for (size_t i = 0; i < retired_scratchpads_.size(); ++i)
+        free(retired_scratchpads_[i]);
+    retired_scratchpads_.clear();
+}
+
+void stream_eager_t::get_scratchpad_stats(size_t *size, size_t *uses) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *size = scratchpad_size_;
+    *uses = scratchpad_uses_;
+}
+
+int stream_eager_t::get_num_threads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_threads_;
+}
+
+status_t stream_eager_t::check_errors(primitive_t **error_prim) {
+    if (status_ != success) {
+        *error_prim = error_prim_;
+        return status_;
+    }
+
+    for (auto it = deps_.begin(); it != deps_.end(); ++it) {
+        /* XXX: topological traverse needed? */
+        if (it->second.get_state() == event_t::error) {
+            *error_prim = (primitive_t *)it->first;
+            return runtime_error;
+        }
+    }
+
+    return success;
+}
+
 /* API */
 
 status_t mkldnn_stream_create(stream_t **stream, stream_kind_t stream_kind) {
@@ -107,9 +374,14 @@ status_t mkldnn_stream_submit(stream_t *stream, size_t n,
 
 status_t mkldnn_stream_wait(stream_t *stream, int block,
         primitive_t **error_primitive) {
-    UNUSED(block);
     if (stream == nullptr) return invalid_arguments;
-    return stream->wait(error_primitive);
+    return stream->wait(error_primitive, block != 0);
+}
+
+status_t mkldnn_stream_query(stream_t *stream,
+        primitive_t **error_primitive) {
+    if (stream == nullptr) return invalid_arguments;
+    return stream->query(error_primitive);
 }
 
 status_t mkldnn_stream_rerun(stream_t *stream, primitive_t **error_primitive) {
@@ -117,6 +389,19 @@ status_t mkldnn_stream_rerun(stream_t *stream, primitive_t **error_primitive) {
     return stream->rerun(error_primitive);
 }
 
+status_t mkldnn_stream_get_scratchpad_stats(stream_t *stream, size_t *size,
+        size_t *uses) {
+    if (utils::any_null(stream, size, uses)) return invalid_arguments;
+    stream->get_scratchpad_stats(size, uses);
+    return success;
+}
+
+status_t mkldnn_stream_get_num_threads(stream_t *stream, int *num_threads) {
+    if (utils::any_null(stream, num_threads)) return invalid_arguments;
+    *num_threads = stream->get_num_threads();
+    return success;
+}
+
 status_t mkldnn_stream_destroy(stream_t *stream) {
     if (stream) delete stream;
     return success;
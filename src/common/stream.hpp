@@ -18,6 +18,10 @@
 #define STREAM_HPP
 
 #include <assert.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "mkldnn.h"
 
 #include "c_types_map.hpp"
@@ -136,11 +140,24 @@ struct mkldnn_stream: public mkldnn::impl::c_compatible {
      *
      * A high level function which is responsible for stream consistency and
      * setting state_ to @c waiting. Implementation specific stuff happens in
-     * wait_impl() */
-    mkldnn::impl::status_t wait(mkldnn::impl::primitive_t **error_prim);
+     * wait_impl()
+     *
+     * If @p block is @c false and the computations are still in progress
+     * returns @c status::try_again leaving the stream in @c waiting state */
+    mkldnn::impl::status_t wait(mkldnn::impl::primitive_t **error_prim,
+            bool block = true);
 
     /** implementation specific wait */
     virtual mkldnn::impl::status_t wait_impl(
+            mkldnn::impl::primitive_t **error_prim, bool block) = 0;
+
+    /** returns @c status::try_again if the computations are still in
+     * progress, otherwise the status of the computations. Does not change
+     * the state of the stream */
+    mkldnn::impl::status_t query(mkldnn::impl::primitive_t **error_prim);
+
+    /** implementation specific query */
+    virtual mkldnn::impl::status_t query_impl(
             mkldnn::impl::primitive_t **error_prim) = 0;
 
     /** re-runs stream
@@ -154,6 +171,14 @@ struct mkldnn_stream: public mkldnn::impl::c_compatible {
     virtual mkldnn::impl::status_t rerun_impl(
             mkldnn::impl::primitive_t **error_prim) = 0;
 
+    /** returns the @p size of the scratchpad arena and the number of
+     * primitive executions that have @p used it */
+    virtual void get_scratchpad_stats(size_t *size, size_t *uses) = 0;
+
+    /** returns the number of OpenMP threads the primitives of the stream
+     * were last run with, 0 if none have run yet */
+    virtual int get_num_threads() = 0;
+
 protected:
     bool modifiable_;
     state_t state_;
@@ -166,97 +191,151 @@ namespace impl {
 
 struct stream_lazy_t;
 
-/** \brief non-lazy stream */
+/** \brief non-lazy stream
+ *
+ * Submitted primitives are executed asynchronously by the worker thread of
+ * the stream: submit() returns immediately, while wait() blocks until the
+ * worker is done.
+ */
 struct stream_eager_t: public stream_t {
     friend stream_lazy_t;
 
-    virtual status_t submit_impl(int begin, int end,
-            primitive_t **error_prim) {
-        for (int p_index = begin; p_index < end; ++p_index) {
-            primitive_t *p = stream_[p_index];
-            const nstl::vector<primitive_at_t> &inputs = p->inputs();
-
-            nstl::vector<event_t *> prereq;
-
-            for (size_t i = 0; i < inputs.size(); ++i) {
-                if (inputs[i].primitive->kind() != primitive_kind::memory) {
-                    for (size_t j = 0; j < stream_.size(); ++j) {
-                        if (stream_[j] == inputs[i].primitive) {
-                            prereq.push_back(&deps_[inputs[i].primitive]);
-                            break;
-                        }
-                    }
-                }
-            }
-
-            status_t status = p->engine()->submit(p, &deps_[p], prereq);
-            if (status != status::success) {
-                *error_prim = p;
-                return status;
-            }
-        }
-
-        return status::success;
+    stream_eager_t()
+        : next_task_(0), stop_(false), status_(status::success)
+        , error_prim_(nullptr), scratchpad_(nullptr), scratchpad_size_(0)
+        , scratchpad_uses_(0), num_threads_(0) {}
+    virtual ~stream_eager_t() {
+        stop();
+        free(scratchpad_);
+        release_scratchpads();
     }
 
-    virtual status_t wait_impl(primitive_t **error_prim) {
-        /* wait until all done */
-        while (1) {
-            bool execution_done = true;
-            for (auto it = deps_.begin(); it != deps_.end(); ++it) {
-                if (!it->second.finished()) execution_done = false;
-            }
-            if (execution_done) break;
-        }
+    virtual status_t submit_impl(int begin, int end,
+            primitive_t **error_prim);
+    virtual status_t wait_impl(primitive_t **error_prim, bool block);
+    virtual status_t query_impl(primitive_t **error_prim);
+    virtual status_t rerun_impl(primitive_t **error_prim);
+    virtual void get_scratchpad_stats(size_t *size, size_t *uses);
+    virtual int get_num_threads();
 
-        /* error handling */
-        for (auto it = deps_.begin(); it != deps_.end(); ++it) {
-            /* XXX: topological traverse needed? */
-            if (it->second.get_state() == event_t::error) {
-                *error_prim = (primitive_t *)it->first;
-                return status::runtime_error;
-            }
-        }
+protected:
+    typedef engine_t::event_vector event_vector;
+
+    /** consecutive primitives of the same engine to be submitted at once,
+     * each of them runs once the primitives it depends on are done */
+    struct task_t {
+        primitive_vector prims;
+        event_vector events;
+        nstl::vector<event_vector> prereqs;
+        /** where the scratchpad of each primitive is in the arena */
+        nstl::vector<size_t> scratchpad_offsets;
+        /** the OpenMP settings of the thread that submitted the task, the
+         * worker thread runs the task with them */
+        int num_threads;
+        bool dynamic;
+    };
 
-        return status::success;
-    }
+    /** returns true if @p p must run after @p q, i.e. @p p takes an output of
+     * @p q or they access the same memory and at least one of them writes it */
+    static bool depends(const primitive_t *p, const primitive_t *q);
 
-    virtual status_t rerun_impl(primitive_t **error_prim) {
-        for (auto it = deps_.begin(); it != deps_.end(); ++it) {
-            it->second.reset();
-        }
-        return submit_impl(0, stream_.size(), error_prim);
-    }
+    /** worker thread body: executes tasks_ in order */
+    void work();
+    /** waits for the submitted tasks and stops the worker thread */
+    void stop();
+    /** returns the status of finished computations, mutex_ must be held */
+    status_t check_errors(primitive_t **error_prim);
+    /** frees the scratchpads retired by growing the arena, no task may be
+     * running */
+    void release_scratchpads();
 
-protected:
     nstl::map<const primitive_t *, event_t> deps_;
+
+    nstl::vector<task_t> tasks_;
+    size_t next_task_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_, done_cv_;
+    std::thread worker_;
+    bool stop_;
+    status_t status_;
+    primitive_t *error_prim_;
+
+    enum { scratchpad_alignment = 64 };
+    /** the arena the scratch memory of the primitives is carved from.
+     * Primitives which may run at once get disjoint areas, a primitive
+     * may reuse the areas of the primitives it depends on */
+    char *scratchpad_;
+    size_t scratchpad_size_;
+    /** the number of executions of primitives that took the arena */
+    size_t scratchpad_uses_;
+    nstl::vector<char *> retired_scratchpads_;
+    /** the number of threads the worker ran the last task with */
+    int num_threads_;
 };
 
 /** \brief lazy stream
+ *
+ * Submitted primitives are executed on wait() only, after the engine has
+ * optimized the whole sequence (see engine_t::optimize()). Primitives the
+ * optimizer has created are owned by the stream.
  *
  * @attention
  *     both wait_impl() and rerun_impl() may return pointer to a primitive
  *     which caused an error. Alas this @p error_prim may point to a
  *     not-user-submitted primitive because of possible fusing. It is
  *     guaranteed that the pointer will be valid till the stream is alive
+ *
+ * @attention
+ *     the contents of memories which are both written and read by the
+ *     primitives of the stream are unspecified after the execution
  */
 struct stream_lazy_t: public stream_t {
-    virtual status_t wait_impl(primitive_t **error_prim) {
-        stream_eager_.stream_ = stream_;
-#if 0
-        for_each (aengine in stream_) {
-            aengine->optimize(stream_eager_.stream_); /* in-place operation */
+    virtual ~stream_lazy_t() {
+        stream_eager_.stop();
+        for (size_t i = 0; i < created_.size(); ++i)
+            delete created_[i];
+    }
+
+    virtual status_t wait_impl(primitive_t **error_prim, bool block) {
+        if (stream_eager_.modifiable_) {
+            primitive_vector prims(stream_);
+            optimize(prims);
+            status_t status = stream_eager_.submit(prims, error_prim);
+            if (status != status::success) return status;
         }
-#endif
-        stream_eager_.submit(stream_eager_.stream_, error_prim);
-        return stream_eager_.wait_impl(error_prim);
+        return stream_eager_.wait(error_prim, block);
+    }
+
+    /** computations of a lazy stream start on wait() only */
+    virtual status_t query_impl(primitive_t **error_prim) {
+        if (stream_eager_.modifiable_) return status::try_again;
+        return stream_eager_.query(error_prim);
     }
 
     virtual status_t rerun_impl(primitive_t **error_prim) {
         return stream_eager_.rerun(error_prim);
     }
 
+    virtual void get_scratchpad_stats(size_t *size, size_t *uses)
+    { stream_eager_.get_scratchpad_stats(size, uses); }
+
+    virtual int get_num_threads() { return stream_eager_.get_num_threads(); }
+
 protected:
+    /** optimizes @p prims in-place if all of them belong to the same engine.
+     * Leaves @p prims untouched if the optimization fails */
+    void optimize(primitive_vector &prims) {
+        if (prims.size() == 0) return;
+        engine_t *engine = prims[0]->engine();
+        for (size_t i = 1; i < prims.size(); ++i)
+            if (prims[i]->engine() != engine) return;
+
+        primitive_vector optimized(prims);
+        if (engine->optimize(optimized, created_) == status::success)
+            prims = optimized;
+    }
+
+    primitive_vector created_;
     stream_eager_t stream_eager_;
 };
 
@@ -18,6 +18,7 @@
 #define TYPE_HELPERS_HPP
 
 #include <assert.h>
+#include <string.h>
 
 #include "mkldnn.h"
 
@@ -38,11 +39,32 @@ status_t safe_ptr_assign(T * &lhs, T* rhs) {
 
 namespace types {
 
+/** returns the size of the operation descriptor of the @p kind, or 0 if
+ * the kind has no operation descriptor */
+inline size_t op_desc_size(primitive_kind_t kind) {
+    using namespace primitive_kind;
+    switch (kind) {
+#   define CASE(op) case op: return sizeof(pkind_trait<op>::desc_type)
+    CASE(convolution);
+    CASE(relu);
+    CASE(pooling);
+    CASE(lrn);
+    CASE(batch_normalization);
+    CASE(inner_product);
+    CASE(convolution_relu);
+    CASE(pooling_inner_product);
+#   undef CASE
+    default: break;
+    }
+    return 0;
+}
+
 inline size_t data_type_size(data_type_t data_type) {
     using namespace data_type;
     switch (data_type) {
     case f32: return sizeof(prec_trait<f32>::type);
     case s32: return sizeof(prec_trait<s32>::type);
+    case u8: return sizeof(prec_trait<u8>::type);
     case data_type::undef:
     default: assert(!"unknown data_type");
     }
@@ -51,8 +73,10 @@ inline size_t data_type_size(data_type_t data_type) {
 
 inline memory_format_t format_normalize(const memory_format_t fmt) {
     using namespace memory_format;
-    if (utils::one_of(fmt, x, nc, nchw, nhwc, nChw8c, oi, oihw, OIhw8i8o,
-                OIhw8o8i, Ohwi8o, goihw, gOIhw8i8o, gOIhw8o8i)) return blocked;
+    if (utils::one_of(fmt, x, nc, nchw, nhwc, nChw8c, nChw16c, oi, oihw,
+                OIhw8i8o, OIhw16i16o, OIhw8o8i, OIhw16o16i, Ohwi8o, Ohwi16o,
+                goihw, gOIhw8i8o, gOIhw16i16o, gOIhw8o8i, gOIhw16o16i))
+        return blocked;
     return fmt;
 }
 
@@ -88,7 +112,8 @@ inline bool operator!=(const memory_desc_t &lhs, const memory_desc_t &rhs) {
 }
 
 inline memory_desc_t zero_md() {
-    memory_desc_t zero({});
+    memory_desc_t zero;
+    memset(&zero, 0, sizeof(zero));
     zero.primitive_kind = primitive_kind::memory;
     return zero;
 }
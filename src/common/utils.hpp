@@ -72,6 +72,11 @@ inline bool any_null(Args... ptrs) { return one_of(nullptr, ptrs...); }
 
 inline bool implication(bool cause, bool effect) { return !cause || effect; }
 
+template <typename T, typename U>
+inline T div_up(const T a, const U b) { return (a + b - 1) / b; }
+template <typename T, typename U>
+inline T rnd_up(const T a, const U b) { return div_up(a, b) * b; }
+
 template<typename T>
 inline void array_copy(T *dst, const T *src, size_t size) {
     for (size_t i = 0; i < size; ++i) dst[i] = src[i];
@@ -23,18 +23,11 @@
 #include "cpu_primitive.hpp"
 #include "event.hpp"
 #include "memory_pd.hpp"
-#include "reorder_pd.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
+#include "cpu_loop_nest.hpp"
 #include "cpu_memory.hpp"
-
-/* FIXME: tentative performance fix
- * The idea is that concat is simply a number of reorders.
- * The problem with this approach is omp parallelization: it is much better to
- * have one omp section with all the reorders, and not one omp section per the
- * reorder. `cpu_simple_concat.hpp addresses this problem, but the solution is
- * too stupid and isolated... */
 #include "cpu_simple_concat.hpp"
 
 namespace mkldnn {
@@ -63,6 +56,9 @@ struct cpu_concat_t: public cpu_primitive_t {
                 dst_pd_ = cpu_memory_t::pd_t(engine, output_d);
             }
 
+            /* the images of the inputs in the output are only described
+             * if the output may be split at the inputs, e.g. the channels
+             * of a blocked output start on block boundaries */
             const int ndims = dst_pd_.desc()->ndims;
             int current_concat_dim_offset = 0;
             for (int i = 0; i < n_; ++i) {
@@ -72,103 +68,161 @@ struct cpu_concat_t: public cpu_primitive_t {
                 dims[concat_dim] = dim;
                 offsets[concat_dim] = current_concat_dim_offset;
 
+                if (!cpu_view_t::pd_t::applicable(&dst_pd_, dims, offsets)) {
+                    src_image_pds_.clear();
+                    break;
+                }
                 cpu_view_t::pd_t v_pd(engine_, &dst_pd_, dims, offsets);
                 src_image_pds_.push_back(*v_pd.dst_pd());
 
                 current_concat_dim_offset += dim;
             }
 
-            use_simple_concat_ =
-                cpu_simple_concat_t<data_type::f32>::applicable(src_pds_,
+            use_simple_concat_ = src_image_pds_.size() != 0
+                && cpu_simple_concat_t<data_type::f32>::applicable(src_pds_,
                         src_image_pds_, concat_dim);
-            if (use_simple_concat_) return;
-
-            for (int i = 0; i < n_; ++i) {
-                auto r_impls = engine_->get_reorder_implementation_list();
-                for (auto r = r_impls; *r; ++r) {
-                    reorder_pd_t *r_pd;
-                    if ((*r)(&r_pd, &src_pds_[i], &src_image_pds_[i], 1.0, 0.0) ==
-                            status::success) {
-                        reorder_pds_.push_back(r_pd);
-                        break;
-                    }
-                }
-            }
-        }
-        pd_t(const pd_t &rhs)
-            : concat_pd_t(rhs), use_simple_concat_(rhs.use_simple_concat_)
-            , src_pds_(rhs.src_pds_), src_image_pds_(rhs.src_image_pds_)
-            , dst_pd_(rhs.dst_pd_)
-        {
-            for (size_t i = 0; i < rhs.reorder_pds_.size(); ++i) {
-                reorder_pds_.push_back(
-                        (const reorder_pd_t *)rhs.reorder_pds_[i]->clone());
-            }
-        }
-
-        virtual ~pd_t() {
-            for (size_t i = 0; i < reorder_pds_.size(); ++i) {
-                delete reorder_pds_[i];
-            }
         }
+        virtual ~pd_t() {}
 
-        virtual pd_t *clone() const override { return nullptr; /* FIXME */ }
-        virtual status_t create_primitive(primitive_t **primitive,
-                const primitive_at_t *inputs, const primitive_t **outputs)
-            const override
-        {
-            nstl::vector<primitive_t *> reorders;
-            if (use_simple_concat_ == false) {
-                reorders.resize(n_);
-                for (int i = 0; i < n_; ++i)
-                    CHECK(reorder_pds_[i]->create_primitive(&reorders[i],
-                                &inputs[i], outputs));
-            }
-
-            primitive_t::input_vector ins(inputs, inputs + n_);
-            primitive_t::output_vector outs(outputs, outputs + 1);
-            return safe_ptr_assign<primitive_t>(*primitive,
-                    new cpu_concat_t(this, ins, outs, reorders));
-        }
+        DECLARE_COMMON_PD_T(cpu_concat_t);
 
         virtual const cpu_memory_t::pd_t *src_pd(int index = 0) const override
         { return index < this->n_ ? &src_pds_[index] : nullptr; }
         virtual const cpu_memory_t::pd_t *dst_pd(int index = 0) const override
         { return index == 0 ? &dst_pd_ : nullptr; }
 
-        bool use_simple_concat_; /* FIXME: improve */
+        /** returns true if the image of input @p i in the output has exactly
+         * the same layout as the input itself, i.e. the input may live
+         * directly in the output */
+        bool src_image_is_dense(int i) const {
+            if (src_image_pds_.size() == 0) return false;
+            const memory_desc_t &src_d = *src_pds_[i].desc();
+            const memory_desc_t &image_d = *src_image_pds_[i].desc();
+            if (src_d.format == memory_format::any
+                    || src_d.ndims != image_d.ndims
+                    || src_d.data_type != image_d.data_type
+                    || !utils::array_cmp(src_d.dims, image_d.dims,
+                        src_d.ndims))
+                return false;
+
+            blocking_desc_t blk = image_d.layout_desc.blocking;
+            const blocking_desc_t &src_blk = src_d.layout_desc.blocking;
+            blk.offset_padding = src_blk.offset_padding;
+            for (int d = 0; d < src_d.ndims; ++d) {
+                /* the stride of a dimension of size 1 does not matter */
+                if (src_d.dims[d] == 1)
+                    blk.strides[0][d] = src_blk.strides[0][d];
+            }
+            return types::blocking_desc_is_equal(blk, src_blk, src_d.ndims);
+        }
+
+        /** returns the offset (in bytes) from the data of the output to the
+         * data of input @p i living in the output, see src_image_is_dense() */
+        size_t src_image_offset(int i) const {
+            const memory_desc_t &src_d = *src_pds_[i].desc();
+            const memory_desc_t &image_d = *src_image_pds_[i].desc();
+            return (image_d.layout_desc.blocking.offset_padding
+                    - src_d.layout_desc.blocking.offset_padding)
+                * types::data_type_size(image_d.data_type);
+        }
+
+        bool use_simple_concat_;
         nstl::vector<cpu_memory_t::pd_t> src_pds_;
         nstl::vector<cpu_memory_t::pd_t> src_image_pds_;
-        nstl::vector<const reorder_pd_t *> reorder_pds_;
         cpu_memory_t::pd_t dst_pd_;
     };
 
     cpu_concat_t(const pd_t *conf, const input_vector &inputs,
-            const output_vector &outputs,
-            const nstl::vector<primitive_t *> &reorders)
-        : cpu_primitive_t(&conf_, inputs, outputs)
-        , conf_(*conf), reorders_(reorders) {}
-    virtual ~cpu_concat_t() {
-        for (size_t i = 0; i < reorders_.size(); ++i)
-            delete reorders_[i];
+            const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*conf)
+    {
+        if (conf_.use_simple_concat_) return;
+
+        /* an input and its image in the output are walked together */
+        const int concat_dim = conf_.concat_dim();
+        const memory_desc_t *mds[2] = { conf_.dst_pd()->desc(), nullptr };
+        dims_t starts[2] = {};
+        for (int a = 0; a < conf_.n_inputs(); ++a) {
+            mds[1] = conf_.src_pd(a)->desc();
+            first_nest_.push_back((int)nests_.size());
+            loop_nest_t::append(nests_, 2, mds, mds[1]->dims, starts);
+            starts[0][concat_dim] += mds[1]->dims[concat_dim];
+            while (nest_input_.size() < nests_.size())
+                nest_input_.push_back(a);
+        }
+        first_nest_.push_back((int)nests_.size());
     }
+    virtual ~cpu_concat_t() {}
 
     virtual void execute(event_t *e) {
         if (conf_.use_simple_concat_) {
             cpu_simple_concat_t<data_type::f32>::execute(conf_.src_pds_,
                     conf_.src_image_pds_, this);
         } else {
-            for (size_t i = 0; i < reorders_.size(); ++i) {
-                event_t ei;
-                reorders_[i]->execute(&ei);
-            }
+            execute_generic();
         }
         e->set_state(event_t::ready);
     }
 
 private:
+    typedef prec_trait<data_type::f32>::type data_t;
+
+    /* inputs of any layouts are copied in a single parallel region: the
+     * elements of all the inputs together are split evenly among the
+     * threads, an input being walked along with its image in the output by
+     * loop nests whose rows run over the innermost dense blocks */
+    void execute_generic() {
+        const int n = conf_.n_inputs();
+        auto output = reinterpret_cast<data_t *>(this->memory());
+
+        nstl::vector<const data_t *> inputs(n);
+        nstl::vector<const loop_nest_t *> nests;
+        size_t nelems = 0;
+        for (int a = 0; a < n; ++a) {
+            inputs[a] = reinterpret_cast<const data_t *>(
+                    this->input_memory(a));
+
+            /* an input that lives in the output is already in place */
+            const bool in_place = conf_.src_image_is_dense(a)
+                && this->input_memory(a)
+                == this->memory() + conf_.src_image_offset(a);
+            if (in_place) continue;
+            for (int i = first_nest_[a]; i < first_nest_[a + 1]; ++i) {
+                nests.push_back(&nests_[i]);
+                nelems += nests_[i].nelems();
+            }
+        }
+
+        auto copy = [&](const loop_nest_t &nest, const ptrdiff_t *off,
+                int k, int len) {
+            const int a = nest_input_[&nest - &nests_[0]];
+            const ptrdiff_t os = nest.row_stride(0), is = nest.row_stride(1);
+            data_t *o = &output[off[0] + k * os];
+            const data_t *i = &inputs[a][off[1] + k * is];
+            if (os == 1 && is == 1) {
+                for (int e = 0; e < len; ++e) o[e] = i[e];
+            } else {
+                for (int e = 0; e < len; ++e) o[e * os] = i[e * is];
+            }
+        };
+
+        /* about a thousand chunks to balance among the threads */
+        const size_t step = 32;
+        const size_t chunk = step * nstl::max<size_t>(1,
+                nelems / (step * 1024));
+        const size_t n_chunks = utils::div_up(nelems, chunk);
+
+#       pragma omp parallel for schedule(static)
+        for (size_t c = 0; c < n_chunks; ++c)
+            for_rows(nests, c * chunk, nstl::min(nelems, (c + 1) * chunk),
+                    copy);
+    }
+
     pd_t conf_;
-    nstl::vector<primitive_t *> reorders_;
+    /* the nests of input a are [first_nest_[a], first_nest_[a + 1]) */
+    nstl::vector<loop_nest_t> nests_;
+    nstl::vector<int> first_nest_;
+    nstl::vector<int> nest_input_;
 };
 
 }
@@ -0,0 +1,134 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_CONCAT_INPLACE_HPP
+#define CPU_CONCAT_INPLACE_HPP
+
+#include <assert.h>
+
+#include "c_types_map.hpp"
+#include "cpu_primitive.hpp"
+#include "event.hpp"
+#include "memory_pd.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+#include "cpu_memory.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl;
+using namespace mkldnn::impl::status;
+
+/** concatenation with the inputs living in the output: input @p i is the
+ * view of the output at src_pd(i), the producers of the inputs write
+ * directly to the output and the primitive itself does nothing */
+struct cpu_concat_inplace_t: public cpu_primitive_t {
+    struct pd_t: public concat_inplace_pd_t {
+        pd_t(engine_t *engine, const cpu_memory_t::pd_t *output_pd, int n,
+                int concat_dim)
+            : concat_inplace_pd_t(engine, n, concat_dim), dst_pd_(*output_pd)
+        {}
+        virtual ~pd_t() {}
+
+        static status_t create(concat_inplace_pd_t **concat_inplace_pd,
+                const cpu_memory_t::pd_t *output_pd, int n, int concat_dim,
+                const int *sizes) {
+            auto _pd = new pd_t(output_pd->engine(), output_pd, n,
+                    concat_dim);
+            if (_pd == nullptr) return out_of_memory;
+            status_t status = _pd->init(sizes);
+            if (status != success) { delete _pd; return status; }
+            return safe_ptr_assign<concat_inplace_pd_t>(*concat_inplace_pd,
+                    _pd);
+        }
+
+        virtual pd_t *clone() const override { return new pd_t(*this); }
+        virtual status_t create_primitive(primitive_t **primitive,
+                const primitive_at_t *inputs, const primitive_t **outputs)
+            const override
+        {
+            /* the inputs must be the images of the output */
+            const primitive_t *base = base_memory_of(outputs[0]);
+            for (int i = 0; i < n_; ++i) {
+                const primitive_t *m = memory_of(inputs[i]);
+                if (base_memory_of(m) != base
+                        || memory_desc_wrapper(src_pds_[i].desc())
+                        != *m->pd()->output_pd()->desc())
+                    return invalid_arguments;
+            }
+
+            primitive_t::input_vector ins(inputs, inputs + n_);
+            primitive_t::output_vector outs(outputs, outputs + 1);
+            return safe_ptr_assign<primitive_t>(*primitive,
+                    new cpu_concat_inplace_t(this, ins, outs));
+        }
+
+        virtual const cpu_memory_t::pd_t *src_pd(int index = 0) const override
+        { return index < this->n_ ? &src_pds_[index] : nullptr; }
+        virtual const cpu_memory_t::pd_t *dst_pd(int index = 0) const override
+        { return index == 0 ? &dst_pd_ : nullptr; }
+
+        nstl::vector<cpu_memory_t::pd_t> src_pds_;
+        cpu_memory_t::pd_t dst_pd_;
+
+    protected:
+        status_t init(const int *sizes) {
+            const memory_desc_t &dst_d = *dst_pd_.desc();
+            const int ndims = dst_d.ndims;
+
+            int current_concat_dim_offset = 0;
+            for (int i = 0; i < n_; ++i) {
+                dims_t dims, offsets = {};
+                utils::array_copy(dims, dst_d.dims, ndims);
+                dims[concat_dim_] = sizes[i];
+                offsets[concat_dim_] = current_concat_dim_offset;
+
+                if (sizes[i] <= 0 || !cpu_view_t::pd_t::applicable(&dst_pd_,
+                            dims, offsets))
+                    return unimplemented;
+
+                cpu_view_t::pd_t v_pd(engine_, &dst_pd_, dims, offsets);
+                src_pds_.push_back(*v_pd.dst_pd());
+
+                current_concat_dim_offset += sizes[i];
+            }
+
+            return current_concat_dim_offset == dst_d.dims[concat_dim_]
+                ? success : invalid_arguments;
+        }
+    };
+
+    cpu_concat_inplace_t(const pd_t *conf, const input_vector &inputs,
+            const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*conf) {}
+    virtual ~cpu_concat_inplace_t() {}
+
+    virtual void execute(event_t *e) { e->set_state(event_t::ready); }
+
+private:
+    pd_t conf_;
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -15,19 +15,31 @@
 *******************************************************************************/
 
 #include <assert.h>
+#include <condition_variable>
+#include <mutex>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 #include "cpu_engine.hpp"
 #include "cpu_memory.hpp"
 #include "type_helpers.hpp"
 
 #include "cpu_concat.hpp"
+#include "cpu_concat_inplace.hpp"
 #include "cpu_sum.hpp"
 
+#include "cpu/jit_avx512_common_convolution.hpp"
+#include "cpu/jit_avx2_1x1_convolution.hpp"
 #include "cpu/jit_avx2_convolution.hpp"
+#include "cpu/jit_sse42_convolution.hpp"
+#include "cpu/winograd_convolution.hpp"
 #include "cpu/ref_convolution.hpp"
 #include "cpu/jit_avx2_relu.hpp"
+#include "cpu/jit_sse42_relu.hpp"
 #include "cpu/ref_relu.hpp"
 #include "cpu/jit_avx2_pooling.hpp"
+#include "cpu/jit_sse42_pooling.hpp"
 #include "cpu/ref_pooling.hpp"
 #include "cpu/jit_avx2_lrn.hpp"
 #include "cpu/ref_lrn.hpp"
@@ -55,7 +67,8 @@ status_t cpu_engine_t::view_primitive_desc_create(view_pd_t **view_pd,
             const dims_t offsets) {
     assert(memory_pd->engine() == this);
     auto mpd = (const cpu_memory_t::pd_t *)memory_pd;
-    /* FIXME: what if failed? */
+    if (!cpu_view_t::pd_t::applicable(mpd, dims, offsets))
+        return unimplemented;
     return safe_ptr_assign<view_pd_t>(*view_pd,
             new cpu_view_t::pd_t(this, mpd, dims, offsets));
 }
@@ -69,6 +82,15 @@ status_t cpu_engine_t::concat_primitive_desc_create(concat_pd_t **concat_pd,
             new cpu_concat_t::pd_t(this, output_d, n, concat_dim, i_pds));
 }
 
+status_t cpu_engine_t::concat_inplace_primitive_desc_create(
+        concat_inplace_pd_t **concat_inplace_pd, const memory_pd_t *output_pd,
+        int n, int concat_dim, const int *sizes) {
+    assert(output_pd->engine() == this);
+    auto o_pd = (const cpu_memory_t::pd_t *)output_pd;
+    return cpu_concat_inplace_t::pd_t::create(concat_inplace_pd, o_pd, n,
+            concat_dim, sizes);
+}
+
 status_t cpu_engine_t::sum_primitive_desc_create(sum_pd_t **sum_pd,
         const memory_desc_t *output_d, int n, double* scale,
         const memory_pd_t **input_pds) {
@@ -100,29 +122,52 @@ static const rpd_create_f cpu_reorder_impl_list[] = {
     simple_reorder_t<f32, OIhw8i8o, f32, OIhw8o8i, fmt_order::reverse>::pd_t::create,
     simple_reorder_t<f32, gOIhw8i8o, f32, gOIhw8o8i, fmt_order::keep>::pd_t::create,
     simple_reorder_t<f32, gOIhw8i8o, f32, gOIhw8o8i, fmt_order::reverse>::pd_t::create,
+    simple_reorder_t<f32, nchw, f32, nChw16c, fmt_order::keep>::pd_t::create,
+    simple_reorder_t<f32, nchw, f32, nChw16c, fmt_order::reverse>::pd_t::create,
+    simple_reorder_t<f32, oihw, f32, OIhw16i16o, fmt_order::keep>::pd_t::create,
+    simple_reorder_t<f32, oihw, f32, OIhw16i16o, fmt_order::reverse>::pd_t::create,
+    simple_reorder_t<f32, goihw, f32, gOIhw16i16o, fmt_order::keep>::pd_t::create,
+    simple_reorder_t<f32, goihw, f32, gOIhw16i16o, fmt_order::reverse>::pd_t::create,
+    simple_reorder_t<f32, OIhw16i16o, f32, OIhw16o16i, fmt_order::keep>::pd_t::create,
+    simple_reorder_t<f32, OIhw16i16o, f32, OIhw16o16i, fmt_order::reverse>::pd_t::create,
+    simple_reorder_t<f32, gOIhw16i16o, f32, gOIhw16o16i, fmt_order::keep>::pd_t::create,
+    simple_reorder_t<f32, gOIhw16i16o, f32, gOIhw16o16i, fmt_order::reverse>::pd_t::create,
     simple_reorder_t<f32, any, f32, any, fmt_order::any, spec::reference>::pd_t::create,
     nullptr,
 };
 #define INSTANCE(inst) &primitive_desc_t::create<inst::pd_t>
 static const pd_create_f cpu_impl_list[] = {
     /* conv */
+    INSTANCE(winograd_convolution_fwd_t),
+    INSTANCE(winograd_convolution_bwd_data_t),
+    INSTANCE(jit_avx512_common_convolution_fwd_t),
+    INSTANCE(jit_avx512_common_convolution_bwd_data_t),
+    INSTANCE(jit_avx512_common_convolution_bwd_weights_t),
+    INSTANCE(jit_avx2_1x1_convolution_fwd_t),
+    INSTANCE(jit_avx2_1x1_convolution_bwd_data_t),
+    INSTANCE(jit_avx2_1x1_convolution_bwd_weights_t),
     INSTANCE(jit_avx2_convolution_fwd_t),
     INSTANCE(jit_avx2_convolution_bwd_data_t),
     INSTANCE(jit_avx2_convolution_bwd_weights_t),
+    INSTANCE(jit_sse42_convolution_fwd_t),
     INSTANCE(ref_convolution_fwd_t<data_type::f32>),
     INSTANCE(ref_convolution_bwd_data_t<data_type::f32>),
     INSTANCE(ref_convolution_bwd_weights_t<data_type::f32>),
     /* relu */
     INSTANCE(jit_avx2_relu_fwd_t),
+    INSTANCE(jit_sse42_relu_fwd_t),
     INSTANCE(ref_relu_fwd_t<data_type::f32>),
     INSTANCE(ref_relu_bwd_t<data_type::f32>),
     /* pool */
     INSTANCE(jit_avx2_pooling_fwd_t),
+    INSTANCE(jit_sse42_pooling_fwd_t),
     INSTANCE(ref_pooling_fwd_t<data_type::f32>),
+    INSTANCE(jit_avx2_pooling_bwd_t),
     INSTANCE(ref_pooling_bwd_t<data_type::f32>),
     /* lrn */
     INSTANCE(jit_avx2_lrn_fwd_t),
     INSTANCE(ref_lrn_fwd_t<data_type::f32>),
+    INSTANCE(jit_avx2_lrn_bwd_t),
     INSTANCE(ref_lrn_bwd_t<data_type::f32>),
     /* batch normalization */
     INSTANCE(jit_avx2_batch_normalization_fwd_t),
@@ -134,8 +179,14 @@ static const pd_create_f cpu_impl_list[] = {
     INSTANCE(ref_inner_product_bwd_data_t<data_type::f32>),
     INSTANCE(ref_inner_product_bwd_weights_t<data_type::f32>),
     /* conv_relu */
+    INSTANCE(jit_avx512_common_convolution_relu_t),
+    INSTANCE(jit_avx2_1x1_convolution_relu_t),
     INSTANCE(jit_avx2_convolution_relu_t),
+    INSTANCE(jit_sse42_convolution_relu_t),
     INSTANCE(ref_convolution_relu_t<data_type::f32>),
+    /* pool_ip */
+    INSTANCE(gemm_pooling_inner_product_fwd_t<data_type::f32>),
+    INSTANCE(ref_pooling_inner_product_fwd_t<data_type::f32>),
     nullptr,
 };
 #undef INSTANCE
@@ -151,9 +202,129 @@ const pd_create_f* cpu_engine_t::get_implementation_list() const {
 
 cpu_engine_factory_t engine_factory;
 
+namespace {
+#if defined(_OPENMP)
+/* the batch submit runs primitives in teams of threads, each primitive
+ * opening its parallel regions inside the region of its team. The number of
+ * active levels is a process-wide setting, hence it is raised only while
+ * some team region runs, and the value the user had is restored once the
+ * last of the concurrent team regions is done */
+struct nested_teams_guard_t {
+    nested_teams_guard_t() {
+        std::lock_guard<std::mutex> guard(mutex());
+        if (users()++ == 0) {
+            saved_levels() = omp_get_max_active_levels();
+            if (saved_levels() < 2) omp_set_max_active_levels(2);
+        }
+    }
+    ~nested_teams_guard_t() {
+        std::lock_guard<std::mutex> guard(mutex());
+        if (--users() == 0 && saved_levels() < 2)
+            omp_set_max_active_levels(saved_levels());
+    }
+
+private:
+    static std::mutex &mutex() { static std::mutex m; return m; }
+    static int &users() { static int u = 0; return u; }
+    static int &saved_levels() { static int l = 1; return l; }
+};
+#endif
+}
+
+cpu_engine_t::cpu_engine_t(): engine_t(engine_kind::cpu) {}
+
 status_t cpu_engine_t::submit(primitive_t *p, event_t *e,
-        event_vector &prerequisites) {
-    p->execute(e);
+        event_vector &prerequisites, char *scratchpad) {
+    for (size_t i = 0; i < prerequisites.size(); ++i) {
+        if (utils::one_of(prerequisites[i]->get_state(), event_t::error,
+                    event_t::aborted)) {
+            e->set_state(event_t::aborted);
+            return success;
+        }
+    }
+    if (scratchpad != nullptr) p->execute(e, scratchpad);
+    else p->execute(e);
+
+    /* not every primitive writes the padding of the blocked formats, while
+     * the memory may have held anything before (e.g. a slab shared by the
+     * memory planner), hence the padding is zeroed after each producer. The
+     * outputs are cpu memories or slices of them, zero_pad() is a no-op for
+     * the rest */
+    if (static_cast<const cpu_primitive_t *>(p)->writes_padding())
+        return success;
+    for (size_t i = 0; i < p->outputs().size(); ++i) {
+        const primitive_t *o = p->outputs()[i];
+        if (o != p) static_cast<const cpu_primitive_t *>(o)->zero_pad();
+    }
+    return success;
+}
+
+status_t cpu_engine_t::submit(const primitive_vector &prims,
+        event_vector &events, nstl::vector<event_vector> &prerequisites,
+        const nstl::vector<char *> &scratchpads) {
+    const int n = (int)prims.size();
+#if defined(_OPENMP)
+    const int nthr = omp_get_max_threads();
+    if (n > 1 && nthr > 1) {
+        /* split the threads into teams, each team takes the first primitive
+         * whose prerequisites are finished, so that a long primitive holds
+         * back only the primitives that depend on it. The team size only
+         * goes to the data environment of the team's own task, which is
+         * where the parallel regions of its primitives take their size
+         * from */
+        const int nteams = nstl::min(n, nthr);
+
+        /* a primitive sets its event before its outputs get zero padded,
+         * hence a primitive waits for its prerequisites in the batch to be
+         * done with submit(). The other prerequisites are finished already */
+        nstl::vector<nstl::vector<int>> waits_for(n);
+        for (int i = 0; i < n; ++i)
+        for (size_t d = 0; d < prerequisites[i].size(); ++d)
+        for (int j = 0; j < i; ++j)
+            if (prerequisites[i][d] == events[j]) waits_for[i].push_back(j);
+
+        nstl::vector<char> taken(n, 0), done(n, 0);
+        int n_taken = 0;
+        auto ready = [&](int i) {
+            for (size_t d = 0; d < waits_for[i].size(); ++d)
+                if (!done[waits_for[i][d]]) return false;
+            return true;
+        };
+        std::mutex mutex;
+        std::condition_variable finished_cv;
+
+        nested_teams_guard_t nested_teams;
+#       pragma omp parallel num_threads(nteams)
+        {
+            const int team = omp_get_thread_num();
+            omp_set_num_threads(nthr / nteams + (team < nthr % nteams));
+
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                int i = -1;
+                finished_cv.wait(lock, [&]() {
+                    if (n_taken == n) return true;
+                    for (i = 0; i < n; ++i)
+                        if (!taken[i] && ready(i))
+                            return true;
+                    return false;
+                });
+                if (n_taken == n) break;
+                taken[i] = 1;
+                ++n_taken;
+                lock.unlock();
+                submit(prims[i], events[i], prerequisites[i],
+                        scratchpads[i]);
+                lock.lock();
+                done[i] = 1;
+                finished_cv.notify_all();
+            }
+        }
+        return success;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        submit(prims[i], events[i], prerequisites[i], scratchpads[i]);
     return success;
 }
 
@@ -23,6 +23,7 @@
 
 #include "c_types_map.hpp"
 #include "../common/engine.hpp"
+#include "../common/primitive_desc_cache.hpp"
 
 namespace mkldnn {
 namespace impl {
@@ -30,10 +31,13 @@ namespace cpu {
 
 class cpu_engine_t: public engine_t {
 public:
-    cpu_engine_t(): engine_t(engine_kind::cpu) {}
+    cpu_engine_t();
 
     virtual status_t submit(primitive_t *p, event_t *e,
-            event_vector &prerequisites);
+            event_vector &prerequisites, char *scratchpad);
+    virtual status_t submit(const primitive_vector &prims,
+            event_vector &events, nstl::vector<event_vector> &prerequisites,
+            const nstl::vector<char *> &scratchpads);
 
     /* implementation part */
 
@@ -45,6 +49,10 @@ public:
     virtual status_t concat_primitive_desc_create(concat_pd_t **concat_pd,
             const memory_desc_t *output_d, int n, int concat_dim,
             const memory_pd_t **input_pds);
+    virtual status_t concat_inplace_primitive_desc_create(
+            concat_inplace_pd_t **concat_inplace_pd,
+            const memory_pd_t *output_pd, int n, int concat_dim,
+            const int *sizes);
     virtual status_t sum_primitive_desc_create(sum_pd_t **sum_pd,
             const memory_desc_t *output_d, int n, double* scale,
             const memory_pd_t **input_pds);
@@ -52,6 +60,17 @@ public:
     virtual const reorder_primitive_desc_create_f*
         get_reorder_implementation_list() const;
     virtual const primitive_desc_create_f* get_implementation_list() const;
+
+    virtual primitive_desc_cache_t *primitive_desc_cache()
+    { return &pd_cache_; }
+
+    virtual status_t optimize(primitive_vector &prims,
+            primitive_vector &created);
+    virtual status_t plan_memory(const primitive_vector &prims,
+            size_t *slab_size, char *slab);
+
+private:
+    primitive_desc_cache_t pd_cache_;
 };
 
 class cpu_engine_factory_t: public engine_factory_t {
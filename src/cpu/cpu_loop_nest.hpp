@@ -0,0 +1,293 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_LOOP_NEST_HPP
+#define CPU_LOOP_NEST_HPP
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "c_types_map.hpp"
+#include "memory_desc_wrapper.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/** a nest of loops with constant strides which walks the same box of
+ * elements in several memories at once, e.g. an input of a concat and its
+ * image in the output. The loops go in the order of the strides of the
+ * first memory and the loops which are dense in all the memories are merged,
+ * so that the innermost loop (a row) runs over the innermost dense block,
+ * unless the block is too short to pay off */
+struct loop_nest_t {
+    /** appends to @p nests the nests walking the box of @p dims, which starts
+     * at @p starts[m] in memory @p mds[m] for m = 0 .. @p n - 1, or at the
+     * origin of all the memories if @p starts is null. The stride along a
+     * blocked dimension is constant within a block only, hence the dimension
+     * is cut at the block boundaries unless the blocks of all the memories
+     * line up, and a box may take several nests */
+    static void append(nstl::vector<loop_nest_t> &nests, int n,
+            const memory_desc_t *const *mds, const dims_t dims,
+            const dims_t *starts) {
+        const int ndims = mds[0]->ndims;
+        for (int d = 0; d < ndims; ++d)
+            if (dims[d] == 0) return;
+
+        nstl::vector<piece_t> pieces[TENSOR_MAX_DIMS];
+        for (int d = 0; d < ndims; ++d)
+            cut(pieces[d], n, mds, dims[d], starts, d);
+
+        /* a nest per combination of the pieces of the dimensions */
+        int which[TENSOR_MAX_DIMS] = {};
+        for (;;) {
+            loop_nest_t nest;
+            nest.init(n, mds, pieces, which, starts);
+            nests.push_back(nest);
+
+            int d = ndims - 1;
+            for (; d >= 0; --d) {
+                if (++which[d] < (int)pieces[d].size()) break;
+                which[d] = 0;
+            }
+            if (d < 0) break;
+        }
+    }
+
+    size_t nelems() const { return nelems_; }
+    ptrdiff_t row_stride(int m) const { return stride(n_loops_ - 1, m); }
+
+    /** calls @p f(off, k, len) for the elements [@p start, @p end) of the
+     * nest, a part of a row at a time: @p off[m] is the offset of the row
+     * in memory m, and the part is the elements [k, k + len) of the row */
+    template <typename F>
+    void for_rows(size_t start, size_t end, F f) const {
+        const int inner = n_loops_ - 1;
+        const size_t len = (size_t)counts_[inner];
+        size_t row = start / len, k = start % len;
+
+        int idx[2 * TENSOR_MAX_DIMS];
+        nstl::vector<ptrdiff_t> off(base_);
+        size_t rem = row;
+        for (int l = inner - 1; l >= 0; --l) {
+            idx[l] = (int)(rem % counts_[l]);
+            rem /= counts_[l];
+            for (int m = 0; m < n_; ++m) off[m] += idx[l] * stride(l, m);
+        }
+
+        while (start < end) {
+            const size_t part = nstl::min(len - k, end - start);
+            f((const ptrdiff_t *)&off[0], (int)k, (int)part);
+            start += part;
+            k = 0;
+
+            for (int l = inner - 1; l >= 0; --l) {
+                for (int m = 0; m < n_; ++m) off[m] += stride(l, m);
+                if (++idx[l] < counts_[l]) break;
+                for (int m = 0; m < n_; ++m)
+                    off[m] -= counts_[l] * stride(l, m);
+                idx[l] = 0;
+            }
+        }
+    }
+
+private:
+    enum { min_row_len = 16 };
+
+    /** a part of a dimension, [start, start + count), which lies within a
+     * block of every blocked memory if block == 1, or is made of whole
+     * blocks of size @p block lined up in all the blocked memories */
+    struct piece_t { int start, count, block; };
+
+    int n_, n_loops_;
+    size_t nelems_;
+    int counts_[2 * TENSOR_MAX_DIMS];
+    nstl::vector<ptrdiff_t> base_; /* [memory] */
+    nstl::vector<ptrdiff_t> strides_; /* [loop][memory] */
+
+    ptrdiff_t stride(int l, int m) const { return strides_[l * n_ + m]; }
+    ptrdiff_t &stride(int l, int m) { return strides_[l * n_ + m]; }
+
+    void swap_loops(int l0, int l1) {
+        const int c = counts_[l0];
+        counts_[l0] = counts_[l1];
+        counts_[l1] = c;
+        for (int m = 0; m < n_; ++m) {
+            const ptrdiff_t s = stride(l0, m);
+            stride(l0, m) = stride(l1, m);
+            stride(l1, m) = s;
+        }
+    }
+
+    static int block_of(const memory_desc_t *md, int d)
+    { return md->layout_desc.blocking.block_dims[d]; }
+    static int start_of(const memory_desc_t *md, const dims_t *starts,
+            int m, int d) {
+        return (starts == nullptr ? 0 : starts[m][d])
+            + md->layout_desc.blocking.offset_padding_to_data[d];
+    }
+
+    static void cut(nstl::vector<piece_t> &pieces, int n,
+            const memory_desc_t *const *mds, int dim, const dims_t *starts,
+            int d) {
+        int block = 1;
+        for (int m = 0; m < n; ++m)
+            block = nstl::max(block, block_of(mds[m], d));
+        if (block == 1) {
+            pieces.push_back({0, dim, 1});
+            return;
+        }
+
+        bool aligned = true;
+        int head = -1;
+        for (int m = 0; m < n; ++m) {
+            const int b = block_of(mds[m], d);
+            if (b == 1) continue;
+            const int h = (b - start_of(mds[m], starts, m, d) % b) % b;
+            aligned = aligned && b == block && utils::one_of(head, -1, h);
+            head = h;
+        }
+
+        if (aligned) {
+            head = nstl::min(head, dim);
+            const int body = (dim - head) / block * block;
+            if (head > 0) pieces.push_back({0, head, 1});
+            if (body > 0) pieces.push_back({head, body, block});
+            if (head + body < dim)
+                pieces.push_back({head + body, dim - head - body, 1});
+            return;
+        }
+
+        /* the blocks do not line up: a piece per run between the block
+         * boundaries of all the memories */
+        for (int x = 0; x < dim;) {
+            int count = dim - x;
+            for (int m = 0; m < n; ++m) {
+                const int b = block_of(mds[m], d);
+                if (b == 1) continue;
+                const int p = start_of(mds[m], starts, m, d) + x;
+                count = nstl::min(count, b - p % b);
+            }
+            pieces.push_back({x, count, 1});
+            x += count;
+        }
+    }
+
+    void init(int n, const memory_desc_t *const *mds,
+            const nstl::vector<piece_t> *pieces, const int *which,
+            const dims_t *starts) {
+        n_ = n;
+        n_loops_ = 0;
+        nelems_ = 1;
+        const int ndims = mds[0]->ndims;
+
+        base_.resize(n);
+        strides_.resize(2 * TENSOR_MAX_DIMS * n);
+        for (int m = 0; m < n; ++m) {
+            dims_t pos;
+            for (int d = 0; d < ndims; ++d)
+                pos[d] = (starts == nullptr ? 0 : starts[m][d])
+                    + pieces[d][which[d]].start;
+            base_[m] = memory_desc_wrapper(mds[m]).off_v(pos);
+        }
+
+        auto add_loop = [&](int count, int d, int s, int step) {
+            if (count == 1) return;
+            for (int m = 0; m < n; ++m) {
+                const auto &blk = mds[m]->layout_desc.blocking;
+                stride(n_loops_, m) = blk.block_dims[d] == 1
+                    ? step * blk.strides[0][d] : blk.strides[s][d];
+            }
+            counts_[n_loops_++] = count;
+        };
+        for (int d = 0; d < ndims; ++d) {
+            const piece_t &p = pieces[d][which[d]];
+            nelems_ *= p.count;
+            if (p.block == 1) {
+                add_loop(p.count, d, 1, 1);
+            } else {
+                add_loop(p.count / p.block, d, 0, p.block);
+                add_loop(p.block, d, 1, 1);
+            }
+        }
+
+        /* the loops go from the largest stride of the first memory */
+        for (int l = 1; l < n_loops_; ++l) {
+            for (int j = l; j > 0 && stride(j, 0) > stride(j - 1, 0); --j)
+                swap_loops(j, j - 1);
+        }
+
+        /* an outer loop stepping over exactly the inner one in all the
+         * memories is merged into it */
+        for (int l = n_loops_ - 1; l > 0; --l) {
+            bool dense = true;
+            for (int m = 0; m < n; ++m)
+                dense = dense
+                    && stride(l - 1, m) == counts_[l] * stride(l, m);
+            if (!dense) continue;
+            counts_[l - 1] *= counts_[l];
+            for (int m = 0; m < n; ++m) stride(l - 1, m) = stride(l, m);
+            for (int j = l; j < n_loops_ - 1; ++j) {
+                counts_[j] = counts_[j + 1];
+                for (int m = 0; m < n; ++m) stride(j, m) = stride(j + 1, m);
+            }
+            --n_loops_;
+        }
+
+        /* a row as short as a block of channels costs more in the loop
+         * overhead than it gains by being dense, the longer next loop is
+         * taken as the row then */
+        const int l = n_loops_ - 1;
+        if (l > 0 && counts_[l] < min_row_len && counts_[l - 1] > counts_[l])
+            swap_loops(l, l - 1);
+
+        if (n_loops_ == 0) {
+            counts_[0] = 1;
+            for (int m = 0; m < n; ++m) stride(0, m) = 0;
+            n_loops_ = 1;
+        }
+
+        strides_.resize(n_loops_ * n);
+    }
+};
+
+/** calls @p f(nest, off, k, len) for the elements [@p start, @p end) of the
+ * @p nests taken one after another, see loop_nest_t::for_rows() */
+template <typename F>
+inline void for_rows(const nstl::vector<const loop_nest_t *> &nests,
+        size_t start, size_t end, F f) {
+    for (size_t i = 0; i < nests.size() && start < end; ++i) {
+        const loop_nest_t &nest = *nests[i];
+        const size_t nelems = nest.nelems();
+        if (start < nelems) {
+            const size_t e = nstl::min(end, nelems);
+            nest.for_rows(start, e, [&](const ptrdiff_t *off, int k, int len)
+                    { f(nest, off, k, len); });
+        }
+        start = start < nelems ? 0 : start - nelems;
+        end -= nstl::min(end, nelems);
+    }
+}
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -18,6 +18,7 @@
 #define CPU_MEMORY_HPP
 
 #include <assert.h>
+#include <string.h>
 
 #include "c_types_map.hpp"
 #include "cpu_primitive.hpp"
@@ -71,9 +72,89 @@ struct cpu_memory_t: public cpu_primitive_t {
     virtual const char* const_memory(size_t output_index = 0) const
     { assert(output_index == 0); return data_; }
 
+    /** zeroes the padding of the blocked formats, i.e. the tail of the last
+     * block of the dimensions that are not a multiple of their block. The
+     * consumers may read the padding along with the data, so whoever writes
+     * the memory keeps it zero (see cpu_engine_t::submit()) */
+    virtual void zero_pad() const { zero_pad(conf_.desc(), data_); }
+
+    /** zeroes the padding of memory @p md which starts at @p data */
+    static void zero_pad(const memory_desc_t *md, char *data) {
+        const memory_desc_wrapper d(md);
+        if (data == nullptr || !d.is_defined() || !d.is_padded()) return;
+
+        for (int dim = 0; dim < d.ndims(); ++dim)
+            if (d.dims()[dim] != d.blocking_desc().padding_dims[dim])
+                zero_pad_dim(d, dim, data);
+    }
+
 private:
     pd_t conf_;
     char *data_;
+
+    /** zeroes the elements at [dims[dim], padding_dims[dim]) along @p dim,
+     * a memset of the tail per block of @p dim, which is a single run if the
+     * elements of the block are adjacent */
+    static void zero_pad_dim(const memory_desc_wrapper &d, int dim,
+            char *base) {
+        const auto &blk = d.blocking_desc();
+        const size_t typesize = types::data_type_size(d.data_type());
+        const int block = blk.block_dims[dim];
+        const int tail = d.dims()[dim], pad = blk.padding_dims[dim];
+        const bool dense_tail = blk.strides[1][dim] == 1
+            && tail / block == (pad - 1) / block;
+        const size_t run = dense_tail ? (size_t)(pad - tail) : 1;
+        const ptrdiff_t tail_off = tail / block * blk.strides[0][dim];
+
+        /* the blocks and the positions within them of the other dimensions,
+         * the innermost loop goes last */
+        int counts[2 * TENSOR_MAX_DIMS];
+        ptrdiff_t strides[2 * TENSOR_MAX_DIMS];
+        int n_loops = 0;
+        for (int e = 0; e < d.ndims(); ++e) {
+            if (e == dim) continue;
+            for (int s = 0; s < 2; ++s) {
+                const int count = s == 0
+                    ? blk.padding_dims[e] / blk.block_dims[e]
+                    : blk.block_dims[e];
+                if (count == 1) continue;
+                counts[n_loops] = count;
+                strides[n_loops++] = blk.strides[s][e];
+            }
+        }
+        int inner_count = 1;
+        ptrdiff_t inner_stride = 0;
+        if (n_loops > 0) {
+            int inner = 0;
+            for (int l = 1; l < n_loops; ++l)
+                if (strides[l] < strides[inner]) inner = l;
+            inner_count = counts[inner];
+            inner_stride = strides[inner];
+            counts[inner] = counts[--n_loops];
+            strides[inner] = strides[n_loops];
+        }
+        size_t n_outer = 1;
+        for (int l = 0; l < n_loops; ++l) n_outer *= counts[l];
+
+        char *data = base + blk.offset_padding * typesize;
+#       pragma omp parallel for schedule(static)
+        for (size_t o = 0; o < n_outer; ++o) {
+            ptrdiff_t off = tail_off;
+            size_t rem = o;
+            for (int l = n_loops - 1; l >= 0; --l) {
+                off += (rem % counts[l]) * strides[l];
+                rem /= counts[l];
+            }
+            for (int i = 0; i < inner_count; ++i) {
+                const ptrdiff_t i_off = off + i * inner_stride;
+                for (int t = tail; t < pad; t += (int)run) {
+                    const ptrdiff_t t_off = i_off
+                        + t % block * blk.strides[1][dim];
+                    memset(data + t_off * typesize, 0, run * typesize);
+                }
+            }
+        }
+    }
 };
 
 struct cpu_view_t: public cpu_primitive_t {
@@ -106,6 +187,24 @@ struct cpu_view_t: public cpu_primitive_t {
         }
         virtual ~pd_t() {}
 
+        /** returns true if the view of @p dims at @p offsets in memory
+         * @p memory_pd may be described by a memory desc, i.e. the memory
+         * is not padded and the view starts and ends on block boundaries */
+        static bool applicable(const cpu_memory_t::pd_t *memory_pd,
+                const dims_t dims, const dims_t offsets) {
+            const memory_desc_t &src_d = *memory_pd->desc();
+            if (src_d.format == memory_format::any) return false;
+            const auto &src_d_blk = src_d.layout_desc.blocking;
+            for (int d = 0; d < src_d.ndims; ++d) {
+                const int block = src_d_blk.block_dims[d];
+                if (src_d.dims[d] != src_d_blk.padding_dims[d]
+                        || src_d_blk.offset_padding_to_data[d] != 0
+                        || dims[d] % block != 0 || offsets[d] % block != 0)
+                    return false;
+            }
+            return true;
+        }
+
         virtual pd_t *clone() const override { return new pd_t(*this); }
         virtual status_t create_primitive(primitive_t **primitive,
                 const primitive_at_t *inputs, const primitive_t **outputs)
@@ -143,6 +242,34 @@ private:
     pd_t conf_;
 };
 
+/** a memory which lives in another memory @p base at byte offset @p offset.
+ * Unlike cpu_view_t the memory desc describes the slice itself, so any
+ * primitive may use it as a regular memory */
+struct cpu_memory_slice_t: public cpu_primitive_t {
+    cpu_memory_slice_t(const cpu_memory_t::pd_t *mpd,
+            const primitive_at_t &base, size_t offset)
+        : cpu_primitive_t(&conf_, input_vector(1, base), output_vector(1, this))
+        , conf_(*mpd), offset_(offset) {}
+    virtual ~cpu_memory_slice_t() {}
+
+    virtual void execute(mkldnn::impl::event_t *e)
+    { e->set_state(event_t::ready); }
+
+    virtual char *memory(size_t output_index = 0) const {
+        assert(output_index == 0);
+        return const_cast<char *>(input_memory()) + offset_;
+    }
+    virtual const char* const_memory(size_t output_index = 0) const
+    { assert(output_index == 0); return input_memory() + offset_; }
+
+    virtual void zero_pad() const
+    { cpu_memory_t::zero_pad(conf_.desc(), memory()); }
+
+private:
+    cpu_memory_t::pd_t conf_;
+    size_t offset_;
+};
+
 }
 }
 }
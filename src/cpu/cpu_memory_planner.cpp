@@ -0,0 +1,313 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "cpu_engine.hpp"
+#include "cpu_memory.hpp"
+#include "cpu_concat.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::status;
+using namespace mkldnn::impl::prop_kind;
+using namespace mkldnn::impl::types;
+using namespace mkldnn::impl::utils;
+
+namespace {
+
+typedef nstl::vector<primitive_t *> prim_vector;
+
+inline const memory_desc_t &md_of(const primitive_t *m) {
+    assert(m->kind() == primitive_kind::memory);
+    return *static_cast<const memory_pd_t *>(m->pd())->desc();
+}
+
+inline size_t size_of(const primitive_t *m) {
+    assert(m->kind() == primitive_kind::memory);
+    return static_cast<const memory_pd_t *>(m->pd())->get_size();
+}
+
+/** \brief memory planner
+ *
+ * A memory is planned if it is intermediate, i.e. it is written and only then
+ * read by the primitives. It is alive from its first write to its last
+ * access. Memories sharing storage form a group: the output of a relu joins
+ * the group of its input if the input dies at the relu, while the inputs of a
+ * concat join the group of the concat output at the place of their images.
+ * Groups that are not alive at the same time share the slab. */
+struct memory_planner_t {
+    memory_planner_t(const prim_vector &prims): prims_(prims) {}
+
+    status_t plan(size_t *slab_size, char *slab) {
+        collect();
+        for (int i = 0; i < n_prims(); ++i) {
+            relu_in_place(i);
+            concat_in_place(i);
+        }
+        *slab_size = place();
+        if (slab != nullptr) return bind(slab);
+        return success;
+    }
+
+private:
+    enum { alignment = 64 };
+
+    struct mem_t {
+        const primitive_t *m;
+        int first_write, last_write, first_read, last_access;
+        bool planned;
+        int root; /* the memory holding the storage of the group */
+        size_t offset; /* offset in the storage of the root */
+        int n_members; /* for a root only */
+        bool external; /* for a root only: the storage is the user's one */
+        size_t slab_offset; /* for a root only */
+    };
+
+    int n_prims() const { return (int)prims_.size(); }
+
+    int index_of(const primitive_t *m) {
+        auto it = index_.find(m);
+        if (it != index_.end()) return it->second;
+
+        mem_t mem = { m, -1, -1, -1, -1, false, (int)mems_.size(), 0, 1,
+            false, 0 };
+        mems_.push_back(mem);
+        index_[m] = mem.root;
+        return mem.root;
+    }
+
+    void access(const primitive_t *m, int i, bool write) {
+        mem_t &mem = mems_[index_of(base_memory_of(m))];
+        if (write) {
+            if (mem.first_write == -1) mem.first_write = i;
+            mem.last_write = i;
+        } else {
+            if (mem.first_read == -1) mem.first_read = i;
+        }
+        mem.last_access = i;
+    }
+
+    void collect() {
+        for (int i = 0; i < n_prims(); ++i) {
+            const primitive_t *p = prims_[i];
+            if (is_memory_kind(p)) continue;
+            for (size_t k = 0; k < p->inputs().size(); ++k)
+                access(memory_of(p->inputs()[k]), i, false);
+            for (size_t k = 0; k < p->outputs().size(); ++k)
+                access(p->outputs()[k], i, true);
+        }
+
+        for (size_t k = 0; k < mems_.size(); ++k) {
+            mem_t &mem = mems_[k];
+            mem.planned = true
+                && mem.m->kind() == primitive_kind::memory
+                && mem.first_write != -1
+                && mem.first_read > mem.first_write;
+        }
+    }
+
+    /** returns the range of primitives the group of @p root is alive at */
+    void lifetime(int root, int &begin, int &end) const {
+        begin = n_prims(); end = -1;
+        if (mems_[root].external) { begin = 0; end = n_prims(); return; }
+        for (size_t k = 0; k < mems_.size(); ++k) {
+            if (mems_[k].root != root) continue;
+            begin = nstl::min(begin, mems_[k].first_write);
+            end = nstl::max(end, mems_[k].last_access);
+        }
+    }
+
+    /** returns the size of the storage of the group of @p root */
+    size_t group_size(int root) const {
+        size_t size = 0;
+        for (size_t k = 0; k < mems_.size(); ++k)
+            if (mems_[k].root == root)
+                size = nstl::max(size, mems_[k].offset + size_of(mems_[k].m));
+        return rnd_up(size, alignment);
+    }
+
+    /** returns true if @p m is a planned memory that is not a part of any
+     * group yet */
+    bool is_single(const primitive_t *m) {
+        if (m->kind() != primitive_kind::memory || base_memory_of(m) != m)
+            return false;
+        const mem_t &mem = mems_[index_of(m)];
+        return mem.planned && mem.root == index_of(m) && mem.n_members == 1;
+    }
+
+    void join(const primitive_t *m, int root, size_t offset) {
+        mem_t &mem = mems_[index_of(m)];
+        mem.root = root;
+        mem.offset = offset;
+        mems_[root].n_members++;
+    }
+
+    /** x -> relu -> y ==> y lives in x if x dies at the relu */
+    void relu_in_place(int i) {
+        const primitive_t *r = prims_[i];
+        if (r->kind() != primitive_kind::relu
+                || !one_of(r->pd()->op_desc()->relu.prop_kind,
+                    forward_training, forward_inference)
+                || r->outputs().size() != 1)
+            return;
+
+        const primitive_t *x = memory_of(r->inputs()[0]);
+        const primitive_t *y = r->outputs()[0];
+        if (x->kind() != primitive_kind::memory || base_memory_of(x) != x
+                || !mems_[index_of(x)].planned || !is_single(y)
+                || md_of(x) != md_of(y))
+            return;
+
+        const mem_t &mx = mems_[index_of(x)];
+        int begin, end;
+        lifetime(mx.root, begin, end);
+        if (end != i || mems_[index_of(y)].first_write != i) return;
+
+        join(y, mx.root, mx.offset);
+    }
+
+    /** inputs of a concat live in the concat output at their images */
+    void concat_in_place(int j) {
+        const primitive_t *c = prims_[j];
+        if (c->kind() != primitive_kind::concat) return;
+
+        auto c_pd = static_cast<const cpu_concat_t::pd_t *>(c->pd());
+        const primitive_t *o = c->outputs()[0];
+        if (base_memory_of(o) != o) return;
+
+        const int io = index_of(o);
+        const mem_t mo = mems_[io];
+        const bool touched_before = mo.first_write < j
+            || (mo.first_read != -1 && mo.first_read < j);
+        if (touched_before || mo.root != io || mo.n_members != 1) return;
+        if (!mo.planned) {
+            /* the inputs live in the user's memory then */
+            void *handle;
+            if (o->get_data_handle(&handle) != success || handle == nullptr)
+                return;
+        }
+
+        for (int k = 0; k < (int)c->inputs().size(); ++k) {
+            const primitive_t *in = memory_of(c->inputs()[k]);
+            if (!is_single(in) || in == o
+                    || md_of(in) != *c_pd->src_pd(k)->desc()
+                    || !c_pd->src_image_is_dense(k)
+                    || mems_[index_of(in)].last_write >= j)
+                continue;
+            if (!mo.planned) mems_[io].external = true;
+            join(in, io, c_pd->src_image_offset(k));
+        }
+    }
+
+    /** assigns slab offsets to the groups, returns the size of the slab */
+    size_t place() {
+        nstl::vector<int> roots;
+        for (size_t k = 0; k < mems_.size(); ++k) {
+            const mem_t &mem = mems_[k];
+            if (mem.planned && mem.root == (int)k && !mem.external)
+                roots.push_back((int)k);
+        }
+
+        /* the largest groups go first, each one to the lowest offset that
+         * does not clash with the placed groups alive at the same time */
+        size_t slab_size = 0;
+        nstl::vector<int> placed;
+        nstl::vector<int> done(roots.size(), 0);
+        for (size_t n = 0; n < roots.size(); ++n) {
+            int g = -1;
+            for (size_t k = 0; k < roots.size(); ++k) {
+                if (done[k]) continue;
+                if (g == -1 || group_size(roots[k]) > group_size(roots[g]))
+                    g = (int)k;
+            }
+            done[g] = 1;
+
+            const int root = roots[g];
+            const size_t size = group_size(root);
+            int begin, end;
+            lifetime(root, begin, end);
+
+            size_t offset = 0;
+            bool moved = true;
+            while (moved) {
+                moved = false;
+                for (size_t k = 0; k < placed.size(); ++k) {
+                    const mem_t &other = mems_[placed[k]];
+                    int o_begin, o_end;
+                    lifetime(placed[k], o_begin, o_end);
+                    const size_t o_size = group_size(placed[k]);
+                    bool clash = begin <= o_end && o_begin <= end
+                        && offset < other.slab_offset + o_size
+                        && other.slab_offset < offset + size;
+                    if (!clash) continue;
+                    offset = other.slab_offset + o_size;
+                    moved = true;
+                }
+            }
+
+            mems_[root].slab_offset = offset;
+            placed.push_back(root);
+            slab_size = nstl::max(slab_size, offset + size);
+        }
+        return slab_size;
+    }
+
+    status_t bind(char *slab) {
+        for (size_t k = 0; k < mems_.size(); ++k) {
+            const mem_t &mem = mems_[k];
+            if (!mem.planned) continue;
+
+            const mem_t &root = mems_[mem.root];
+            char *storage = slab + root.slab_offset;
+            if (root.external) {
+                void *handle;
+                CHECK(root.m->get_data_handle(&handle));
+                storage = static_cast<char *>(handle);
+            }
+            auto m = const_cast<primitive_t *>(mem.m);
+            CHECK(m->set_data_handle(storage + mem.offset));
+        }
+        return success;
+    }
+
+    const prim_vector &prims_;
+    nstl::vector<mem_t> mems_;
+    nstl::map<const primitive_t *, int> index_;
+};
+
+}
+
+status_t cpu_engine_t::plan_memory(const primitive_vector &prims,
+        size_t *slab_size, char *slab) {
+    for (size_t i = 0; i < prims.size(); ++i)
+        if (prims[i]->engine() != this) return invalid_arguments;
+
+    return memory_planner_t(prims).plan(slab_size, slab);
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
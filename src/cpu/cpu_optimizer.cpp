@@ -0,0 +1,499 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "cpu_engine.hpp"
+#include "cpu_memory.hpp"
+#include "cpu_concat.hpp"
+#include "reorder_pd.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::status;
+using namespace mkldnn::impl::prop_kind;
+using namespace mkldnn::impl::types;
+using namespace mkldnn::impl::utils;
+
+namespace {
+
+typedef nstl::vector<primitive_t *> prim_vector;
+
+inline bool is_plain_memory(const primitive_t *m) {
+    return m->kind() == primitive_kind::memory && base_memory_of(m) == m;
+}
+
+/** returns the layout of memory @p m, for a view the layout of the view */
+inline const memory_desc_t &md_of(const primitive_t *m) {
+    assert(is_memory_kind(m));
+    return *m->pd()->output_pd()->desc();
+}
+
+bool reads(const primitive_t *p, const primitive_t *m) {
+    if (p == nullptr || is_memory_kind(p)) return false;
+    for (size_t i = 0; i < p->inputs().size(); ++i)
+        if (overlap(memory_of(p->inputs()[i]), m)) return true;
+    return false;
+}
+
+bool writes(const primitive_t *p, const primitive_t *m) {
+    if (p == nullptr || is_memory_kind(p)) return false;
+    for (size_t i = 0; i < p->outputs().size(); ++i)
+        if (overlap(p->outputs()[i], m)) return true;
+    return false;
+}
+
+inline bool touches(const primitive_t *p, const primitive_t *m)
+{ return reads(p, m) || writes(p, m); }
+
+bool is_plain_copy(const primitive_t *p) {
+    if (p == nullptr || p->kind() != primitive_kind::reorder) return false;
+    auto r_pd = static_cast<const reorder_pd_t *>(p->pd());
+    return r_pd->alpha() == 1.0 && r_pd->beta() == 0.0;
+}
+
+struct stream_optimizer_t {
+    stream_optimizer_t(engine_t *engine, prim_vector &prims,
+            prim_vector &created)
+        : engine_(engine), prims_(prims), orig_(prims), created_(created) {}
+
+    status_t optimize() {
+        fuse_conv_relu();
+        fuse_pool_ip();
+        compose_reorders();
+        elide_reorders();
+        concat_in_place();
+        CHECK(fix_references());
+
+        prim_vector result;
+        for (size_t i = 0; i < prims_.size(); ++i)
+            if (prims_[i] != nullptr) result.push_back(prims_[i]);
+        prims_ = result;
+        return success;
+    }
+
+private:
+    int size() const { return (int)prims_.size(); }
+
+    /** a memory is intermediate if the original sequence reads it after it
+     * has been written to. The optimizer is free to leave such a memory
+     * unwritten */
+    bool is_intermediate(const primitive_t *m) const {
+        bool written = false;
+        for (size_t i = 0; i < orig_.size(); ++i) {
+            if (written && reads(orig_[i], m)) return true;
+            written = written || writes(orig_[i], m);
+        }
+        return false;
+    }
+
+    primitive_t *create(const primitive_desc_t *pd,
+            const nstl::vector<primitive_at_t> &inputs,
+            const nstl::vector<const primitive_t *> &outputs) {
+        primitive_t *np;
+        nstl::vector<const primitive_t *> outs(outputs);
+        if (pd->create_primitive(&np, inputs.size() ? &inputs[0] : nullptr,
+                    outs.size() ? &outs[0] : nullptr) != success)
+            return nullptr;
+        created_.push_back(np);
+        return np;
+    }
+
+    /** conv -> relu ==> conv_relu, if the conv result is an intermediate
+     * used by the relu only. The fused primitive does not write the conv
+     * result, hence training convs (whose result the backward pass may need)
+     * are never fused */
+    void fuse_conv_relu() {
+        for (int i = 0; i < size(); ++i) {
+            const primitive_t *c = prims_[i];
+            if (c == nullptr || c->kind() != primitive_kind::convolution
+                    || c->pd()->op_desc()->convolution.prop_kind
+                    != forward_inference)
+                continue;
+
+            const primitive_t *m = c->outputs()[0];
+            int j = i + 1;
+            while (j < size() && !touches(prims_[j], m)) ++j;
+            if (j == size()) continue;
+
+            const primitive_t *r = prims_[j];
+            if (r->kind() != primitive_kind::relu
+                    || !one_of(r->pd()->op_desc()->relu.prop_kind,
+                        forward_training, forward_inference)
+                    || r->outputs().size() != 1
+                    || memory_of(r->inputs()[0]) != m
+                    || md_of(m) != *r->pd()->dst_pd()->desc())
+                continue;
+
+            /* the fused primitive runs at the place of relu */
+            const primitive_t *o = r->outputs()[0];
+            bool ok = true;
+            for (size_t k = 0; k < c->inputs().size(); ++k) {
+                const primitive_t *in = memory_of(c->inputs()[k]);
+                ok = ok && !overlap(in, o);
+                for (int l = i + 1; l < j; ++l)
+                    ok = ok && !writes(prims_[l], in);
+            }
+            if (!overlap(o, m)) {
+                for (int l = j + 1; l < size(); ++l)
+                    ok = ok && !reads(prims_[l], m);
+            }
+            if (!ok) continue;
+
+            auto c_pd = c->pd();
+            convolution_desc_t cd = c_pd->op_desc()->convolution;
+            cd.src_desc = *c_pd->src_pd()->desc();
+            cd.weights_desc = *c_pd->weights_pd(0)->desc();
+            if (c_pd->weights_pd(1) != nullptr)
+                cd.bias_desc = *c_pd->weights_pd(1)->desc();
+            cd.dst_desc = *c_pd->dst_pd()->desc();
+
+            convolution_relu_desc_t crd;
+            if (mkldnn_convolution_relu_desc_init(&crd, &cd,
+                        r->pd()->op_desc()->relu.negative_slope) != success)
+                continue;
+
+            primitive_desc_t *f_pd;
+            if (mkldnn_primitive_desc_create(&f_pd, &crd, engine_, nullptr)
+                    != success)
+                continue;
+
+            bool same_layout = true
+                && *f_pd->src_pd()->desc() == cd.src_desc
+                && *f_pd->weights_pd(0)->desc() == cd.weights_desc
+                && *f_pd->dst_pd()->desc() == cd.dst_desc;
+            primitive_t *f = same_layout
+                ? create(f_pd, c->inputs(), r->outputs()) : nullptr;
+            delete f_pd;
+            if (f == nullptr) continue;
+
+            prims_[i] = nullptr;
+            prims_[j] = f;
+        }
+    }
+
+    /** global avg pool -> [plain copy ->] ip ==> pool_ip, if the pooling
+     * result (and its copy) are used by the ip only */
+    void fuse_pool_ip() {
+        for (int i = 0; i < size(); ++i) {
+            const primitive_t *p = prims_[i];
+            if (p == nullptr || p->kind() != primitive_kind::pooling
+                    || p->outputs().size() != 1)
+                continue;
+            const pooling_desc_t &pd0 = p->pd()->op_desc()->pooling;
+            const memory_desc_t &p_src_md = *p->pd()->src_pd()->desc();
+            const memory_desc_t &p_dst_md = *p->pd()->dst_pd()->desc();
+            if (!one_of(pd0.prop_kind, forward_training, forward_inference)
+                    || pd0.alg_kind != alg_kind::pooling_avg
+                    || p_dst_md.dims[2] != 1 || p_dst_md.dims[3] != 1)
+                continue;
+
+            /* the ip reads the pooling result directly or via a copy */
+            const primitive_t *m = p->outputs()[0];
+            int j = i + 1;
+            while (j < size() && !touches(prims_[j], m)) ++j;
+            if (j == size()) continue;
+
+            int k = j;
+            const primitive_t *t = m;
+            if (is_plain_copy(prims_[j])
+                    && memory_of(prims_[j]->inputs()[0]) == m) {
+                t = prims_[j]->outputs()[0];
+                if (!is_plain_memory(t) || overlap(t, m)) continue;
+                k = j + 1;
+                while (k < size() && !touches(prims_[k], t)) ++k;
+                if (k == size()) continue;
+            }
+
+            const primitive_t *ip = prims_[k];
+            if (ip->kind() != primitive_kind::inner_product
+                    || !one_of(ip->pd()->op_desc()->inner_product.prop_kind,
+                        forward_training, forward_inference)
+                    || memory_of(ip->inputs()[0]) != t
+                    || md_of(t) != *ip->pd()->src_pd()->desc())
+                continue;
+
+            /* the fused primitive runs at the place of ip */
+            const primitive_t *o = ip->outputs()[0];
+            const primitive_t *in = memory_of(p->inputs()[0]);
+            bool ok = !overlap(in, o);
+            for (int l = i + 1; l < k; ++l)
+                ok = ok && !writes(prims_[l], in);
+            for (int l = j + 1; l < size(); ++l)
+                ok = ok && (l == k
+                        || (!reads(prims_[l], m) && !reads(prims_[l], t)));
+            for (size_t l = 1; l < ip->inputs().size(); ++l) {
+                const primitive_t *w = memory_of(ip->inputs()[l]);
+                ok = ok && !overlap(w, m) && !overlap(w, t);
+            }
+            if (!ok) continue;
+
+            pooling_desc_t pd = pd0;
+            pd.prop_kind = forward_inference;
+            pd.src_desc = p_src_md;
+            pd.dst_desc = p_dst_md;
+
+            auto ip_pd = ip->pd();
+            inner_product_desc_t id = ip_pd->op_desc()->inner_product;
+            id.prop_kind = forward_inference;
+            id.src_desc = *ip_pd->src_pd()->desc();
+            id.weights_desc = *ip_pd->weights_pd(0)->desc();
+            if (ip_pd->weights_pd(1) != nullptr)
+                id.bias_desc = *ip_pd->weights_pd(1)->desc();
+            id.dst_desc = *ip_pd->dst_pd()->desc();
+
+            pooling_inner_product_desc_t pid;
+            if (mkldnn_pooling_inner_product_desc_init(&pid, &pd, &id)
+                    != success)
+                continue;
+
+            primitive_desc_t *f_pd;
+            if (mkldnn_primitive_desc_create(&f_pd, &pid, engine_, nullptr)
+                    != success)
+                continue;
+
+            bool same_layout = true
+                && *f_pd->src_pd()->desc() == pd.src_desc
+                && *f_pd->weights_pd(0)->desc() == id.weights_desc
+                && *f_pd->dst_pd()->desc() == id.dst_desc;
+            nstl::vector<primitive_at_t> ins(ip->inputs());
+            ins[0] = p->inputs()[0];
+            primitive_t *f = same_layout
+                ? create(f_pd, ins, ip->outputs()) : nullptr;
+            delete f_pd;
+            if (f == nullptr) continue;
+
+            prims_[i] = nullptr;
+            if (j != k) prims_[j] = nullptr;
+            prims_[k] = f;
+        }
+    }
+
+    /** r1: i -> t, r2: t -> o, with layout(i) == layout(o) ==> o = copy(i)
+     * (or nothing if i == o); r1 is then removed if t is intermediate */
+    void compose_reorders() {
+        for (int j = 0; j < size(); ++j) {
+            const primitive_t *r2 = prims_[j];
+            if (!is_plain_copy(r2)) continue;
+
+            const primitive_t *t = memory_of(r2->inputs()[0]);
+            const primitive_t *o = r2->outputs()[0];
+            int i = j - 1;
+            while (i >= 0 && !writes(prims_[i], t)) --i;
+            if (i < 0 || !is_plain_copy(prims_[i])
+                    || prims_[i]->outputs()[0] != t)
+                continue;
+
+            const primitive_t *r1 = prims_[i];
+            const primitive_t *in = memory_of(r1->inputs()[0]);
+            if (!is_plain_memory(in) || !is_plain_memory(t)
+                    || !is_plain_memory(o) || md_of(in) != md_of(o)
+                    || !is_intermediate(t))
+                continue;
+
+            bool ok = true;
+            for (int l = i + 1; l < j; ++l)
+                ok = ok && !writes(prims_[l], in) && !reads(prims_[l], t);
+            for (int l = j + 1; l < size(); ++l)
+                ok = ok && !reads(prims_[l], t);
+            if (!ok) continue;
+
+            primitive_t *copy = nullptr;
+            if (in != o) {
+                primitive_desc_t *r_pd;
+                if (mkldnn_reorder_primitive_desc_create(&r_pd, in->pd(),
+                            o->pd()) != success)
+                    continue;
+                copy = create(r_pd, nstl::vector<primitive_at_t>(1, {in, 0}),
+                        nstl::vector<const primitive_t *>(1, o));
+                delete r_pd;
+                if (copy == nullptr) continue;
+            }
+
+            prims_[i] = nullptr;
+            prims_[j] = copy;
+        }
+    }
+
+    /** i -> o with layout(i) == layout(o) ==> consumers of o read i */
+    void elide_reorders() {
+        for (int j = 0; j < size(); ++j) {
+            const primitive_t *r = prims_[j];
+            if (!is_plain_copy(r)) continue;
+
+            const primitive_t *in = memory_of(r->inputs()[0]);
+            const primitive_t *o = r->outputs()[0];
+            if (!is_plain_memory(in) || !is_plain_memory(o)
+                    || md_of(in) != md_of(o))
+                continue;
+            if (in == o) { prims_[j] = nullptr; continue; }
+            if (!is_intermediate(o)) continue;
+
+            bool ok = true;
+            for (int l = j + 1; l < size(); ++l) {
+                ok = ok && !writes(prims_[l], in) && !writes(prims_[l], o);
+                if (prims_[l] == nullptr || is_memory_kind(prims_[l])) continue;
+                /* views of o cannot be redirected */
+                for (size_t k = 0; k < prims_[l]->inputs().size(); ++k) {
+                    const primitive_t *m = memory_of(prims_[l]->inputs()[k]);
+                    ok = ok && implication(base_memory_of(m) == o, m == o);
+                }
+            }
+            if (!ok) continue;
+
+            prim_vector consumers(prims_.size(), nullptr);
+            for (int l = j + 1; l < size() && ok; ++l) {
+                if (!reads(prims_[l], o)) continue;
+                nstl::vector<primitive_at_t> ins(prims_[l]->inputs());
+                for (size_t k = 0; k < ins.size(); ++k)
+                    if (memory_of(ins[k]) == o) ins[k] = {in, 0};
+                consumers[l] = create(prims_[l]->pd(), ins,
+                        prims_[l]->outputs());
+                ok = consumers[l] != nullptr;
+            }
+            if (!ok) continue;
+
+            prims_[j] = nullptr;
+            for (int l = j + 1; l < size(); ++l)
+                if (consumers[l] != nullptr) prims_[l] = consumers[l];
+        }
+    }
+
+    /** producers of concat inputs write directly to the concat output */
+    void concat_in_place() {
+        for (int j = 0; j < size(); ++j) {
+            const primitive_t *c = prims_[j];
+            if (c == nullptr || c->kind() != primitive_kind::concat) continue;
+
+            auto c_pd = static_cast<const cpu_concat_t::pd_t *>(c->pd());
+            const primitive_t *o = c->outputs()[0];
+            const int n = (int)c->inputs().size();
+            if (!is_plain_memory(o)) continue;
+
+            bool ok = true;
+            int first = j;
+            nstl::vector<int> producers(n, -1), out_idx(n, -1);
+            for (int k = 0; k < n && ok; ++k) {
+                const primitive_t *in = memory_of(c->inputs()[k]);
+                ok = ok && is_plain_memory(in)
+                    && md_of(in) == *c_pd->src_pds_[k].desc()
+                    && c_pd->src_image_is_dense(k);
+                for (int l = 0; l < size() && ok; ++l) {
+                    if (l == j) continue;
+                    ok = !reads(prims_[l], in);
+                    if (!writes(prims_[l], in)) continue;
+                    ok = ok && l < j && producers[k] == -1;
+                    producers[k] = l;
+                }
+                ok = ok && producers[k] != -1;
+                if (!ok) break;
+
+                const primitive_t *p = prims_[producers[k]];
+                for (size_t oi = 0; oi < p->outputs().size(); ++oi)
+                    if (p->outputs()[oi] == in) out_idx[k] = (int)oi;
+                for (int kk = 0; kk < k; ++kk)
+                    ok = ok && producers[kk] != producers[k];
+                ok = ok && out_idx[k] != -1;
+                first = nstl::min(first, producers[k]);
+            }
+            for (int l = first; l < j && ok; ++l)
+                ok = !touches(prims_[l], o);
+            if (!ok) continue;
+
+            prim_vector clones(n, nullptr);
+            for (int k = 0; k < n && ok; ++k) {
+                primitive_t *slice = new cpu_memory_slice_t(&c_pd->src_pds_[k],
+                        {o, 0}, c_pd->src_image_offset(k));
+                created_.push_back(slice);
+
+                const primitive_t *p = prims_[producers[k]];
+                nstl::vector<const primitive_t *> outs(p->outputs());
+                outs[out_idx[k]] = slice;
+                clones[k] = create(p->pd(), p->inputs(), outs);
+                ok = clones[k] != nullptr;
+            }
+            if (!ok) continue;
+
+            for (int k = 0; k < n; ++k)
+                prims_[producers[k]] = clones[k];
+            prims_[j] = nullptr;
+        }
+    }
+
+    /** primitives that refer to removed ones read the memory directly */
+    status_t fix_references() {
+        auto removed = [&](const primitive_t *p) {
+            bool in_orig = false, in_prims = false;
+            for (size_t i = 0; i < orig_.size(); ++i)
+                in_orig = in_orig || orig_[i] == p;
+            for (size_t i = 0; i < prims_.size(); ++i)
+                in_prims = in_prims || prims_[i] == p;
+            return in_orig && !in_prims;
+        };
+
+        for (int l = 0; l < size(); ++l) {
+            const primitive_t *p = prims_[l];
+            if (p == nullptr || is_memory_kind(p)) continue;
+
+            bool fix = false;
+            nstl::vector<primitive_at_t> ins(p->inputs());
+            for (size_t k = 0; k < ins.size(); ++k) {
+                if (is_memory_kind(ins[k].primitive)
+                        || !removed(ins[k].primitive))
+                    continue;
+                ins[k] = {memory_of(ins[k]), 0};
+                fix = true;
+            }
+            if (!fix) continue;
+
+            primitive_t *np = create(p->pd(), ins, p->outputs());
+            if (np == nullptr) return runtime_error;
+            prims_[l] = np;
+        }
+        return success;
+    }
+
+    engine_t *engine_;
+    prim_vector &prims_;
+    const prim_vector orig_;
+    prim_vector &created_;
+};
+
+}
+
+status_t cpu_engine_t::optimize(primitive_vector &prims,
+        primitive_vector &created) {
+    for (size_t i = 0; i < prims.size(); ++i)
+        if (prims[i]->engine() != this) return success;
+
+    prim_vector optimized(prims);
+    CHECK(stream_optimizer_t(this, optimized, created).optimize());
+    prims = optimized;
+    return success;
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -31,6 +31,13 @@ namespace mkldnn {
 namespace impl {
 namespace cpu {
 
+/** max pooling keeps the position kh * KW + kw of the maximum within the
+ * window in the workspace: a byte is enough for windows of up to 256 taps */
+inline data_type_t pooling_index_data_type(const pooling_desc_t *desc) {
+    return desc->kernel[0] * desc->kernel[1] <= 256
+        ? data_type::u8 : data_type::s32;
+}
+
 struct cpu_pooling_fwd_pd_t: public pooling_fwd_pd_t {
     using cpu_memory_pd_t = cpu_memory_t::pd_t;
 
@@ -89,6 +96,15 @@ protected:
     cpu_memory_pd_t ws_pd_;
 
     virtual status_t init() = 0;
+
+    virtual status_t set_default_params() {
+        using namespace memory_format;
+        if (diff_src_pd_.desc()->format == any)
+            CHECK(diff_src_pd_.set_format(nchw));
+        if (diff_dst_pd_.desc()->format == any)
+            CHECK(diff_dst_pd_.set_format(diff_src_pd_.desc()->format));
+        return status::success;
+    }
 };
 
 }
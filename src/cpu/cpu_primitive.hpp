@@ -22,6 +22,7 @@
 #include "c_types_map.hpp"
 #include "event.hpp"
 #include "primitive.hpp"
+#include "utils.hpp"
 
 namespace mkldnn {
 namespace impl {
@@ -54,6 +55,28 @@ struct cpu_primitive_t: public primitive_t {
                 this->inputs()[index].primitive);
         return p->const_memory(oi);
     }
+
+    /** zeroes the padding of the blocked formats of the memory the primitive
+     * holds, nothing to do for the primitives which are not memories */
+    virtual void zero_pad() const {}
+
+    /** returns true if the primitive writes the padding of its outputs
+     * itself (with zeros), so the engine need not zero it after execute */
+    virtual bool writes_padding() const { return false; }
+
+protected:
+    /** executes the primitive, which needs scratch memory, without a caller
+     * providing one: the memory is allocated for this execution only */
+    void execute_with_own_scratchpad(event_t *e) {
+        const size_t size = this->pd()->scratchpad_size();
+        char *scratchpad = size == 0 ? nullptr : (char *)malloc(size, 64);
+        if (size != 0 && scratchpad == nullptr) {
+            e->set_state(event_t::error);
+            return;
+        }
+        this->execute(e, scratchpad);
+        free(scratchpad);
+    }
 };
 
 }
@@ -72,7 +72,9 @@ struct cpu_simple_concat_t: public c_compatible {
                     concat->input_memory(a)) + i_d.blk_off(0);
             output_ptrs[a] = o_base_ptr + o_d.blk_off(0);
 
-            nelems_no_d0[a] = nelems_no_dim_0(i_d);
+            /* an input that lives in the output is already in place */
+            nelems_no_d0[a] = input_ptrs[a] == output_ptrs[a]
+                ? 0 : nelems_no_dim_0(i_d);
             is[a] = i_d.blocking_desc().strides[0][0];
         }
 
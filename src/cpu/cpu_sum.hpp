@@ -23,19 +23,13 @@
 #include "cpu_primitive.hpp"
 #include "event.hpp"
 #include "memory_pd.hpp"
-#include "reorder_pd.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
+#include "cpu_loop_nest.hpp"
 #include "cpu_memory.hpp"
-
-/* FIXME: tentative performance fix
- * The idea is that sum use a number of reorders.
- * The problem with this approach is omp parallelization: it is much better to
- * have one omp section with all the reorders, and not one omp section per the
- * reorder. `cpu_simple_sum.hpp should addresses this problem, but the solution
- * is too stupid and isolated... */
-#include "cpu_simple_sum.hpp"
+#include "jit_avx2_sum_kernel_f32.hpp"
+#include "jit_kernel_cache.hpp"
 
 namespace mkldnn {
 namespace impl {
@@ -67,64 +61,23 @@ struct cpu_sum_t: public cpu_primitive_t
                 dst_pd_ = cpu_memory_t::pd_t(engine, output_d);
             }
 
-            use_simple_sum_ =
-                cpu_simple_sum_t<data_type::f32>::applicable(src_pds_, scale_,
-                        dst_pd_);
-            if (use_simple_sum_) return;
-
+            /* the jit kernel sums up dense arrays of the same layout */
+            const memory_desc_wrapper o_d(&dst_pd_);
+            use_jit_sum_ = o_d.data_type() == data_type::f32
+                && o_d.is_dense(true);
             for (int i = 0; i < n_; ++i) {
-                auto r_impls = engine_->get_reorder_implementation_list();
-                for (auto r = r_impls; *r; ++r) {
-                    reorder_pd_t *r_pd;
-                    double beta = (i == 0) ? 0.0 : 1.0;
-                    if ((*r)(&r_pd, &src_pds_[i], &dst_pd_, scale_[i], beta) ==
-                            status::success) {
-                        reorder_pds_.push_back(r_pd);
-                        break;
-                    }
-                }
-            }
-            assert((int)reorder_pds_.size() == n_);
-        }
-        pd_t(const pd_t &rhs)
-            : sum_pd_t(rhs), use_simple_sum_(rhs.use_simple_sum_)
-            , src_pds_(rhs.src_pds_), dst_pd_(rhs.dst_pd_)
-        {
-            for (size_t i = 0; i < rhs.scale_.size(); ++i) {
-                scale_.push_back(rhs.scale_[i]);
-            }
-            for (size_t i = 0; i < rhs.reorder_pds_.size(); ++i) {
-                reorder_pds_.push_back(
-                        (const reorder_pd_t *)rhs.reorder_pds_[i]->clone());
-            }
-        }
-
-        virtual ~pd_t()
-        {
-            for (size_t i = 0; i < reorder_pds_.size(); ++i) {
-                delete reorder_pds_[i];
+                const memory_desc_wrapper i_d(&src_pds_[i]);
+                use_jit_sum_ = use_jit_sum_
+                    && i_d.data_type() == data_type::f32
+                    && i_d.format() == o_d.format() && i_d.is_dense(true)
+                    && i_d.size() == o_d.size();
             }
+            use_jit_sum_ = use_jit_sum_ && jit_avx2_sum_kernel_f32::init_conf(
+                    jsp_, n_, o_d) == status::success;
         }
+        virtual ~pd_t() {}
 
-        virtual pd_t *clone() const override { return nullptr; /* FIXME */ }
-        virtual status_t create_primitive(  primitive_t **primitive,
-                                            const primitive_at_t *inputs,
-                                            const primitive_t **outputs)
-                                            const override
-        {
-            nstl::vector<primitive_t *> reorders;
-            if (use_simple_sum_ == false) {
-                reorders.resize(n_);
-                for (int i = 0; i < n_; ++i)
-                    CHECK(reorder_pds_[i]->create_primitive(&reorders[i],
-                                &inputs[i], outputs));
-            }
-
-            primitive_t::input_vector ins(inputs, inputs + n_);
-            primitive_t::output_vector outs(outputs, outputs + 1);
-            return safe_ptr_assign<primitive_t>(*primitive,
-                    new cpu_sum_t(this, ins, outs, reorders));
-        }
+        DECLARE_COMMON_PD_T(cpu_sum_t);
 
         virtual const cpu_memory_t::pd_t *src_pd(int index = 0) const override
         {
@@ -135,41 +88,156 @@ struct cpu_sum_t: public cpu_primitive_t
             return index == 0 ? &dst_pd_ : nullptr;
         }
 
-        bool use_simple_sum_; /* FIXME: improve */
+        bool use_jit_sum_;
+        jit_sum_conf_t jsp_;
         nstl::vector<cpu_memory_t::pd_t> src_pds_;
         nstl::vector<double> scale_;
-        nstl::vector<const reorder_pd_t *> reorder_pds_;
         cpu_memory_t::pd_t dst_pd_;
     };
 
-    cpu_sum_t(  const pd_t *conf, const input_vector &inputs,
-                const output_vector &outputs,
-                const nstl::vector<primitive_t *> &reorders)
-            : cpu_primitive_t(&conf_, inputs, outputs)
-            , conf_(*conf), reorders_(reorders) {}
-    virtual ~cpu_sum_t()
+    cpu_sum_t(const pd_t *conf, const input_vector &inputs,
+            const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*conf)
+        , kernel_(nullptr), chunk_size_(0)
     {
-        for (size_t i = 0; i < reorders_.size(); ++i)
-            delete reorders_[i];
+        const int n = conf_.n_inputs();
+        for (int a = 0; a < n; ++a)
+            scales_.push_back(data_t(conf_.scale_[a]));
+
+        size_t nelems = 0;
+        if (conf_.use_jit_sum_) {
+            kernel_ = jit_kernel_cache_t::get<jit_avx2_sum_kernel_f32>(
+                    conf_.jsp_, conf_.jsp_);
+            nelems = memory_desc_wrapper(conf_.dst_pd()).nelems(true);
+        } else {
+            /* the output is walked along with all the inputs */
+            nstl::vector<const memory_desc_t *> mds(n + 1);
+            mds[0] = conf_.dst_pd()->desc();
+            for (int a = 0; a < n; ++a)
+                mds[a + 1] = conf_.src_pd(a)->desc();
+            loop_nest_t::append(nests_, n + 1, &mds[0], mds[0]->dims,
+                    nullptr);
+            for (size_t i = 0; i < nests_.size(); ++i) {
+                nest_ptrs_.push_back(&nests_[i]);
+                nelems += nests_[i].nelems();
+            }
+        }
+
+        /* about a thousand chunks of whole cache lines to balance among
+         * the threads */
+        const size_t step = 32;
+        chunk_size_ = step * nstl::max<size_t>(1, nelems / (step * 1024));
     }
+    virtual ~cpu_sum_t() { jit_kernel_cache_t::release(kernel_); }
 
     virtual void execute(event_t *e)
     {
-        if (conf_.use_simple_sum_) {
-            cpu_simple_sum_t<data_type::f32>::execute(conf_.src_pds_,
-                    conf_.scale_, conf_.dst_pd_, this);
+        if (conf_.use_jit_sum_) {
+            execute_jit();
         } else {
-            for (size_t i = 0; i < reorders_.size(); ++i) {
-                event_t ei;
-                reorders_[i]->execute(&ei);
-            }
+            execute_generic();
         }
         e->set_state(event_t::ready);
     }
 
 private:
+    typedef prec_trait<data_type::f32>::type data_t;
+
+    /* all the inputs are read and the output is written once in a single
+     * pass. the first chunk aligns the output of the rest chunks for
+     * the streaming stores */
+    void execute_jit() {
+        const memory_desc_wrapper o_d(conf_.dst_pd());
+        const int n = conf_.n_inputs();
+        const size_t nelems = o_d.nelems(true);
+
+        auto output = reinterpret_cast<data_t *>(this->memory())
+            + o_d.blk_off(0);
+        nstl::vector<const data_t *> inputs(n);
+        for (int a = 0; a < n; ++a) {
+            const memory_desc_wrapper i_d(conf_.src_pd(a));
+            inputs[a] = reinterpret_cast<const data_t *>(
+                    this->input_memory(a)) + i_d.blk_off(0);
+        }
+
+        const size_t misalign = (size_t)output % 32;
+        const size_t head = nstl::min(nelems,
+                (32 - misalign) % 32 / sizeof(data_t));
+        const size_t n_chunks = utils::div_up(nelems - head, chunk_size_);
+
+#       pragma omp parallel for schedule(static)
+        for (size_t c = 0; c < n_chunks + 1; ++c) {
+            jit_sum_call_s p = {};
+            p.srcs = &inputs[0];
+            p.scales = &scales_[0];
+            p.dst = output;
+            p.start = c == 0 ? 0 : head + (c - 1) * chunk_size_;
+            p.nelems = c == 0 ? head
+                : nstl::min(chunk_size_, nelems - p.start);
+            if (p.nelems != 0) (*kernel_)(&p);
+        }
+    }
+
+    /* inputs of any layouts are summed up in a single parallel region: the
+     * elements of the output are split evenly among the threads and walked
+     * along with the inputs by loop nests whose rows run over the innermost
+     * dense blocks of the output. A part of a row is accumulated aside and
+     * stored once all the inputs are read, so the output may alias any
+     * input of the same layout */
+    void execute_generic() {
+        const int n = conf_.n_inputs();
+        auto output = reinterpret_cast<data_t *>(this->memory());
+        nstl::vector<const data_t *> inputs(n);
+        for (int a = 0; a < n; ++a)
+            inputs[a] = reinterpret_cast<const data_t *>(
+                    this->input_memory(a));
+
+        size_t nelems = 0;
+        for (size_t i = 0; i < nests_.size(); ++i)
+            nelems += nests_[i].nelems();
+
+        auto sum = [&](const loop_nest_t &nest, const ptrdiff_t *off,
+                int k, int len) {
+            const int acc_len = 256;
+            data_t acc[acc_len];
+            for (int k0 = k; k0 < k + len; k0 += acc_len) {
+                const int l = nstl::min(acc_len, k + len - k0);
+                for (int a = 0; a < n; ++a) {
+                    const ptrdiff_t is = nest.row_stride(a + 1);
+                    const data_t *i = &inputs[a][off[a + 1] + k0 * is];
+                    const data_t s = scales_[a];
+                    if (a == 0 && is == 1)
+                        for (int e = 0; e < l; ++e) acc[e] = s * i[e];
+                    else if (a == 0)
+                        for (int e = 0; e < l; ++e) acc[e] = s * i[e * is];
+                    else if (is == 1)
+                        for (int e = 0; e < l; ++e) acc[e] += s * i[e];
+                    else
+                        for (int e = 0; e < l; ++e) acc[e] += s * i[e * is];
+                }
+
+                const ptrdiff_t os = nest.row_stride(0);
+                data_t *o = &output[off[0] + k0 * os];
+                if (os == 1)
+                    for (int e = 0; e < l; ++e) o[e] = acc[e];
+                else
+                    for (int e = 0; e < l; ++e) o[e * os] = acc[e];
+            }
+        };
+
+        const size_t n_chunks = utils::div_up(nelems, chunk_size_);
+#       pragma omp parallel for schedule(static)
+        for (size_t c = 0; c < n_chunks; ++c)
+            for_rows(nest_ptrs_, c * chunk_size_,
+                    nstl::min(nelems, (c + 1) * chunk_size_), sum);
+    }
+
     pd_t conf_;
-    nstl::vector<primitive_t *> reorders_;
+    jit_avx2_sum_kernel_f32 *kernel_;
+    nstl::vector<data_t> scales_;
+    size_t chunk_size_;
+    nstl::vector<loop_nest_t> nests_;
+    nstl::vector<const loop_nest_t *> nest_ptrs_;
 };
 
 }
@@ -76,8 +76,8 @@ using namespace mkldnn::impl::memory_format;
 using namespace mkldnn::impl::primitive_kind;
 
 template <impl::data_type_t data_type>
-void gemm_inner_product_fwd_t<data_type>::execute_forward() {
-#ifdef USE_CBLAS
+void gemm_inner_product_fwd_t<data_type>::execute_forward(
+        char *scratchpad) {
     auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
     auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
     auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
@@ -86,21 +86,124 @@ void gemm_inner_product_fwd_t<data_type>::execute_forward() {
     const memory_desc_wrapper dst_d(conf_.dst_pd());
 
     // TODO: consistency checks
-    const cblas_int M = conf_.MB();
-    const cblas_int N = conf_.OC();
-    const cblas_int K = conf_.IC_total();
+    const int M = conf_.MB();
+    const int N = conf_.OC();
+    const int K = conf_.IC_total();
 
+#ifdef USE_CBLAS
     cblas_gemm<data_type>(CblasRowMajor, CblasNoTrans, CblasTrans, M, N, K,
             1.0, src, K, weights, K, 0.0, dst, N);
     if (bias)
 #       pragma omp parallel for schedule(static)
         for (cblas_int mb = 0; mb < M; mb++)
             cblas_axpy<data_type>(N, 1.0, bias, 1, dst + dst_d.blk_off(mb), 1);
+#else
+    /* dst^T = weights * src^T in the column-major terms of sgemm */
+    sgemm_->sgemm(N, M, K, 1.0, weights, K, src, K, dst, N, scratchpad);
+    if (bias)
+#       pragma omp parallel for schedule(static)
+        for (int mb = 0; mb < M; mb++) {
+            data_t *d = dst + dst_d.blk_off(mb);
+            for (int oc = 0; oc < N; ++oc)
+                d[oc] += bias[oc];
+        }
 #endif
 }
 
 template struct gemm_inner_product_fwd_t<data_type::f32>;
 
+template <impl::data_type_t data_type>
+void gemm_pooling_inner_product_fwd_t<data_type>::execute_forward(
+        char *scratchpad) {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
+    auto dst = reinterpret_cast<data_t*>(this->memory());
+    auto pooled = reinterpret_cast<data_t *>(scratchpad);
+
+    const memory_desc_wrapper src_d(conf_.src_pd());
+    const memory_desc_wrapper dst_d(conf_.dst_pd());
+
+    const int MB = conf_.MB();
+    const int C = conf_.C();
+    const int SP = conf_.IH() * conf_.IW();
+    const data_t scale = data_t(1) / SP;
+
+    /* reduce the image to the C averages of each minibatch */
+    switch (src_d.format()) {
+    case nchw:
+#       pragma omp parallel for collapse(2) schedule(static)
+        for (int mb = 0; mb < MB; ++mb) {
+            for (int c = 0; c < C; ++c) {
+                const data_t *s = &src[src_d.blk_off(mb, c)];
+                data_t sum = 0;
+                for (int sp = 0; sp < SP; ++sp)
+                    sum += s[sp];
+                pooled[mb * C + c] = sum * scale;
+            }
+        }
+        break;
+    case nhwc:
+#       pragma omp parallel for schedule(static)
+        for (int mb = 0; mb < MB; ++mb) {
+            const data_t *s = &src[src_d.blk_off(mb)];
+            data_t *p = &pooled[mb * C];
+            for (int c = 0; c < C; ++c)
+                p[c] = 0;
+            for (int sp = 0; sp < SP; ++sp)
+                for (int c = 0; c < C; ++c)
+                    p[c] += s[sp * C + c];
+            for (int c = 0; c < C; ++c)
+                p[c] *= scale;
+        }
+        break;
+    default: {
+        assert(utils::one_of(src_d.format(), nChw8c, nChw16c));
+        const int blksize = src_d.format() == nChw8c ? 8 : 16;
+        const int NB_C = C / blksize;
+#       pragma omp parallel for collapse(2) schedule(static)
+        for (int mb = 0; mb < MB; ++mb) {
+            for (int cb = 0; cb < NB_C; ++cb) {
+                const data_t *s = &src[src_d.blk_off(mb, cb)];
+                data_t *p = &pooled[mb * C + cb * blksize];
+                data_t sum[16] = {};
+                for (int sp = 0; sp < SP; ++sp)
+                    for (int v = 0; v < blksize; ++v)
+                        sum[v] += s[sp * blksize + v];
+                for (int v = 0; v < blksize; ++v)
+                    p[v] = sum[v] * scale;
+            }
+        }
+        break;
+    }
+    }
+
+    const int M = MB;
+    const int N = conf_.OC();
+    const int K = C;
+
+#ifdef USE_CBLAS
+    cblas_gemm<data_type>(CblasRowMajor, CblasNoTrans, CblasTrans, M, N, K,
+            1.0, pooled, K, weights, K, 0.0, dst, N);
+    if (bias)
+#       pragma omp parallel for schedule(static)
+        for (cblas_int mb = 0; mb < M; mb++)
+            cblas_axpy<data_type>(N, 1.0, bias, 1, dst + dst_d.blk_off(mb), 1);
+#else
+    sgemm_->sgemm(N, M, K, 1.0, weights, K, pooled, K, dst, N,
+            scratchpad + conf_.pooled_size());
+    if (bias)
+#       pragma omp parallel for schedule(static)
+        for (int mb = 0; mb < M; mb++) {
+            data_t *d = dst + dst_d.blk_off(mb);
+            for (int oc = 0; oc < N; ++oc)
+                d[oc] += bias[oc];
+        }
+#endif
+}
+
+template struct gemm_pooling_inner_product_fwd_t<data_type::f32>;
+
 }
 }
 }
@@ -21,7 +21,9 @@
 
 #include "c_types_map.hpp"
 #include "cpu_inner_product_pd.hpp"
+#include "cpu_pooling_inner_product_pd.hpp"
 #include "cpu_engine.hpp"
+#include "jit_avx2_gemm_f32.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
@@ -39,12 +41,16 @@ struct gemm_inner_product_fwd_t: public cpu_primitive_t {
         DECLARE_COMMON_PD_T(gemm_inner_product_fwd_t);
 
         virtual status_t init() override {
-#ifdef USE_CBLAS
             using namespace prop_kind;
             using namespace memory_format;
             using namespace utils;
             assert(engine()->kind() == engine_kind::cpu);
             bool ok = true
+#ifndef USE_CBLAS
+                /* the built-in sgemm */
+                && data_type == data_type::f32
+                && mayiuse(avx2)
+#endif
                 && this->set_default_params() == status::success
                 && one_of(desc()->prop_kind, forward_training,
                         forward_inference)
@@ -66,11 +72,14 @@ struct gemm_inner_product_fwd_t: public cpu_primitive_t {
                 && memory_desc_wrapper(dst_pd()).is_dense()
                 && memory_desc_wrapper(weights_pd()).is_dense();
             return ok ? status::success : status::unimplemented;
-#else
-            return status::unimplemented;
-#endif
         }
 
+#ifndef USE_CBLAS
+        virtual size_t scratchpad_size() const override {
+            return jit_avx2_gemm_f32::ws_size(OC(), MB(), IC_total());
+        }
+#endif
+
     protected:
         virtual status_t set_default_params() override {
             using namespace memory_format;
@@ -85,14 +94,22 @@ struct gemm_inner_product_fwd_t: public cpu_primitive_t {
 
     gemm_inner_product_fwd_t(const pd_t *pd, const input_vector &inputs,
             const output_vector &outputs)
-        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd) {}
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+        , sgemm_(nullptr)
+    {
+#ifndef USE_CBLAS
+        sgemm_ = new jit_avx2_gemm_f32(true, false, 0.0);
+#endif
+    }
+    ~gemm_inner_product_fwd_t() { delete sgemm_; }
     typedef typename prec_trait<data_type>::type data_t;
 
-    virtual void execute(event_t *e) {
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
         switch (conf_.desc()->prop_kind) {
         case prop_kind::forward_training:
         case prop_kind::forward_inference:
-            execute_forward();
+            execute_forward(scratchpad);
             break;
         default:
             assert(!"invalid prop_kind");
@@ -101,8 +118,107 @@ struct gemm_inner_product_fwd_t: public cpu_primitive_t {
     }
 
 private:
-    void execute_forward();
+    void execute_forward(char *scratchpad);
+    pd_t conf_;
+    jit_avx2_gemm_f32 *sgemm_;
+};
+
+/** global average pooling followed by inner product: the image is reduced
+ * to C averages per minibatch, which then go through the same gemm as in
+ * gemm_inner_product_fwd_t */
+template <impl::data_type_t data_type>
+struct gemm_pooling_inner_product_fwd_t: public cpu_primitive_t {
+    struct pd_t: public cpu_pooling_inner_product_fwd_pd_t {
+        pd_t(engine_t *engine, const pooling_inner_product_desc_t *adesc,
+                const pooling_inner_product_fwd_pd_t *hint_fwd_pd)
+            : cpu_pooling_inner_product_fwd_pd_t(engine, adesc, hint_fwd_pd)
+        {}
+
+        DECLARE_COMMON_PD_T(gemm_pooling_inner_product_fwd_t);
+
+        virtual status_t init() override {
+            using namespace memory_format;
+            using namespace utils;
+            assert(engine()->kind() == engine_kind::cpu);
+            bool ok = true
+#ifndef USE_CBLAS
+                /* the built-in sgemm */
+                && data_type == data_type::f32
+                && mayiuse(avx2)
+#endif
+                && this->set_default_params() == status::success
+                && this->is_global_avg()
+                && everyone_is(data_type, pdesc()->src_desc.data_type,
+                        ipdesc()->weights_desc.data_type,
+                        ipdesc()->dst_desc.data_type)
+                && implication(this->with_bias(),
+                        data_type == ipdesc()->bias_desc.data_type)
+                && true
+                && one_of(src_pd_.desc()->format, nchw, nhwc, nChw8c,
+                        nChw16c)
+                && implication(src_pd_.desc()->format == nChw8c,
+                        C() % 8 == 0)
+                && implication(src_pd_.desc()->format == nChw16c,
+                        C() % 16 == 0)
+                /* the weights are an OC x C matrix */
+                && (weights_pd_.desc()->format == oi
+                        || weights_pd_.desc()->format == oihw
+                        || (weights_pd_.desc()->format == oIhw8i
+                            && C() % 8 == 0))
+                && dst_pd_.desc()->format == nc
+                && true
+                && memory_desc_wrapper(src_pd()).is_dense()
+                && memory_desc_wrapper(dst_pd()).is_dense()
+                && memory_desc_wrapper(weights_pd()).is_dense();
+            return ok ? status::success : status::unimplemented;
+        }
+
+        /** the averages come first, followed by the sgemm workspace */
+        size_t pooled_size() const
+        { return utils::rnd_up(sizeof(data_t) * MB() * C(), 64); }
+
+        virtual size_t scratchpad_size() const override {
+            return pooled_size()
+#ifndef USE_CBLAS
+                + jit_avx2_gemm_f32::ws_size(OC(), MB(), C())
+#endif
+                ;
+        }
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (src_pd_.desc()->format == any)
+                CHECK(src_pd_.set_format(nChw8c));
+            if (weights_pd_.desc()->format == any && ip_ndims() == 4
+                    && src_pd_.desc()->format == nChw8c)
+                CHECK(weights_pd_.set_format(oIhw8i));
+            return cpu_pooling_inner_product_fwd_pd_t::set_default_params();
+        }
+    };
+
+    gemm_pooling_inner_product_fwd_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+        , sgemm_(nullptr)
+    {
+#ifndef USE_CBLAS
+        sgemm_ = new jit_avx2_gemm_f32(true, false, 0.0);
+#endif
+    }
+    ~gemm_pooling_inner_product_fwd_t() { delete sgemm_; }
+    typedef typename prec_trait<data_type>::type data_t;
+
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        execute_forward(scratchpad);
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_forward(char *scratchpad);
     pd_t conf_;
+    jit_avx2_gemm_f32 *sgemm_;
 };
 
 }
@@ -0,0 +1,400 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+#include "jit_avx2_1x1_conv_kernel_f32.hpp"
+
+#define GET_OFF(field) offsetof(jit_1x1_conv_call_s, field)
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::prop_kind;
+using namespace mkldnn::impl::memory_format;
+using namespace mkldnn::impl::utils;
+
+using Xbyak::Xmm;
+using Xbyak::Ymm;
+
+void jit_avx2_1x1_conv_kernel_f32::reduce_loop(int load_loop_blk, int ur,
+        char load_tag, char bcast_tag) {
+    /* accumulators take ymm0..ymm11, the load vectors ymm12..ymm14 and the
+     * broadcast ymm15 */
+    auto vreg_accum = [=](int i, int j) { return Ymm(j * load_loop_blk + i); };
+    auto vreg_load = [=](int i) { return Ymm(12 + i); };
+    const Ymm vreg_bcast = ymm15;
+
+    auto bcast_ptr = [=](int u, int j) {
+        return ptr[aux_reg_bcast_data + sizeof(float)
+            * (j * jcp.bcast_j_stride + u * jcp.bcast_u_stride)];
+    };
+    auto load_ptr = [=](int u, int i) {
+        return ptr[aux_reg_load_data + sizeof(float)
+            * (i * jcp.load_i_stride + u * jcp.oc_block)];
+    };
+    auto output_ptr = [=](int i, int j) {
+        return ptr[aux_reg_output_data + sizeof(float)
+            * (i * jcp.output_i_stride + j * jcp.oc_block)];
+    };
+
+    char init_first[16], init_done[16], reduce_loop[16], reduce_tail[16],
+         store[16];
+    snprintf(init_first, sizeof(init_first), ".if_%c%c", load_tag, bcast_tag);
+    snprintf(init_done, sizeof(init_done), ".id_%c%c", load_tag, bcast_tag);
+    snprintf(reduce_loop, sizeof(reduce_loop), ".rl_%c%c", load_tag,
+            bcast_tag);
+    snprintf(reduce_tail, sizeof(reduce_tail), ".rt_%c%c", load_tag,
+            bcast_tag);
+    snprintf(store, sizeof(store), ".st_%c%c", load_tag, bcast_tag);
+
+    mov(reg_reduce_pos_flag, ptr[param1 + GET_OFF(reduce_pos_flag)]);
+    test(reg_reduce_pos_flag, REDUCE_FLAG_FIRST);
+    jnz(init_first, T_NEAR);
+
+    for (int i = 0; i < load_loop_blk; ++i)
+        for (int j = 0; j < ur; ++j)
+            vmovups(vreg_accum(i, j), output_ptr(i, j));
+    jmp(init_done, T_NEAR);
+
+    L(init_first);
+    for (int i = 0; i < load_loop_blk; ++i) {
+        for (int j = 0; j < ur; ++j) {
+            if (jcp.with_bias)
+                vmovups(vreg_accum(i, j), ptr[reg_bias_data
+                        + sizeof(float) * i * jcp.oc_block]);
+            else
+                vxorps(vreg_accum(i, j), vreg_accum(i, j), vreg_accum(i, j));
+        }
+    }
+    L(init_done);
+
+    auto fma_block = [=](int unroll) {
+        for (int u = 0; u < unroll; ++u) {
+            for (int i = 0; i < load_loop_blk; ++i)
+                vmovups(vreg_load(i), load_ptr(u, i));
+            for (int j = 0; j < ur; ++j) {
+                vbroadcastss(vreg_bcast, bcast_ptr(u, j));
+                for (int i = 0; i < load_loop_blk; ++i)
+                    vfmadd231ps(vreg_accum(i, j), vreg_load(i), vreg_bcast);
+            }
+        }
+    };
+
+    mov(aux_reg_bcast_data, aux1_reg_bcast_data);
+    mov(aux_reg_load_data, reg_load_data);
+    mov(reduce_loop_iter, ptr[param1 + GET_OFF(reduce_dim)]);
+
+    L(reduce_loop);
+    {
+        cmp(reduce_loop_iter, jcp.reduce_loop_unroll);
+        jl(reduce_tail, T_NEAR);
+
+        fma_block(jcp.reduce_loop_unroll);
+        add(aux_reg_bcast_data, sizeof(float) * jcp.reduce_loop_bcast_step);
+        add(aux_reg_load_data, sizeof(float) * jcp.reduce_loop_load_step);
+
+        sub(reduce_loop_iter, jcp.reduce_loop_unroll);
+        jmp(reduce_loop, T_NEAR);
+    }
+
+    L(reduce_tail);
+    /* a call takes whole unrolls but for the last block of the reduce
+     * dimension, which is reduce_dim % unroll long */
+    const int reduce_loop_tail = jcp.reduce_dim % jcp.reduce_loop_unroll;
+    if (reduce_loop_tail != 0) {
+        cmp(reduce_loop_iter, 0);
+        jle(store, T_NEAR);
+        fma_block(reduce_loop_tail);
+    }
+
+    L(store);
+    if (jcp.with_relu) {
+        char store_done[16];
+        snprintf(store_done, sizeof(store_done), ".sd_%c%c", load_tag,
+                bcast_tag);
+
+        test(reg_reduce_pos_flag, REDUCE_FLAG_LAST);
+        jz(store_done, T_NEAR);
+
+        const Ymm yzero = ymm15, ymask = ymm14, yslope = ymm13, ytmp = ymm12;
+        float slope = (float)jcp.relu_negative_slope;
+        uint32_t slope_bits;
+        memcpy(&slope_bits, &slope, sizeof(slope));
+        mov(reg_tmp, slope_bits);
+        vmovq(Xmm(yslope.getIdx()), reg_tmp);
+        vbroadcastss(yslope, Xmm(yslope.getIdx()));
+        vxorps(yzero, yzero, yzero);
+
+        for (int i = 0; i < load_loop_blk; ++i) {
+            for (int j = 0; j < ur; ++j) {
+                const Ymm acc = vreg_accum(i, j);
+                vcmpgtps(ymask, acc, yzero);
+                vmulps(ytmp, acc, yslope);
+                vblendvps(acc, ytmp, acc, ymask);
+            }
+        }
+        L(store_done);
+    }
+
+    for (int i = 0; i < load_loop_blk; ++i)
+        for (int j = 0; j < ur; ++j)
+            vmovups(output_ptr(i, j), vreg_accum(i, j));
+}
+
+void jit_avx2_1x1_conv_kernel_f32::bcast_loop(int load_loop_blk,
+        char load_tag) {
+    char bcast_loop[16], bcast_loop_tail[16];
+    snprintf(bcast_loop, sizeof(bcast_loop), ".bl_%c", load_tag);
+    snprintf(bcast_loop_tail, sizeof(bcast_loop_tail), ".bt_%c", load_tag);
+
+    mov(aux1_reg_bcast_data, reg_bcast_data);
+    mov(aux_reg_output_data, reg_output_data);
+    mov(bcast_loop_iter, ptr[param1 + GET_OFF(bcast_dim)]);
+
+    L(bcast_loop);
+    {
+        cmp(bcast_loop_iter, jcp.ur);
+        jl(bcast_loop_tail, T_NEAR);
+
+        reduce_loop(load_loop_blk, jcp.ur, load_tag, 'u');
+        add(aux1_reg_bcast_data, sizeof(float) * jcp.ur * jcp.bcast_j_stride);
+        add(aux_reg_output_data, sizeof(float) * jcp.ur * jcp.oc_block);
+
+        sub(bcast_loop_iter, jcp.ur);
+        jmp(bcast_loop, T_NEAR);
+    }
+
+    L(bcast_loop_tail);
+    if (jcp.ur_tail != 0) {
+        char bcast_loop_done[16];
+        snprintf(bcast_loop_done, sizeof(bcast_loop_done), ".bd_%c",
+                load_tag);
+        cmp(bcast_loop_iter, 0);
+        jle(bcast_loop_done, T_NEAR);
+        reduce_loop(load_loop_blk, jcp.ur_tail, load_tag, 't');
+        L(bcast_loop_done);
+    }
+}
+
+void jit_avx2_1x1_conv_kernel_f32::generate() {
+    preamble();
+
+    mov(reg_bcast_data, ptr[param1 + GET_OFF(bcast_data)]);
+    mov(reg_load_data, ptr[param1 + GET_OFF(load_data)]);
+    mov(reg_output_data, ptr[param1 + GET_OFF(output_data)]);
+    if (jcp.with_bias)
+        mov(reg_bias_data, ptr[param1 + GET_OFF(bias_data)]);
+    mov(reg_load_loop_work, ptr[param1 + GET_OFF(load_dim)]);
+
+    auto load_loop_body = [=](int load_loop_blk, char load_tag) {
+        bcast_loop(load_loop_blk, load_tag);
+        add(reg_load_data, sizeof(float) * load_loop_blk * jcp.load_i_stride);
+        add(reg_output_data,
+                sizeof(float) * load_loop_blk * jcp.output_i_stride);
+        if (jcp.with_bias)
+            add(reg_bias_data, sizeof(float) * load_loop_blk * jcp.oc_block);
+        sub(reg_load_loop_work, load_loop_blk * jcp.oc_block);
+    };
+
+    const int simd_w = jcp.oc_block;
+
+    L(".load_loop_3");
+    {
+        cmp(reg_load_loop_work, 2 * simd_w);
+        jle(".load_loop_2", T_NEAR);
+        load_loop_body(3, '3');
+        jmp(".load_loop_3", T_NEAR);
+    }
+
+    L(".load_loop_2");
+    cmp(reg_load_loop_work, simd_w);
+    jle(".load_loop_1", T_NEAR);
+    load_loop_body(2, '2');
+    jmp(".load_loop_done", T_NEAR);
+
+    L(".load_loop_1");
+    cmp(reg_load_loop_work, 0);
+    jle(".load_loop_done", T_NEAR);
+    load_loop_body(1, '1');
+
+    L(".load_loop_done");
+
+    postamble();
+}
+
+status_t jit_avx2_1x1_conv_kernel_f32::init_conf(jit_1x1_conv_conf_t &jcp,
+        const convolution_desc_t &cd, const memory_desc_wrapper &src_d,
+        const memory_desc_wrapper &weights_d, const memory_desc_wrapper &dst_d,
+        bool with_relu, double relu_negative_slope)
+{
+    memset(&jcp, 0, sizeof(jcp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
+    const bool with_groups = weights_d.ndims() == src_d.ndims() + 1;
+
+    jcp.prop_kind = cd.prop_kind;
+
+    jcp.ngroups = with_groups ? weights_d.dims()[0] : 1;
+    jcp.mb = src_d.dims()[0];
+
+    jcp.oc = dst_d.dims()[1] / jcp.ngroups;
+    jcp.ic = src_d.dims()[1] / jcp.ngroups;
+
+    jcp.ih = src_d.dims()[2];
+    jcp.iw = src_d.dims()[3];
+    jcp.oh = dst_d.dims()[2];
+    jcp.ow = dst_d.dims()[3];
+
+    jcp.kh = weights_d.dims()[with_groups + 2];
+    jcp.kw = weights_d.dims()[with_groups + 3];
+
+    jcp.t_pad = cd.padding[0][0];
+    jcp.l_pad = cd.padding[0][1];
+
+    jcp.stride_h = cd.strides[0];
+    jcp.stride_w = cd.strides[1];
+
+    /* the diff bias is not computed by the kernel */
+    jcp.with_bias = one_of(jcp.prop_kind, forward_training, forward_inference)
+        && cd.bias_desc.format != memory_format::undef;
+    jcp.with_relu = with_relu;
+    jcp.relu_negative_slope = relu_negative_slope;
+
+    jcp.os = jcp.oh * jcp.ow;
+    jcp.is = jcp.ih * jcp.iw;
+
+    const int simd_w = 8;
+
+    const bool is_bwd_w = jcp.prop_kind == backward_weights;
+    const bool w_8i8o = weights_d.format()
+        == (with_groups ? gOIhw8i8o : OIhw8i8o);
+    const bool w_8o8i = weights_d.format()
+        == (with_groups ? gOIhw8o8i : OIhw8o8i);
+
+    bool args_ok = true
+        && jcp.kh == 1 && jcp.kw == 1
+        && jcp.stride_h == 1 && jcp.stride_w == 1
+        && jcp.t_pad == 0 && jcp.l_pad == 0
+        && jcp.ih == jcp.oh && jcp.iw == jcp.ow
+        && jcp.ic % simd_w == 0 && jcp.oc % simd_w == 0
+        && src_d.format() == nChw8c && dst_d.format() == nChw8c
+        && implication(one_of(jcp.prop_kind, forward_training,
+                    forward_inference), w_8i8o)
+        && implication(jcp.prop_kind == backward_data, w_8o8i)
+        && implication(is_bwd_w, w_8i8o || w_8o8i)
+        && one_of(cd.bias_desc.format, memory_format::undef, any, x)
+        && implication(with_relu, relu_negative_slope >= 0
+                && relu_negative_slope <= 1);
+    if (!args_ok) return status::unimplemented;
+
+    jcp.ic_block = jcp.oc_block = simd_w;
+    jcp.ur = 4;
+
+    /* the bcast data of a call is reused for all the load vectors, hence it
+     * should stay in L2; the load data of a call and a triple of vectors is
+     * reused for all the bcast rows, hence it should stay in L1 */
+    const int L1_capacity = 24 * 1024 / sizeof(float);
+    const int L2_capacity = 128 * 1024 / sizeof(float);
+
+    switch (jcp.prop_kind) {
+    case forward_training:
+    case forward_inference:
+    case backward_data: {
+        const bool is_fwd = jcp.prop_kind != backward_data;
+        jcp.bcast_dim = jcp.os;
+        jcp.reduce_dim = is_fwd ? jcp.ic : jcp.oc;
+        jcp.load_dim = is_fwd ? jcp.oc : jcp.ic;
+
+        jcp.reduce_loop_unroll = simd_w;
+        jcp.bcast_j_stride = simd_w;
+        jcp.bcast_u_stride = 1;
+        jcp.reduce_loop_bcast_step = jcp.os * simd_w;
+        if (is_fwd) {
+            jcp.load_i_stride = jcp.ic * simd_w;
+            jcp.reduce_loop_load_step = simd_w * simd_w;
+        } else {
+            jcp.load_i_stride = simd_w * simd_w;
+            jcp.reduce_loop_load_step = jcp.ic * simd_w;
+        }
+        jcp.output_i_stride = jcp.os * simd_w;
+
+        const int max_reduce = L1_capacity / (3 * simd_w);
+        const int nb_reduce = div_up(jcp.reduce_dim, max_reduce);
+        jcp.reduce_block = rnd_up(div_up(jcp.reduce_dim, nb_reduce), simd_w);
+
+        jcp.bcast_block = nstl::max(jcp.ur,
+                L2_capacity / jcp.reduce_block / jcp.ur * jcp.ur);
+        if (jcp.bcast_block >= jcp.bcast_dim) jcp.bcast_block = jcp.bcast_dim;
+
+        const int max_load_blocks = 12;
+        const int nb_load = div_up(jcp.load_dim, max_load_blocks * simd_w);
+        jcp.load_block = rnd_up(div_up(jcp.load_dim, nb_load), simd_w);
+        break;
+    }
+    case backward_weights: {
+        /* the output is a block of 8x8 weights per (bcast, load) pair: with
+         * OIhw8i8o the rows are ic and the vectors oc, with OIhw8o8i it is
+         * the other way round. the reduction goes over the pixels */
+        jcp.bcast_dim = w_8i8o ? jcp.ic : jcp.oc;
+        jcp.load_dim = w_8i8o ? jcp.oc : jcp.ic;
+        jcp.reduce_dim = jcp.os;
+
+        jcp.reduce_loop_unroll = simd_w;
+        jcp.bcast_j_stride = 1;
+        jcp.bcast_u_stride = simd_w;
+        jcp.reduce_loop_bcast_step = jcp.reduce_loop_unroll * simd_w;
+        jcp.load_i_stride = jcp.os * simd_w;
+        jcp.reduce_loop_load_step = jcp.reduce_loop_unroll * simd_w;
+        jcp.output_i_stride = w_8i8o ? jcp.ic * simd_w : simd_w * simd_w;
+
+        jcp.bcast_block = simd_w;
+
+        const int max_load_blocks = 12;
+        const int nb_load = div_up(jcp.load_dim, max_load_blocks * simd_w);
+        jcp.load_block = rnd_up(div_up(jcp.load_dim, nb_load), simd_w);
+
+        jcp.reduce_block = nstl::max(jcp.reduce_loop_unroll,
+                L2_capacity / (jcp.load_block + simd_w)
+                / jcp.reduce_loop_unroll * jcp.reduce_loop_unroll);
+        if (jcp.reduce_block >= jcp.reduce_dim)
+            jcp.reduce_block = jcp.reduce_dim;
+        break;
+    }
+    default:
+        return status::unimplemented;
+    }
+
+    jcp.ur_tail = jcp.bcast_dim % jcp.ur;
+    jcp.nb_bcast = div_up(jcp.bcast_dim, jcp.bcast_block);
+    jcp.nb_load = div_up(jcp.load_dim, jcp.load_block);
+    jcp.nb_reduce = div_up(jcp.reduce_dim, jcp.reduce_block);
+
+    return status::success;
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -0,0 +1,86 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef JIT_AVX2_1x1_CONV_KERNEL_F32_HPP
+#define JIT_AVX2_1x1_CONV_KERNEL_F32_HPP
+
+#include "c_types_map.hpp"
+#include "jit_generator.hpp"
+#include "jit_primitive_conf.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/** 1x1 convolution with unit strides and no padding on nChw8c
+ *
+ * the spatial dimension is flat, so each direction is a gemm: forward
+ * broadcasts the src pixels against the oc vectors of the weights, backward
+ * data the diff_dst pixels against the ic vectors, and backward weights
+ * reduces over the pixels. the kernel loops over the load vectors by 3, the
+ * bcast rows by ur and the reduce dimension innermost */
+struct jit_avx2_1x1_conv_kernel_f32: public jit_generator {
+    enum { REDUCE_FLAG_FIRST = 1, REDUCE_FLAG_LAST = 2 };
+
+    jit_avx2_1x1_conv_kernel_f32(jit_1x1_conv_conf_t ajcp,
+            void *code_ptr = nullptr,
+            size_t code_size = 8 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jcp(ajcp)
+    {
+        this->generate();
+        jit_ker = (void (*)(jit_1x1_conv_call_s *))this->getCode();
+    }
+
+    /** @p src_d, @p weights_d and @p dst_d are the (diff) memories of the
+     * direction given by cd.prop_kind */
+    static status_t init_conf(jit_1x1_conv_conf_t &jcp,
+            const convolution_desc_t &cd, const memory_desc_wrapper &src_d,
+            const memory_desc_wrapper &weights_d,
+            const memory_desc_wrapper &dst_d, bool with_relu = false,
+            double relu_negative_slope = 0.);
+
+    jit_1x1_conv_conf_t jcp;
+    void (*jit_ker)(jit_1x1_conv_call_s *);
+
+private:
+    using reg64_t = const Xbyak::Reg64;
+    reg64_t reg_bcast_data = r8;
+    reg64_t reg_load_data = r9;
+    reg64_t reg_output_data = r10;
+    reg64_t reg_bias_data = r11;
+    reg64_t aux1_reg_bcast_data = rbx;
+    reg64_t aux_reg_bcast_data = rdx;
+    reg64_t aux_reg_load_data = rsi;
+    reg64_t aux_reg_output_data = rbp;
+    reg64_t reg_load_loop_work = r12;
+    reg64_t bcast_loop_iter = r13;
+    reg64_t reduce_loop_iter = r14;
+    reg64_t reg_tmp = r15;
+    reg64_t reg_reduce_pos_flag = rax;
+
+    void reduce_loop(int load_loop_blk, int ur, char load_tag, char bcast_tag);
+    void bcast_loop(int load_loop_blk, char load_tag);
+
+    void generate();
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
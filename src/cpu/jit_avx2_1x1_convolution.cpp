@@ -0,0 +1,239 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "mkldnn_types.h"
+
+#include "c_types_map.hpp"
+#include "jit_avx2_1x1_convolution.hpp"
+#include "type_helpers.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::status;
+using namespace mkldnn::impl::memory_format;
+
+#define REDUCE_FLAG_FIRST jit_avx2_1x1_conv_kernel_f32::REDUCE_FLAG_FIRST
+#define REDUCE_FLAG_LAST jit_avx2_1x1_conv_kernel_f32::REDUCE_FLAG_LAST
+
+template <bool with_relu>
+void _jit_avx2_1x1_convolution_fwd_t<with_relu>::execute_forward() {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
+    auto dst = reinterpret_cast<data_t *>(this->memory());
+
+    const memory_desc_wrapper src_d(conf_.src_pd());
+    const memory_desc_wrapper dst_d(conf_.dst_pd());
+    const memory_desc_wrapper weights_d(conf_.weights_pd(0));
+    const memory_desc_wrapper bias_d(conf_.weights_pd(1));
+
+    const auto &jcp = kernel_->jcp;
+    const int nb_ic = jcp.ic / jcp.ic_block;
+    const int nb_oc = jcp.oc / jcp.oc_block;
+
+    auto ker = [&](int g, int n, int bcast, int load) {
+        jit_1x1_conv_call_s p = {};
+
+        const int os = bcast * jcp.bcast_block;
+        const int ocb = load * jcp.load_block / jcp.oc_block;
+        p.bcast_dim = nstl::min(jcp.bcast_block, jcp.bcast_dim - os);
+        p.load_dim = nstl::min(jcp.load_block,
+                jcp.load_dim - load * jcp.load_block);
+
+        p.output_data = &dst[dst_d.blk_off(n, g * nb_oc + ocb, 0, 0)
+            + os * jcp.oc_block];
+        if (bias)
+            p.bias_data = &bias[bias_d.blk_off(
+                    (g * nb_oc + ocb) * jcp.oc_block)];
+
+        for (int r = 0; r < jcp.nb_reduce; ++r) {
+            const int icb = r * jcp.reduce_block / jcp.ic_block;
+            p.reduce_dim = nstl::min(jcp.reduce_block,
+                    jcp.reduce_dim - r * jcp.reduce_block);
+            p.reduce_pos_flag = 0
+                | (r == 0 ? REDUCE_FLAG_FIRST : 0)
+                | (r == jcp.nb_reduce - 1 ? REDUCE_FLAG_LAST : 0);
+
+            p.bcast_data = &src[src_d.blk_off(n, g * nb_ic + icb, 0, 0)
+                + os * jcp.ic_block];
+            p.load_data = &weights[conf_.with_groups()
+                ? weights_d.blk_off(g, ocb, icb, 0, 0)
+                : weights_d.blk_off(ocb, icb, 0, 0)];
+
+            kernel_->jit_ker(&p);
+        }
+    };
+
+#   pragma omp parallel for collapse(4) schedule(static)
+    for (int g = 0; g < jcp.ngroups; ++g) {
+        for (int n = 0; n < jcp.mb; ++n) {
+            for (int bcast = 0; bcast < jcp.nb_bcast; ++bcast) {
+                for (int load = 0; load < jcp.nb_load; ++load) {
+                    ker(g, n, bcast, load);
+                }
+            }
+        }
+    }
+}
+
+template void _jit_avx2_1x1_convolution_fwd_t<true>::execute_forward();
+template void _jit_avx2_1x1_convolution_fwd_t<false>::execute_forward();
+
+void jit_avx2_1x1_convolution_bwd_data_t::execute_backward_data() {
+    auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto diff_src = reinterpret_cast<data_t *>(this->memory());
+
+    const memory_desc_wrapper diff_dst_d(conf_.diff_dst_pd());
+    const memory_desc_wrapper weights_d(conf_.weights_pd(0));
+    const memory_desc_wrapper diff_src_d(conf_.diff_src_pd());
+
+    const auto &jcp = kernel_->jcp;
+    const int nb_ic = jcp.ic / jcp.ic_block;
+    const int nb_oc = jcp.oc / jcp.oc_block;
+
+    auto ker = [&](int g, int n, int bcast, int load) {
+        jit_1x1_conv_call_s p = {};
+
+        const int is = bcast * jcp.bcast_block;
+        const int icb = load * jcp.load_block / jcp.ic_block;
+        p.bcast_dim = nstl::min(jcp.bcast_block, jcp.bcast_dim - is);
+        p.load_dim = nstl::min(jcp.load_block,
+                jcp.load_dim - load * jcp.load_block);
+
+        p.output_data = &diff_src[diff_src_d.blk_off(n, g * nb_ic + icb, 0, 0)
+            + is * jcp.ic_block];
+
+        for (int r = 0; r < jcp.nb_reduce; ++r) {
+            const int ocb = r * jcp.reduce_block / jcp.oc_block;
+            p.reduce_dim = nstl::min(jcp.reduce_block,
+                    jcp.reduce_dim - r * jcp.reduce_block);
+            p.reduce_pos_flag = 0
+                | (r == 0 ? REDUCE_FLAG_FIRST : 0)
+                | (r == jcp.nb_reduce - 1 ? REDUCE_FLAG_LAST : 0);
+
+            p.bcast_data = &diff_dst[diff_dst_d.blk_off(n, g * nb_oc + ocb,
+                    0, 0) + is * jcp.oc_block];
+            p.load_data = &weights[conf_.with_groups()
+                ? weights_d.blk_off(g, ocb, icb, 0, 0)
+                : weights_d.blk_off(ocb, icb, 0, 0)];
+
+            kernel_->jit_ker(&p);
+        }
+    };
+
+#   pragma omp parallel for collapse(4) schedule(static)
+    for (int g = 0; g < jcp.ngroups; ++g) {
+        for (int n = 0; n < jcp.mb; ++n) {
+            for (int bcast = 0; bcast < jcp.nb_bcast; ++bcast) {
+                for (int load = 0; load < jcp.nb_load; ++load) {
+                    ker(g, n, bcast, load);
+                }
+            }
+        }
+    }
+}
+
+void jit_avx2_1x1_convolution_bwd_weights_t::execute_backward_weights() {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto diff_weights = reinterpret_cast<data_t *>(this->memory(0));
+    auto diff_bias = reinterpret_cast<data_t *>(this->memory(1));
+
+    const memory_desc_wrapper src_d(conf_.src_pd(0));
+    const memory_desc_wrapper diff_dst_d(conf_.diff_dst_pd());
+    const memory_desc_wrapper diff_weights_d(conf_.diff_weights_pd(0));
+    const memory_desc_wrapper diff_bias_d(conf_.diff_weights_pd(1));
+
+    const auto &jcp = kernel_->jcp;
+    const int nb_ic = jcp.ic / jcp.ic_block;
+    const int nb_oc = jcp.oc / jcp.oc_block;
+
+    /* with OIhw8i8o the kernel broadcasts src against the vectors of
+     * diff_dst, with OIhw8o8i the other way round */
+    const bool w_8i8o = utils::one_of(diff_weights_d.format(), OIhw8i8o,
+            gOIhw8i8o);
+
+    auto ker = [&](int g, int bcast, int load) {
+        jit_1x1_conv_call_s p = {};
+
+        const int bcast_cb = bcast * jcp.bcast_block / jcp.ic_block;
+        const int load_cb = load * jcp.load_block / jcp.oc_block;
+        const int icb = w_8i8o ? bcast_cb : load_cb;
+        const int ocb = w_8i8o ? load_cb : bcast_cb;
+
+        p.bcast_dim = jcp.bcast_block;
+        p.load_dim = nstl::min(jcp.load_block,
+                jcp.load_dim - load * jcp.load_block);
+        p.output_data = &diff_weights[conf_.with_groups()
+            ? diff_weights_d.blk_off(g, ocb, icb, 0, 0)
+            : diff_weights_d.blk_off(ocb, icb, 0, 0)];
+
+        for (int n = 0; n < jcp.mb; ++n) {
+            const data_t *s = &src[src_d.blk_off(n, g * nb_ic + icb, 0, 0)];
+            const data_t *d = &diff_dst[diff_dst_d.blk_off(n, g * nb_oc + ocb,
+                    0, 0)];
+            for (int r = 0; r < jcp.nb_reduce; ++r) {
+                const int sp = r * jcp.reduce_block;
+                p.reduce_dim = nstl::min(jcp.reduce_block,
+                        jcp.reduce_dim - sp);
+                p.reduce_pos_flag = n == 0 && r == 0 ? REDUCE_FLAG_FIRST : 0;
+                p.bcast_data = (w_8i8o ? s : d) + sp * jcp.ic_block;
+                p.load_data = (w_8i8o ? d : s) + sp * jcp.oc_block;
+
+                kernel_->jit_ker(&p);
+            }
+        }
+    };
+
+#   pragma omp parallel for collapse(2) schedule(static)
+    for (int g = 0; g < jcp.ngroups; ++g) {
+        for (int bcast = 0; bcast < jcp.nb_bcast; ++bcast) {
+            for (int load = 0; load < jcp.nb_load; ++load) {
+                ker(g, bcast, load);
+            }
+        }
+    }
+
+    if (diff_bias) {
+        const int simd_w = jcp.oc_block;
+
+#       pragma omp parallel for collapse(2) schedule(static)
+        for (int g = 0; g < jcp.ngroups; ++g) {
+            for (int ocb = 0; ocb < nb_oc; ++ocb) {
+                auto db = &diff_bias[diff_bias_d.blk_off(
+                        (g * nb_oc + ocb) * simd_w)];
+                for (int c = 0; c < simd_w; ++c) db[c] = 0;
+
+                for (int n = 0; n < jcp.mb; ++n) {
+                    auto dd = &diff_dst[diff_dst_d.blk_off(n, g * nb_oc + ocb,
+                            0, 0)];
+                    for (int sp = 0; sp < jcp.os; ++sp)
+                        for (int c = 0; c < simd_w; ++c)
+                            db[c] += dd[sp * simd_w + c];
+                }
+            }
+        }
+    }
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
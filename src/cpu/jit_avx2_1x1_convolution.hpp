@@ -0,0 +1,255 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_JIT_AVX2_1x1_CONVOLUTION_HPP
+#define CPU_JIT_AVX2_1x1_CONVOLUTION_HPP
+
+#include "c_types_map.hpp"
+#include "cpu_convolution_pd.hpp"
+#include "cpu_engine.hpp"
+#include "jit_avx2_1x1_conv_kernel_f32.hpp"
+#include "jit_kernel_cache.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+template <bool with_relu>
+struct _jit_avx2_1x1_convolution_fwd_t: public cpu_primitive_t {
+    struct pd_t: public _cpu_convolution_fwd_pd_t<with_relu> {
+        pd_t(engine_t *engine,
+                const typename pd_t::base_desc_t *adesc,
+                const typename pd_t::base_class *hint_fwd_pd)
+            : _cpu_convolution_fwd_pd_t<with_relu>(engine, adesc, hint_fwd_pd)
+            , jcp_({}) {}
+
+        DECLARE_COMMON_PD_T(_jit_avx2_1x1_convolution_fwd_t<with_relu>);
+
+        virtual status_t init() override {
+            using namespace prop_kind;
+            assert(this->engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && this->set_default_params() == status::success
+                && utils::one_of(this->cdesc_().prop_kind, forward_training,
+                        forward_inference)
+                && utils::implication(
+                        this->base_pkind == primitive_kind::convolution_relu,
+                        this->cdesc_().prop_kind == forward_inference)
+                && this->cdesc_().alg_kind == alg_kind::convolution_direct
+                && utils::everyone_is(data_type::f32,
+                        this->cdesc_().src_desc.data_type,
+                        this->cdesc_().weights_desc.data_type,
+                        this->cdesc_().dst_desc.data_type)
+                && utils::implication(this->with_bias(),
+                        data_type::f32 == this->cdesc_().bias_desc.data_type);
+            if (!ok) return status::unimplemented;
+
+            return jit_avx2_1x1_conv_kernel_f32::init_conf(jcp_,
+                    this->cdesc_(), *this->src_pd_.desc(),
+                    *this->weights_pd_.desc(), *this->dst_pd_.desc(),
+                    with_relu, this->negative_slope());
+        }
+
+        jit_1x1_conv_conf_t jcp_;
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (this->src_pd_.desc()->format == any)
+                CHECK(this->src_pd_.set_format(nChw8c));
+            if (this->dst_pd_.desc()->format == any)
+                CHECK(this->dst_pd_.set_format(nChw8c));
+            if (this->weights_pd_.desc()->format == any)
+                CHECK(this->weights_pd_.set_format(this->with_groups()
+                            ? gOIhw8i8o : OIhw8i8o));
+            if (this->bias_pd_.desc()->format == any)
+                CHECK(this->bias_pd_.set_format(x));
+            return status::success;
+        }
+    };
+
+    _jit_avx2_1x1_convolution_fwd_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_1x1_conv_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~_jit_avx2_1x1_convolution_fwd_t()
+    { jit_kernel_cache_t::release(kernel_); }
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) {
+        execute_forward();
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_forward();
+    pd_t conf_;
+    jit_avx2_1x1_conv_kernel_f32 *kernel_;
+};
+
+using jit_avx2_1x1_convolution_fwd_t = _jit_avx2_1x1_convolution_fwd_t<false>;
+using jit_avx2_1x1_convolution_relu_t = _jit_avx2_1x1_convolution_fwd_t<true>;
+
+struct jit_avx2_1x1_convolution_bwd_data_t: public cpu_primitive_t {
+    struct pd_t: public cpu_convolution_bwd_data_pd_t {
+        pd_t(engine_t *engine,
+                const convolution_desc_t *adesc,
+                const convolution_fwd_pd_t *hint_fwd_pd)
+            : cpu_convolution_bwd_data_pd_t(engine, adesc, hint_fwd_pd)
+            , jcp_({})
+        {}
+
+        DECLARE_COMMON_PD_T(jit_avx2_1x1_convolution_bwd_data_t);
+
+        virtual status_t init() override {
+            using namespace prop_kind;
+            assert(this->engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && this->set_default_params() == status::success
+                && this->desc()->prop_kind == backward_data
+                && this->desc()->alg_kind == alg_kind::convolution_direct
+                && utils::everyone_is(data_type::f32,
+                        this->desc()->diff_src_desc.data_type,
+                        this->desc()->weights_desc.data_type,
+                        this->desc()->diff_dst_desc.data_type);
+            if (!ok) return status::unimplemented;
+
+            return jit_avx2_1x1_conv_kernel_f32::init_conf(jcp_,
+                    *this->desc(), *this->diff_src_pd_.desc(),
+                    *this->weights_pd_.desc(), *this->diff_dst_pd_.desc());
+        }
+
+        jit_1x1_conv_conf_t jcp_;
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (this->diff_src_pd_.desc()->format == any)
+                CHECK(this->diff_src_pd_.set_format(nChw8c));
+            if (this->diff_dst_pd_.desc()->format == any)
+                CHECK(this->diff_dst_pd_.set_format(nChw8c));
+            if (this->weights_pd_.desc()->format == any)
+                CHECK(this->weights_pd_.set_format(this->with_groups()
+                            ? gOIhw8o8i : OIhw8o8i));
+            return status::success;
+        }
+    };
+
+    jit_avx2_1x1_convolution_bwd_data_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_1x1_conv_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~jit_avx2_1x1_convolution_bwd_data_t()
+    { jit_kernel_cache_t::release(kernel_); }
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) {
+        switch (conf_.desc()->prop_kind) {
+        case prop_kind::backward_data:
+            execute_backward_data();
+            break;
+        default:
+            assert(!"invalid prop_kind");
+        }
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_backward_data();
+    pd_t conf_;
+    jit_avx2_1x1_conv_kernel_f32 *kernel_;
+};
+
+struct jit_avx2_1x1_convolution_bwd_weights_t: public cpu_primitive_t {
+    struct pd_t: public cpu_convolution_bwd_weights_pd_t {
+        pd_t(engine_t *engine, const convolution_desc_t *adesc,
+                const convolution_fwd_pd_t *hint_fwd_pd)
+            : cpu_convolution_bwd_weights_pd_t(engine, adesc, hint_fwd_pd)
+            , jcp_({}) {}
+
+        DECLARE_COMMON_PD_T(jit_avx2_1x1_convolution_bwd_weights_t);
+
+        virtual status_t init() override {
+            assert(this->engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && this->set_default_params() == status::success
+                && this->desc()->prop_kind == prop_kind::backward_weights
+                && this->desc()->alg_kind == alg_kind::convolution_direct
+                && utils::everyone_is(data_type::f32,
+                        this->desc()->src_desc.data_type,
+                        this->desc()->diff_dst_desc.data_type,
+                        this->desc()->diff_weights_desc.data_type);
+            if (!ok) return status::unimplemented;
+
+            return jit_avx2_1x1_conv_kernel_f32::init_conf(jcp_,
+                    *this->desc(), *this->src_pd_.desc(),
+                    *this->diff_weights_pd_.desc(),
+                    *this->diff_dst_pd_.desc());
+        }
+
+        jit_1x1_conv_conf_t jcp_;
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (this->src_pd_.desc()->format == any)
+                CHECK(this->src_pd_.set_format(nChw8c));
+            if (this->diff_dst_pd_.desc()->format == any)
+                CHECK(this->diff_dst_pd_.set_format(nChw8c));
+            if (this->diff_weights_pd_.desc()->format == any)
+                CHECK(this->diff_weights_pd_.set_format(this->with_groups()
+                            ? gOIhw8i8o : OIhw8i8o));
+            if (this->diff_bias_pd_.desc()->format == any)
+                CHECK(this->diff_bias_pd_.set_format(x));
+            return status::success;
+        }
+    };
+
+    jit_avx2_1x1_convolution_bwd_weights_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_1x1_conv_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~jit_avx2_1x1_convolution_bwd_weights_t()
+    { jit_kernel_cache_t::release(kernel_); }
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) {
+        execute_backward_weights();
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_backward_weights();
+    pd_t conf_;
+    jit_avx2_1x1_conv_kernel_f32 *kernel_;
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
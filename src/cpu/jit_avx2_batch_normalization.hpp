@@ -22,6 +22,7 @@
 #include "c_types_map.hpp"
 #include "cpu_batch_normalization_pd.hpp"
 #include "jit_avx2_bnrm_kernel_f32.hpp"
+#include "jit_kernel_cache.hpp"
 #include "cpu_engine.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
@@ -69,7 +70,12 @@ struct jit_avx2_batch_normalization_fwd_t: public cpu_primitive_t {
     jit_avx2_batch_normalization_fwd_t(const pd_t *pd,
             const input_vector &inputs, const output_vector &outputs)
         : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
-    { kernel_ = new jit_avx2_bnrm_kernel_f32(conf_.jbp_); }
+    {
+        kernel_ = jit_kernel_cache_t::get<jit_avx2_bnrm_kernel_f32>(
+                conf_.jbp_, conf_.jbp_);
+    }
+    ~jit_avx2_batch_normalization_fwd_t()
+    { jit_kernel_cache_t::release(kernel_); }
     typedef typename prec_trait<data_type::f32>::type data_t;
 
     virtual void execute(event_t *e) {
@@ -14,6 +14,8 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <string.h>
+
 #include "c_types_map.hpp"
 #include "nstl.hpp"
 #include "type_helpers.hpp"
@@ -28,10 +30,14 @@ status_t jit_avx2_bnrm_kernel_f32::init_conf(jit_bnrm_conf_t &jbp,
         const batch_normalization_desc_t &bnd,
         const memory_desc_wrapper &data_d,
         const memory_desc_wrapper &scaleshift_d, bool is_training) {
+    memset(&jbp, 0, sizeof(jbp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
     bool args_ok = (data_d.format() == memory_format::nChw8c ||
             ( data_d.format() == memory_format::nchw
               && data_d.dims()[2] == 1 && data_d.dims()[3] == 1))
-        && scaleshift_d.format() == memory_format::nc;
+        && scaleshift_d.format() == memory_format::nc
+        && data_d.dims()[1] % 8 == 0; /* no padded channels so far */
     if (!args_ok) return status::unimplemented;
 
     jbp.mb = data_d.dims()[0];
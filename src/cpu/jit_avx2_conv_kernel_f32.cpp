@@ -14,6 +14,9 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <string.h>
+#include <string>
+
 #include "c_types_map.hpp"
 #include "nstl.hpp"
 #include "type_helpers.hpp"
@@ -30,6 +33,13 @@ namespace cpu {
 using namespace mkldnn::impl::memory_format;
 using namespace mkldnn::impl::utils;
 
+namespace {
+/* the capacity of L2 in floats, a guess if its size is not reported */
+int l2_capacity() {
+    static const size_t l2_size = get_cache_size(2);
+    return (int)((l2_size != 0 ? l2_size : 256 * 1024) / sizeof(float));
+}
+}
 
 void jit_avx2_conv_fwd_kernel_f32::oh_step_unroll_kw(int ur_w, int pad_l,
         int pad_r) {
@@ -159,26 +169,42 @@ void jit_avx2_conv_fwd_kernel_f32::width_blk_step(int ur_w, int pad_l, int pad_r
 
     L(init_done_label);
 
-    mov(aux_reg_input, reg_input);
-    mov(aux_reg_kernel, reg_kernel);
+    /* the accumulators stay in registers over nb_ic_blocking ic blocks */
+    mov(aux1_reg_input, reg_input);
+    mov(aux1_reg_kernel, reg_kernel);
 
-    mov(kj, reg_kh);
-    char kh_label[4] = {'.', 'h', pad_label, '\0'};
-    L(kh_label);
+    mov(ic_iter, jcp.nb_ic_blocking);
+    char ic_label[4] = {'.', 'c', pad_label, '\0'};
+    L(ic_label);
     {
-        if (jcp.kw >= 5 && pad_l == 0 && pad_r == 0) {
-            oh_step_nopad(ur_w, pad_l, pad_r, pad_label);
-            sub(aux_reg_input, sizeof(float) * kw * inp_mult);
-            add(aux_reg_input, sizeof(float) * iw * inp_mult);
-        } else {
-            oh_step_unroll_kw(ur_w, pad_l, pad_r);
-            add(aux_reg_kernel, sizeof(float) * kw * oc_blk * ic_blk);
-            add(aux_reg_input, sizeof(float) * iw * inp_mult);
+        mov(aux_reg_input, aux1_reg_input);
+        mov(aux_reg_kernel, aux1_reg_kernel);
+
+        mov(kj, reg_kh);
+        char kh_label[4] = {'.', 'h', pad_label, '\0'};
+        L(kh_label);
+        {
+            if (jcp.kw >= 5 && pad_l == 0 && pad_r == 0) {
+                oh_step_nopad(ur_w, pad_l, pad_r, pad_label);
+                sub(aux_reg_input, sizeof(float) * kw * inp_mult);
+                add(aux_reg_input, sizeof(float) * iw * inp_mult);
+            } else {
+                oh_step_unroll_kw(ur_w, pad_l, pad_r);
+                add(aux_reg_kernel, sizeof(float) * kw * oc_blk * ic_blk);
+                add(aux_reg_input, sizeof(float) * iw * inp_mult);
+            }
+
+            dec(kj);
+            cmp(kj, 0);
+            jg(kh_label, T_NEAR);
         }
 
-        dec(kj);
-        cmp(kj, 0);
-        jg(kh_label, T_NEAR);
+        add(aux1_reg_input, sizeof(float) * jcp.ih * iw * ic_blk);
+        add(aux1_reg_kernel, sizeof(float) * jcp.kh * kw * ic_blk * oc_blk);
+
+        dec(ic_iter);
+        cmp(ic_iter, 0);
+        jg(ic_label, T_NEAR);
     }
 
     char done_label[4] = {'.', 'd', pad_label, '\0'};
@@ -284,6 +310,9 @@ status_t jit_avx2_conv_fwd_kernel_f32::init_conf(jit_conv_conf_t &jcp,
         const memory_desc_wrapper &weights_d, const memory_desc_wrapper &dst_d,
         bool with_relu, double relu_negative_slope)
 {
+    memset(&jcp, 0, sizeof(jcp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
     const bool with_groups = weights_d.ndims() == src_d.ndims() + 1;
 
     jcp.ngroups = with_groups ? weights_d.dims()[0] : 1;
@@ -325,6 +354,13 @@ status_t jit_avx2_conv_fwd_kernel_f32::init_conf(jit_conv_conf_t &jcp,
 
     const int simd_w = 8;
 
+    /* without groups the blocked formats pad the channels up to the simd
+     * width with zeros, the kernel computes over them as over data */
+    if (jcp.ngroups == 1) {
+        jcp.oc = dst_d.blocking_desc().padding_dims[1];
+        if (mimo) jcp.ic = src_d.blocking_desc().padding_dims[1];
+    }
+
     jcp.ur_h = 1; /* no code-unrolling by h so far */
     jcp.ur_w = 3;
     if (jcp.ow < jcp.ur_w) jcp.ur_w = jcp.ow;
@@ -358,126 +394,223 @@ status_t jit_avx2_conv_fwd_kernel_f32::init_conf(jit_conv_conf_t &jcp,
         }
     }
 
+    /* the weights of an (oc, ic) tile are reused for all the rows of an oh
+     * tile, and the dst rows of the oh tile for all the ic tiles, hence both
+     * should stay in L2 together with the src rows they read */
+    const int L2_capacity = l2_capacity();
+    const int wei_per_icb = jcp.nb_oc_blocking * jcp.kh * jcp.kw
+        * jcp.ic_block * jcp.oc_block;
+    for (int b = jcp.nb_ic; b > 1; b--) {
+        if (jcp.nb_ic % b == 0 && b * wei_per_icb <= L2_capacity / 2) {
+            jcp.nb_ic_blocking = b;
+            break;
+        }
+    }
+
+    const int dst_per_oh = jcp.nb_oc_blocking * jcp.ow * jcp.oc_block;
+    const int src_per_oh = jcp.nb_ic_blocking * jcp.stride_h * jcp.iw
+        * jcp.ic_block;
+    jcp.oh_blocking = nstl::max(1, (L2_capacity
+                - jcp.nb_ic_blocking * wei_per_icb) / (dst_per_oh + src_per_oh));
+    if (jcp.oh_blocking > jcp.oh) jcp.oh_blocking = jcp.oh;
+
     return status::success;
 }
 
-inline Xbyak::Address jit_avx2_conv_bwd_data_kernel_f32::get_address(
-        Xbyak::Reg64 base, int offset) {
-    using Xbyak::Ymm;
-    return YWORD[base + offset];
+namespace {
+/* with stride_w > 1 the iw of a row split into phases: the positions
+ * iw0 + j * stride_w, j < n_j, are reached only by the taps
+ * kw0 + t * stride_w, and the diff_dst column of tap kw at j is
+ * (iw0 + l_pad - kw) / stride_w + j. The full blocks of ur_w positions
+ * within [j_lo, j_hi] read columns in range for every tap, the n_l
+ * leading and n_r trailing blocks and the tail may not */
+struct bwd_data_phase_t {
+    int n_j, kw0, n_kw;
+    int j_lo, j_hi;
+    int n_l, n_m, n_r, tail;
+};
+
+bwd_data_phase_t bwd_data_phase(const jit_conv_conf_t &jcp, int iw0) {
+    const int str_w = jcp.stride_w;
+    bwd_data_phase_t p;
+
+    p.n_j = div_up(jcp.iw - iw0, str_w);
+    p.kw0 = (iw0 + jcp.l_pad) % str_w;
+    p.n_kw = p.kw0 < jcp.kw ? (jcp.kw - 1 - p.kw0) / str_w + 1 : 0;
+
+    p.j_lo = 0;
+    p.j_hi = p.n_j - 1;
+    if (p.n_kw > 0) {
+        const int kw1 = p.kw0 + (p.n_kw - 1) * str_w;
+        p.j_lo = nstl::max(p.j_lo, -(iw0 + jcp.l_pad - kw1) / str_w);
+        p.j_hi = nstl::min(p.j_hi,
+                jcp.ow - 1 - (iw0 + jcp.l_pad - p.kw0) / str_w);
+    }
+
+    const int ur_w = jcp.ur_w;
+    const int n_full = p.n_j / ur_w;
+    const int b_lo = nstl::min(n_full, div_up(p.j_lo, ur_w));
+    const int b_hi = nstl::max(b_lo, nstl::min(n_full, (p.j_hi + 1) / ur_w));
+    p.n_l = b_lo;
+    p.n_m = b_hi - b_lo;
+    p.n_r = n_full - b_hi;
+    p.tail = p.n_j % ur_w;
+    return p;
+}
 }
 
-void jit_avx2_conv_bwd_data_kernel_f32::hsw_iter_s1(int ur_w, int l_overflow,
-        int r_overflow, const char* kh_lable) {
+void jit_avx2_conv_bwd_data_kernel_f32::compute_block(int ur_w, int iw0,
+        int j0) {
     using Xbyak::Ymm;
 
-    int kw    = jcp.kw;
-    int kh    = jcp.kh;
-    int iw    = jcp.iw;
-    int ih    = jcp.ih;
-    int ow    = jcp.ow;
-
-    int ic_block = jcp.ic_block;
-    int oc_block = jcp.oc_block;
-    int nb_ic_block = jcp.nb_ic_blocking;
+    const int kw = jcp.kw;
+    const int kh = jcp.kh;
+    const int iw = jcp.iw;
+    const int ih = jcp.ih;
+    const int ow = jcp.ow;
+    const int oh = jcp.oh;
+    const int str_w = jcp.stride_w;
+    const int ic_blk = jcp.ic_block;
+    const int oc_blk = jcp.oc_block;
+    const int nb_ic_block = jcp.nb_ic_blocking;
+
+    const auto p = bwd_data_phase(jcp, iw0);
+    const std::string l = ".b" + std::to_string(label_cnt++);
+
+    auto dsrc_off = [&](int ii, int jj) {
+        return sizeof(float) * (ii * ih * iw + jj * str_w) * ic_blk;
+    };
+
+    if (p.n_kw == 0) {
+        /* no tap reaches these positions */
+        test(reg_oc_flag, OC_FLAG_FIRST);
+        jz(l + "d", T_NEAR);
+        vpxor(ymm0, ymm0, ymm0);
+        for (int ii = 0; ii < nb_ic_block; ii++)
+            for (int jj = 0; jj < ur_w; jj++)
+                vmovups(YWORD[reg_dsrc + dsrc_off(ii, jj)], ymm0);
+        L(l + "d");
+        return;
+    }
 
+    test(reg_oc_flag, OC_FLAG_FIRST);
+    jnz(l + "f", T_NEAR);
+    for (int ii = 0; ii < nb_ic_block; ii++)
+        for (int jj = 0; jj < ur_w; jj++)
+            vmovups(Ymm(ur_w * ii + jj), YWORD[reg_dsrc + dsrc_off(ii, jj)]);
+    jmp(l + "i", T_NEAR);
+    L(l + "f");
     for (int ii = 0; ii < nb_ic_block; ii++)
         for (int jj = 0; jj < ur_w; jj++)
-            vmovups(Ymm(ur_w*ii+jj), ptr [ reg_dsrc + sizeof(float)*(ii*ih*iw+jj)*ic_block ]);
+            vpxor(Ymm(ur_w * ii + jj), Ymm(ur_w * ii + jj));
+    L(l + "i");
+
+    cmp(reg_kh, 0);
+    je(l + "s", T_NEAR);
 
+    /* the accumulators stay in registers over nb_oc_blocking oc blocks */
     mov(aux_reg_ddst, reg_ddst);
     mov(aux_reg_kernel, reg_kernel);
-
-    mov(kj, reg_kh);
-    L(kh_lable);
+    mov(oc_iter, jcp.nb_oc_blocking);
+    L(l + "c");
     {
-        //TODO: try lable
-        for (int ki = 0; ki < kw; ki++)
+        mov(aux1_reg_ddst, aux_reg_ddst);
+        mov(aux1_reg_kernel, aux_reg_kernel);
+        mov(kj, reg_kh);
+        L(l + "h");
         {
-            int jj_start = nstl::max(0, l_overflow - (kw-1) + ki) ; // 0;
-            int jj_end = ur_w - nstl::max(0, r_overflow - ki); // ur_w;
-            for (int ofm2 = 0; ofm2 < jcp.oc_block; ofm2++)
-            {
-                for (int jj =jj_start ; jj < jj_end; jj++)
-                {
-                    int aux_output_offset = (jj + jcp.l_pad - ki)*jcp.oc_block + ofm2;
-                    vbroadcastss(Ymm(nb_ic_block*ur_w+jj), ptr [ aux_reg_ddst + sizeof(float)*aux_output_offset ]);
-                }
-                for (int ii = 0; ii  < nb_ic_block; ii++)
-                {
-                    int aux_kernel_offset = ii*kh*kw*jcp.ic_block*jcp.oc_block +
-                                             ki*jcp.ic_block*jcp.oc_block+ ofm2*jcp.ic_block;
-                    vmovups(ymm15, ptr [ aux_reg_kernel +  sizeof(float)*aux_kernel_offset ]);
-                    for (int jj = jj_start; jj  < jj_end; jj++)
-                    {
-                        vfmadd231ps(Ymm(ur_w*ii+jj), Ymm(nb_ic_block*ur_w+jj), ymm15);
+            for (int t = 0; t < p.n_kw; t++) {
+                const int ki = p.kw0 + t * str_w;
+                const int o = (iw0 + jcp.l_pad - ki) / str_w;
+                const int jj_start = nstl::max(0, -(o + j0));
+                const int jj_end = nstl::min(ur_w, ow - (o + j0));
+                for (int ofm = 0; ofm < oc_blk; ofm++) {
+                    for (int jj = jj_start; jj < jj_end; jj++) {
+                        const int ddst_off = (o + jj) * oc_blk + ofm;
+                        vbroadcastss(Ymm(nb_ic_block * ur_w + jj),
+                                ptr[aux1_reg_ddst + sizeof(float) * ddst_off]);
+                    }
+                    for (int ii = 0; ii < nb_ic_block; ii++) {
+                        const int ker_off = ((ii * kh * kw + ki) * oc_blk
+                                + ofm) * ic_blk;
+                        vmovups(ymm15, YWORD[aux1_reg_kernel
+                                + sizeof(float) * ker_off]);
+                        for (int jj = jj_start; jj < jj_end; jj++)
+                            vfmadd231ps(Ymm(ur_w * ii + jj),
+                                    Ymm(nb_ic_block * ur_w + jj), ymm15);
                     }
                 }
             }
+            add(aux1_reg_kernel,
+                    sizeof(float) * jcp.stride_h * kw * oc_blk * ic_blk);
+            sub(aux1_reg_ddst, sizeof(float) * ow * oc_blk);
+
+            dec(kj);
+            jg(l + "h", T_NEAR);
         }
-        add(aux_reg_kernel, sizeof(float)*kw *oc_block*ic_block);
-        sub(aux_reg_ddst, sizeof(float)*ow*oc_block);
+        add(aux_reg_ddst, sizeof(float) * oh * ow * oc_blk);
+        add(aux_reg_kernel,
+                sizeof(float) * jcp.nb_ic * kh * kw * oc_blk * ic_blk);
 
-        dec(kj);
-        cmp(kj, 0);
-        jg(kh_lable, T_NEAR);
+        dec(oc_iter);
+        jg(l + "c", T_NEAR);
     }
 
+    L(l + "s");
     for (int ii = 0; ii < nb_ic_block; ii++)
         for (int jj = 0; jj < ur_w; jj++)
-            vmovups(ptr [ reg_dsrc + sizeof(float)*(ii*ih*iw+jj)*ic_block ], Ymm(ur_w*ii+jj));
-
+            vmovups(YWORD[reg_dsrc + dsrc_off(ii, jj)], Ymm(ur_w * ii + jj));
 }
 
 void jit_avx2_conv_bwd_data_kernel_f32::generate() {
-    using Xbyak::Ymm;
     preamble();
 
-    mov(reg_dsrc, ptr[this->param1 + GET_OFF(src)]);
-    mov(reg_ddst, ptr[this->param1 + GET_OFF(dst)]);
     mov(reg_kernel, ptr[this->param1 + GET_OFF(filt)]);
     mov(reg_kh, ptr[this->param1 + GET_OFF(kh_padding)]);
-
-    int n_oi = jcp.iw / jcp.ur_w;
-    xor_(oi_iter, oi_iter);
-
-    int l_overflow = nstl::max(0, jcp.kw - 1 - jcp.l_pad);
-    if (l_overflow > 0)
-    {
-        hsw_iter_s1(jcp.ur_w, l_overflow, 0, ".kh_loop_oimain_overflow_l");
-        add(reg_dsrc , sizeof(float)*jcp.ur_w*jcp.ic_block);
-        add(reg_ddst, sizeof(float)*jcp.ur_w*jcp.oc_block);
-        inc(oi_iter);
-    }
-
-    int r_pad = jcp.iwp - jcp.iw - jcp.l_pad;
-    int r_overflow1 = nstl::max(0,jcp.kw - 1 - (jcp.iw - jcp.ur_w*n_oi) - r_pad);
-    int r_overflow  = nstl::max(0,jcp.kw - 1 - r_pad);
-    if (r_overflow1 > 0)
-        n_oi--;
-
-    if ((l_overflow <= 0 && n_oi > 0)
-      ||(l_overflow >  0 && n_oi > 1))
-    {
-        L(".ow_loop");
-        {
-            hsw_iter_s1(jcp.ur_w, 0, 0, ".kh_loop_oimain");
-            add(reg_dsrc, sizeof(float)*jcp.ur_w*jcp.ic_block);
-            add(reg_ddst, sizeof(float)*jcp.ur_w*jcp.oc_block);
-
-            inc(oi_iter);
-            cmp(oi_iter, n_oi); jl(".ow_loop", T_NEAR);
+    mov(reg_oc_flag, ptr[this->param1 + GET_OFF(ic_flag)]);
+
+    const int ur_w = jcp.ur_w;
+    const int str_w = jcp.stride_w;
+    const int ic_blk = jcp.ic_block;
+    const int oc_blk = jcp.oc_block;
+
+    for (int iw0 = 0; iw0 < nstl::min(str_w, jcp.iw); iw0++) {
+        const auto p = bwd_data_phase(jcp, iw0);
+
+        mov(reg_dsrc, ptr[this->param1 + GET_OFF(src)]);
+        if (iw0 > 0)
+            add(reg_dsrc, sizeof(float) * iw0 * ic_blk);
+        mov(reg_ddst, ptr[this->param1 + GET_OFF(dst)]);
+
+        int j0 = 0;
+        auto step = [&](int ur) {
+            compute_block(ur, iw0, j0);
+            add(reg_dsrc, sizeof(float) * ur * str_w * ic_blk);
+            add(reg_ddst, sizeof(float) * ur * oc_blk);
+            j0 += ur;
+        };
+
+        for (int b = 0; b < p.n_l; b++)
+            step(ur_w);
+
+        if (p.n_m > 0) {
+            const std::string l = ".w" + std::to_string(label_cnt++);
+            mov(oi_iter, p.n_m);
+            L(l);
+            compute_block(ur_w, iw0, j0);
+            add(reg_dsrc, sizeof(float) * ur_w * str_w * ic_blk);
+            add(reg_ddst, sizeof(float) * ur_w * oc_blk);
+            dec(oi_iter);
+            jg(l, T_NEAR);
+            j0 += p.n_m * ur_w;
         }
-    }
 
-    if (r_overflow1 > 0 )
-    {
-        hsw_iter_s1(jcp.ur_w, 0, r_overflow1, ".kh_loop_oimain_overflow_r");
-        add(reg_dsrc, sizeof(float)*jcp.ur_w*jcp.ic_block);
-        add(reg_ddst, sizeof(float)*jcp.ur_w*jcp.oc_block);
+        for (int b = 0; b < p.n_r; b++)
+            step(ur_w);
+
+        if (p.tail > 0)
+            step(p.tail);
     }
-    if (jcp.ur_w_tail != 0)
-        hsw_iter_s1(jcp.ur_w_tail, 0, r_overflow, ".kh_loop_oitail");
 
     this->postamble();
 }
@@ -487,6 +620,9 @@ status_t jit_avx2_conv_bwd_data_kernel_f32::init_conf(jit_conv_conf_t &jcp,
         const memory_desc_wrapper &weights_d,
         const memory_desc_wrapper &diff_dst_d)
 {
+    memset(&jcp, 0, sizeof(jcp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
     const bool with_groups = weights_d.ndims() == diff_src_d.ndims() + 1;
 
     jcp.ngroups = with_groups ? weights_d.dims()[0] : 1;
@@ -509,78 +645,81 @@ status_t jit_avx2_conv_bwd_data_kernel_f32::init_conf(jit_conv_conf_t &jcp,
     jcp.stride_h = cd.strides[0];
     jcp.stride_w = cd.strides[1];
 
-    const int simd_w = 8;
-
-    /* derivatives */
-    jcp.ihp = jcp.ih + 2*jcp.t_pad;
-    jcp.iwp = jcp.iw + 2*jcp.l_pad;
-    jcp.ohp = jcp.oh; /* do we really need */
-    jcp.owp = jcp.ow; /* padded output ??? */
-
-    jcp.ic_block = (jcp.ic % simd_w) ? 1 : simd_w;
-    jcp.nb_ic = jcp.ic / jcp.ic_block;
-
-    jcp.oc_block = simd_w;
-    if (jcp.oc % jcp.oc_block) return status::unimplemented;
-    jcp.nb_oc = jcp.oc / jcp.oc_block;
-
-    jcp.ur_h = 1; /* no code-unrolling by h so far */
-    jcp.nb_ic_blocking = 1;
-    jcp.nb_oc_blocking = 1;
-    jcp.ur_w = 1;
-
     jcp.src_fmt = diff_src_d.format();
 
+    const int simd_w = 8;
+
     bool args_ok = true
         && diff_src_d.format() == nChw8c
-        && weights_d.format() == with_groups ? gOIhw8o8i : OIhw8o8i
-        && diff_dst_d.format() == nChw8c
-        && jcp.stride_w == jcp.stride_h
-        && jcp.stride_w == 1
+        && weights_d.format() == (with_groups ? gOIhw8o8i : OIhw8o8i)
+        && diff_dst_d.format() == nChw8c;
+    if (!args_ok) return status::unimplemented;
+
+    /* the channels are zero-padded as in the forward */
+    if (jcp.ngroups == 1) {
+        jcp.ic = diff_src_d.blocking_desc().padding_dims[1];
+        jcp.oc = diff_dst_d.blocking_desc().padding_dims[1];
+    }
+
+    args_ok = true
         && jcp.ic % simd_w == 0
         && jcp.oc % simd_w == 0
-        && jcp.t_pad == jcp.l_pad /* Only AlexNet so far */
-        && (jcp.t_pad == 1 || jcp.t_pad == 2) /* Only AlexNet so far */
-        && jcp.oh == (jcp.ihp - jcp.kh) / jcp.stride_h + 1
-        && jcp.ow == (jcp.iwp - jcp.kw) / jcp.stride_w + 1;
+        && jcp.t_pad >= 0 && jcp.l_pad >= 0;
     if (!args_ok) return status::unimplemented;
 
-    jcp.ur_w = 3;
-    if (jcp.stride_w > 1 || jcp.stride_h > 1)
-        return status::unimplemented;
-    if (jcp.ngroups == 1
-        && jcp.kw == 1 && jcp.kh == 1 && jcp.l_pad == 0 && jcp.t_pad == 0
-        && jcp.stride_w == 1 && jcp.stride_h == 1
-        && jcp.iw == jcp.ow && jcp.ih == jcp.oh
-        && jcp.ic_block == simd_w) {
-
-        jcp.nb_ic_blocking = 3;
+    jcp.ic_block = simd_w;
+    jcp.nb_ic = jcp.ic / jcp.ic_block;
 
-        return status::success;
-    }
+    jcp.oc_block = simd_w;
+    jcp.nb_oc = jcp.oc / jcp.oc_block;
 
-    jcp.ur_w = 3;
-    for (int b = 4; b > 1; b--)
-    {
-        if (jcp.nb_ic % b == 0)
-        {
+    /* ur_w * nb_ic_blocking accumulators, ur_w broadcasts of diff_dst and
+     * a vector of weights */
+    jcp.ur_h = 1; /* no code-unrolling by h so far */
+    jcp.nb_ic_blocking = 1;
+    for (int b = 4; b > 1; b--) {
+        if (jcp.nb_ic % b == 0) {
             jcp.nb_ic_blocking = b;
             break;
         }
     }
-    jcp.ur_w_tail = jcp.iw % jcp.ur_w;
-    int l_overflow = nstl::max(0, jcp.kw - 1 - jcp.l_pad);
-    if (l_overflow > jcp.ur_w) /* maximum 1 step with l_overflow so far */
-        return status::unimplemented;
-    int r_pad = jcp.iwp - jcp.iw - jcp.l_pad;
-    int r_overflow_step0 = nstl::max(0, jcp.kw - 1 - (jcp.iw - jcp.ur_w) - r_pad);
-    if (l_overflow > 0 && r_overflow_step0 > 0) /* no steps with both left and
-                                                   right overflow so far */
-        return status::unimplemented;
-    int r_overflow_no_tail = nstl::max(0,jcp.kw - 1 - jcp.ur_w_tail - r_pad);
-    if (r_overflow_no_tail > jcp.ur_w) /* maximum 1 ur_w block with
-                                          r_overflow so far */
+    jcp.ur_w = nstl::min(15 / (jcp.nb_ic_blocking + 1),
+            div_up(jcp.iw, jcp.stride_w));
+
+    /* the weights of an (ic, oc) tile are reused for all the rows of an ih
+     * tile, and the diff_src rows of the ih tile for all the oc tiles */
+    const int L2_capacity = l2_capacity();
+    const int wei_per_ocb = jcp.nb_ic_blocking * jcp.kh * jcp.kw
+        * jcp.ic_block * jcp.oc_block;
+    jcp.nb_oc_blocking = 1;
+    for (int b = jcp.nb_oc; b > 1; b--) {
+        if (jcp.nb_oc % b == 0 && b * wei_per_ocb <= L2_capacity / 2) {
+            jcp.nb_oc_blocking = b;
+            break;
+        }
+    }
+
+    const int src_per_ih = jcp.nb_ic_blocking * jcp.iw * jcp.ic_block;
+    const int dst_per_ih = jcp.nb_oc_blocking * div_up(jcp.kh, jcp.stride_h)
+        * jcp.ow * jcp.oc_block;
+    jcp.oh_blocking = nstl::max(1, (L2_capacity
+                - jcp.nb_oc_blocking * wei_per_ocb)
+            / (src_per_ih + dst_per_ih));
+    if (jcp.oh_blocking > jcp.ih) jcp.oh_blocking = jcp.ih;
+
+    /* every block of a phase but the looped ones is emitted on its own */
+    size_t code_size = 0;
+    for (int iw0 = 0; iw0 < nstl::min(jcp.stride_w, jcp.iw); iw0++) {
+        const auto p = bwd_data_phase(jcp, iw0);
+        const int n_blocks = p.n_l + (p.n_m > 0) + p.n_r + (p.tail > 0);
+        const int n_insns = p.n_kw * jcp.oc_block
+            * (jcp.ur_w + jcp.nb_ic_blocking * (jcp.ur_w + 1))
+            + 3 * jcp.nb_ic_blocking * jcp.ur_w;
+        code_size += n_blocks * n_insns * 10;
+    }
+    if (code_size > 7 * Xbyak::DEFAULT_MAX_CODE_SIZE)
         return status::unimplemented;
+
     return status::success;
 }
 
@@ -601,6 +740,9 @@ status_t jit_avx2_conv_bwd_weights_kernel_f32::init_conf(jit_conv_conf_t &jcp,
         const convolution_desc_t &cd, const memory_desc_wrapper &src_d,
         const memory_desc_wrapper &diff_weights_d,
         const memory_desc_wrapper &diff_dst_d) {
+    memset(&jcp, 0, sizeof(jcp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
     const bool with_groups = diff_weights_d.ndims() == src_d.ndims() + 1;
 
     jcp.ngroups = with_groups ? diff_weights_d.dims()[0] : 1;
@@ -633,6 +775,7 @@ status_t jit_avx2_conv_bwd_weights_kernel_f32::init_conf(jit_conv_conf_t &jcp,
         && diff_weights_d.format() == (with_groups ? gOIhw8i8o : OIhw8i8o)
         && one_of(cd.bias_desc.format, memory_format::undef, x)
         && diff_dst_d.format() == nChw8c
+        && jcp.ic % 8 == 0 && jcp.oc % 8 == 0 /* no padded channels so far */
         && jcp.kw < 14;
     if (!args_ok) return status::unimplemented;
 
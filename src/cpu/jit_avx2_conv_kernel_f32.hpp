@@ -19,44 +19,12 @@
 
 #include "c_types_map.hpp"
 #include "jit_generator.hpp"
+#include "jit_primitive_conf.hpp"
 
 namespace mkldnn {
 namespace impl {
 namespace cpu {
 
-struct jit_conv_conf_t {
-    int mb;
-    int ngroups, ic, oc;
-    int ih, iw, oh, ow;
-    int l_pad, t_pad;
-    int kh, kw;
-    int stride_h, stride_w;
-    memory_format_t src_fmt;
-    bool with_bias, with_relu;
-    double relu_negative_slope;
-
-    int ihp, iwp, ohp, owp;
-    int nb_ic, ic_block;
-    int nb_oc, oc_block;
-    int nb_ic_blocking, nb_oc_blocking; // blocking of nb_ic and nb_ic
-    int ur_h, ur_w;
-    int ur_w_tail;
-};
-
-struct __attribute__((__packed__)) jit_conv_call_s {
-    const float *src; /* hack, non-const for backward_data */
-    const float *dst; /* hack, non-const for forward */
-    const float *filt; /* hack, non-const for backward_weights */
-    const float *bias; /* hack, non-const for backward_bias */
-    const float *src_prf;
-    const float *dst_prf;
-    const float *filt_prf;
-    size_t kh_padding;
-    size_t kh_padding_prf;
-    size_t kw_padding;
-    int ic_flag;
-};
-
 struct jit_avx2_conv_fwd_kernel_f32: public jit_generator {
     enum { IC_FLAG_FIRST = 1, IC_FLAG_LAST = 2 };
 
@@ -92,6 +60,10 @@ private:
     reg64_t reg_kh = rcx;
     Xbyak::Reg32 reg_ci_flag = r13d;
 
+    reg64_t ic_iter = r14;
+    reg64_t aux1_reg_input = r15;
+    reg64_t aux1_reg_kernel = rbp;
+
     inline void oh_step_unroll_kw(int ur_w, int pad_l, int pad_r);
     inline void oh_step_nopad(int ur_w, int pad_l, int pad_r, char pad_label);
     inline void width_blk_step(int ur_w, int pad_l, int pad_r, char pad_label);
@@ -100,12 +72,13 @@ private:
 };
 
 struct jit_avx2_conv_bwd_data_kernel_f32: public jit_generator {
-    enum { IC_FLAG_FIRST = 1, IC_FLAG_LAST = 2 };
+    /* diff_src is zeroed instead of accumulated on the first oc tile */
+    enum { OC_FLAG_FIRST = 1 };
 
     jit_avx2_conv_bwd_data_kernel_f32(jit_conv_conf_t ajcp,
             void *code_ptr = nullptr,
             size_t code_size = 8 * Xbyak::DEFAULT_MAX_CODE_SIZE)
-        : jcp(ajcp)
+        : jit_generator(code_ptr, code_size), jcp(ajcp)
     {
         this->generate();
         jit_ker = (void (*)(jit_conv_call_s *))this->getCode();
@@ -121,30 +94,22 @@ struct jit_avx2_conv_bwd_data_kernel_f32: public jit_generator {
 
 private:
     using reg64_t = const Xbyak::Reg64;
+    reg64_t reg_dsrc = rax;
+    reg64_t reg_ddst = rsi;
+    reg64_t reg_kernel = rdx;
+    reg64_t reg_kh = rcx;
+    reg64_t aux_reg_ddst = r8;
+    reg64_t aux_reg_kernel = r9;
+    reg64_t aux1_reg_ddst = r10;
+    reg64_t aux1_reg_kernel = r11;
+    reg64_t kj = r12;
+    reg64_t oc_iter = r13;
+    reg64_t oi_iter = r14;
+    Xbyak::Reg32 reg_oc_flag = r15d;
 
-    /*
-    reg64_t param          = Xbyak::util::cdecl_param1;
-    */
-    reg64_t reg_input      = rax;
-    reg64_t reg_ddst       = rax;
-    reg64_t aux_reg_input  = r8;
-    reg64_t aux_reg_ddst   = r8;
-    reg64_t aux1_reg_input = r9;
-    reg64_t reg_kernel     = rdx;
-    reg64_t aux_reg_kernel = r10;
-    reg64_t reg_output     = rsi;
-    reg64_t reg_dsrc       = rsi;
-    reg64_t aux_reg_output = rbx;
-    reg64_t aux_reg_dsrc = rbx;
-
-    reg64_t kj      = r11;
-    reg64_t oi_iter = r12;
-    reg64_t reg_kh  = r14;
-    reg64_t ki_iter = r13;
+    int label_cnt = 0;
 
-    inline Xbyak::Address get_address(Xbyak::Reg64 base, int offset);
-    inline void hsw_iter_s1(int ur_w, int l_overflow, int r_overflow,
-            const char* kh_lable);
+    inline void compute_block(int ur_w, int iw0, int j0);
 
     void generate();
 };
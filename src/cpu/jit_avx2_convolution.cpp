@@ -14,6 +14,10 @@
 * limitations under the License.
 *******************************************************************************/
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include "mkldnn_types.h"
 
 #include "c_types_map.hpp"
@@ -28,7 +32,8 @@ using namespace mkldnn::impl::status;
 using namespace mkldnn::impl::memory_format;
 
 template <bool with_relu>
-void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward() {
+void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward(
+        char *scratchpad) {
     auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
     auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
     auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
@@ -41,6 +46,13 @@ void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward() {
 
     const auto &jcp = kernel_->jcp;
 
+    if (bias && conf_.scratchpad_size() != 0) {
+        auto padded_bias = reinterpret_cast<data_t *>(scratchpad);
+        for (int oc = 0; oc < jcp.oc; ++oc)
+            padded_bias[oc] = oc < conf_.OC() ? bias[bias_d.off(oc)] : 0;
+        bias = padded_bias;
+    }
+
     auto ker = [&](int g, int n, int oc, int ic, int oh) {
         jit_conv_call_s par_conv = {};
 
@@ -70,7 +82,7 @@ void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward() {
             par_conv.ic_flag |= jit_avx2_conv_fwd_kernel_f32::IC_FLAG_FIRST;
         }
 
-        if (with_relu && ic + 1 == jcp.nb_ic) {
+        if (with_relu && ic + jcp.nb_ic_blocking == jcp.nb_ic) {
             par_conv.ic_flag |= jit_avx2_conv_fwd_kernel_f32::IC_FLAG_LAST;
         }
 
@@ -80,13 +92,19 @@ void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward() {
         kernel_->jit_ker(&par_conv);
     };
 
+    /* the kernel accumulates nb_ic_blocking ic blocks per call; the rows of
+     * an oh tile are revisited for every ic tile while they are in cache */
 #   pragma omp parallel for collapse(3) schedule(static)
     for (int g = 0; g < jcp.ngroups; ++g) {
         for (int n = 0; n < jcp.mb; ++n) {
             for (int oc = 0; oc < (jcp.nb_oc/jcp.nb_oc_blocking); ++oc) {
-                for (int ic = 0; ic < jcp.nb_ic; ++ic) {
-                    for (int oh = 0; oh < jcp.oh; ++oh) {
-                        ker(g, n, oc, ic, oh);
+                for (int ohb = 0; ohb < jcp.oh; ohb += jcp.oh_blocking) {
+                    const int oh_end = nstl::min(jcp.oh, ohb + jcp.oh_blocking);
+                    for (int ic = 0; ic < jcp.nb_ic;
+                            ic += jcp.nb_ic_blocking) {
+                        for (int oh = ohb; oh < oh_end; ++oh) {
+                            ker(g, n, oc, ic, oh);
+                        }
                     }
                 }
             }
@@ -94,8 +112,8 @@ void _jit_avx2_convolution_fwd_t<with_relu>::execute_forward() {
     }
 }
 
-template void _jit_avx2_convolution_fwd_t<true>::execute_forward();
-template void _jit_avx2_convolution_fwd_t<false>::execute_forward();
+template void _jit_avx2_convolution_fwd_t<true>::execute_forward(char *);
+template void _jit_avx2_convolution_fwd_t<false>::execute_forward(char *);
 
 void jit_avx2_convolution_bwd_data_t::execute_backward_data() {
     auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(0));
@@ -111,52 +129,52 @@ void jit_avx2_convolution_bwd_data_t::execute_backward_data() {
     auto ker = [&](int g, int n, int ic, int oc, int ih) {
         jit_conv_call_s par_conv = {};
 
-        const int i_t_overflow = nstl::max(0, jcp.kh - 1 - ih - jcp.t_pad);
-        const int b_pad = jcp.ihp - jcp.ih - jcp.t_pad;
-        const int i_b_overflow = nstl::max(0, jcp.kh - 1 - (jcp.ih - 1 - ih) - b_pad);
-        const int oh = ih + jcp.t_pad - i_b_overflow;
-
-        const int simd_w = 8;
-
+        /* the taps reaching row ih are kh = kh_s, kh_s + stride_h, ... and
+         * read the diff_dst rows oh_s, oh_s - 1, ... */
+        const int str_h = jcp.stride_h;
+        const int ihp = ih + jcp.t_pad;
+        const int kh_lo = nstl::max(0, ihp - (jcp.oh - 1) * str_h);
+        const int kh_hi = nstl::min(jcp.kh - 1, ihp);
+        const int kh_s = kh_lo + (ihp - kh_lo) % str_h;
+        const int kh_cnt = kh_s <= kh_hi ? (kh_hi - kh_s) / str_h + 1 : 0;
+        const int oh_s = kh_cnt > 0 ? (ihp - kh_s) / str_h : 0;
+
+        const int icb = jcp.nb_ic_blocking * ic;
+        const int ocb = jcp.nb_oc_blocking * oc;
         par_conv.src = &diff_src[diff_src_d.blk_off(n,
-                    /*jcp.ic == 3 ? 0 :*/
-                g * jcp.nb_ic + jcp.nb_ic_blocking*ic, ih, 0)];
-        par_conv.dst = const_cast<data_t *>(&diff_dst[diff_dst_d.blk_off(n,
-                g * jcp.nb_oc + oc, oh, 0)]);
-        par_conv.filt = const_cast<data_t *>(&weights[conf_.with_groups()
-            ? weights_d.blk_off(g, oc, jcp.ic == 3 ? 0 : jcp.nb_ic_blocking*ic, i_b_overflow, 0)
-            : weights_d.blk_off(oc, jcp.ic == 3 ? 0 : jcp.nb_ic_blocking*ic, i_b_overflow, 0)]);
-        par_conv.src_prf  = nullptr;
-        par_conv.dst_prf  = nullptr;
-        par_conv.filt_prf = nullptr;
-        if (oc == 0)
-        {
-            for (int iw = 0; iw < jcp.iw; iw++)
-            {
-                for (int b = 0; b < jcp.nb_ic_blocking; b++)
-                {
-                    int current_ic = (jcp.ic == 3 ? 0 : g*jcp.nb_ic)
-                        + jcp.nb_ic_blocking*ic+b;
-                    int current_idx = diff_src_d.blk_off(n, current_ic, ih, iw);
-                    for (int v = 0; v < simd_w; v++)
-                        diff_src[current_idx + v] = 0.0;
-                }
-            }
+                g * jcp.nb_ic + icb, ih, 0)];
+        par_conv.dst = &diff_dst[diff_dst_d.blk_off(n,
+                g * jcp.nb_oc + ocb, oh_s, 0)];
+        par_conv.filt = &weights[conf_.with_groups()
+            ? weights_d.blk_off(g, ocb, icb, kh_cnt > 0 ? kh_s : 0, 0)
+            : weights_d.blk_off(ocb, icb, kh_cnt > 0 ? kh_s : 0, 0)];
+
+        if (oc == 0) {
+            par_conv.ic_flag
+                |= jit_avx2_conv_bwd_data_kernel_f32::OC_FLAG_FIRST;
         }
 
-        par_conv.kh_padding = jcp.kh - i_t_overflow - i_b_overflow;
+        par_conv.kh_padding = kh_cnt;
         par_conv.kw_padding = 0;
 
         kernel_->jit_ker(&par_conv);
     };
 
-#   pragma omp parallel for collapse(3) schedule(static)
+    /* the kernel accumulates nb_oc_blocking oc blocks per call; the rows of
+     * an ih tile are revisited for every oc tile while they are in cache */
+    const int nb_ihb = utils::div_up(jcp.ih, jcp.oh_blocking);
+#   pragma omp parallel for collapse(4) schedule(static)
     for (int n = 0; n < jcp.mb; ++n) {
         for (int g = 0; g < jcp.ngroups; ++g) {
             for (int ic = 0; ic < (jcp.nb_ic/jcp.nb_ic_blocking); ++ic) {
-                for (int oc = 0; oc < jcp.nb_oc; ++oc) {
-                    for (int ih = 0; ih < jcp.ih; ++ih) {
-                        ker(g, n, ic, oc, ih);
+                for (int ihb = 0; ihb < nb_ihb; ++ihb) {
+                    const int ih_s = ihb * jcp.oh_blocking;
+                    const int ih_e = nstl::min(jcp.ih, ih_s + jcp.oh_blocking);
+                    for (int oc = 0; oc < (jcp.nb_oc/jcp.nb_oc_blocking);
+                            ++oc) {
+                        for (int ih = ih_s; ih < ih_e; ++ih) {
+                            ker(g, n, ic, oc, ih);
+                        }
                     }
                 }
             }
@@ -164,7 +182,21 @@ void jit_avx2_convolution_bwd_data_t::execute_backward_data() {
     }
 }
 
-void jit_avx2_convolution_bwd_weights_t::execute_backward_weights() {
+void jit_avx2_convolution_bwd_weights_t::pd_t::init_balance() {
+#if defined(_OPENMP)
+    const int nthr = omp_get_max_threads();
+#else
+    const int nthr = 1;
+#endif
+    /* the minibatch is split only if the channels give too little work */
+    const int work = jcp_.ngroups * jcp_.nb_oc * jcp_.nb_ic;
+    nthr_mb_ = 1;
+    if (work < nthr && reduction_size() != 0)
+        nthr_mb_ = nstl::min(jcp_.mb, utils::div_up(nthr, work));
+}
+
+void jit_avx2_convolution_bwd_weights_t::execute_backward_weights(
+        char *scratchpad) {
     auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
     auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(1));
     auto diff_weights = reinterpret_cast<data_t*>(this->memory(0));
@@ -177,54 +209,96 @@ void jit_avx2_convolution_bwd_weights_t::execute_backward_weights() {
 
     const auto &jcp = kernel_->jcp;
 
-    auto ker = [&](int g, int n, int oc, int ic) {
-        jit_conv_call_s par_conv = {};
-
-        par_conv.src = &src[src_d.blk_off(n, g * jcp.nb_ic + ic)];
-        par_conv.dst = &diff_dst[diff_dst_d.blk_off(n, g * jcp.nb_oc + oc)];
+    const int nthr_mb = conf_.nthr_mb_;
+    const size_t reduction_size = conf_.reduction_size();
+    const size_t wei_size = diff_weights_d.size() / sizeof(data_t);
+    char *ws = scratchpad;
+
+    auto ker = [&](int mb_part, int g, int oc, int ic) {
+        data_t *dw = diff_weights, *db = diff_bias;
+        if (mb_part > 0) {
+            dw = reinterpret_cast<data_t *>(ws
+                    + (mb_part - 1) * reduction_size);
+            db = diff_bias ? dw + wei_size : nullptr;
+        }
 
         const size_t wdiff_offset = conf_.with_groups()
             ? diff_weights_d.blk_off(g, oc, ic, 0, 0)
             : diff_weights_d.blk_off(oc, ic, 0, 0);
-        par_conv.filt = &diff_weights[wdiff_offset];
 
-        if (n == 0) {
-            const size_t sz = jcp.kw * jcp.kh * jcp.oc_block * jcp.ic_block;
-            for (size_t i = 0; i < sz; ++i) diff_weights[wdiff_offset + i] = 0.0;
-        }
+        const int n_start = mb_part * jcp.mb / nthr_mb;
+        const int n_end = (mb_part + 1) * jcp.mb / nthr_mb;
+        for (int n = n_start; n < n_end; ++n) {
+            jit_conv_call_s par_conv = {};
 
-        if (diff_bias && ic == 0) {
-            const size_t _c = g*jcp.nb_oc + oc;
-            auto db = &diff_bias[diff_bias_d.blk_off(_c*jcp.oc_block)];
+            par_conv.src = &src[src_d.blk_off(n, g * jcp.nb_ic + ic)];
+            par_conv.dst = &diff_dst[diff_dst_d.blk_off(n,
+                    g * jcp.nb_oc + oc)];
+            par_conv.filt = &dw[wdiff_offset];
 
-            if (n == 0) {
-                for (int cb = 0; cb < jcp.oc_block; ++cb) db[cb] = 0.0;
+            if (n == n_start) {
+                const size_t sz = jcp.kw * jcp.kh * jcp.oc_block
+                    * jcp.ic_block;
+                for (size_t i = 0; i < sz; ++i) dw[wdiff_offset + i] = 0.0;
             }
 
-            for (int h = 0; h < jcp.oh; ++h) {
-                for (int w = 0; w < jcp.ow; ++w) {
-                    auto dd = &diff_dst[diff_dst_d.blk_off(n,
-                            g * jcp.nb_oc + oc, h, w)];
-                    for (int cb = 0; cb < jcp.oc_block; ++cb) {
-                        db[cb] += dd[cb];
+            if (db && ic == 0) {
+                const size_t _c = g*jcp.nb_oc + oc;
+                auto b = &db[diff_bias_d.blk_off(_c*jcp.oc_block)];
+
+                if (n == n_start) {
+                    for (int cb = 0; cb < jcp.oc_block; ++cb) b[cb] = 0.0;
+                }
+
+                for (int h = 0; h < jcp.oh; ++h) {
+                    for (int w = 0; w < jcp.ow; ++w) {
+                        auto dd = &diff_dst[diff_dst_d.blk_off(n,
+                                g * jcp.nb_oc + oc, h, w)];
+                        for (int cb = 0; cb < jcp.oc_block; ++cb) {
+                            b[cb] += dd[cb];
+                        }
                     }
                 }
             }
-        }
 
-        kernel_->jit_ker(&par_conv);
+            kernel_->jit_ker(&par_conv);
+        }
     };
 
-#   pragma omp parallel for collapse(3) schedule(static)
-    for (int g = 0; g < jcp.ngroups; ++g) {
-        for (int oc = 0; oc < jcp.nb_oc; ++oc) {
-            for (int ic = 0; ic < jcp.nb_ic; ++ic) {
-                for (int n = 0; n < jcp.mb; ++n) {
-                    ker(g, n, oc, ic);
+#   pragma omp parallel for collapse(4) schedule(static)
+    for (int mb_part = 0; mb_part < nthr_mb; ++mb_part) {
+        for (int g = 0; g < jcp.ngroups; ++g) {
+            for (int oc = 0; oc < jcp.nb_oc; ++oc) {
+                for (int ic = 0; ic < jcp.nb_ic; ++ic) {
+                    ker(mb_part, g, oc, ic);
                 }
             }
         }
     }
+
+    if (nthr_mb == 1) return;
+
+    /* sums the copies of the other partitions up to the first one */
+    auto reduce = [&](data_t *acc, size_t offset, size_t len) {
+        const size_t block = 1024;
+        const int nb_blocks = (int)utils::div_up(len, block);
+
+#       pragma omp parallel for schedule(static)
+        for (int b = 0; b < nb_blocks; ++b) {
+            const size_t start = b * block;
+            const size_t end = nstl::min(len, start + block);
+            for (int p = 1; p < nthr_mb; ++p) {
+                const data_t *part = reinterpret_cast<const data_t *>(ws
+                        + (p - 1) * reduction_size) + offset;
+                for (size_t i = start; i < end; ++i)
+                    acc[i] += part[i];
+            }
+        }
+    };
+
+    reduce(diff_weights, 0, wei_size);
+    if (diff_bias)
+        reduce(diff_bias, wei_size, diff_bias_d.size() / sizeof(data_t));
 }
 
 }
@@ -21,6 +21,7 @@
 #include "cpu_convolution_pd.hpp"
 #include "cpu_engine.hpp"
 #include "jit_avx2_conv_kernel_f32.hpp"
+#include "jit_kernel_cache.hpp"
 
 namespace mkldnn {
 namespace impl {
@@ -61,6 +62,14 @@ struct _jit_avx2_convolution_fwd_t: public cpu_primitive_t {
                     *this->dst_pd_.desc(), with_relu, this->negative_slope());
         }
 
+        /** the kernel reads the bias by blocks of oc, a zero-padded copy is
+         * made if the channels are padded */
+        virtual size_t scratchpad_size() const override {
+            return this->with_bias() && jcp_.ngroups == 1
+                && jcp_.oc != this->OC()
+                ? sizeof(float) * jcp_.oc : 0;
+        }
+
         jit_conv_conf_t jcp_;
 
     protected:
@@ -87,16 +96,26 @@ struct _jit_avx2_convolution_fwd_t: public cpu_primitive_t {
     _jit_avx2_convolution_fwd_t(const pd_t *pd, const input_vector &inputs,
             const output_vector &outputs)
         : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
-    { kernel_ = new jit_avx2_conv_fwd_kernel_f32(conf_.jcp_); }
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_conv_fwd_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~_jit_avx2_convolution_fwd_t()
+    { jit_kernel_cache_t::release(kernel_); }
     typedef typename prec_trait<data_type::f32>::type data_t;
 
-    virtual void execute(event_t *e) {
-        execute_forward();
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        execute_forward(scratchpad);
         e->set_state(event_t::ready);
     }
 
+    /* without groups the kernel computes the padded channels out of the
+     * zero padding of its inputs */
+    virtual bool writes_padding() const { return conf_.jcp_.ngroups == 1; }
+
 private:
-    void execute_forward();
+    void execute_forward(char *scratchpad);
     pd_t conf_;
     jit_avx2_conv_fwd_kernel_f32 *kernel_;
 };
@@ -156,7 +175,12 @@ struct jit_avx2_convolution_bwd_data_t: public cpu_primitive_t {
     jit_avx2_convolution_bwd_data_t(const pd_t *pd, const input_vector &inputs,
             const output_vector &outputs)
         : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
-    { kernel_ = new jit_avx2_conv_bwd_data_kernel_f32(conf_.jcp_); }
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_conv_bwd_data_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~jit_avx2_convolution_bwd_data_t()
+    { jit_kernel_cache_t::release(kernel_); }
     typedef typename prec_trait<data_type::f32>::type data_t;
 
     virtual void execute(event_t *e) {
@@ -170,6 +194,10 @@ struct jit_avx2_convolution_bwd_data_t: public cpu_primitive_t {
         e->set_state(event_t::ready);
     }
 
+    /* without groups the kernel computes the padded channels out of the
+     * zero padding of its inputs */
+    virtual bool writes_padding() const { return conf_.jcp_.ngroups == 1; }
+
 private:
     void execute_backward_data();
     pd_t conf_;
@@ -181,7 +209,7 @@ struct jit_avx2_convolution_bwd_weights_t: public cpu_primitive_t {
         pd_t(engine_t *engine, const convolution_desc_t *adesc,
                 const convolution_fwd_pd_t *hint_fwd_pd)
             : cpu_convolution_bwd_weights_pd_t(engine, adesc, hint_fwd_pd)
-            , jcp_({}) {}
+            , jcp_({}), nthr_mb_(1) {}
 
         DECLARE_COMMON_PD_T(jit_avx2_convolution_bwd_weights_t);
 
@@ -197,13 +225,28 @@ struct jit_avx2_convolution_bwd_weights_t: public cpu_primitive_t {
                         this->desc()->diff_weights_desc.data_type);
             if (!ok) return status::unimplemented;
 
-            return jit_avx2_conv_bwd_weights_kernel_f32::init_conf(jcp_,
-                    *this->desc(), *this->src_pd_.desc(),
-                    *this->diff_weights_pd_.desc(),
-                    *this->diff_dst_pd_.desc());
+            CHECK(jit_avx2_conv_bwd_weights_kernel_f32::init_conf(jcp_,
+                        *this->desc(), *this->src_pd_.desc(),
+                        *this->diff_weights_pd_.desc(),
+                        *this->diff_dst_pd_.desc()));
+            init_balance();
+            return status::success;
+        }
+
+        /** the minibatch partitions but the first one accumulate to their
+         * own copies of diff_weights and diff_bias */
+        virtual size_t scratchpad_size() const override
+        { return (nthr_mb_ - 1) * reduction_size(); }
+
+        size_t reduction_size() const {
+            size_t size = memory_desc_wrapper(this->diff_weights_pd(0)).size();
+            if (this->with_bias())
+                size += memory_desc_wrapper(this->diff_weights_pd(1)).size();
+            return size;
         }
 
         jit_conv_conf_t jcp_;
+        int nthr_mb_; /* number of minibatch partitions */
 
     protected:
         virtual status_t set_default_params() override {
@@ -225,21 +268,30 @@ struct jit_avx2_convolution_bwd_weights_t: public cpu_primitive_t {
 
             return status::success;
         }
+
+    private:
+        void init_balance();
     };
 
     jit_avx2_convolution_bwd_weights_t(const pd_t *pd,
             const input_vector &inputs, const output_vector &outputs)
         : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
-    { kernel_ = new jit_avx2_conv_bwd_weights_kernel_f32(conf_.jcp_); }
+    {
+        kernel_ = jit_kernel_cache_t::get<
+            jit_avx2_conv_bwd_weights_kernel_f32>(conf_.jcp_, conf_.jcp_);
+    }
+    ~jit_avx2_convolution_bwd_weights_t()
+    { jit_kernel_cache_t::release(kernel_); }
     typedef typename prec_trait<data_type::f32>::type data_t;
 
-    virtual void execute(event_t *e) {
-        execute_backward_weights();
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        execute_backward_weights(scratchpad);
         e->set_state(event_t::ready);
     }
 
 private:
-    void execute_backward_weights();
+    void execute_backward_weights(char *scratchpad);
     pd_t conf_;
     jit_avx2_conv_bwd_weights_kernel_f32 *kernel_;
 };
@@ -0,0 +1,289 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+#include "jit_avx2_gemm_f32.hpp"
+#include "jit_kernel_cache.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::utils;
+
+struct __attribute__((__packed__)) jit_gemm_call_s {
+    const float *a;
+    const float *b;
+    float *c;
+    size_t k;
+    size_t ldc;
+};
+
+#define GET_OFF(field) offsetof(jit_gemm_call_s, field)
+
+/** computes an mr x nr tile of C from a panel of A (k x mr) and a panel of
+ * B (k x nr), both k-major */
+struct jit_avx2_gemm_f32::xbyak_gemm: public jit_generator {
+    xbyak_gemm(bool beta0, void *code_ptr = nullptr,
+            size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+    {
+        using Xbyak::Ymm;
+        enum { unroll = 4 };
+
+        this->preamble();
+
+        mov(reg_a, ptr[this->param1 + GET_OFF(a)]);
+        mov(reg_b, ptr[this->param1 + GET_OFF(b)]);
+        mov(reg_c, ptr[this->param1 + GET_OFF(c)]);
+        mov(reg_k, ptr[this->param1 + GET_OFF(k)]);
+        mov(reg_ldc, ptr[this->param1 + GET_OFF(ldc)]);
+        shl(reg_ldc, 2); /* in bytes */
+
+        for (int j = 0; j < nr; ++j)
+            for (int h = 0; h < 2; ++h)
+                vxorps(acc(j, h), acc(j, h), acc(j, h));
+
+        auto step = [&](int u) {
+            vmovups(ya0, ptr[reg_a + sizeof(float) * (u * mr)]);
+            vmovups(ya1, ptr[reg_a + sizeof(float) * (u * mr + 8)]);
+            for (int j = 0; j < nr; ++j) {
+                vbroadcastss(yb, ptr[reg_b + sizeof(float) * (u * nr + j)]);
+                vfmadd231ps(acc(j, 0), ya0, yb);
+                vfmadd231ps(acc(j, 1), ya1, yb);
+            }
+        };
+
+        L(".k_loop");
+        cmp(reg_k, unroll);
+        jl(".k_tail", T_NEAR);
+        for (int u = 0; u < unroll; ++u)
+            step(u);
+        add(reg_a, sizeof(float) * unroll * mr);
+        add(reg_b, sizeof(float) * unroll * nr);
+        sub(reg_k, unroll);
+        jmp(".k_loop", T_NEAR);
+
+        L(".k_tail");
+        cmp(reg_k, 0);
+        je(".store", T_NEAR);
+        step(0);
+        add(reg_a, sizeof(float) * mr);
+        add(reg_b, sizeof(float) * nr);
+        dec(reg_k);
+        jmp(".k_tail", T_NEAR);
+
+        L(".store");
+        for (int j = 0; j < nr; ++j) {
+            for (int h = 0; h < 2; ++h) {
+                if (!beta0)
+                    vaddps(acc(j, h), acc(j, h), ptr[reg_c + 32 * h]);
+                vmovups(ptr[reg_c + 32 * h], acc(j, h));
+            }
+            add(reg_c, reg_ldc);
+        }
+
+        this->postamble();
+
+        ker_ = reinterpret_cast<decltype(ker_)>(const_cast<uint8_t*>(
+                    this->getCode()));
+    }
+
+    void operator()(const jit_gemm_call_s *args) { (*ker_)(args); }
+
+private:
+    Xbyak::Reg64 reg_a = r8;
+    Xbyak::Reg64 reg_b = r9;
+    Xbyak::Reg64 reg_c = r10;
+    Xbyak::Reg64 reg_k = r11;
+    Xbyak::Reg64 reg_ldc = rax;
+
+    /* 2 x nr accumulators, 8 rows of the tile each */
+    Xbyak::Ymm acc(int j, int h) { return Xbyak::Ymm(2 * j + h); }
+    Xbyak::Ymm ya0 = ymm12;
+    Xbyak::Ymm ya1 = ymm13;
+    Xbyak::Ymm yb = ymm14;
+
+    void (*ker_)(const jit_gemm_call_s *args);
+};
+
+#undef GET_OFF
+
+namespace {
+
+/* packs op(A)[i0:i0+rows, p0:p0+kb] scaled by alpha into a k-major panel of
+ * mr rows padded with zeros */
+inline void pack_a(bool transa, int rows, int kb, const float *a, int lda,
+        int i0, int p0, float alpha, float *ap) {
+    const int mr = jit_avx2_gemm_f32::mr;
+    for (int r = rows; r < mr; ++r)
+        for (int kk = 0; kk < kb; ++kk)
+            ap[kk * mr + r] = 0;
+
+    if (transa) {
+        for (int r = 0; r < rows; ++r) {
+            const float *a_r = &a[p0 + (size_t)(i0 + r) * lda];
+            for (int kk = 0; kk < kb; ++kk)
+                ap[kk * mr + r] = alpha * a_r[kk];
+        }
+    } else {
+        for (int kk = 0; kk < kb; ++kk) {
+            const float *a_k = &a[i0 + (size_t)(p0 + kk) * lda];
+            for (int r = 0; r < rows; ++r)
+                ap[kk * mr + r] = alpha * a_k[r];
+        }
+    }
+}
+
+/* packs op(B)[p0:p0+kb, j0:j0+cols] into a k-major panel of nr columns
+ * padded with zeros */
+inline void pack_b(bool transb, int cols, int kb, const float *b, int ldb,
+        int p0, int j0, float *bp) {
+    const int nr = jit_avx2_gemm_f32::nr;
+    for (int c = cols; c < nr; ++c)
+        for (int kk = 0; kk < kb; ++kk)
+            bp[kk * nr + c] = 0;
+
+    if (transb) {
+        for (int kk = 0; kk < kb; ++kk) {
+            const float *b_k = &b[j0 + (size_t)(p0 + kk) * ldb];
+            for (int c = 0; c < cols; ++c)
+                bp[kk * nr + c] = b_k[c];
+        }
+    } else {
+        for (int c = 0; c < cols; ++c) {
+            const float *b_c = &b[p0 + (size_t)(j0 + c) * ldb];
+            for (int kk = 0; kk < kb; ++kk)
+                bp[kk * nr + c] = b_c[kk];
+        }
+    }
+}
+
+inline size_t a_pack_size(int m, int k) {
+    return rnd_up(sizeof(float) * rnd_up(nstl::min<int>(m,
+                    jit_avx2_gemm_f32::mc), jit_avx2_gemm_f32::mr)
+            * nstl::min<int>(k, jit_avx2_gemm_f32::kc), 64);
+}
+
+}
+
+jit_avx2_gemm_f32::jit_avx2_gemm_f32(bool transa, bool transb, float beta)
+    : transa_(transa), transb_(transb), beta_(beta)
+{
+    ker_beta0_ = jit_kernel_cache_t::get<xbyak_gemm>(true, true);
+    ker_beta1_ = jit_kernel_cache_t::get<xbyak_gemm>(false, false);
+}
+
+jit_avx2_gemm_f32::~jit_avx2_gemm_f32() {
+    jit_kernel_cache_t::release(ker_beta0_);
+    jit_kernel_cache_t::release(ker_beta1_);
+}
+
+size_t jit_avx2_gemm_f32::ws_size(int m, int n, int k) {
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
+    return a_pack_size(m, k)
+        + sizeof(float) * rnd_up(n, (int)nr) * nstl::min<int>(k, kc);
+}
+
+void jit_avx2_gemm_f32::sgemm(int m, int n, int k, float alpha,
+        const float *a, int lda, const float *b, int ldb, float *c, int ldc,
+        char *ws) {
+    if (m <= 0 || n <= 0) return;
+
+    /* the first block of k overwrites C if beta == 0, otherwise C is
+     * scaled by beta beforehand and the blocks accumulate to it */
+    const bool beta0 = beta_ == 0;
+    const bool no_product = k <= 0 || alpha == 0;
+    if (beta_ != 1 && (no_product || !beta0)) {
+#       pragma omp parallel for schedule(static)
+        for (int j = 0; j < n; ++j)
+            for (int i = 0; i < m; ++i)
+                c[i + (size_t)j * ldc] = beta0
+                    ? 0 : beta_ * c[i + (size_t)j * ldc];
+    }
+    if (no_product) return;
+
+    char *own_ws = nullptr;
+    if (ws == nullptr) ws = own_ws = (char *)malloc(ws_size(m, n, k), 64);
+    float *ap = (float *)ws;
+    float *bp = (float *)(ws + a_pack_size(m, k));
+
+    const int nb_n = div_up(n, (int)nr);
+    for (int p0 = 0; p0 < k; p0 += kc) {
+        const int kb = nstl::min<int>(kc, k - p0);
+        const bool first = p0 == 0 && beta0;
+        xbyak_gemm *ker = first ? ker_beta0_ : ker_beta1_;
+
+#       pragma omp parallel for schedule(static)
+        for (int jp = 0; jp < nb_n; ++jp)
+            pack_b(transb_, nstl::min<int>(nr, n - jp * nr), kb, b, ldb, p0,
+                    jp * nr, &bp[(size_t)jp * nr * kb]);
+
+        for (int i0 = 0; i0 < m; i0 += mc) {
+            const int mb = nstl::min<int>(mc, m - i0);
+            const int nb_m = div_up(mb, (int)mr);
+
+#           pragma omp parallel for schedule(static)
+            for (int ip = 0; ip < nb_m; ++ip)
+                pack_a(transa_, nstl::min<int>(mr, mb - ip * mr), kb, a, lda,
+                        i0 + ip * mr, p0, alpha, &ap[(size_t)ip * mr * kb]);
+
+#           pragma omp parallel for collapse(2) schedule(static)
+            for (int jp = 0; jp < nb_n; ++jp) {
+                for (int ip = 0; ip < nb_m; ++ip) {
+                    const int i = i0 + ip * mr, j = jp * nr;
+                    const int rows = nstl::min<int>(mr, m - i);
+                    const int cols = nstl::min<int>(nr, n - j);
+
+                    jit_gemm_call_s args;
+                    args.a = &ap[(size_t)ip * mr * kb];
+                    args.b = &bp[(size_t)jp * nr * kb];
+                    args.k = kb;
+
+                    if (rows == mr && cols == nr) {
+                        args.c = &c[i + (size_t)j * ldc];
+                        args.ldc = ldc;
+                        (*ker)(&args);
+                        continue;
+                    }
+
+                    /* a partial tile goes through a local buffer */
+                    float tile[mr * nr];
+                    args.c = tile;
+                    args.ldc = mr;
+                    (*ker_beta0_)(&args);
+                    for (int jj = 0; jj < cols; ++jj) {
+                        float *c_j = &c[i + (size_t)(j + jj) * ldc];
+                        for (int ii = 0; ii < rows; ++ii)
+                            c_j[ii] = (first ? 0 : c_j[ii])
+                                + tile[jj * mr + ii];
+                    }
+                }
+            }
+        }
+    }
+
+    free(own_ws);
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
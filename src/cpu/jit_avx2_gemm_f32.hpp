@@ -0,0 +1,62 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_JIT_AVX2_GEMM_F32_HPP
+#define CPU_JIT_AVX2_GEMM_F32_HPP
+
+#include "c_types_map.hpp"
+#include "jit_generator.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/** single precision gemm: C = alpha * op(A) * op(B) + beta * C
+ *
+ * matrices are column-major as in BLAS, op(X) is X or its transpose.
+ * A and B are packed by blocks of kc x mc and kc x n into panels of mr rows
+ * and nr columns, and the jit micro-kernel accumulates an mr x nr tile of C
+ * in registers. the tiles of a block are computed in parallel */
+struct jit_avx2_gemm_f32 {
+    enum { mr = 16, nr = 6, mc = 256, kc = 256 };
+
+    jit_avx2_gemm_f32(bool transa, bool transb, float beta);
+    ~jit_avx2_gemm_f32();
+
+    /** returns the size of the workspace sgemm() needs for these sizes */
+    static size_t ws_size(int m, int n, int k);
+
+    /** @p ws is ws_size(m, n, k) bytes of scratch memory aligned on 64
+     * bytes, or nullptr to let sgemm() allocate it on its own */
+    void sgemm(int m, int n, int k, float alpha, const float *a, int lda,
+            const float *b, int ldb, float *c, int ldc, char *ws = nullptr);
+
+private:
+    struct xbyak_gemm;
+
+    bool transa_, transb_;
+    float beta_;
+    xbyak_gemm *ker_beta0_; /* C = A * B */
+    xbyak_gemm *ker_beta1_; /* C += A * B */
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -14,11 +14,16 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <omp.h>
+#include <string.h>
+#include <string>
+
 #include "mkldnn_types.h"
 
 #include "c_types_map.hpp"
 #include "jit_avx2_lrn.hpp"
 #include "jit_generator.hpp"
+#include "jit_kernel_cache.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
@@ -29,22 +34,22 @@ namespace cpu {
 using namespace mkldnn::impl::status;
 using namespace mkldnn::impl::memory_format;
 
-enum { VECTOR_LENGTH = 8, MAX_LOCAL_SIZE = 32 };
+enum { VECTOR_LENGTH = 8 };
 typedef struct {
     const float *src;
-    float *dst, *scratch;
+    float *dst, *scratch, *buf;
 } jit_args_t;
 
+typedef struct {
+    const float *src, *diff_dst, *scratch;
+    float *diff_src;
+} jit_args_bwd_t;
+
 struct nchw8c_across {
     int HW, version; // -1 channels 0..7, 1 channels C-8 .. C-1, 0 -- other channels
     nchw8c_across(int hw, int v) : HW(hw), version(v) {}
 };
 
-struct nchw8c_within {
-    int H, W, size;
-    nchw8c_within(int h, int w, int s) : H(h), W(w), size(s) {}
-};
-
 struct nchw_across {
     int C, HW, tail;
     nchw_across(int c, int hw, int t) : C(c), HW(hw), tail(t) {}
@@ -55,6 +60,53 @@ struct nhwc_across {
     nhwc_across(int c) : C(c) {}
 };
 
+/* general kernels: any odd local size, beta and k */
+struct nchw8c_across_gen {
+    int HW, size, has_prev, has_next;
+    nchw8c_across_gen(int hw, int s, int p, int n)
+        : HW(hw), size(s), has_prev(p), has_next(n) {}
+};
+
+struct nchw_across_gen {
+    int C, HW, tail, size;
+    nchw_across_gen(int c, int hw, int t, int s)
+        : C(c), HW(hw), tail(t), size(s) {}
+};
+
+struct nhwc_across_gen {
+    int C, size;
+    nhwc_across_gen(int c, int s) : C(c), size(s) {}
+};
+
+/* one row of a within channel lrn plane, see execute_forward(): the row is
+ * W vectors of channels stride bytes apart (nChw8c, nhwc) or, if stride is
+ * 0, W floats of nchw. buf accumulates the window sums of the plane */
+enum { within_acc_add = 0, within_acc_sub = 1, within_norm = 2 };
+struct within_row_gen {
+    int W, size, stride, tail, op;
+    within_row_gen(int w, int s, int st, int t, int o)
+        : W(w), size(s), stride(st), tail(t), op(o) {}
+};
+
+template <typename J>
+struct lrn_kernel_key_t {
+    J j;
+    float alpha, beta, k;
+    prop_kind_t pk;
+};
+
+template <typename kernel_t, typename J>
+kernel_t *get_lrn_kernel(const J &j, float alpha, float beta, float k,
+        prop_kind_t pk) {
+    const lrn_kernel_key_t<J> key = { j, alpha, beta, k, pk };
+    return jit_kernel_cache_t::get<kernel_t>(key, j, alpha, beta, k, pk);
+}
+
+static const uint32_t lrn_tail_mask[] = {
+    0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000,
+    0x80000000, 0, 0, 0, 0, 0, 0, 0
+};
+
 struct jit_avx2_lrn_fwd_t::xbyak_lrn: public jit_generator {
     Xbyak::Reg64 src = rax;
     Xbyak::Reg64 dst = r8;
@@ -70,126 +122,448 @@ struct jit_avx2_lrn_fwd_t::xbyak_lrn: public jit_generator {
     void (*ker)(jit_args_t *);
     void operator()(jit_args_t *arg) { ker(arg); }
 
-    void within_body(
-        int hoff, int Hoff, int woff, int Woff, int stride,
-        Xbyak::Ymm ysum, Xbyak::Ymm ydst, Xbyak::Ymm ytmp, Xbyak::Ymm ysum2,
-        prop_kind_t pk)
+    /* general kernels */
+    Xbyak::Reg64 buf = r11;
+    Xbyak::Reg64 cnt = r9;
+    Xbyak::Reg64 reg_table = r12;
+
+    Xbyak::Ymm yk = ymm1;
+    Xbyak::Ymm ymask = ymm2;
+    Xbyak::Ymm ybase = ymm11;
+    Xbyak::Ymm ynorm = ymm12;
+    Xbyak::Ymm yt0 = ymm13;
+    Xbyak::Ymm yt1 = ymm14;
+    Xbyak::Ymm yt2 = ymm15;
+
+    enum {
+        t_k, t_beta, t_one, t_half, t_mant_mask, t_sqrthf, t_126, t_127,
+        t_log_p0, t_log_q1 = t_log_p0 + 9, t_log_q2,
+        t_exp_hi, t_exp_lo, t_log2e, t_exp_c1, t_exp_c2,
+        t_exp_p0, t_size = t_exp_p0 + 6
+    };
+    float beta;
+    float table[t_size * VECTOR_LENGTH];
+    int label_cnt;
+
+    Xbyak::Address cst(int i) { return ptr[reg_table + i * 4 * VECTOR_LENGTH]; }
+
+    void init_general(float B, float K, int tail) {
+        auto set = [&](int i, float v) {
+            for (int j = 0; j < VECTOR_LENGTH; ++j)
+                table[i * VECTOR_LENGTH + j] = v;
+        };
+        auto set_bits = [&](int i, uint32_t v) {
+            float f;
+            memcpy(&f, &v, sizeof(f));
+            set(i, f);
+        };
+        /* cephes logf() and expf() */
+        static const float log_p[] = { 7.0376836292E-2f, -1.1514610310E-1f,
+            1.1676998740E-1f, -1.2420140846E-1f, 1.4249322787E-1f,
+            -1.6668057665E-1f, 2.0000714765E-1f, -2.4999993993E-1f,
+            3.3333331174E-1f };
+        static const float exp_p[] = { 1.9875691500E-4f, 1.3981999507E-3f,
+            8.3334519073E-3f, 4.1665795894E-2f, 1.6666665459E-1f,
+            5.0000001201E-1f };
+
+        set(t_k, K);
+        set(t_beta, B);
+        set(t_one, 1.f);
+        set(t_half, 0.5f);
+        set_bits(t_mant_mask, 0x007fffff);
+        set(t_sqrthf, 0.707106781186547524f);
+        set_bits(t_126, 126);
+        set_bits(t_127, 127);
+        for (int i = 0; i < 9; ++i) set(t_log_p0 + i, log_p[i]);
+        set(t_log_q1, -2.12194440e-4f);
+        set(t_log_q2, 0.693359375f);
+        set(t_exp_hi, 88.f);
+        set(t_exp_lo, -87.f);
+        set(t_log2e, 1.44269504088896341f);
+        set(t_exp_c1, 0.693359375f);
+        set(t_exp_c2, -2.12194440e-4f);
+        for (int i = 0; i < 6; ++i) set(t_exp_p0 + i, exp_p[i]);
+        beta = B;
+        label_cnt = 0;
+
+        this->preamble();
+
+        mov(src, ptr[this->param1 + 0]);
+        mov(dst, ptr[this->param1 + 8]);
+        mov(scratch, ptr[this->param1 + 16]);
+        mov(buf, ptr[this->param1 + 24]);
+        mov(imm_addr64, reinterpret_cast<size_t>(&this->alpha));
+        vbroadcastss(yalpha, ptr[imm_addr64]);
+        mov(reg_table, reinterpret_cast<size_t>(&this->table[0]));
+        vmovups(yk, cst(t_k));
+        if (tail != 0) {
+            mov(imm_addr64,
+                    reinterpret_cast<size_t>(&lrn_tail_mask[7 - tail]));
+            vmovups(ymask, ptr[imm_addr64]);
+        }
+    }
+
+    void load(Xbyak::Ymm y, const Xbyak::Address &addr, bool masked) {
+        if (masked) vmaskmovps(y, ymask, addr);
+        else vmovups(y, addr);
+    }
+
+    void store(const Xbyak::Address &addr, Xbyak::Ymm y, bool masked) {
+        if (masked) vmaskmovps(addr, ymask, y);
+        else vmovups(addr, y);
+    }
+
+    /* ynorm = ybase^beta, ybase > 0 is preserved */
+    void pow_beta() {
+        if (beta == 1.f) {
+            vmovaps(ynorm, ybase);
+            return;
+        } else if (beta == 0.5f) {
+            vsqrtps(ynorm, ybase);
+            return;
+        } else if (beta == 0.75f) {
+            vmulps(ynorm, ybase, ybase);
+            vmulps(ynorm, ynorm, ybase);
+            vsqrtps(ynorm, ynorm);
+            vsqrtps(ynorm, ynorm);
+            return;
+        }
+
+        /* log: ybase = m * 2^e, m in [0.5, 1) */
+        vpsrld(yt0, ybase, 23);
+        vpsubd(yt0, yt0, cst(t_126));
+        vcvtdq2ps(yt0, yt0); // yt0 = e
+        vandps(yt1, ybase, cst(t_mant_mask));
+        vorps(yt1, yt1, cst(t_half)); // yt1 = m
+        vcmpltps(yt2, yt1, cst(t_sqrthf));
+        vandps(ynorm, yt1, yt2);
+        vsubps(yt1, yt1, cst(t_one));
+        vaddps(yt1, yt1, ynorm); // yt1 = x = m < sqrt(0.5) ? 2m - 1 : m - 1
+        vandps(yt2, yt2, cst(t_one));
+        vsubps(yt0, yt0, yt2);
+        vmovups(ynorm, cst(t_log_p0));
+        for (int i = 1; i < 9; ++i)
+            vfmadd213ps(ynorm, yt1, cst(t_log_p0 + i));
+        vmulps(yt2, yt1, yt1); // yt2 = x^2
+        vmulps(ynorm, ynorm, yt1);
+        vmulps(ynorm, ynorm, yt2);
+        vfmadd231ps(ynorm, yt0, cst(t_log_q1));
+        vfnmadd231ps(ynorm, yt2, cst(t_half));
+        vaddps(ynorm, ynorm, yt1);
+        vfmadd231ps(ynorm, yt0, cst(t_log_q2)); // ynorm = log(ybase)
+
+        /* exp(beta * log(ybase)) = 2^n * exp(r), r = a - n * ln2 */
+        vmulps(ynorm, ynorm, cst(t_beta));
+        vminps(ynorm, ynorm, cst(t_exp_hi));
+        vmaxps(ynorm, ynorm, cst(t_exp_lo));
+        vmulps(yt0, ynorm, cst(t_log2e));
+        vroundps(yt0, yt0, 0); // yt0 = n
+        vfnmadd231ps(ynorm, yt0, cst(t_exp_c1));
+        vfnmadd231ps(ynorm, yt0, cst(t_exp_c2)); // ynorm = r
+        vmovups(yt1, cst(t_exp_p0));
+        for (int i = 1; i < 6; ++i)
+            vfmadd213ps(yt1, ynorm, cst(t_exp_p0 + i));
+        vmulps(yt2, ynorm, ynorm);
+        vfmadd213ps(yt1, yt2, ynorm);
+        vaddps(yt1, yt1, cst(t_one)); // yt1 = exp(r)
+        vcvtps2dq(yt0, yt0);
+        vpaddd(yt0, yt0, cst(t_127));
+        vpslld(yt0, yt0, 23); // yt0 = 2^n
+        vmulps(ynorm, yt1, yt0);
+    }
+
+    /* dst = ysrc / (k + alpha * ysum)^beta, ws = (k + alpha * ysum)^(1+beta) */
+    void lrn_out(Xbyak::Ymm ysrc, Xbyak::Ymm ysum, const Xbyak::Address &d,
+            const Xbyak::Address &ws, bool masked, prop_kind_t pk) {
+        vmovaps(ybase, yk);
+        vfmadd231ps(ybase, ysum, yalpha);
+        pow_beta();
+        vdivps(yt0, ysrc, ynorm);
+        store(d, yt0, masked);
+        if (pk != prop_kind::forward_inference) {
+            vmulps(ynorm, ynorm, ybase);
+            store(ws, ynorm, masked);
+        }
+    }
+
+    /* emits body() n times, as a loop over cnt if n > 1 */
+    template <typename F> void repeat(int n, F body) {
+        if (n <= 0) return;
+        if (n == 1) { body(); return; }
+        std::string l = ".g" + std::to_string(label_cnt++);
+        mov(cnt, n);
+        L(l);
+        body();
+        dec(cnt);
+        jnz(l, T_NEAR);
+    }
+
+    /* emits body(add, sub) for i in [0, len) of a window of 2 * half + 1
+     * sliding along i: the element i + half enters the window (add) if it
+     * exists and the element i - half - 1 leaves it (sub) if it exists */
+    template <typename F> void sliding(int len, int half, F body) {
+        for (int i = 0; i < len;) {
+            const bool add = i + half < len, sub = i - half - 1 >= 0;
+            int j = i + 1;
+            while (j < len && (j + half < len) == add
+                    && (j - half - 1 >= 0) == sub)
+                ++j;
+            repeat(j - i, [&]() { body(add, sub); });
+            i = j;
+        }
+    }
+
+    xbyak_lrn(
+        const struct nchw_across_gen &J,
+        float A, float B, float K,
+        prop_kind_t pk,
+        void *code_ptr = nullptr,
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+        , alpha(A)
     {
+        Xbyak::Ymm ysum = ymm3;
+        Xbyak::Ymm ysrc = ymm4;
+        Xbyak::Ymm ytmp = ymm5;
+
+        const int half = (J.size - 1) / 2;
+        const int cs = J.HW * 4;
+        const bool m = J.tail != 0;
+
+        init_general(B, K, J.tail);
+
         vxorps(ysum, ysum, ysum);
-        for (int i = hoff; i <= Hoff; ++i)
-        {
-            for (int j = woff; j <= Woff; ++j)
-            {
-                if (i == 0 && j == 0)
-                {
-                    vmovups(ydst, ptr[src]);
-                    vfmadd231ps(ysum, ydst, ydst);
-                }
-                else
-                {
-                    vmovups(ytmp, ptr[src + (i * stride + j)* VECTOR_LENGTH * 4]);
-                    vfmadd231ps(ysum, ytmp, ytmp);
-                }
-            }
+        for (int c = 0; c < nstl::min(half, J.C); ++c) {
+            load(ytmp, ptr[src + c * cs], m);
+            vfmadd231ps(ysum, ytmp, ytmp);
         }
-        vfmadd132ps(ysum, yone, yalpha); // ysum <- ysum*yalpha+yone
-        vmovaps(ytmp, ysum);
-        vmulps(ysum2, ysum, ysum);
-        vmulps(ysum, ysum, ysum2); // ysum = (ysum*yalpha+yone)^3;
-        vsqrtps(ysum, ysum);
-        vsqrtps(ysum, ysum); // ysum = (ysum*yalpha+yone)^0.75
-        vdivps(ydst, ydst, ysum); // ydst <- ydst / ysum
-        if (pk != prop_kind::forward_inference)
-            vmulps(ysum, ysum, ytmp); // ysum = (ysum*yalpha+yone) ^ 1.75 -- for back prop
-        vmovups(ptr[dst], ydst);
-        if (pk != prop_kind::forward_inference)
-            vmovups(ptr[scratch], ysum);
-        add(src, 32);
-        add(dst, 32);
-        if (pk != prop_kind::forward_inference)
+
+        sliding(J.C, half, [&](bool add_c, bool sub_c) {
+            if (add_c) {
+                load(ytmp, ptr[src + half * cs], m);
+                vfmadd231ps(ysum, ytmp, ytmp);
+            }
+            if (sub_c) {
+                load(ytmp, ptr[src - (half + 1) * cs], m);
+                vfnmadd231ps(ysum, ytmp, ytmp);
+            }
+            load(ysrc, ptr[src], m);
+            lrn_out(ysrc, ysum, ptr[dst], ptr[scratch], m, pk);
+            add(src, cs);
+            add(dst, cs);
+            add(scratch, cs);
+        });
+
+        this->postamble();
+
+        ker = reinterpret_cast<decltype(ker)>(const_cast<uint8_t*>(
+                    this->getCode()));
+    }
+
+    xbyak_lrn(
+        const struct nchw8c_across_gen &J,
+        float A, float B, float K,
+        prop_kind_t pk,
+        void *code_ptr = nullptr,
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+        , alpha(A)
+    {
+        Xbyak::Reg64 t = rsp;
+        Xbyak::Ymm ysum = ymm3;
+        Xbyak::Ymm ysrc = ymm4;
+        Xbyak::Ymm ytmp = ymm5;
+
+        /* t stages the squares of the previous, the current and the next
+         * blocks of channels, a missing neighbour is zeros */
+        const int half = (J.size - 1) / 2;
+        const int bs = J.HW * 4 * VECTOR_LENGTH;
+
+        init_general(B, K, 0);
+
+        sub(t, 96);
+        vxorps(ytmp, ytmp, ytmp);
+        if (!J.has_prev) vmovups(ptr[t + 0], ytmp);
+        if (!J.has_next) vmovups(ptr[t + 64], ytmp);
+
+        repeat(J.HW, [&]() {
+            if (J.has_prev) {
+                vmovups(ytmp, ptr[src - bs]);
+                vmulps(ytmp, ytmp, ytmp);
+                vmovups(ptr[t + 0], ytmp);
+            }
+            vmovups(ysrc, ptr[src]);
+            vmulps(ytmp, ysrc, ysrc);
+            vmovups(ptr[t + 32], ytmp);
+            if (J.has_next) {
+                vmovups(ytmp, ptr[src + bs]);
+                vmulps(ytmp, ytmp, ytmp);
+                vmovups(ptr[t + 64], ytmp);
+            }
+            vmovups(ysum, ptr[t + 32 - 4 * half]);
+            for (int o = -half + 1; o <= half; ++o)
+                vaddps(ysum, ysum, ptr[t + 32 + 4 * o]);
+            lrn_out(ysrc, ysum, ptr[dst], ptr[scratch], false, pk);
+            add(src, 32);
+            add(dst, 32);
             add(scratch, 32);
+        });
+
+        add(t, 96);
+        this->postamble();
+
+        ker = reinterpret_cast<decltype(ker)>(const_cast<uint8_t*>(
+                    this->getCode()));
     }
 
     xbyak_lrn(
-        const struct nchw8c_within &J,
-        float A,
+        const struct nhwc_across_gen &J,
+        float A, float B, float K,
         prop_kind_t pk,
         void *code_ptr = nullptr,
-        size_t code_size = 2 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
         : jit_generator(code_ptr, code_size)
         , alpha(A)
     {
-        Xbyak::Reg64 h = r9;
-        Xbyak::Reg64 w = r10;
-        Xbyak::Ymm ysum = ymm9;
-        Xbyak::Ymm ysum2 = ymm10;
-        Xbyak::Ymm ydst = ymm11;
-        Xbyak::Ymm ytmp = ymm12;
+        Xbyak::Reg64 t = rsp;
+        Xbyak::Reg64 sq = r10;
+        Xbyak::Reg64 in = r13;
+        Xbyak::Ymm ysum = ymm3;
+        Xbyak::Ymm ysrc = ymm4;
+        Xbyak::Ymm ytmp = ymm5;
+
+        /* t stages the squares of the pixel with pad zeros on either side */
+        const int half = (J.size - 1) / 2;
+        const int pad = utils::rnd_up(half, VECTOR_LENGTH);
+        const int nb = J.C / VECTOR_LENGTH, tail = J.C % VECTOR_LENGTH;
+        const int padded = utils::rnd_up(J.C, VECTOR_LENGTH);
+        const int stack_size = 4 * (2 * pad + padded);
+
+        init_general(B, K, tail);
+
+        sub(t, stack_size);
+        vxorps(ytmp, ytmp, ytmp);
+        for (int i = 0; i < pad; i += VECTOR_LENGTH) {
+            vmovups(ptr[t + 4 * i], ytmp);
+            vmovups(ptr[t + 4 * (pad + padded + i)], ytmp);
+        }
 
-        static const char *label[MAX_LOCAL_SIZE] = {
-            ".l00", ".l01", ".l02", ".l03", ".l04", ".l05", ".l06", ".l07", ".l08", ".l09",
-            ".l10", ".l11", ".l12", ".l13", ".l14", ".l15", ".l16", ".l17", ".l18", ".l19",
-            ".l20", ".l21", ".l22", ".l23", ".l24", ".l25", ".l26", ".l27", ".l28", ".l29",
-            ".l30", ".l31"
+        mov(in, src);
+        lea(sq, ptr[t + 4 * pad]);
+        auto square = [&](bool m) {
+            load(ytmp, ptr[in], m);
+            vmulps(ytmp, ytmp, ytmp);
+            vmovups(ptr[sq], ytmp); // masked out channels are zeros
+            add(in, 32);
+            add(sq, 32);
         };
+        repeat(nb, [&]() { square(false); });
+        if (tail) square(true);
+
+        lea(sq, ptr[t + 4 * pad]);
+        auto norm = [&](bool m) {
+            vmovups(ysum, ptr[sq - 4 * half]);
+            for (int o = -half + 1; o <= half; ++o)
+                vaddps(ysum, ysum, ptr[sq + 4 * o]);
+            load(ysrc, ptr[src], m);
+            lrn_out(ysrc, ysum, ptr[dst], ptr[scratch], m, pk);
+            add(src, 32);
+            add(dst, 32);
+            add(scratch, 32);
+            add(sq, 32);
+        };
+        repeat(nb, [&]() { norm(false); });
+        if (tail) norm(true);
 
-        this->preamble();
+        add(t, stack_size);
+        this->postamble();
 
-        mov(src, ptr[this->param1 + 0]);
-        mov(dst, ptr[this->param1 + 8]);
-        if (pk != prop_kind::forward_inference)
-            mov(scratch, ptr[this->param1 + 16]);
-        mov(imm_addr64, reinterpret_cast<size_t>(&this->alpha));
-        vbroadcastss(yalpha, ptr[imm_addr64]);
-        mov(imm_addr64, reinterpret_cast<size_t>(&this->one));
-        vbroadcastss(yone, ptr[imm_addr64]);
+        ker = reinterpret_cast<decltype(ker)>(const_cast<uint8_t*>(
+                    this->getCode()));
+    }
+
+    xbyak_lrn(
+        const struct within_row_gen &J,
+        float A, float B, float K,
+        prop_kind_t pk,
+        void *code_ptr = nullptr,
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+        , alpha(A)
+    {
+        Xbyak::Ymm ysum = ymm3;
+        Xbyak::Ymm ysrc = ymm4;
+        Xbyak::Ymm ytmp = ymm5;
+        Xbyak::Ymm yacc = ymm6;
 
-        int s2 = (J.size - 1) / 2, S2 = J.size - s2 - 1;
-        const char **label_t = &label[0];
-        const char **label_b = &label[s2];
+        const int half = (J.size - 1) / 2;
+        const bool m = J.tail != 0;
 
-        for (int i = 0; i < s2; ++i)
-        {
-            for (int j = 0; j < s2; ++j)
-                within_body(-i, S2, -j, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-            mov(w, J.W - J.size + 1);
-            L(label_t[i]);
-            within_body(-i, S2, -s2, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-            dec(w);
-            cmp(w, 0);
-            jne(label_t[i], T_NEAR);
-            for (int j = J.W - S2; j < J.W; ++j)
-                within_body(-i, S2, -s2, J.W - 1 - j, J.W, ysum, ydst, ytmp, ysum2, pk);
-        }
-
-        mov(h, J.H - J.size + 1);
-        L(".lrn_loop_h");
-        for (int j = 0; j < s2; ++j)
-            within_body(-s2, S2, -j, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-        mov(w, J.W - J.size + 1);
-        L(".lrn_loop_w");
-        within_body(-s2, S2, -s2, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-        dec(w);
-        cmp(w, 0);
-        jne(".lrn_loop_w", T_NEAR);
-        for (int j = J.W - S2; j < J.W; ++j)
-            within_body(-s2, S2, -s2, J.W - 1 - j, J.W, ysum, ydst, ytmp, ysum2, pk);
-        dec(h);
-        cmp(h, 0);
-        jne(".lrn_loop_h", T_NEAR);
-
-        for (int i = J.H - S2; i < J.H; ++i)
-        {
-            for (int j = 0; j < s2; ++j)
-                within_body(-s2, J.H - 1 - i, -j, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-            mov(w, J.W - J.size + 1);
-            L(label_b[i - (J.H - S2)]);
-            within_body(-s2, J.H - 1 - i, -s2, S2, J.W, ysum, ydst, ytmp, ysum2, pk);
-            dec(w);
-            cmp(w, 0);
-            jne(label_b[i - (J.H - S2)], T_NEAR);
-            for (int j = J.W - S2; j < J.W; ++j)
-                within_body(-s2, J.H - 1 - i, -s2, J.W - 1 - j, J.W, ysum, ydst, ytmp, ysum2, pk);
+        init_general(B, K, J.tail);
+
+        auto accumulate = [&](Xbyak::Ymm y, int off) {
+            vmovups(yacc, ptr[buf + off]);
+            if (J.op == within_acc_add) vaddps(yacc, yacc, y);
+            else vsubps(yacc, yacc, y);
+            vmovups(ptr[buf + off], yacc);
+        };
+
+        if (J.stride != 0 && J.op != within_norm) {
+            /* buf[w] +-= sum of the squares around w along the row */
+            const int es = J.stride;
+            vxorps(ysum, ysum, ysum);
+            for (int w = 0; w < nstl::min(half, J.W); ++w) {
+                load(ytmp, ptr[src + w * es], m);
+                vfmadd231ps(ysum, ytmp, ytmp);
+            }
+            sliding(J.W, half, [&](bool add_w, bool sub_w) {
+                if (add_w) {
+                    load(ytmp, ptr[src + half * es], m);
+                    vfmadd231ps(ysum, ytmp, ytmp);
+                }
+                if (sub_w) {
+                    load(ytmp, ptr[src - (half + 1) * es], m);
+                    vfnmadd231ps(ysum, ytmp, ytmp);
+                }
+                accumulate(ysum, 0);
+                add(src, es);
+                add(buf, 32);
+            });
+        } else if (J.stride != 0) {
+            const int es = J.stride;
+            repeat(J.W, [&]() {
+                vmovups(ysum, ptr[buf]);
+                load(ysrc, ptr[src], m);
+                lrn_out(ysrc, ysum, ptr[dst], ptr[scratch], m, pk);
+                add(src, es);
+                add(dst, es);
+                add(scratch, es);
+                add(buf, 32);
+            });
+        } else {
+            /* nchw: buf is the row of the vertical sums with pad zeros on
+             * either side, the horizontal sums are taken at the output */
+            const int pad = utils::rnd_up(half, VECTOR_LENGTH);
+            const int nv = J.W / VECTOR_LENGTH;
+            auto step = [&](bool masked) {
+                if (J.op != within_norm) {
+                    load(ytmp, ptr[src], masked);
+                    vmulps(ytmp, ytmp, ytmp);
+                    accumulate(ytmp, 4 * pad);
+                } else {
+                    vmovups(ysum, ptr[buf + 4 * (pad - half)]);
+                    for (int o = -half + 1; o <= half; ++o)
+                        vaddps(ysum, ysum, ptr[buf + 4 * (pad + o)]);
+                    load(ysrc, ptr[src], masked);
+                    lrn_out(ysrc, ysum, ptr[dst], ptr[scratch], masked, pk);
+                    add(dst, 32);
+                    add(scratch, 32);
+                }
+                add(src, 32);
+                add(buf, 32);
+            };
+            repeat(nv, [&]() { step(false); });
+            if (m) step(true);
         }
 
         this->postamble();
@@ -200,7 +574,7 @@ struct jit_avx2_lrn_fwd_t::xbyak_lrn: public jit_generator {
 
     xbyak_lrn(
         const struct nchw8c_across &J,
-        float A,
+        float A, float B, float K,
         prop_kind_t pk,
         void *code_ptr = nullptr,
         size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
@@ -295,7 +669,7 @@ struct jit_avx2_lrn_fwd_t::xbyak_lrn: public jit_generator {
 
     xbyak_lrn(
         const struct nhwc_across &J,
-        float A,
+        float A, float B, float K,
         prop_kind_t pk,
         void *code_ptr = nullptr,
         size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
@@ -462,7 +836,7 @@ struct jit_avx2_lrn_fwd_t::xbyak_lrn: public jit_generator {
 
     xbyak_lrn(
         struct nchw_across J,
-        float A,
+        float A, float B, float K,
         prop_kind_t pk,
         void* code_ptr = nullptr,
         size_t code_size = 2 * Xbyak::DEFAULT_MAX_CODE_SIZE)
@@ -559,31 +933,45 @@ status_t jit_avx2_lrn_fwd_t::pd_t::init() {
 
     const memory_desc_wrapper data_d(data_pd_.desc());
     bool ok = true
+        && mayiuse(avx2)
         && utils::one_of(desc()->prop_kind, forward_training, forward_inference)
         && utils::everyone_is(data_type::f32, desc()->data_desc.data_type)
         && data_d.ndims() == 4
-        && data_d.dims()[1] % VECTOR_LENGTH == 0
-        && data_d.dims()[1] >= 2 * VECTOR_LENGTH
-        && desc()->lrn_beta == 0.75;
+        && desc()->local_size % 2 == 1
+        && desc()->lrn_alpha >= 0
+        && desc()->lrn_k > 0 // the power is taken via log()
+        && utils::implication(data_d.format() == nChw8c,
+                data_d.dims()[1] % VECTOR_LENGTH == 0);
     if (!ok) return unimplemented;
 
     if (desc_.prop_kind == forward_training) { ws_pd_ = data_pd_; }
 
     bool args_ok_across = true
         && desc()->alg_kind == lrn_across_channels
-        && desc()->local_size == 5
-        && utils::one_of(data_d.format(), nChw8c, nchw, nhwc);
+        && utils::one_of(data_d.format(), nChw8c, nchw, nhwc)
+        && utils::implication(data_d.format() == nChw8c,
+                desc()->local_size <= 2 * VECTOR_LENGTH + 1);
 
     bool args_ok_within = true
         && desc()->alg_kind == lrn_within_channel
-        && desc()->local_size <= MAX_LOCAL_SIZE
-        && data_d.dims()[2] >= desc()->local_size
-        && data_d.dims()[3] >= desc()->local_size
-        && utils::one_of(data_d.format(), nChw8c);
+        && utils::one_of(data_d.format(), nChw8c, nchw, nhwc);
+
+#if defined(_OPENMP)
+    nthr_ = omp_get_max_threads();
+#else
+    nthr_ = 1;
+#endif
 
     return args_ok_across || args_ok_within ? success : unimplemented;
 }
 
+size_t jit_avx2_lrn_fwd_t::pd_t::within_buf_size() const {
+    const int W = this->W();
+    if (data_pd_.desc()->format != nchw) return W * VECTOR_LENGTH;
+    const int pad = utils::rnd_up((desc()->local_size - 1) / 2, VECTOR_LENGTH);
+    return 2 * pad + utils::rnd_up(W, VECTOR_LENGTH);
+}
+
 jit_avx2_lrn_fwd_t::jit_avx2_lrn_fwd_t(const pd_t *pd,
         const input_vector &inputs, const output_vector &outputs)
     : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd), ker_(nullptr)
@@ -594,35 +982,88 @@ jit_avx2_lrn_fwd_t::jit_avx2_lrn_fwd_t(const pd_t *pd,
     const int H = conf_.H();
     const int W = conf_.W();
     const int ls = conf_.desc()->local_size;
+    const float B = conf_.desc()->lrn_beta;
+    const float K = conf_.desc()->lrn_k;
     double A = conf_.desc()->lrn_alpha / ls;
 
     auto pk = conf_.desc()->prop_kind;
     auto ak = conf_.desc()->alg_kind;
     auto dfmt = conf_.src_pd()->desc()->format;
 
-    if (dfmt == nChw8c && ls == 5 && ak == lrn_across_channels) {
-        ker_ = new xbyak_lrn(nchw8c_across(H*W, 0), A, pk);
-        ker_first_ = new xbyak_lrn(nchw8c_across(H*W, -1), A, pk);
-        ker_last_ = new xbyak_lrn(nchw8c_across(H*W, +1), A, pk);
-    } else if (dfmt == nChw8c && ak == lrn_within_channel) {
-        /* within channel, local_size (x) local_size */
-        A /= ls; /* XXX: why? */
-        ker_ = new xbyak_lrn(nchw8c_within(H, W, ls), A, pk);
-    } else if (dfmt == nchw && ls == 5 && ak == lrn_across_channels) {
-        ker_ = new xbyak_lrn(nchw_across(C, H*W, 0), A, pk);
+    for (int op = 0; op < 3; ++op)
+        ker_within_[op][0] = ker_within_[op][1] = nullptr;
+
+    /* the kernels specialized for alexnet-like lrn */
+    const bool alexnet = true
+        && ak == lrn_across_channels
+        && ls == 5 && B == 0.75f && K == 1.f
+        && C % VECTOR_LENGTH == 0 && C >= 2 * VECTOR_LENGTH;
+
+    if (alexnet && dfmt == nChw8c) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, 0), A, B, K, pk);
+        ker_first_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, -1),
+                A, B, K, pk);
+        ker_last_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, +1),
+                A, B, K, pk);
+    } else if (alexnet && dfmt == nchw) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw_across(C, H*W, 0), A, B, K, pk);
         int remind = (H*W) % VECTOR_LENGTH;
         if (remind != 0) {
-            ker_last_ = new xbyak_lrn(nchw_across(C, H*W, remind), A, pk);
+            ker_last_ = get_lrn_kernel<xbyak_lrn>(nchw_across(C, H*W, remind),
+                    A, B, K, pk);
+        }
+    } else if (alexnet) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nhwc_across(C), A, B, K, pk);
+    } else if (ak == lrn_across_channels && dfmt == nChw8c) {
+        const int nb = C / VECTOR_LENGTH;
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across_gen(H*W, ls, 1, 1),
+                A, B, K, pk);
+        ker_first_ = get_lrn_kernel<xbyak_lrn>(
+                nchw8c_across_gen(H*W, ls, 0, nb > 1), A, B, K, pk);
+        ker_last_ = get_lrn_kernel<xbyak_lrn>(
+                nchw8c_across_gen(H*W, ls, 1, 0), A, B, K, pk);
+    } else if (ak == lrn_across_channels && dfmt == nchw) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw_across_gen(C, H*W, 0, ls),
+                A, B, K, pk);
+        int remind = (H*W) % VECTOR_LENGTH;
+        if (remind != 0) {
+            ker_last_ = get_lrn_kernel<xbyak_lrn>(
+                    nchw_across_gen(C, H*W, remind, ls), A, B, K, pk);
+        }
+    } else if (ak == lrn_across_channels) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nhwc_across_gen(C, ls), A, B, K, pk);
+    } else {
+        /* within channel, local_size (x) local_size */
+        A /= ls;
+        int stride = 0, tail = W % VECTOR_LENGTH;
+        if (dfmt == nChw8c) {
+            stride = 4 * VECTOR_LENGTH;
+            tail = 0;
+        } else if (dfmt == nhwc) {
+            stride = 4 * C;
+            tail = C % VECTOR_LENGTH;
+        }
+        for (int op = 0; op < 3; ++op) {
+            ker_within_[op][0] = get_lrn_kernel<xbyak_lrn>(
+                    within_row_gen(W, ls, stride, stride ? 0 : tail, op),
+                    A, B, K, pk);
+            if (stride != 0 && tail != 0)
+                ker_within_[op][1] = get_lrn_kernel<xbyak_lrn>(
+                        within_row_gen(W, ls, stride, tail, op), A, B, K, pk);
         }
-    } else if (true /* XXX: why */) {
-        ker_ = new xbyak_lrn(nhwc_across(C), A, pk);
     }
 }
 
-jit_avx2_lrn_fwd_t::~jit_avx2_lrn_fwd_t()
-{ delete ker_; delete ker_first_; delete ker_last_; }
+jit_avx2_lrn_fwd_t::~jit_avx2_lrn_fwd_t() {
+    jit_kernel_cache_t::release(ker_);
+    jit_kernel_cache_t::release(ker_first_);
+    jit_kernel_cache_t::release(ker_last_);
+    for (int op = 0; op < 3; ++op)
+    for (int tail = 0; tail < 2; ++tail)
+        jit_kernel_cache_t::release(ker_within_[op][tail]);
+}
 
-void jit_avx2_lrn_fwd_t::execute_forward() {
+void jit_avx2_lrn_fwd_t::execute_forward(char *scratchpad) {
     using namespace alg_kind;
 
     auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
@@ -632,12 +1073,13 @@ void jit_avx2_lrn_fwd_t::execute_forward() {
     const int N = conf_.MB();
     const int C = conf_.C();
     const int HW = conf_.H() * conf_.W();
-    const int ls = conf_.desc()->local_size;
 
     auto ak = conf_.desc()->alg_kind;
     auto dfmt = conf_.src_pd()->desc()->format;
 
-    if (dfmt == nChw8c && ls == 5 && ak == lrn_across_channels) {
+    if (ak == lrn_within_channel) {
+        execute_within(src, dst, ws, scratchpad);
+    } else if (dfmt == nChw8c) {
 #       pragma omp parallel for collapse(2) schedule(static)
         for (int n = 0; n < N; ++n) {
             for (int c8 = 0; c8 < C / VECTOR_LENGTH; ++c8) {
@@ -653,18 +1095,7 @@ void jit_avx2_lrn_fwd_t::execute_forward() {
                     (*ker_)(&args);
             }
         }
-    } else if (dfmt == nChw8c && ak == lrn_within_channel) {
-#       pragma omp parallel for collapse(2) schedule(static)
-        for (int n = 0; n < N; ++n) {
-            for (int c8 = 0; c8 < C / VECTOR_LENGTH; ++c8) {
-                jit_args_t args;
-                args.src = &src[n*HW*C + c8 * HW * VECTOR_LENGTH];
-                args.dst = &dst[n*HW*C + c8 * HW * VECTOR_LENGTH];
-                args.scratch = &ws[n*HW*C + c8 * HW * VECTOR_LENGTH];
-                (*ker_)(&args);
-            }
-        }
-    } else if (dfmt == nchw && ls == 5 && ak == lrn_across_channels) {
+    } else if (dfmt == nchw) {
 #       pragma omp parallel for collapse(2) schedule(static)
         for (int n = 0; n < N; ++n) {
             for (int hw8 = 0; hw8 < (HW + VECTOR_LENGTH - 1) / VECTOR_LENGTH; ++hw8) {
@@ -692,6 +1123,434 @@ void jit_avx2_lrn_fwd_t::execute_forward() {
     }
 }
 
+/* within channel lrn is separable: every row of a plane adds the sums of
+ * its squares along the row to buf when it enters the vertical window and
+ * subtracts them when it leaves it, so that buf holds the window sums of the
+ * current output row */
+void jit_avx2_lrn_fwd_t::execute_within(const data_t *src, data_t *dst,
+        data_t *ws, char *scratchpad) {
+    const int N = conf_.MB();
+    const int C = conf_.C();
+    const int H = conf_.H();
+    const int W = conf_.W();
+    const int half = (conf_.desc()->local_size - 1) / 2;
+    const size_t buf_size = conf_.within_buf_size();
+
+    auto dfmt = conf_.src_pd()->desc()->format;
+    const int CB = dfmt == nchw ? C : utils::div_up(C, VECTOR_LENGTH);
+
+#   pragma omp parallel num_threads(conf_.nthr_)
+    {
+#if defined(_OPENMP)
+        const int ithr = omp_get_thread_num();
+#else
+        const int ithr = 0;
+#endif
+        data_t *buf = reinterpret_cast<data_t *>(scratchpad) + ithr * buf_size;
+
+#       pragma omp for collapse(2) schedule(static)
+        for (int n = 0; n < N; ++n) {
+            for (int cb = 0; cb < CB; ++cb) {
+                size_t off;
+                int row;
+                if (dfmt == nChw8c) {
+                    off = (size_t)(n * CB + cb) * H * W * VECTOR_LENGTH;
+                    row = W * VECTOR_LENGTH;
+                } else if (dfmt == nhwc) {
+                    off = (size_t)n * H * W * C + cb * VECTOR_LENGTH;
+                    row = W * C;
+                } else {
+                    off = (size_t)(n * C + cb) * H * W;
+                    row = W;
+                }
+                const int t = ker_within_[0][1] != nullptr && cb == CB - 1;
+
+                jit_args_t args;
+                args.buf = buf;
+                auto acc = [&](int op, int h) {
+                    args.src = &src[off + h * row];
+                    (*ker_within_[op][t])(&args);
+                };
+
+                memset(buf, 0, buf_size * sizeof(data_t));
+                for (int h = 0; h < nstl::min(half, H); ++h)
+                    acc(within_acc_add, h);
+                for (int h = 0; h < H; ++h) {
+                    if (h + half < H) acc(within_acc_add, h + half);
+                    if (h - half - 1 >= 0) acc(within_acc_sub, h - half - 1);
+                    args.src = &src[off + h * row];
+                    args.dst = &dst[off + h * row];
+                    args.scratch = &ws[off + h * row];
+                    (*ker_within_[within_norm][t])(&args);
+                }
+            }
+        }
+    }
+}
+
+/* backward across channels, ws = base^(1 + beta) from the forward:
+ *   r_c = diff_dst_c / ws_c
+ *   diff_src_c = r_c * base_c - 2 * beta * A * src_c * sum_{j ~ c} src_j * r_j
+ * where base_c = k + A * sum_{j ~ c} src_j^2 */
+struct jit_avx2_lrn_bwd_t::xbyak_lrn: public jit_generator {
+    Xbyak::Reg64 src = rax;
+    Xbyak::Reg64 diff_src = r8;
+    Xbyak::Reg64 diff_dst = r11;
+    Xbyak::Reg64 scratch = rdx;
+    Xbyak::Reg64 imm_addr64 = rbx;
+
+    Xbyak::Ymm yalpha = ymm0;
+    Xbyak::Ymm ycoef = ymm1;
+
+    float alpha, coef;
+    float k[VECTOR_LENGTH];
+
+    void (*ker)(jit_args_bwd_t *);
+    void operator()(jit_args_bwd_t *arg) { ker(arg); }
+
+    void load_args() {
+        mov(src, ptr[this->param1 + 0]);
+        mov(diff_dst, ptr[this->param1 + 8]);
+        mov(scratch, ptr[this->param1 + 16]);
+        mov(diff_src, ptr[this->param1 + 24]);
+        mov(imm_addr64, reinterpret_cast<size_t>(&this->alpha));
+        vbroadcastss(yalpha, ptr[imm_addr64]);
+        mov(imm_addr64, reinterpret_cast<size_t>(&this->coef));
+        vbroadcastss(ycoef, ptr[imm_addr64]);
+        mov(imm_addr64, reinterpret_cast<size_t>(&this->k[0]));
+    }
+
+    xbyak_lrn(
+        const struct nchw8c_across &J,
+        float A, float B, float K,
+        prop_kind_t pk,
+        void *code_ptr = nullptr,
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+        , alpha(A), coef(2 * B * A)
+    {
+        for (int i = 0; i < VECTOR_LENGTH; ++i) k[i] = K;
+        Xbyak::Reg64 t = rsp;
+        Xbyak::Reg64 hw = r9;
+        Xbyak::Xmm xtmp = xmm2;
+        Xbyak::Ymm ysrc = ymm3;
+        Xbyak::Ymm yr = ymm4;
+        Xbyak::Ymm ya = ymm5;
+        Xbyak::Ymm yb = ymm6;
+        Xbyak::Ymm ysum = ymm7;
+        Xbyak::Ymm ytsum = ymm8;
+
+        /* t[0:64) stages src, t[64:128) stages r: 4 channels of the
+         * previous block, the current block and 4 channels of the next one */
+        const int T_SRC = 0, T_R = 64;
+        const int prev = -J.HW * 32 + 16, next = J.HW * 32;
+
+        this->preamble();
+
+        load_args();
+        sub(t, 128);
+        if (J.version == -1) {
+            vxorps(xtmp, xtmp, xtmp);
+            vmovups(ptr[t + T_SRC + 0], xtmp);
+            vmovups(ptr[t + T_R + 0], xtmp);
+        }
+        if (J.version == +1) {
+            vxorps(xtmp, xtmp, xtmp);
+            vmovups(ptr[t + T_SRC + 48], xtmp);
+            vmovups(ptr[t + T_R + 48], xtmp);
+        }
+
+        mov(hw, J.HW);
+        L(".lrn_loop");
+
+        if (J.version != -1) {
+            vmovups(xtmp, ptr[src + prev]);
+            vmovups(ptr[t + T_SRC + 0], xtmp);
+            vmovups(xtmp, ptr[diff_dst + prev]);
+            vdivps(xtmp, xtmp, ptr[scratch + prev]);
+            vmovups(ptr[t + T_R + 0], xtmp);
+        }
+        vmovups(ysrc, ptr[src]);
+        vmovups(ptr[t + T_SRC + 16], ysrc);
+        vmovups(yr, ptr[diff_dst]);
+        vdivps(yr, yr, ptr[scratch]); // yr = diff_dst / ws
+        vmovups(ptr[t + T_R + 16], yr);
+        if (J.version != +1) {
+            vmovups(xtmp, ptr[src + next]);
+            vmovups(ptr[t + T_SRC + 48], xtmp);
+            vmovups(xtmp, ptr[diff_dst + next]);
+            vdivps(xtmp, xtmp, ptr[scratch + next]);
+            vmovups(ptr[t + T_R + 48], xtmp);
+        }
+
+        vmulps(ysum, ysrc, ysrc);
+        vmulps(ytsum, ysrc, yr);
+        for (int off = -8; off <= 8; off += 4) {
+            if (off == 0) continue;
+            vmovups(ya, ptr[t + T_SRC + 16 + off]);
+            vmovups(yb, ptr[t + T_R + 16 + off]);
+            vfmadd231ps(ysum, ya, ya); // ysum <- ysum + ya*ya
+            vfmadd231ps(ytsum, ya, yb); // ytsum <- ytsum + ya*yb
+        }
+
+        vfmadd213ps(ysum, yalpha, ptr[imm_addr64]);
+        vmulps(ysum, ysum, yr); // ysum = yr * base
+        vmulps(ytsum, ytsum, ysrc);
+        vfnmadd231ps(ysum, ytsum, ycoef); // ysum -= ycoef * ysrc * ytsum
+        vmovups(ptr[diff_src], ysum);
+
+        add(src, 32);
+        add(diff_dst, 32);
+        add(scratch, 32);
+        add(diff_src, 32);
+        dec(hw);
+        cmp(hw, 0);
+        jne(".lrn_loop", T_NEAR);
+
+        add(t, 128);
+        this->postamble();
+
+        ker = reinterpret_cast<decltype(ker)>(const_cast<uint8_t*>(
+                    this->getCode()));
+    }
+
+    void nchw_load(int tail, const Xbyak::Address &addr, Xbyak::Ymm ymask,
+            Xbyak::Ymm y)
+    {
+        if (tail != 0)
+            vmaskmovps(y, ymask, addr);
+        else
+            vmovups(y, addr);
+    }
+
+    /* loads src and r of the channel two steps ahead of diff_src */
+    void nchw_load_ahead(int tail, int HW, Xbyak::Ymm ymask, Xbyak::Ymm ytmp,
+            Xbyak::Ymm ye, Xbyak::Ymm yre)
+    {
+        nchw_load(tail, ptr[src + HW * 8], ymask, ye);
+        nchw_load(tail, ptr[diff_dst + HW * 8], ymask, yre);
+        nchw_load(tail, ptr[scratch + HW * 8], ymask, ytmp);
+        vdivps(yre, yre, ytmp); // yre = diff_dst / ws
+    }
+
+    void nchw_body(int tail, Xbyak::Ymm ymask, Xbyak::Ymm *ys,
+            Xbyak::Ymm *yrs, Xbyak::Ymm ysum, Xbyak::Ymm ytsum)
+    {
+        vmulps(ysum, ys[0], ys[0]);
+        vmulps(ytsum, ys[0], yrs[0]);
+        for (int i = 1; i < 5; ++i) {
+            vfmadd231ps(ysum, ys[i], ys[i]);
+            vfmadd231ps(ytsum, ys[i], yrs[i]);
+        }
+
+        vfmadd213ps(ysum, yalpha, ptr[imm_addr64]);
+        vmulps(ysum, ysum, yrs[2]); // ysum = yr * base
+        vmulps(ytsum, ytsum, ys[2]);
+        vfnmadd231ps(ysum, ytsum, ycoef); // ysum -= ycoef * ysrc * ytsum
+
+        if (tail != 0)
+            vmaskmovps(ptr[diff_src], ymask, ysum);
+        else
+            vmovups(ptr[diff_src], ysum);
+
+        for (int i = 0; i < 4; ++i) {
+            vmovaps(ys[i], ys[i + 1]);
+            vmovaps(yrs[i], yrs[i + 1]);
+        }
+    }
+
+    void nchw_step(int HW) {
+        add(src, HW * 4);
+        add(diff_dst, HW * 4);
+        add(scratch, HW * 4);
+        add(diff_src, HW * 4);
+    }
+
+    xbyak_lrn(
+        struct nchw_across J,
+        float A, float B, float K,
+        prop_kind_t pk,
+        void* code_ptr = nullptr,
+        size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size)
+        , alpha(A), coef(2 * B * A)
+    {
+        for (int i = 0; i < VECTOR_LENGTH; ++i) k[i] = K;
+        Xbyak::Reg64 c = r10;
+        Xbyak::Ymm ymask = ymm2;
+        Xbyak::Ymm ytmp = ymm3;
+        Xbyak::Ymm ys[5] = { ymm4, ymm5, ymm6, ymm7, ymm8 };
+        Xbyak::Ymm yrs[5] = { ymm9, ymm10, ymm11, ymm12, ymm13 };
+        Xbyak::Ymm ysum = ymm14;
+        Xbyak::Ymm ytsum = ymm15;
+
+        this->preamble();
+
+        if (J.tail != 0) {
+            mov(imm_addr64,
+                    reinterpret_cast<size_t>(&lrn_tail_mask[7 - J.tail]));
+            vmovups(ymask, ptr[imm_addr64]);
+        }
+        load_args();
+
+        /* channels -2 and -1 are zeros, 0 and 1 are preloaded */
+        for (int i = 0; i < 2; ++i) {
+            vxorps(ys[i], ys[i], ys[i]);
+            vxorps(yrs[i], yrs[i], yrs[i]);
+        }
+        for (int i = 0; i < 2; ++i) {
+            nchw_load(J.tail, ptr[src + J.HW * 4 * i], ymask, ys[2 + i]);
+            nchw_load(J.tail, ptr[diff_dst + J.HW * 4 * i], ymask,
+                    yrs[2 + i]);
+            nchw_load(J.tail, ptr[scratch + J.HW * 4 * i], ymask, ytmp);
+            vdivps(yrs[2 + i], yrs[2 + i], ytmp);
+        }
+
+        mov(c, J.C - 2);
+        L(".lrn_loop");
+
+        nchw_load_ahead(J.tail, J.HW, ymask, ytmp, ys[4], yrs[4]);
+        nchw_body(J.tail, ymask, ys, yrs, ysum, ytsum);
+        nchw_step(J.HW);
+
+        dec(c);
+        cmp(c, 0);
+        jne(".lrn_loop", T_NEAR);
+
+        /* the last two channels see zeros above */
+        for (int i = 0; i < 2; ++i) {
+            vxorps(ys[4], ys[4], ys[4]);
+            vxorps(yrs[4], yrs[4], yrs[4]);
+            nchw_body(J.tail, ymask, ys, yrs, ysum, ytsum);
+            if (i == 0) nchw_step(J.HW);
+        }
+
+        this->postamble();
+
+        ker = reinterpret_cast<decltype(ker)>(const_cast<uint8_t*>(
+                    this->getCode()));
+    }
+};
+
+status_t jit_avx2_lrn_bwd_t::pd_t::init() {
+    using namespace prop_kind;
+    using namespace alg_kind;
+
+    assert(engine()->kind() == engine_kind::cpu);
+
+    const memory_desc_wrapper data_d(data_pd_.desc());
+    const memory_desc_wrapper diff_data_d(diff_data_pd_.desc());
+    bool ok = true
+        && mayiuse(avx2)
+        && desc()->prop_kind == backward_data
+        && desc()->alg_kind == lrn_across_channels
+        && utils::everyone_is(data_type::f32, desc()->data_desc.data_type,
+                desc()->diff_data_desc.data_type)
+        && data_d.ndims() == 4
+        && data_d.dims()[1] % VECTOR_LENGTH == 0
+        && data_d.dims()[1] >= 2 * VECTOR_LENGTH
+        && desc()->local_size == 5
+        && utils::one_of(data_d.format(), nChw8c, nchw)
+        && diff_data_d.format() == data_d.format();
+    if (!ok) return unimplemented;
+
+    /* the kernel relies on base^1.75 saved by forward training */
+    ok = true
+        && hint_fwd_pd_ != nullptr
+        && hint_fwd_pd_->workspace_pd() != nullptr
+        && memory_desc_wrapper(hint_fwd_pd_->workspace_pd()) == data_d;
+    if (!ok) return unimplemented;
+
+    ws_pd_ = data_pd_;
+
+    return success;
+}
+
+jit_avx2_lrn_bwd_t::jit_avx2_lrn_bwd_t(const pd_t *pd,
+        const input_vector &inputs, const output_vector &outputs)
+    : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd), ker_(nullptr)
+    , ker_first_(nullptr), ker_last_(nullptr) {
+    const int C = conf_.C();
+    const int H = conf_.H();
+    const int W = conf_.W();
+    const double A = conf_.desc()->lrn_alpha / conf_.desc()->local_size;
+    const float B = conf_.desc()->lrn_beta;
+    const float K = conf_.desc()->lrn_k;
+
+    auto pk = conf_.desc()->prop_kind;
+    auto dfmt = conf_.src_pd()->desc()->format;
+
+    if (dfmt == nChw8c) {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, 0), A, B, K, pk);
+        ker_first_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, -1),
+                A, B, K, pk);
+        ker_last_ = get_lrn_kernel<xbyak_lrn>(nchw8c_across(H*W, +1),
+                A, B, K, pk);
+    } else {
+        ker_ = get_lrn_kernel<xbyak_lrn>(nchw_across(C, H*W, 0), A, B, K, pk);
+        int remind = (H*W) % VECTOR_LENGTH;
+        if (remind != 0) {
+            ker_last_ = get_lrn_kernel<xbyak_lrn>(nchw_across(C, H*W, remind),
+                    A, B, K, pk);
+        }
+    }
+}
+
+jit_avx2_lrn_bwd_t::~jit_avx2_lrn_bwd_t() {
+    jit_kernel_cache_t::release(ker_);
+    jit_kernel_cache_t::release(ker_first_);
+    jit_kernel_cache_t::release(ker_last_);
+}
+
+void jit_avx2_lrn_bwd_t::execute_backward() {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto ws = reinterpret_cast<const data_t *>(this->input_memory(2));
+    auto diff_src = reinterpret_cast<data_t*>(this->memory(0));
+
+    const int N = conf_.MB();
+    const int C = conf_.C();
+    const int HW = conf_.H() * conf_.W();
+
+    auto dfmt = conf_.src_pd()->desc()->format;
+
+    if (dfmt == nChw8c) {
+#       pragma omp parallel for collapse(2) schedule(static)
+        for (int n = 0; n < N; ++n) {
+            for (int c8 = 0; c8 < C / VECTOR_LENGTH; ++c8) {
+                const size_t off = n*HW*C + c8 * HW * VECTOR_LENGTH;
+                jit_args_bwd_t args;
+                args.src = &src[off];
+                args.diff_dst = &diff_dst[off];
+                args.scratch = &ws[off];
+                args.diff_src = &diff_src[off];
+                if (c8 == 0)
+                    (*ker_first_)(&args);
+                else if (c8 == C / VECTOR_LENGTH - 1)
+                    (*ker_last_)(&args);
+                else
+                    (*ker_)(&args);
+            }
+        }
+    } else { // nchw
+#       pragma omp parallel for collapse(2) schedule(static)
+        for (int n = 0; n < N; ++n) {
+            for (int hw8 = 0; hw8 < (HW + VECTOR_LENGTH - 1) / VECTOR_LENGTH; ++hw8) {
+                const size_t off = n*HW*C + hw8 * VECTOR_LENGTH;
+                jit_args_bwd_t args;
+                args.src = &src[off];
+                args.diff_dst = &diff_dst[off];
+                args.scratch = &ws[off];
+                args.diff_src = &diff_src[off];
+                if ((hw8+1)*VECTOR_LENGTH > HW)
+                    (*ker_last_)(&args);
+                else
+                    (*ker_)(&args);
+            }
+        }
+    }
+}
+
 }
 }
 }
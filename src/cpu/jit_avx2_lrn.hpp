@@ -29,11 +29,23 @@ struct jit_avx2_lrn_fwd_t: public cpu_primitive_t {
     struct pd_t: public cpu_lrn_fwd_pd_t {
         pd_t(engine_t *engine, const lrn_desc_t *adesc,
                 const lrn_fwd_pd_t *hint_fwd_pd)
-            : cpu_lrn_fwd_pd_t(engine, adesc, hint_fwd_pd) {}
+            : cpu_lrn_fwd_pd_t(engine, adesc, hint_fwd_pd), nthr_(1) {}
 
         DECLARE_COMMON_PD_T(jit_avx2_lrn_fwd_t);
 
         virtual status_t init() override;
+
+        /** within channel lrn keeps the window sums of a plane row per
+         * thread */
+        virtual size_t scratchpad_size() const override {
+            return desc()->alg_kind == alg_kind::lrn_within_channel
+                ? nthr_ * within_buf_size() * sizeof(float) : 0;
+        }
+
+        /** floats of the per thread buffer of within channel lrn */
+        size_t within_buf_size() const;
+
+        int nthr_;
     };
 
     jit_avx2_lrn_fwd_t(const pd_t *pd, const input_vector &inputs,
@@ -42,13 +54,47 @@ struct jit_avx2_lrn_fwd_t: public cpu_primitive_t {
 
     typedef typename prec_trait<data_type::f32>::type data_t;
 
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        execute_forward(scratchpad);
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_forward(char *scratchpad);
+    void execute_within(const data_t *src, data_t *dst, data_t *ws,
+            char *scratchpad);
+    pd_t conf_;
+
+    struct xbyak_lrn;
+    xbyak_lrn *ker_, *ker_first_, *ker_last_;
+    xbyak_lrn *ker_within_[3][2]; /* [acc_add, acc_sub, norm][tail] */
+};
+
+struct jit_avx2_lrn_bwd_t: public cpu_primitive_t {
+    struct pd_t: public cpu_lrn_bwd_pd_t {
+        pd_t(engine_t *engine, const lrn_desc_t *adesc,
+                const lrn_fwd_pd_t *hint_fwd_pd)
+            : cpu_lrn_bwd_pd_t(engine, adesc, hint_fwd_pd) {}
+
+        DECLARE_COMMON_PD_T(jit_avx2_lrn_bwd_t);
+
+        virtual status_t init() override;
+    };
+
+    jit_avx2_lrn_bwd_t(const pd_t *pd, const input_vector &inputs,
+            const output_vector &outputs);
+    ~jit_avx2_lrn_bwd_t();
+
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
     virtual void execute(event_t *e) {
-        execute_forward();
+        execute_backward();
         e->set_state(event_t::ready);
     }
 
 private:
-    void execute_forward();
+    void execute_backward();
     pd_t conf_;
 
     struct xbyak_lrn;
@@ -13,28 +13,24 @@
 * See the License for the specific language governing permissions and
 * limitations under the License.
 *******************************************************************************/
+#include <string.h>
+
 #include "c_types_map.hpp"
 #include "nstl.hpp"
 #include "utils.hpp"
 
+#include "cpu_pooling_pd.hpp"
 #include "jit_avx2_pool_kernel_f32.hpp"
 
 #define ymm_store_mask Ymm(15)
 #define ymm_input Ymm(14)
 #define ymm_tmp Ymm(13)
 #define xmm_tmp Xmm(13)
-#define ymm_index Ymm(12)
-#define xmm_index Xmm(12)
-#define ymm_c_block Ymm(11)
-#define xmm_c_block Xmm(11)
-#define ymm_c_block_stride_w Ymm(10)
-#define xmm_c_block_stride_w Xmm(10)
+#define ymm_one Ymm(11)
+#define xmm_one Xmm(11)
+#define ymm_kh_shift Ymm(10)
+#define xmm_kh_shift Xmm(10)
 #define ymm_ki_offset Ymm(9)
-#define xmm_ki_offset Xmm(9)
-#define ymm_ji_offset Ymm(8)
-#define xmm_ji_offset Xmm(8)
-#define ymm_offset_base Ymm(7)
-#define xmm_offset_base Xmm(7)
 
 namespace mkldnn {
 namespace impl {
@@ -43,19 +39,19 @@ namespace cpu {
 status_t jit_avx2_pool_kernel_f32::init_conf(jit_pool_conf_t &jpp,
             const pooling_desc_t &pd, const memory_desc_wrapper &src_d,
             const memory_desc_wrapper &dst_d, bool is_training) {
+    memset(&jpp, 0, sizeof(jpp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
     bool args_ok = true
         && utils::one_of(pd.alg_kind, alg_kind::pooling_max,
                 alg_kind::pooling_avg)
         && src_d.format() == memory_format::nChw8c
-        && dst_d.format() == src_d.format()
-        && pd.kernel[0] == pd.kernel[1]
-        && pd.padding[0][0] == pd.padding[1][0] /* top = bottom */
-        && pd.padding[0][1] == pd.padding[1][1] /* left = right */;
+        && dst_d.format() == src_d.format();
     if (!args_ok) return status::unimplemented;
 
     const int simd_w = 8;
     jpp.mb = src_d.dims()[0];
-    jpp.c = src_d.dims()[1];
+    jpp.c = src_d.blocking_desc().padding_dims[1]; /* zero-padded channels */
     jpp.ih = src_d.dims()[2];
     jpp.iw = src_d.dims()[3];
     jpp.oh = dst_d.dims()[2];
@@ -71,14 +67,32 @@ status_t jit_avx2_pool_kernel_f32::init_conf(jit_pool_conf_t &jpp,
 
     jpp.is_max = pd.alg_kind == alg_kind::pooling_max;
     jpp.is_training = is_training;
+    jpp.is_backward = pd.prop_kind == prop_kind::backward_data;
+    jpp.ind_dt = pooling_index_data_type(&pd);
 
     jpp.c_block = simd_w;
     jpp.nb_c = jpp.c / jpp.c_block;
     jpp.ur_h = 1; /* no code-unrolling by h so far */
-    jpp.ur_w = jpp.is_training ? 3 : 8;
+    jpp.ur_w = jpp.is_training || jpp.is_backward ? 3 : 8;
     if (jpp.ow < jpp.ur_w) jpp.ur_w = jpp.ow;
     jpp.ur_w_tail = jpp.ow % jpp.ur_w;
 
+    /* the padding is implied by the output size and may differ on each
+     * side. every window has to overlap the input, the left padding may
+     * only reach the first ur_w block and the right one the last block
+     * and the tail */
+    const int b_pad = (jpp.oh - 1) * jpp.stride_h + jpp.kh - jpp.ih
+        - jpp.t_pad;
+    const int r_pad = (jpp.ow - 1) * jpp.stride_w + jpp.kw - jpp.iw
+        - jpp.l_pad;
+    args_ok = true
+        && jpp.t_pad < jpp.kh && b_pad < jpp.kh
+        && jpp.l_pad < jpp.kw && r_pad < jpp.kw
+        && jpp.l_pad <= jpp.ur_w * jpp.stride_w
+        && utils::div_up(nstl::max(0, r_pad), jpp.stride_w)
+                <= jpp.ur_w + jpp.ur_w_tail;
+    if (!args_ok) return status::unimplemented;
+
     return status::success;
 }
 
@@ -111,8 +125,10 @@ inline void jit_avx2_pool_kernel_f32::avg_oh_step(int ur_w, int pad_l,
     L(kh_lable);
     {
         for (int ki = 0; ki < kw; ki++) {
-            int jj_start = nstl::max(0, pad_l - ki);
-            int jj_end = ur_w - nstl::max(0, ki + pad_r - (kw-1));
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
             for (int jj = jj_start; jj  < jj_end; jj++) {
                 int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
                 if (aux_input_offset > iw * c_block)
@@ -159,45 +175,37 @@ inline void jit_avx2_pool_kernel_f32::max_oh_step(int ur_w, int pad_l,
     for (int jj = 0; jj < ur_w; jj++)
         vmovups(Ymm(jj), ymm_tmp);
 
+    /* ymm_ki_offset is the position kh * KW + kw of the current tap */
+    if (jpp.is_training) {
+        for (int jj = 0; jj < ur_w; jj++)
+            vpxor(Ymm(ur_w+jj), Ymm(ur_w+jj));
+        vmovdqu(ymm_ki_offset, ymm_kh_shift);
+    }
+
     mov(aux_reg_input, reg_input);
     xor_(kj, kj);
     L(kh_lable);
     {
-        if (jpp.is_training) {
-            vpxor(ymm_ki_offset, ymm_ki_offset);
-        }
         for (int ki = 0; ki < kw; ki++) {
-            int jj_start = nstl::max(0, pad_l - ki);
-            int jj_end = ur_w - nstl::max(0, ki + pad_r - (kw-1));
-            if (jpp.is_training) {
-                vmovups(ymm_index, ymm_ki_offset);
-                vmovups(ymm_ji_offset, ymm_offset_base);
-                if (jj_start != 0) {
-                    mov(tmp_gpr,(jj_start * stride_w * c_block));
-                    movq(xmm_tmp, tmp_gpr);
-                    vpbroadcastd(ymm_tmp, xmm_tmp);
-                    vpaddd(ymm_ji_offset, ymm_ji_offset, ymm_tmp);
-                }
-            }
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
             for (int jj = jj_start; jj  < jj_end; jj++) {
                 int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
                 if (aux_input_offset > iw * c_block)
                     continue;
-                if (jpp.is_training) {
-                    vpaddd(ymm_index, ymm_ki_offset, ymm_ji_offset);
-                }
                 vmovups(ymm_input,
                         ptr[aux_reg_input + sizeof(float)*aux_input_offset]);
                 vcmpps(ymm_store_mask, Ymm(jj), ymm_input, _cmp);
                 vblendvps(Ymm(jj), Ymm(jj), ymm_input, ymm_store_mask);
                 if (jpp.is_training) {
-                    vblendvps(Ymm(ur_w+jj), Ymm(ur_w+jj), ymm_index,
+                    vblendvps(Ymm(ur_w+jj), Ymm(ur_w+jj), ymm_ki_offset,
                             ymm_store_mask);
-                    vpaddd(ymm_ji_offset, ymm_ji_offset, ymm_c_block_stride_w);
                 }
             }
             if (jpp.is_training) {
-                vpaddd(ymm_ki_offset, ymm_ki_offset, ymm_c_block);
+                vpaddd(ymm_ki_offset, ymm_ki_offset, ymm_one);
             }
         }
         add(aux_reg_input,  sizeof(float) * iw * c_block);
@@ -206,10 +214,123 @@ inline void jit_avx2_pool_kernel_f32::max_oh_step(int ur_w, int pad_l,
         jl(kh_lable, T_NEAR);
     }
 
+    const int ind_dt_size = types::data_type_size(jpp.ind_dt);
     for (int jj = 0; jj < ur_w; jj++) {
         vmovups(YWORD[reg_output + sizeof(float)*jj*c_block], Ymm(jj));
-        if (jpp.is_training)
-            vmovdqu(YWORD[reg_index + sizeof(int)*jj*c_block], Ymm(ur_w+jj));
+        if (!jpp.is_training) continue;
+
+        auto ind = ptr[reg_index + ind_dt_size*jj*c_block];
+        if (jpp.ind_dt == data_type::u8) {
+            Xmm xr_index = Xmm(ur_w+jj);
+            vextracti128(xmm_tmp, Ymm(ur_w+jj), 1);
+            vpackusdw(xr_index, xr_index, xmm_tmp);
+            vpackuswb(xr_index, xr_index, xr_index);
+            vmovq(ind, xr_index);
+        } else {
+            vmovdqu(ind, Ymm(ur_w+jj));
+        }
+    }
+}
+
+inline void jit_avx2_pool_kernel_f32::avg_oh_step_bwd(int ur_w, int pad_l,
+        int pad_r, const char *kh_lable) {
+    using Xbyak::Ymm;
+    using Xbyak::Xmm;
+
+    int iw = jpp.iw;
+    int kw = jpp.kw;
+    int kh = jpp.kh;
+    int stride_w = jpp.stride_w;
+    int c_block = jpp.c_block;
+
+    union {
+        float _devider;
+        int _devider_int;
+    } cvt;
+    cvt._devider = kw*kh;
+
+    mov(tmp_gpr, cvt._devider_int);
+    movq(xmm_tmp, tmp_gpr);
+    vbroadcastss(ymm_tmp, xmm_tmp);
+
+    for (int jj = 0; jj < ur_w; jj++) {
+        vmovups(Ymm(jj), ptr[reg_output + sizeof(float)*jj*c_block]);
+        vdivps(Ymm(jj), Ymm(jj), ymm_tmp);
+    }
+
+    mov(aux_reg_input, reg_input);
+    xor_(kj, kj);
+    L(kh_lable);
+    {
+        for (int ki = 0; ki < kw; ki++) {
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
+            for (int jj = jj_start; jj  < jj_end; jj++) {
+                int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
+                if (aux_input_offset > iw * c_block)
+                    continue;
+                auto diff_src = ptr[aux_reg_input
+                    + sizeof(float)*aux_input_offset];
+                vaddps(ymm_input, Ymm(jj), diff_src);
+                vmovups(diff_src, ymm_input);
+            }
+        }
+        add(aux_reg_input,  sizeof(float) * iw * c_block);
+        inc(kj);
+        cmp(kj, reg_kh);
+        jl(kh_lable, T_NEAR);
+    }
+}
+
+inline void jit_avx2_pool_kernel_f32::max_oh_step_bwd(int ur_w, int pad_l,
+        int pad_r, const char *kh_lable) {
+    using Xbyak::Ymm;
+    using Xbyak::Xmm;
+
+    int iw = jpp.iw;
+    int kw = jpp.kw;
+    int stride_w = jpp.stride_w;
+    int c_block = jpp.c_block;
+
+    const int ind_dt_size = types::data_type_size(jpp.ind_dt);
+    for (int jj = 0; jj < ur_w; jj++) {
+        vmovups(Ymm(jj), ptr[reg_output + sizeof(float)*jj*c_block]);
+        auto ind = ptr[reg_index + ind_dt_size*jj*c_block];
+        if (jpp.ind_dt == data_type::u8)
+            vpmovzxbd(Ymm(ur_w+jj), ind);
+        else
+            vmovdqu(Ymm(ur_w+jj), ind);
+    }
+    vmovdqu(ymm_ki_offset, ymm_kh_shift);
+
+    mov(aux_reg_input, reg_input);
+    xor_(kj, kj);
+    L(kh_lable);
+    {
+        for (int ki = 0; ki < kw; ki++) {
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
+            for (int jj = jj_start; jj  < jj_end; jj++) {
+                int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
+                if (aux_input_offset > iw * c_block)
+                    continue;
+                auto diff_src = ptr[aux_reg_input
+                    + sizeof(float)*aux_input_offset];
+                vpcmpeqd(ymm_store_mask, Ymm(ur_w+jj), ymm_ki_offset);
+                vandps(ymm_tmp, ymm_store_mask, Ymm(jj));
+                vaddps(ymm_input, ymm_tmp, diff_src);
+                vmovups(diff_src, ymm_input);
+            }
+            vpaddd(ymm_ki_offset, ymm_ki_offset, ymm_one);
+        }
+        add(aux_reg_input,  sizeof(float) * iw * c_block);
+        inc(kj);
+        cmp(kj, reg_kh);
+        jl(kh_lable, T_NEAR);
     }
 }
 
@@ -228,33 +349,29 @@ void jit_avx2_pool_kernel_f32::generate() {
 
     int n_oi = ow / ur_w;
 
+    /* backward reads diff_dst through reg_output and writes diff_src
+     * through reg_input */
+    const bool with_indices = jpp.is_max
+        && (jpp.is_training || jpp.is_backward);
+    const int ind_dt_size = types::data_type_size(jpp.ind_dt);
+
 #   define GET_OFF(field) offsetof(jit_pool_call_s, field)
     mov(reg_input, ptr[this->param1 + GET_OFF(src)]);
     mov(reg_output, ptr[this->param1 + GET_OFF(dst)]);
-    if (jpp.is_max && jpp.is_training)
+    if (with_indices)
         mov(reg_index, ptr[this->param1 + GET_OFF(indices)]);
     mov(reg_kh, ptr[this->param1 + GET_OFF(kh_padding)]);
-    if (jpp.is_max && jpp.is_training)
-        mov(reg_arr_init, ptr[this->param1 + GET_OFF(init_array)]);
-#   undef GET_OFF
-
-    if (jpp.is_max && jpp.is_training) {
-        mov(tmp_gpr,c_block);
-        movq(xmm_c_block, tmp_gpr);
-        vpbroadcastd(ymm_c_block, xmm_c_block);
-
-        mov(tmp_gpr,(stride_w * c_block));
-        movq(xmm_c_block_stride_w, tmp_gpr);
-        vpbroadcastd(ymm_c_block_stride_w, xmm_c_block_stride_w);
-
-        vmovdqu(ymm_offset_base, ptr[reg_arr_init]);
-        if (l_pad > 0) {
-            mov(tmp_gpr,(l_pad * c_block));
-            movq(xmm_tmp, tmp_gpr);
-            vpbroadcastd(ymm_tmp, xmm_tmp);
-            vpsubd(ymm_offset_base, ymm_offset_base, ymm_tmp);
-        }
+    if (with_indices) {
+        mov(tmp_gpr, ptr[this->param1 + GET_OFF(kh_padding_shift)]);
+        imul(tmp_gpr, tmp_gpr, kw);
+        movq(xmm_kh_shift, tmp_gpr);
+        vpbroadcastd(ymm_kh_shift, xmm_kh_shift);
+
+        mov(tmp_gpr, 1);
+        movq(xmm_one, tmp_gpr);
+        vpbroadcastd(ymm_one, xmm_one);
     }
+#   undef GET_OFF
 
     int r_pad  = nstl::max(0, ((ow-1)*stride_w) + kw - 1 - (iw + l_pad - 1 ));
     int r_pad1 = (ur_w*n_oi - 1)*stride_w + kw - 1 - (iw + l_pad - 1);
@@ -270,8 +387,8 @@ void jit_avx2_pool_kernel_f32::generate() {
 
         add(reg_input,  sizeof(float)*(ur_w*stride_w - l_pad)*c_block);
         add(reg_output,  sizeof(float)*ur_w*c_block);
-        if (jpp.is_max && jpp.is_training)
-            add(reg_index, sizeof(int)*ur_w*c_block);
+        if (with_indices)
+            add(reg_index, ind_dt_size*ur_w*c_block);
     }
 
     xor_(oi_iter, oi_iter);
@@ -280,8 +397,8 @@ void jit_avx2_pool_kernel_f32::generate() {
             oh_step( ur_w, 0, 0, ".kh_loop_oimain");
             add(reg_input, sizeof(float)*ur_w*stride_w*c_block);
             add(reg_output, sizeof(float)*ur_w*c_block);
-            if (jpp.is_max && jpp.is_training)
-                add(reg_index, sizeof(int)*ur_w*c_block);
+            if (with_indices)
+                add(reg_index, ind_dt_size*ur_w*c_block);
 
             inc(oi_iter);
             cmp(oi_iter, n_oi); jl(".ow_loop", T_NEAR);
@@ -292,8 +409,8 @@ void jit_avx2_pool_kernel_f32::generate() {
         oh_step( ur_w, 0, r_pad1, ".kh_loop_oimain_padwr");
         add(reg_input, sizeof(float)*ur_w*stride_w*c_block);
         add(reg_output, sizeof(float)*ur_w*c_block);
-        if (jpp.is_max && jpp.is_training)
-            add(reg_index, sizeof(int) * ur_w * c_block);
+        if (with_indices)
+            add(reg_index, ind_dt_size * ur_w * c_block);
     }
 
     if (ur_w_tail != 0)
@@ -21,40 +21,19 @@
 
 #include "c_types_map.hpp"
 #include "jit_generator.hpp"
+#include "jit_primitive_conf.hpp"
 #include "type_helpers.hpp"
 
 namespace mkldnn {
 namespace impl {
 namespace cpu {
 
-struct jit_pool_conf_t {
-    int mb, c;
-    int ih, iw, oh, ow;
-    int stride_h, stride_w;
-    int kh, kw;
-    int t_pad, l_pad;
-    bool is_max;
-    bool is_training;
-
-    int nb_c, c_block;
-    int ur_h, ur_w;
-    int ur_w_tail;
-};
-
-struct __attribute__ ((__packed__)) jit_pool_call_s {
-    const float *src;
-    const float *dst;
-    const int *indices;
-    const float *src_prf;
-    const float *dst_prf;
-    const int *indices_prf;
-    size_t kh_padding;
-    size_t kh_padding_prf;
-    size_t kw_padding;
-    const float* init_value;
-    int* init_array;
-};
-
+/** max and avg pooling on nChw8c, forward and backward
+ *
+ * max pooling keeps in the workspace the position kh * KW + kw of the
+ * maximum within the window, as the reference does. backward adds
+ * diff_dst into the rows of diff_src, hence a call must not run
+ * concurrently with another one writing the same rows */
 struct jit_avx2_pool_kernel_f32: public jit_generator {
     jit_avx2_pool_kernel_f32(jit_pool_conf_t ajpp, void* code_ptr = nullptr,
         size_t code_size = 8 * Xbyak::DEFAULT_MAX_CODE_SIZE): jpp(ajpp)
@@ -76,7 +55,6 @@ private:
     reg64_t reg_index      = r10;
     reg64_t aux_reg_index  = r11;
     reg64_t reg_output     = r12;
-    reg64_t reg_arr_init   = r13;
 
     reg64_t kj      = r14;
     reg64_t oi_iter = r15;
@@ -87,9 +65,18 @@ private:
     void (*jit_ker)(jit_pool_call_s *);
     void avg_oh_step(int ur_w, int pad_l, int pad_r, const char *kh_lable);
     void max_oh_step(int ur_w, int pad_l, int pad_r, const char *kh_lable);
+    void avg_oh_step_bwd(int ur_w, int pad_l, int pad_r,
+            const char *kh_lable);
+    void max_oh_step_bwd(int ur_w, int pad_l, int pad_r,
+            const char *kh_lable);
     inline void oh_step(int ur_w, int pad_l, int pad_r, const char *kh_lable) {
-        if (jpp.is_max) max_oh_step(ur_w, pad_l, pad_r, kh_lable);
-        else avg_oh_step(ur_w, pad_l, pad_r, kh_lable);
+        if (jpp.is_backward) {
+            if (jpp.is_max) max_oh_step_bwd(ur_w, pad_l, pad_r, kh_lable);
+            else avg_oh_step_bwd(ur_w, pad_l, pad_r, kh_lable);
+        } else {
+            if (jpp.is_max) max_oh_step(ur_w, pad_l, pad_r, kh_lable);
+            else avg_oh_step(ur_w, pad_l, pad_r, kh_lable);
+        }
     }
     void generate();
 };
@@ -28,19 +28,18 @@ void jit_avx2_pooling_fwd_t::execute_forward() {
     auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
     auto dst = reinterpret_cast<data_t*>(this->memory(0));
     auto indices = conf_.desc()->alg_kind == alg_kind::pooling_avg ? nullptr
-        : reinterpret_cast<int*>(this->memory(1));
+        : reinterpret_cast<unsigned char *>(this->memory(1));
 
     const memory_desc_wrapper src_d(conf_.src_pd());
     const memory_desc_wrapper dst_d(conf_.dst_pd());
     const memory_desc_wrapper indices_d(conf_.workspace_pd());
 
     const auto &jpp = kernel_->jpp;
+    const size_t ind_dt_size = types::data_type_size(jpp.ind_dt);
 
     auto ker = [&](int n, int b_c, int oh) {
         jit_pool_call_s arg = {};
 
-        int arr_init[8] = {0, 1, 2, 3, 4, 5, 6, 7};
-
         const int ij = oh * jpp.stride_h;
         const int i_t_overflow = nstl::max(0, jpp.t_pad-ij);
         const int i_b_overflow = nstl::max(jpp.ih, ij+jpp.kh-jpp.t_pad)-jpp.ih;
@@ -49,10 +48,11 @@ void jit_avx2_pooling_fwd_t::execute_forward() {
         arg.src = &src[src_d.blk_off(n, b_c, ih, 0)];
         arg.dst = &dst[dst_d.blk_off(n, b_c, oh, 0)];
         if (indices)
-            arg.indices = &indices[indices_d.blk_off(n, b_c, oh, 0)];
+            arg.indices = &indices[ind_dt_size
+                * indices_d.blk_off(n, b_c, oh, 0)];
         arg.kh_padding = jpp.kh - i_t_overflow - i_b_overflow;
+        arg.kh_padding_shift = i_t_overflow;
         arg.kw_padding = 0;
-        arg.init_array = arr_init;
 
         (*kernel_)(&arg);
     };
@@ -67,6 +67,55 @@ void jit_avx2_pooling_fwd_t::execute_forward() {
     }
 }
 
+void jit_avx2_pooling_bwd_t::execute_backward() {
+    auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto diff_src = reinterpret_cast<data_t*>(this->memory(0));
+    auto indices = conf_.desc()->alg_kind == alg_kind::pooling_avg ? nullptr
+        : reinterpret_cast<const unsigned char *>(this->input_memory(1));
+
+    const memory_desc_wrapper diff_src_d(conf_.diff_src_pd());
+    const memory_desc_wrapper diff_dst_d(conf_.diff_dst_pd());
+    const memory_desc_wrapper indices_d(conf_.workspace_pd());
+
+    const auto &jpp = kernel_->jpp;
+    const size_t ind_dt_size = types::data_type_size(jpp.ind_dt);
+
+    auto ker = [&](int n, int b_c, int oh) {
+        jit_pool_call_s arg = {};
+
+        const int ij = oh * jpp.stride_h;
+        const int i_t_overflow = nstl::max(0, jpp.t_pad-ij);
+        const int i_b_overflow = nstl::max(jpp.ih, ij+jpp.kh-jpp.t_pad)-jpp.ih;
+        const int ih = nstl::max(ij - jpp.t_pad, 0);
+
+        arg.src = &diff_src[diff_src_d.blk_off(n, b_c, ih, 0)];
+        arg.dst = &diff_dst[diff_dst_d.blk_off(n, b_c, oh, 0)];
+        if (indices)
+            arg.indices = &indices[ind_dt_size
+                * indices_d.blk_off(n, b_c, oh, 0)];
+        arg.kh_padding = jpp.kh - i_t_overflow - i_b_overflow;
+        arg.kh_padding_shift = i_t_overflow;
+        arg.kw_padding = 0;
+
+        (*kernel_)(&arg);
+    };
+
+    /* the windows of neighbouring rows overlap, hence a thread owns whole
+     * (n, c block) planes of diff_src and walks their rows in order */
+#   pragma omp parallel for collapse(2) schedule(static)
+    for (int n = 0; n < jpp.mb; ++n) {
+        for (int b_c = 0; b_c < jpp.nb_c; ++b_c) {
+            data_t *ds = &diff_src[diff_src_d.blk_off(n, b_c, 0, 0)];
+            const size_t plane = (size_t)jpp.ih * jpp.iw * jpp.c_block;
+            for (size_t i = 0; i < plane; ++i) ds[i] = 0;
+
+            for (int oh = 0; oh < jpp.oh; ++oh) {
+                ker (n, b_c, oh);
+            }
+        }
+    }
+}
+
 }
 }
 }
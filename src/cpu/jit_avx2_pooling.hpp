@@ -23,6 +23,7 @@
 #include "cpu_pooling_pd.hpp"
 #include "cpu_engine.hpp"
 #include "jit_avx2_pool_kernel_f32.hpp"
+#include "jit_kernel_cache.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
@@ -55,7 +56,7 @@ struct jit_avx2_pooling_fwd_t: public cpu_primitive_t {
             bool is_training = desc_.prop_kind == forward_training;
             if (desc()->alg_kind == pooling_max && is_training) {
                 auto indices_desc = *dst_pd()->desc();
-                indices_desc.data_type = data_type::s32;
+                indices_desc.data_type = pooling_index_data_type(desc());
                 ws_pd_ = cpu_memory_t::pd_t(engine_, &indices_desc);
             }
 
@@ -69,7 +70,12 @@ struct jit_avx2_pooling_fwd_t: public cpu_primitive_t {
     jit_avx2_pooling_fwd_t(const pd_t *pd, const input_vector &inputs,
             const output_vector &outputs)
         : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
-    { kernel_ = new jit_avx2_pool_kernel_f32(conf_.jpp_); }
+    {
+        kernel_ = jit_kernel_cache_t::get<jit_avx2_pool_kernel_f32>(
+                conf_.jpp_, conf_.jpp_);
+    }
+    ~jit_avx2_pooling_fwd_t()
+    { jit_kernel_cache_t::release(kernel_); }
     typedef typename prec_trait<data_type::f32>::type data_t;
 
     virtual void execute(event_t *e) {
@@ -77,12 +83,75 @@ struct jit_avx2_pooling_fwd_t: public cpu_primitive_t {
         e->set_state(event_t::ready);
     }
 
+    /* the kernel runs over the zero-padded channel blocks as well */
+    virtual bool writes_padding() const { return true; }
+
 private:
     void execute_forward();
     pd_t conf_;
     jit_avx2_pool_kernel_f32 *kernel_;
 };
 
+struct jit_avx2_pooling_bwd_t: public cpu_primitive_t {
+    struct pd_t: public cpu_pooling_bwd_pd_t {
+        pd_t(engine_t *engine, const pooling_desc_t *adesc,
+                const pooling_fwd_pd_t *hint_fwd_pd)
+            : cpu_pooling_bwd_pd_t(engine, adesc, hint_fwd_pd) {}
+
+        DECLARE_COMMON_PD_T(jit_avx2_pooling_bwd_t);
+
+        virtual status_t init() override {
+            using namespace prop_kind;
+            using namespace alg_kind;
+            using namespace utils;
+            assert(engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && set_default_params() == status::success
+                && desc()->prop_kind == backward_data
+                && one_of(desc()->alg_kind, pooling_max, pooling_avg)
+                && everyone_is(data_type::f32,
+                        diff_src_pd()->desc()->data_type,
+                        diff_dst_pd()->desc()->data_type);
+            if (!ok) return status::unimplemented;
+
+            if (desc()->alg_kind == pooling_max) {
+                auto indices_desc = *diff_dst_pd()->desc();
+                indices_desc.data_type = pooling_index_data_type(desc());
+                ws_pd_ = cpu_memory_t::pd_t(engine_, &indices_desc);
+            }
+
+            return jit_avx2_pool_kernel_f32::init_conf(jpp_, desc_,
+                    diff_src_pd_.desc(), diff_dst_pd_.desc(), false);
+        }
+
+        jit_pool_conf_t jpp_;
+    };
+
+    jit_avx2_pooling_bwd_t(const pd_t *pd, const input_vector &inputs,
+            const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+    {
+        kernel_ = jit_kernel_cache_t::get<jit_avx2_pool_kernel_f32>(
+                conf_.jpp_, conf_.jpp_);
+    }
+    ~jit_avx2_pooling_bwd_t()
+    { jit_kernel_cache_t::release(kernel_); }
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) {
+        execute_backward();
+        e->set_state(event_t::ready);
+    }
+
+    /* the kernel runs over the zero-padded channel blocks as well */
+    virtual bool writes_padding() const { return true; }
+
+private:
+    void execute_backward();
+    pd_t conf_;
+    jit_avx2_pool_kernel_f32 *kernel_;
+};
+
 }
 }
 }
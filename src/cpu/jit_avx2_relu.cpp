@@ -16,6 +16,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 
 #include "c_types_map.hpp"
 #include "type_helpers.hpp"
@@ -23,6 +24,8 @@
 
 #include "jit_avx2_relu.hpp"
 #include "jit_generator.hpp"
+#include "jit_kernel_cache.hpp"
+#include "jit_primitive_conf.hpp"
 
 namespace mkldnn {
 namespace impl {
@@ -35,18 +38,19 @@ struct jit_args_t {
 };
 
 struct jit_avx2_relu_fwd_t::xbyak_relu: public jit_generator {
-    xbyak_relu(float *run_time_ptr_negative_slope,
+    xbyak_relu(float negative_slope,
             int compile_time_main_loop_iterations,
             size_t compile_time_reminder, void *code_ptr = nullptr,
             size_t code_size = 1 * Xbyak::DEFAULT_MAX_CODE_SIZE)
         : jit_generator(code_ptr, code_size)
+        , negative_slope_(negative_slope)
     {
         this->preamble();
 
         mov(src, ptr[this->param1 + 0]);
         mov(dst, ptr[this->param1 + 8]);
 
-        mov(imm_addr64, reinterpret_cast<size_t>(run_time_ptr_negative_slope));
+        mov(imm_addr64, reinterpret_cast<size_t>(&this->negative_slope_));
         vbroadcastss(yns, ptr[imm_addr64]);
 
         vxorps(yzero, yzero, yzero);
@@ -105,6 +109,8 @@ struct jit_avx2_relu_fwd_t::xbyak_relu: public jit_generator {
     void operator()(const jit_args_t *args) { (*ker_)(args); }
 
 private:
+    float negative_slope_;
+
     Xbyak::Reg64 src = rax;
     Xbyak::Reg64 dst = r8;
     Xbyak::Reg64 main_loop_iterator = r9;
@@ -126,7 +132,7 @@ jit_avx2_relu_fwd_t::jit_avx2_relu_fwd_t(const pd_t *pd,
         const input_vector &inputs, const output_vector &outputs)
     : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd) {
     const memory_desc_wrapper data_d(conf_.src_pd());
-    n_elems_ = data_d.nelems();
+    n_elems_ = data_d.nelems(true); /* relu keeps the zero padding zero */
 
     const size_t step = VECTOR_LENGTH * UNROLLING_FACTOR;
     const size_t jit_iters = nstl::max<size_t>(1,
@@ -138,14 +144,24 @@ jit_avx2_relu_fwd_t::jit_avx2_relu_fwd_t(const pd_t *pd,
     const size_t rem_loop_iters = n_rem_elems / step;
     const size_t jit_reminder = n_rem_elems - rem_loop_iters * step;
 
-    negative_slope_ = conf_.desc()->negative_slope;
-    ker_ = new xbyak_relu(&negative_slope_, jit_iters, 0);
-    ker_rem_ = new xbyak_relu(&negative_slope_, rem_loop_iters, jit_reminder);
+    const float ns = conf_.desc()->negative_slope;
+    jit_relu_conf_t key;
+    memset(&key, 0, sizeof(key));
+    key.negative_slope = ns;
+    key.main_loop_iterations = (int)jit_iters;
+    ker_ = jit_kernel_cache_t::get<xbyak_relu>(key, ns, jit_iters, 0);
+    jit_relu_conf_t key_rem;
+    memset(&key_rem, 0, sizeof(key_rem));
+    key_rem.negative_slope = ns;
+    key_rem.main_loop_iterations = (int)rem_loop_iters;
+    key_rem.reminder = jit_reminder;
+    ker_rem_ = jit_kernel_cache_t::get<xbyak_relu>(key_rem, ns, rem_loop_iters,
+            jit_reminder);
 }
 
 jit_avx2_relu_fwd_t::~jit_avx2_relu_fwd_t() {
-    delete ker_;
-    if (ker_rem_) delete ker_rem_;
+    jit_kernel_cache_t::release(ker_);
+    jit_kernel_cache_t::release(ker_rem_);
 }
 
 void jit_avx2_relu_fwd_t::execute_forward() {
@@ -22,6 +22,7 @@
 #include "c_types_map.hpp"
 #include "cpu_relu_pd.hpp"
 #include "cpu_engine.hpp"
+#include "jit_generator.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
 
@@ -41,11 +42,12 @@ struct jit_avx2_relu_fwd_t: public cpu_primitive_t {
             using namespace prop_kind;
             assert(engine()->kind() == engine_kind::cpu);
             bool ok = true
+                && mayiuse(avx2)
                 && utils::one_of(desc()->prop_kind, forward_training,
                         forward_inference)
                 && utils::everyone_is(data_type::f32,
                         desc()->data_desc.data_type)
-                && memory_desc_wrapper(src_pd()).is_dense();
+                && memory_desc_wrapper(src_pd()).is_dense(true);
             if (!ok) return status::unimplemented;
 
             return status::success;
@@ -67,7 +69,6 @@ private:
     void execute_forward();
     pd_t conf_;
 
-    float negative_slope_;
     size_t n_elems_, chunk_size_;
 
     struct xbyak_relu;
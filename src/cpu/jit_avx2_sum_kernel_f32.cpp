@@ -0,0 +1,135 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <string.h>
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+#include "jit_avx2_sum_kernel_f32.hpp"
+
+#define GET_OFF(field) offsetof(jit_sum_call_s, field)
+
+#define ymm_scale_tmp Ymm(15)
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace Xbyak;
+
+status_t jit_avx2_sum_kernel_f32::init_conf(jit_sum_conf_t &jsp,
+        int n_inputs, const memory_desc_wrapper &dst_d) {
+    memset(&jsp, 0, sizeof(jsp));
+    if (!mayiuse(avx2)) return status::unimplemented;
+
+    /* a guess if the size of the last level cache is not reported */
+    static const size_t llc_size = get_cache_size(0);
+    const size_t llc = llc_size != 0 ? llc_size : 8 * 1024 * 1024;
+
+    jsp.n_inputs = n_inputs;
+    jsp.use_nt_store = dst_d.size() > llc;
+
+    return status::success;
+}
+
+/* dst[off : off + ur_w * simd_w) (or the single element at off if scalar)
+ * gets the weighted sum of the inputs */
+void jit_avx2_sum_kernel_f32::step(int ur_w, bool scalar) {
+    const int vlen = scalar ? sizeof(float) : simd_w * sizeof(float);
+
+    for (int a = 0; a < jsp.n_inputs; ++a) {
+        mov(reg_src, ptr[reg_srcs + a * sizeof(float *)]);
+
+        Ymm ymm_scale = ymm_scale_tmp;
+        if (a < max_scale_regs)
+            ymm_scale = Ymm(first_scale_idx + a);
+        else
+            vbroadcastss(ymm_scale, ptr[reg_scales + a * sizeof(float)]);
+
+        for (int u = 0; u < ur_w; ++u) {
+            auto src = ptr[reg_src + reg_off + u * vlen];
+            if (scalar) {
+                Xmm xmm_acc = Xmm(u), xmm_scale = Xmm(ymm_scale.getIdx());
+                if (a == 0) vmulss(xmm_acc, xmm_scale, src);
+                else vfmadd231ss(xmm_acc, xmm_scale, src);
+            } else {
+                if (a == 0) vmulps(Ymm(u), ymm_scale, src);
+                else vfmadd231ps(Ymm(u), ymm_scale, src);
+            }
+        }
+    }
+
+    for (int u = 0; u < ur_w; ++u) {
+        auto dst = ptr[reg_dst + reg_off + u * vlen];
+        if (scalar) vmovss(dst, Xmm(u));
+        else if (jsp.use_nt_store) vmovntps(dst, Ymm(u));
+        else vmovups(dst, Ymm(u));
+    }
+}
+
+void jit_avx2_sum_kernel_f32::generate() {
+    this->preamble();
+
+    mov(reg_srcs, ptr[this->param1 + GET_OFF(srcs)]);
+    mov(reg_scales, ptr[this->param1 + GET_OFF(scales)]);
+    mov(reg_dst, ptr[this->param1 + GET_OFF(dst)]);
+    mov(reg_off, ptr[this->param1 + GET_OFF(start)]);
+    shl(reg_off, 2); /* in bytes */
+    mov(reg_nelems, ptr[this->param1 + GET_OFF(nelems)]);
+
+    for (int a = 0; a < nstl::min<int>(jsp.n_inputs, max_scale_regs); ++a)
+        vbroadcastss(Ymm(first_scale_idx + a),
+                ptr[reg_scales + a * sizeof(float)]);
+
+    /* ur vectors at a time, then the remaining vectors and elements */
+    L(".sum_ur_loop");
+    cmp(reg_nelems, ur * simd_w);
+    jl(".sum_vec_loop", T_NEAR);
+    step(ur, false);
+    add(reg_off, ur * simd_w * sizeof(float));
+    sub(reg_nelems, ur * simd_w);
+    jmp(".sum_ur_loop", T_NEAR);
+
+    L(".sum_vec_loop");
+    cmp(reg_nelems, simd_w);
+    jl(".sum_scalar_loop", T_NEAR);
+    step(1, false);
+    add(reg_off, simd_w * sizeof(float));
+    sub(reg_nelems, simd_w);
+    jmp(".sum_vec_loop", T_NEAR);
+
+    L(".sum_scalar_loop");
+    cmp(reg_nelems, 0);
+    je(".sum_done", T_NEAR);
+    step(1, true);
+    add(reg_off, sizeof(float));
+    dec(reg_nelems);
+    jmp(".sum_scalar_loop", T_NEAR);
+
+    L(".sum_done");
+    if (jsp.use_nt_store) sfence(); /* order streaming stores before return */
+    vzeroupper();
+
+    this->postamble();
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
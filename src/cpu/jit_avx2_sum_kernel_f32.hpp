@@ -0,0 +1,70 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_JIT_AVX2_SUM_KERNEL_F32_HPP
+#define CPU_JIT_AVX2_SUM_KERNEL_F32_HPP
+
+#include "c_types_map.hpp"
+#include "jit_generator.hpp"
+#include "jit_primitive_conf.hpp"
+#include "type_helpers.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/** dst[e] = sum_i scales[i] * srcs[i][e] for e in [start, start + nelems)
+ *
+ * all the inputs are read for a block of elements before the block of dst
+ * is written, hence dst is written exactly once and may be one of srcs.
+ * with use_nt_store the full vectors of dst are stored bypassing the
+ * caches, which requires &dst[start] to be 32-byte aligned */
+struct jit_avx2_sum_kernel_f32: public jit_generator {
+    jit_avx2_sum_kernel_f32(jit_sum_conf_t ajsp, void* code_ptr = nullptr,
+        size_t code_size = 8 * Xbyak::DEFAULT_MAX_CODE_SIZE): jsp(ajsp)
+    {
+        this->generate();
+        jit_ker = (decltype(jit_ker))this->getCode();
+    }
+
+    jit_sum_conf_t jsp;
+    void operator()(jit_sum_call_s *arg) { jit_ker(arg); }
+    static status_t init_conf(jit_sum_conf_t &jsp, int n_inputs,
+            const memory_desc_wrapper &dst_d);
+
+private:
+    using reg64_t = const Xbyak::Reg64;
+    reg64_t reg_srcs   = r8;
+    reg64_t reg_scales = r9;
+    reg64_t reg_dst    = r10;
+    reg64_t reg_nelems = r11;
+    reg64_t reg_off    = r12;
+    reg64_t reg_src    = r13;
+
+    enum { simd_w = 8, ur = 4, first_scale_idx = ur, max_scale_regs = 11 };
+
+    void (*jit_ker)(jit_sum_call_s *);
+    void step(int ur_w, bool scalar);
+    void generate();
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -23,6 +23,7 @@
  * be obtained with mmap */
 #define XBYAK_USE_MMAP_ALLOCATOR
 #include "xbyak/xbyak.h"
+#include "xbyak/xbyak_util.h"
 
 #define XBYAK_VERSION 0x5000
 
@@ -60,6 +61,56 @@ static const Reg64 cdecl_param1(Operand::RDI), cdecl_param2(Operand::RSI),
 #endif
 }
 
+typedef enum {
+    sse42,
+    avx2,
+    avx512_common,
+} cpu_isa_t;
+
+/** returns true if the jit code for @p cpu_isa can run on this machine */
+static inline bool mayiuse(const cpu_isa_t cpu_isa) {
+    using namespace Xbyak::util;
+    static Cpu cpu;
+
+    switch (cpu_isa) {
+    case sse42: return cpu.has(Cpu::tSSE42);
+    case avx2: /* the avx2 kernels use fma as well */
+        return cpu.has(Cpu::tAVX2) && cpu.has(Cpu::tFMA);
+    case avx512_common: return cpu.has(Cpu::tAVX512F);
+    }
+    return false;
+}
+
+/** returns the size in bytes of the data cache of @p level (1 for L1, 2 for
+ * L2, etc) or, if @p level is 0, of the last level cache, as reported by the
+ * deterministic cache parameters (cpuid leaf 4). Returns 0 if not reported */
+static inline size_t get_cache_size(int level) {
+    using namespace Xbyak::util;
+    unsigned int data[4];
+    size_t size = 0;
+    int size_level = 0;
+
+    Cpu::getCpuid(0, data);
+    if (data[0] < 4) return 0;
+    for (unsigned int i = 0; ; ++i) {
+        Cpu::getCpuidEx(4, i, data);
+        const unsigned int type = data[0] & 0x1f;
+        if (type == 0) break; /* no more caches */
+        if (type == 2) continue; /* instruction cache */
+        const int cache_level = (data[0] >> 5) & 0x7;
+        if (level == 0 ? cache_level < size_level : cache_level != level)
+            continue;
+        const size_t ways = (data[1] >> 22) + 1;
+        const size_t partitions = ((data[1] >> 12) & 0x3ff) + 1;
+        const size_t line_size = (data[1] & 0xfff) + 1;
+        const size_t sets = data[2] + 1;
+        size = ways * partitions * line_size * sets;
+        size_level = cache_level;
+    }
+
+    return size;
+}
+
 class jit_generator : public Xbyak::CodeGenerator
 {
 protected:
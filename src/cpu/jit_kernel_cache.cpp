@@ -0,0 +1,126 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+#include <mutex>
+
+#include "mkldnn.h"
+
+#include "c_types_map.hpp"
+#include "jit_kernel_cache.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+namespace {
+std::mutex &cache_mutex() {
+    static std::mutex m;
+    return m;
+}
+}
+
+size_t jit_kernel_cache_t::hits_ = 0;
+size_t jit_kernel_cache_t::misses_ = 0;
+size_t jit_kernel_cache_t::uses_ = 0;
+
+jit_kernel_cache_t::kernels_t &jit_kernel_cache_t::kernels() {
+    static kernels_t k;
+    return k;
+}
+
+nstl::map<const jit_generator *, jit_kernel_cache_t::entry_iterator> &
+jit_kernel_cache_t::owners() {
+    static nstl::map<const jit_generator *, entry_iterator> o;
+    return o;
+}
+
+nstl::map<size_t, jit_kernel_cache_t::entry_iterator> &
+jit_kernel_cache_t::unused() {
+    static nstl::map<size_t, entry_iterator> u;
+    return u;
+}
+
+void jit_kernel_cache_t::lock() { cache_mutex().lock(); }
+void jit_kernel_cache_t::unlock() { cache_mutex().unlock(); }
+
+jit_generator *jit_kernel_cache_t::lookup(const key_bytes_t &key) {
+    auto it = kernels().find(key);
+    if (it == kernels().end()) return nullptr;
+    if (it->second.refs++ == 0)
+        unused().erase(unused().find(it->second.last_use));
+    it->second.last_use = ++uses_;
+    ++hits_;
+    return it->second.kernel;
+}
+
+void jit_kernel_cache_t::insert(const key_bytes_t &key,
+        jit_generator *kernel) {
+    entry_t e = { kernel, 1, ++uses_ };
+    kernels()[key] = e;
+    owners()[kernel] = kernels().find(key);
+    ++misses_;
+}
+
+void jit_kernel_cache_t::release(const jit_generator *kernel) {
+    if (kernel == nullptr) return;
+    lock();
+    auto o = owners().find(kernel);
+    assert(o != owners().end());
+    entry_t &e = o->second->second;
+    assert(e.refs > 0);
+    if (--e.refs == 0) {
+        unused()[e.last_use] = o->second;
+        evict();
+    }
+    unlock();
+}
+
+/* drops the least recently used unused kernels above max_unused */
+void jit_kernel_cache_t::evict() {
+    while (unused().size() > max_unused) {
+        auto lru = unused().begin();
+        entry_iterator it = lru->second;
+        unused().erase(lru);
+        owners().erase(owners().find(it->second.kernel));
+        delete it->second.kernel;
+        kernels().erase(it);
+    }
+}
+
+void jit_kernel_cache_t::get_stats(size_t *hits, size_t *misses) {
+    lock();
+    *hits = hits_;
+    *misses = misses_;
+    unlock();
+}
+
+}
+}
+}
+
+using namespace mkldnn::impl;
+using namespace mkldnn::impl::status;
+
+status_t mkldnn_jit_kernel_cache_get_stats(size_t *hits, size_t *misses) {
+    if (utils::any_null(hits, misses))
+        return invalid_arguments;
+    cpu::jit_kernel_cache_t::get_stats(hits, misses);
+    return success;
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -0,0 +1,119 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_JIT_KERNEL_CACHE_HPP
+#define CPU_JIT_KERNEL_CACHE_HPP
+
+#include <string.h>
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+#include "jit_generator.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/** process-wide cache of jit generated kernels
+ *
+ * kernels are looked up by the type of the kernel and the raw bytes of a key
+ * (usually the configuration structure the kernel is generated from, e.g.
+ * jit_conv_conf_t), so that the primitives with the same configuration share
+ * the same code instead of generating it over and over again.
+ *
+ * kernels are owned by the cache: a primitive gets a kernel with get() and
+ * gives it back with release() when destroyed. at most max_unused kernels
+ * that no primitive uses are kept, the least recently used ones go first.
+ *
+ * keys are compared with memcmp(), hence a key (and the configuration
+ * structures used as keys) must be zeroed before the fields are set, so
+ * that the padding bytes do not turn identical keys into different ones */
+struct jit_kernel_cache_t {
+    enum { max_unused = 256 };
+
+    template <typename kernel_t, typename key_t, typename... Args>
+    static kernel_t *get(const key_t &key, Args... args) {
+        const key_bytes_t kb(type_id<kernel_t>(), &key, sizeof(key_t));
+        lock();
+        jit_generator *kernel = lookup(kb);
+        if (kernel == nullptr) {
+            kernel = new kernel_t(args...);
+            insert(kb, kernel);
+        }
+        unlock();
+        return static_cast<kernel_t *>(kernel);
+    }
+
+    static void release(const jit_generator *kernel);
+
+    static void get_stats(size_t *hits, size_t *misses);
+
+private:
+    struct key_bytes_t {
+        key_bytes_t(const void *type, const void *key, size_t size)
+            : type_(type), bytes_(size) { memcpy(&bytes_[0], key, size); }
+        bool operator<(const key_bytes_t &rhs) const {
+            if (type_ != rhs.type_) return type_ < rhs.type_;
+            if (bytes_.size() != rhs.bytes_.size())
+                return bytes_.size() < rhs.bytes_.size();
+            return memcmp(&bytes_[0], &rhs.bytes_[0], bytes_.size()) < 0;
+        }
+        const void *type_;
+        nstl::vector<char> bytes_;
+    };
+
+    /* an address unique for each kernel type */
+    template <typename kernel_t> static const void *type_id() {
+        static const char id = 0;
+        return &id;
+    }
+
+    struct entry_t {
+        jit_generator *kernel;
+        int refs; /* primitives using the kernel */
+        size_t last_use;
+    };
+    struct kernels_t: public nstl::map<key_bytes_t, entry_t> {
+        ~kernels_t() {
+            for (auto it = begin(); it != end(); ++it)
+                delete it->second.kernel;
+        }
+    };
+    typedef kernels_t::iterator entry_iterator;
+
+    static kernels_t &kernels();
+    /* the entry of each kernel, so that release() does not scan kernels() */
+    static nstl::map<const jit_generator *, entry_iterator> &owners();
+    /* the unused entries ordered by last_use, the least recent one first */
+    static nstl::map<size_t, entry_iterator> &unused();
+    static void lock();
+    static void unlock();
+    static jit_generator *lookup(const key_bytes_t &key);
+    static void insert(const key_bytes_t &key, jit_generator *kernel);
+    static void evict();
+
+    static size_t hits_, misses_, uses_;
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_JIT_PRIMITIVE_CONF_HPP
+#define CPU_JIT_PRIMITIVE_CONF_HPP
+
+#include <stddef.h>
+
+#include "c_types_map.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+/* convolution */
+struct jit_conv_conf_t {
+    int mb;
+    int ngroups, ic, oc;
+    int ih, iw, oh, ow;
+    int l_pad, t_pad;
+    int kh, kw;
+    int stride_h, stride_w;
+    memory_format_t src_fmt;
+    bool with_bias, with_relu;
+    double relu_negative_slope;
+
+    int ihp, iwp, ohp, owp;
+    int nb_ic, ic_block;
+    int nb_oc, oc_block;
+    int nb_ic_blocking, nb_oc_blocking; // blocking of nb_ic and nb_ic
+    int oh_blocking; // rows of the output kept in cache over the reduction
+    int ur_h, ur_w;
+    int ur_w_tail;
+};
+
+struct __attribute__((__packed__)) jit_conv_call_s {
+    const float *src; /* hack, non-const for backward_data */
+    const float *dst; /* hack, non-const for forward */
+    const float *filt; /* hack, non-const for backward_weights */
+    const float *bias; /* hack, non-const for backward_bias */
+    const float *src_prf;
+    const float *dst_prf;
+    const float *filt_prf;
+    size_t kh_padding;
+    size_t kh_padding_prf;
+    size_t kw_padding;
+    int ic_flag;
+};
+
+/* 1x1 convolution */
+struct jit_1x1_conv_conf_t {
+    prop_kind_t prop_kind;
+
+    int mb;
+    int ngroups, ic, oc;
+    int ih, iw, oh, ow;
+    int l_pad, t_pad;
+    int kh, kw;
+    int stride_h, stride_w;
+    bool with_bias, with_relu;
+    double relu_negative_slope;
+
+    int is, os;
+    int ic_block, oc_block;
+
+    /* the convolution is a gemm: output[bcast][load] += sum over reduce of
+     * bcast[bcast][reduce] * load[reduce][load], a call of the kernel takes
+     * a block of each of the dimensions */
+    int bcast_dim, bcast_block, nb_bcast;
+    int load_dim, load_block, nb_load;
+    int reduce_dim, reduce_block, nb_reduce;
+
+    /* the register tile is ur rows of bcast by up to 3 simd vectors of
+     * load, the offsets below are in floats */
+    int ur, ur_tail;
+    int reduce_loop_unroll;
+    int bcast_j_stride, bcast_u_stride; /* next row, next reduce element */
+    int load_i_stride, output_i_stride; /* next simd vector of load */
+    int reduce_loop_bcast_step, reduce_loop_load_step; /* next unroll */
+};
+
+struct __attribute__((__packed__)) jit_1x1_conv_call_s {
+    const float *bcast_data;
+    const float *load_data;
+    const float *output_data;
+    const float *bias_data;
+    size_t load_dim;
+    size_t bcast_dim;
+    size_t reduce_dim;
+    size_t reduce_pos_flag;
+};
+
+/* pooling */
+struct jit_pool_conf_t {
+    int mb, c;
+    int ih, iw, oh, ow;
+    int stride_h, stride_w;
+    int kh, kw;
+    int t_pad, l_pad;
+    bool is_max;
+    bool is_training;
+    bool is_backward;
+    data_type_t ind_dt; /* data type of the max pooling workspace */
+
+    int nb_c, c_block;
+    int ur_h, ur_w;
+    int ur_w_tail;
+};
+
+struct __attribute__ ((__packed__)) jit_pool_call_s {
+    const float *src;
+    const float *dst;
+    const void *indices;
+    const float *src_prf;
+    const float *dst_prf;
+    const void *indices_prf;
+    size_t kh_padding;
+    size_t kh_padding_prf;
+    size_t kh_padding_shift; /* rows of the window cut by the top padding */
+    size_t kw_padding;
+    const float* init_value;
+};
+
+/* relu */
+struct jit_relu_conf_t {
+    float negative_slope;
+    int main_loop_iterations;
+    size_t reminder;
+};
+
+/* sum */
+struct jit_sum_conf_t {
+    int n_inputs;
+    bool use_nt_store; /* streaming stores, the output does not fit the LLC */
+};
+
+struct __attribute__ ((__packed__)) jit_sum_call_s {
+    const float **srcs;
+    const float *scales;
+    float *dst;
+    size_t start; /* the first element to sum up */
+    size_t nelems;
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef JIT_SSE42_CONV_KERNEL_F32_HPP
+#define JIT_SSE42_CONV_KERNEL_F32_HPP
+
+#include "c_types_map.hpp"
+#include "jit_generator.hpp"
+#include "jit_primitive_conf.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+struct jit_sse42_conv_fwd_kernel_f32: public jit_generator {
+    enum { IC_FLAG_FIRST = 1, IC_FLAG_LAST = 2 };
+
+    jit_sse42_conv_fwd_kernel_f32(jit_conv_conf_t ajcp,
+            void *code_ptr = nullptr,
+            size_t code_size = 64 * Xbyak::DEFAULT_MAX_CODE_SIZE)
+        : jit_generator(code_ptr, code_size), jcp(ajcp)
+    {
+        this->generate();
+        jit_ker = (void (*)(jit_conv_call_s *))this->getCode();
+    }
+
+    static status_t init_conf(jit_conv_conf_t &jcp,
+            const convolution_desc_t &cd, const memory_desc_wrapper &src_d,
+            const memory_desc_wrapper &weights_d,
+            const memory_desc_wrapper &dst_d, bool with_relu = false,
+            double relu_negative_slope = 0.);
+
+    jit_conv_conf_t jcp;
+    void (*jit_ker)(jit_conv_call_s *);
+
+private:
+    enum { simd_w = 4 };
+
+    using reg64_t = const Xbyak::Reg64;
+    reg64_t reg_input = rax;
+    reg64_t aux_reg_input = r8;
+    reg64_t reg_kernel = rdx;
+    reg64_t aux_reg_kernel = r9;
+    reg64_t reg_output = rsi;
+    reg64_t reg_bias = rbx;
+
+    reg64_t kj = r10;
+    reg64_t oi_iter = r11;
+    reg64_t ki_iter = r12;
+    reg64_t reg_kh = rcx;
+    Xbyak::Reg32 reg_ci_flag = r13d;
+
+    /* an 8-channel output block is kept in two xmm halves */
+    inline Xbyak::Xmm xmm_out(int ur_w, int ii, int jj, int h)
+    { return Xbyak::Xmm(2 * (ur_w * ii + jj) + h); }
+    inline Xbyak::Xmm xmm_inp(int jj) { return Xbyak::Xmm(12 + jj); }
+    Xbyak::Xmm xmm_wei = Xbyak::Xmm(15);
+
+    inline void oh_step_unroll_kw(int ur_w, int pad_l, int pad_r);
+    inline void oh_step_nopad(int ur_w, int pad_l, int pad_r, char pad_label);
+    inline void width_blk_step(int ur_w, int pad_l, int pad_r, char pad_label);
+
+    void generate();
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
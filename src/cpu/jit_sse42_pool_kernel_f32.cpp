@@ -0,0 +1,315 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+#include <string.h>
+
+#include "c_types_map.hpp"
+#include "nstl.hpp"
+#include "utils.hpp"
+
+#include "cpu_pooling_pd.hpp"
+#include "jit_sse42_pool_kernel_f32.hpp"
+
+/* blendvps takes the mask in xmm0 implicitly, hence the accumulators start
+ * from xmm1 */
+#define xmm_store_mask Xmm(0)
+#define xmm_acc(jj) Xmm(1 + (jj))
+#define xmm_input Xmm(14)
+#define xmm_tmp Xmm(13)
+#define xmm_one Xmm(11)
+#define xmm_kh_shift Xmm(10)
+#define xmm_ki_offset Xmm(9)
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+status_t jit_sse42_pool_kernel_f32::init_conf(jit_pool_conf_t &jpp,
+            const pooling_desc_t &pd, const memory_desc_wrapper &src_d,
+            const memory_desc_wrapper &dst_d, bool is_training) {
+    memset(&jpp, 0, sizeof(jpp));
+    if (!mayiuse(sse42)) return status::unimplemented;
+
+    bool args_ok = true
+        && utils::one_of(pd.alg_kind, alg_kind::pooling_max,
+                alg_kind::pooling_avg)
+        && src_d.format() == memory_format::nChw8c
+        && dst_d.format() == src_d.format();
+    if (!args_ok) return status::unimplemented;
+
+    const int simd_w = 8; /* the channel block, not the vector length */
+    jpp.mb = src_d.dims()[0];
+    jpp.c = src_d.blocking_desc().padding_dims[1]; /* zero-padded channels */
+    jpp.ih = src_d.dims()[2];
+    jpp.iw = src_d.dims()[3];
+    jpp.oh = dst_d.dims()[2];
+    jpp.ow = dst_d.dims()[3];
+
+    jpp.stride_h = pd.strides[0];
+    jpp.stride_w = pd.strides[1];
+    jpp.kh = pd.kernel[0];
+    jpp.kw = pd.kernel[1];
+
+    jpp.t_pad = pd.padding[0][0];
+    jpp.l_pad = pd.padding[0][1];
+
+    jpp.is_max = pd.alg_kind == alg_kind::pooling_max;
+    jpp.is_training = is_training;
+    jpp.is_backward = false;
+    jpp.ind_dt = pooling_index_data_type(&pd);
+
+    jpp.c_block = simd_w;
+    jpp.nb_c = jpp.c / jpp.c_block;
+    jpp.ur_h = 1; /* no code-unrolling by h so far */
+    jpp.ur_w = jpp.is_training ? 3 : 8;
+    if (jpp.ow < jpp.ur_w) jpp.ur_w = jpp.ow;
+    jpp.ur_w_tail = jpp.ow % jpp.ur_w;
+
+    /* the padding is implied by the output size and may differ on each
+     * side. every window has to overlap the input, the left padding may
+     * only reach the first ur_w block and the right one the last block
+     * and the tail */
+    const int b_pad = (jpp.oh - 1) * jpp.stride_h + jpp.kh - jpp.ih
+        - jpp.t_pad;
+    const int r_pad = (jpp.ow - 1) * jpp.stride_w + jpp.kw - jpp.iw
+        - jpp.l_pad;
+    args_ok = true
+        && jpp.t_pad < jpp.kh && b_pad < jpp.kh
+        && jpp.l_pad < jpp.kw && r_pad < jpp.kw
+        && jpp.l_pad <= jpp.ur_w * jpp.stride_w
+        && utils::div_up(nstl::max(0, r_pad), jpp.stride_w)
+                <= jpp.ur_w + jpp.ur_w_tail;
+    if (!args_ok) return status::unimplemented;
+
+    return status::success;
+}
+
+inline void jit_sse42_pool_kernel_f32::avg_oh_step(int ur_w, int pad_l,
+        int pad_r, const char* kh_lable, int half) {
+    using Xbyak::Xmm;
+
+    int iw = jpp.iw;
+    int kw = jpp.kw;
+    int kh = jpp.kh;
+    int stride_w = jpp.stride_w;
+    int c_block = jpp.c_block;
+    const int c_off = half * c_block / 2;
+
+    union {
+        float _devider;
+        int _devider_int;
+    } cvt;
+    cvt._devider = kw*kh;
+
+    mov(tmp_gpr, cvt._devider_int);
+    movq(xmm_tmp, tmp_gpr);
+    pshufd(xmm_tmp, xmm_tmp, 0);
+
+    for (int jj = 0; jj < ur_w; jj++)
+        pxor(xmm_acc(jj), xmm_acc(jj));
+
+    mov(aux_reg_input , reg_input);
+    xor_(kj, kj);
+    L(kh_lable);
+    {
+        for (int ki = 0; ki < kw; ki++) {
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
+            for (int jj = jj_start; jj  < jj_end; jj++) {
+                int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
+                if (aux_input_offset > iw * c_block)
+                    continue;
+                movups(xmm_input, ptr[aux_reg_input
+                        + sizeof(float)*(aux_input_offset + c_off)]);
+                addps(xmm_acc(jj), xmm_input);
+            }
+        }
+        add(aux_reg_input,  sizeof(float) * iw * c_block);
+        inc(kj);
+        cmp(kj, reg_kh);
+        jl(kh_lable, T_NEAR);
+    }
+
+    for (int jj = 0; jj < ur_w; jj++) {
+        divps(xmm_acc(jj), xmm_tmp);
+        movups(ptr[reg_output + sizeof(float)*(jj*c_block + c_off)],
+                xmm_acc(jj));
+    }
+}
+
+inline void jit_sse42_pool_kernel_f32::max_oh_step(int ur_w, int pad_l,
+        int pad_r, const char *kh_lable, int half) {
+    using Xbyak::Xmm;
+
+    union {
+        float _flt_max;
+        int _flt_max_int;
+    } cvt;
+    cvt._flt_max = -FLT_MAX;
+
+    int iw = jpp.iw;
+    int kw = jpp.kw;
+    int stride_w = jpp.stride_w;
+    int c_block = jpp.c_block;
+    const int c_off = half * c_block / 2;
+
+    mov(tmp_gpr, cvt._flt_max_int);
+    movq(xmm_tmp, tmp_gpr);
+    pshufd(xmm_tmp, xmm_tmp, 0);
+    for (int jj = 0; jj < ur_w; jj++)
+        movaps(xmm_acc(jj), xmm_tmp);
+
+    /* xmm_ki_offset is the position kh * KW + kw of the current tap */
+    if (jpp.is_training) {
+        for (int jj = 0; jj < ur_w; jj++)
+            pxor(xmm_acc(ur_w+jj), xmm_acc(ur_w+jj));
+        movdqa(xmm_ki_offset, xmm_kh_shift);
+    }
+
+    mov(aux_reg_input, reg_input);
+    xor_(kj, kj);
+    L(kh_lable);
+    {
+        for (int ki = 0; ki < kw; ki++) {
+            int jj_start = nstl::max(0, (pad_l - ki + stride_w - 1)
+                    / stride_w);
+            int jj_end = ur_w - nstl::max(0, (ki + pad_r - (kw-1)
+                        + stride_w - 1) / stride_w);
+            for (int jj = jj_start; jj  < jj_end; jj++) {
+                int aux_input_offset = (ki+jj*stride_w-pad_l)* c_block;
+                if (aux_input_offset > iw * c_block)
+                    continue;
+                movups(xmm_input, ptr[aux_reg_input
+                        + sizeof(float)*(aux_input_offset + c_off)]);
+                movaps(xmm_store_mask, xmm_acc(jj));
+                cmpltps(xmm_store_mask, xmm_input);
+                blendvps(xmm_acc(jj), xmm_input);
+                if (jpp.is_training)
+                    blendvps(xmm_acc(ur_w+jj), xmm_ki_offset);
+            }
+            if (jpp.is_training)
+                paddd(xmm_ki_offset, xmm_one);
+        }
+        add(aux_reg_input,  sizeof(float) * iw * c_block);
+        inc(kj);
+        cmp(kj, reg_kh);
+        jl(kh_lable, T_NEAR);
+    }
+
+    const int ind_dt_size = types::data_type_size(jpp.ind_dt);
+    for (int jj = 0; jj < ur_w; jj++) {
+        movups(ptr[reg_output + sizeof(float)*(jj*c_block + c_off)],
+                xmm_acc(jj));
+        if (!jpp.is_training) continue;
+
+        auto ind = ptr[reg_index + ind_dt_size*(jj*c_block + c_off)];
+        if (jpp.ind_dt == data_type::u8) {
+            packusdw(xmm_acc(ur_w+jj), xmm_acc(ur_w+jj));
+            packuswb(xmm_acc(ur_w+jj), xmm_acc(ur_w+jj));
+            movd(ind, xmm_acc(ur_w+jj));
+        } else {
+            movdqu(ind, xmm_acc(ur_w+jj));
+        }
+    }
+}
+
+void jit_sse42_pool_kernel_f32::generate() {
+    using Xbyak::Xmm;
+    this->preamble();
+
+    int ow = jpp.ow;
+    int iw = jpp.iw;
+    int kw = jpp.kw;
+    int ur_w = jpp.ur_w;
+    int c_block = jpp.c_block;
+    int stride_w = jpp.stride_w;
+    int l_pad = jpp.l_pad;
+    int ur_w_tail = jpp.ur_w_tail;
+
+    int n_oi = ow / ur_w;
+
+#   define GET_OFF(field) offsetof(jit_pool_call_s, field)
+    mov(reg_input, ptr[this->param1 + GET_OFF(src)]);
+    mov(reg_output, ptr[this->param1 + GET_OFF(dst)]);
+    if (jpp.is_max && jpp.is_training)
+        mov(reg_index, ptr[this->param1 + GET_OFF(indices)]);
+    mov(reg_kh, ptr[this->param1 + GET_OFF(kh_padding)]);
+    if (jpp.is_max && jpp.is_training) {
+        mov(tmp_gpr, ptr[this->param1 + GET_OFF(kh_padding_shift)]);
+        imul(tmp_gpr, tmp_gpr, kw);
+        movq(xmm_kh_shift, tmp_gpr);
+        pshufd(xmm_kh_shift, xmm_kh_shift, 0);
+
+        mov(tmp_gpr, 1);
+        movq(xmm_one, tmp_gpr);
+        pshufd(xmm_one, xmm_one, 0);
+    }
+#   undef GET_OFF
+
+    const int ind_dt_size = types::data_type_size(jpp.ind_dt);
+
+    int r_pad  = nstl::max(0, ((ow-1)*stride_w) + kw - 1 - (iw + l_pad - 1 ));
+    int r_pad1 = (ur_w*n_oi - 1)*stride_w + kw - 1 - (iw + l_pad - 1);
+    if (r_pad1 > 0) n_oi--;
+
+    if (l_pad > 0) {
+        n_oi--;
+        if (n_oi < 0 && r_pad1 > 0) {
+            oh_step(ur_w, l_pad, r_pad1, ".kh_loop_oimain_padwl");
+        } else  {
+            oh_step(ur_w, l_pad, 0, ".kh_loop_oimain_padwl");
+        }
+
+        add(reg_input,  sizeof(float)*(ur_w*stride_w - l_pad)*c_block);
+        add(reg_output,  sizeof(float)*ur_w*c_block);
+        if (jpp.is_max && jpp.is_training)
+            add(reg_index, ind_dt_size*ur_w*c_block);
+    }
+
+    xor_(oi_iter, oi_iter);
+    if (n_oi > 0) {
+        L(".ow_loop"); {
+            oh_step( ur_w, 0, 0, ".kh_loop_oimain");
+            add(reg_input, sizeof(float)*ur_w*stride_w*c_block);
+            add(reg_output, sizeof(float)*ur_w*c_block);
+            if (jpp.is_max && jpp.is_training)
+                add(reg_index, ind_dt_size*ur_w*c_block);
+
+            inc(oi_iter);
+            cmp(oi_iter, n_oi); jl(".ow_loop", T_NEAR);
+        } L(".ow_loop_end");
+    }
+
+    if (r_pad1 > 0 && n_oi >= 0) {
+        oh_step( ur_w, 0, r_pad1, ".kh_loop_oimain_padwr");
+        add(reg_input, sizeof(float)*ur_w*stride_w*c_block);
+        add(reg_output, sizeof(float)*ur_w*c_block);
+        if (jpp.is_max && jpp.is_training)
+            add(reg_index, ind_dt_size * ur_w * c_block);
+    }
+
+    if (ur_w_tail != 0)
+        oh_step(ur_w_tail, 0, r_pad, ".kh_loop_oitail");
+
+    this->postamble();
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
@@ -50,7 +50,9 @@ struct _ref_convolution_fwd_t: public cpu_primitive_t {
                 && utils::implication(
                         this->base_pkind == primitive_kind::convolution_relu,
                         this->cdesc_().prop_kind == forward_inference)
-                && this->cdesc_().alg_kind == alg_kind::convolution_direct
+                && utils::one_of(this->cdesc_().alg_kind,
+                        alg_kind::convolution_direct,
+                        alg_kind::convolution_winograd)
                 && utils::everyone_is(data_type,
                         this->cdesc_().src_desc.data_type,
                         this->cdesc_().weights_desc.data_type,
@@ -106,7 +108,9 @@ struct ref_convolution_bwd_data_t: public cpu_primitive_t {
                 && this->set_default_params() == status::success
                 && utils::one_of(this->desc()->prop_kind, backward,
                         backward_data)
-                && this->desc()->alg_kind == alg_kind::convolution_direct
+                && utils::one_of(this->desc()->alg_kind,
+                        alg_kind::convolution_direct,
+                        alg_kind::convolution_winograd)
                 && utils::everyone_is(data_type,
                         this->desc()->diff_src_desc.data_type,
                         this->desc()->weights_desc.data_type,
@@ -155,7 +159,9 @@ struct ref_convolution_bwd_weights_t: public cpu_primitive_t {
                 && this->set_default_params() == status::success
                 && utils::one_of(this->desc()->prop_kind, backward,
                         backward_weights)
-                && this->desc()->alg_kind == alg_kind::convolution_direct
+                && utils::one_of(this->desc()->alg_kind,
+                        alg_kind::convolution_direct,
+                        alg_kind::convolution_winograd)
                 && utils::everyone_is(data_type,
                         this->desc()->src_desc.data_type,
                         this->desc()->diff_dst_desc.data_type,
@@ -14,7 +14,10 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <limits>
+
 #include "c_types_map.hpp"
+#include "nstl.hpp"
 #include "type_helpers.hpp"
 
 #include "ref_inner_product.hpp"
@@ -75,6 +78,83 @@ void ref_inner_product_fwd_t<data_type>::execute_forward() {
 
 template struct ref_inner_product_fwd_t<data_type::f32>;
 
+template <impl::data_type_t data_type>
+void ref_pooling_inner_product_fwd_t<data_type>::execute_forward(
+        char *scratchpad) {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
+    auto dst = reinterpret_cast<data_t*>(this->memory());
+    auto pooled = reinterpret_cast<data_t *>(scratchpad);
+
+    const memory_desc_wrapper src_d(conf_.src_pd());
+    const memory_desc_wrapper dst_d(conf_.dst_pd());
+    const memory_desc_wrapper weights_d(conf_.weights_pd(0));
+    const memory_desc_wrapper bias_d(conf_.weights_pd(1));
+
+    const int MB = conf_.MB();
+    const int C = conf_.C();
+    const int IH = conf_.IH();
+    const int IW = conf_.IW();
+    const int OH = conf_.OH();
+    const int OW = conf_.OW();
+    const int KH = conf_.KH();
+    const int KW = conf_.KW();
+    const int SH = conf_.KSH();
+    const int SW = conf_.KSW();
+    const int padT = conf_.padT();
+    const int padL = conf_.padL();
+    const int OC = conf_.OC();
+    const bool is_max = conf_.pdesc()->alg_kind == alg_kind::pooling_max;
+
+#   pragma omp parallel for collapse(4) schedule(static)
+    for (int mb = 0; mb < MB; ++mb) {
+        for (int c = 0; c < C; ++c) {
+            for (int oh = 0; oh < OH; ++oh) {
+                for (int ow = 0; ow < OW; ++ow) {
+                    data_t d = is_max
+                        ? -std::numeric_limits<data_t>::infinity() : 0;
+                    for (int kh = 0; kh < KH; ++kh) {
+                        for (int kw = 0; kw < KW; ++kw) {
+                            const int ih = oh * SH - padT + kh;
+                            const int iw = ow * SW - padL + kw;
+                            if (ih < 0 || ih >= IH) continue;
+                            if (iw < 0 || iw >= IW) continue;
+
+                            auto s = src[src_d.off(mb, c, ih, iw)];
+                            d = is_max ? nstl::max(d, s) : d + s;
+                        }
+                    }
+                    pooled[((mb * C + c) * OH + oh) * OW + ow] = is_max
+                        ? d : d / (KH * KW);
+                }
+            }
+        }
+    }
+
+    const bool ip_has_spatial = conf_.ip_ndims() == 4;
+#   pragma omp parallel for collapse(2) schedule(static)
+    for (int mb = 0; mb < MB; ++mb) {
+        for (int oc = 0; oc < OC; ++oc) {
+            data_t d = bias ? bias[bias_d.off(oc)] : data_t(0);
+            const data_t *p = &pooled[mb * C * OH * OW];
+            for (int c = 0; c < C; ++c) {
+                for (int oh = 0; oh < OH; ++oh) {
+                    for (int ow = 0; ow < OW; ++ow) {
+                        const size_t w_off = ip_has_spatial
+                            ? weights_d.off(oc, c, oh, ow)
+                            : weights_d.off(oc, c);
+                        d += p[(c * OH + oh) * OW + ow] * weights[w_off];
+                    }
+                }
+            }
+            dst[dst_d.off(mb, oc)] = d;
+        }
+    }
+}
+
+template struct ref_pooling_inner_product_fwd_t<data_type::f32>;
+
 template <impl::data_type_t data_type>
 void ref_inner_product_bwd_data_t<data_type>::execute_backward_data() {
     auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(0));
@@ -21,6 +21,7 @@
 
 #include "c_types_map.hpp"
 #include "cpu_inner_product_pd.hpp"
+#include "cpu_pooling_inner_product_pd.hpp"
 #include "cpu_engine.hpp"
 #include "type_helpers.hpp"
 #include "utils.hpp"
@@ -170,6 +171,52 @@ private:
     pd_t conf_;
 };
 
+template <impl::data_type_t data_type>
+struct ref_pooling_inner_product_fwd_t: public cpu_primitive_t {
+    struct pd_t: public cpu_pooling_inner_product_fwd_pd_t {
+        pd_t(engine_t *engine, const pooling_inner_product_desc_t *adesc,
+                const pooling_inner_product_fwd_pd_t *hint_fwd_pd)
+            : cpu_pooling_inner_product_fwd_pd_t(engine, adesc, hint_fwd_pd)
+        {}
+
+        DECLARE_COMMON_PD_T(ref_pooling_inner_product_fwd_t);
+
+        virtual status_t init() override {
+            using namespace alg_kind;
+            assert(engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && this->set_default_params() == status::success
+                && utils::one_of(pdesc()->alg_kind, pooling_max,
+                        pooling_avg)
+                && utils::everyone_is(data_type, pdesc()->src_desc.data_type,
+                        ipdesc()->weights_desc.data_type,
+                        ipdesc()->dst_desc.data_type)
+                && utils::implication(this->with_bias(),
+                        data_type == ipdesc()->bias_desc.data_type);
+            return ok ? status::success : status::unimplemented;
+        }
+
+        /* the pooling result, in nchw */
+        virtual size_t scratchpad_size() const override
+        { return sizeof(data_t) * MB() * C() * OH() * OW(); }
+    };
+
+    ref_pooling_inner_product_fwd_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd) {}
+    typedef typename prec_trait<data_type>::type data_t;
+
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        execute_forward(scratchpad);
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_forward(char *scratchpad);
+    pd_t conf_;
+};
+
 }
 }
 }
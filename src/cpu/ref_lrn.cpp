@@ -45,6 +45,7 @@ void ref_lrn_fwd_t<data_type>::execute_forward() {
     auto ker = [=](data_t *d, int mb, int oc, int oh, int ow) {
         const double alpha = conf_.desc()->lrn_alpha;
         const double beta = conf_.desc()->lrn_beta;
+        const double k = conf_.desc()->lrn_k;
 
         const int size = conf_.desc()->local_size;
         const int CSIZE = across_channels ? size : 1;
@@ -67,11 +68,11 @@ void ref_lrn_fwd_t<data_type>::execute_forward() {
                 }
             }
         }
-        data_t k = pow(1 + alpha * sum / summands, beta);
-        d[0] = src[data_d.off(mb, oc, oh, ow)] / k;
-        if (ws)
-            ws[ws_d.off(mb, oc, oh, ow)]
-                = 1 / (k * (1 + alpha * sum / summands)); // for back prop
+        const data_t base = k + alpha * sum / summands;
+        const data_t norm_coef = pow(base, beta);
+        d[0] = src[data_d.off(mb, oc, oh, ow)] / norm_coef;
+        if (ws) // base^(1 + beta) for back prop, same as the jit forward
+            ws[ws_d.off(mb, oc, oh, ow)] = norm_coef * base;
     };
 
     const int MB = conf_.MB();
@@ -107,7 +108,7 @@ void ref_lrn_bwd_t<data_type>::execute_backward() {
 
     const double alpha = conf_.desc()->lrn_alpha;
     const double beta = conf_.desc()->lrn_beta;
-    const double k = 1.0;
+    const double k = conf_.desc()->lrn_k;
     const int kernel_size = conf_.desc()->local_size;
 
     auto get_omega = [=](data_t c_k, int kernel_size, double alpha, int C,
@@ -0,0 +1,342 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "mkldnn_types.h"
+
+#include "c_types_map.hpp"
+#include "winograd_convolution.hpp"
+#include "type_helpers.hpp"
+#include "utils.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+using namespace mkldnn::impl::status;
+using namespace mkldnn::impl::utils;
+
+namespace {
+
+enum { alpha = winograd_f32::alpha, simd_w = winograd_f32::simd_w };
+
+/* the tiles of a block and their transforms fit this much of the cache */
+const size_t tile_block_cache = 512 * 1024;
+
+inline size_t u_size(const winograd_conf_t &wc) {
+    return rnd_up(sizeof(float) * alpha * alpha * wc.ic * wc.oc, 64);
+}
+
+inline size_t v_size(const winograd_conf_t &wc) {
+    return rnd_up(sizeof(float) * alpha * alpha * wc.tile_block * wc.ic, 64);
+}
+
+inline size_t m_size(const winograd_conf_t &wc) {
+    return rnd_up(sizeof(float) * alpha * alpha * wc.tile_block * wc.oc, 64);
+}
+
+inline size_t gemm_ws_size(const winograd_conf_t &wc) {
+    return rnd_up(jit_avx2_gemm_f32::ws_size(wc.oc, wc.tile_block, wc.ic), 64);
+}
+
+inline size_t thr_ws_size(const winograd_conf_t &wc) {
+    return v_size(wc) + m_size(wc) + gemm_ws_size(wc);
+}
+
+}
+
+status_t winograd_f32::init_conf(winograd_conf_t &wc, int mb, int ic,
+        int oc, int ih, int iw, int oh, int ow, int t_pad, int l_pad,
+        bool flip_weights) {
+    if (ic % simd_w != 0 || oc % simd_w != 0)
+        return status::unimplemented;
+
+    wc.mb = mb; wc.ic = ic; wc.oc = oc;
+    wc.ih = ih; wc.iw = iw; wc.oh = oh; wc.ow = ow;
+    wc.t_pad = t_pad; wc.l_pad = l_pad;
+    wc.flip_weights = flip_weights;
+
+    wc.tiles_h = div_up(oh, (int)tile);
+    wc.tiles_w = div_up(ow, (int)tile);
+    wc.nb_tiles = mb * wc.tiles_h * wc.tiles_w;
+
+#if defined(_OPENMP)
+    wc.nthr = omp_get_max_threads();
+#else
+    wc.nthr = 1;
+#endif
+
+    /* a block of tiles is the n of the gemms: large enough to amortize the
+     * packing of the filters, small enough to keep its transforms in cache
+     * and to give every thread a block */
+    const int cache_tiles = (int)(tile_block_cache
+            / (sizeof(float) * alpha * alpha * (ic + oc)));
+    wc.tile_block = nstl::max(24, nstl::min(96, cache_tiles));
+    wc.tile_block = nstl::min(wc.tile_block, div_up(wc.nb_tiles, wc.nthr));
+    wc.nb_tile_blocks = div_up(wc.nb_tiles, wc.tile_block);
+    wc.nthr = nstl::min(wc.nthr, wc.nb_tile_blocks);
+
+    return status::success;
+}
+
+size_t winograd_f32::weights_size(const winograd_conf_t &wc) {
+    return u_size(wc);
+}
+
+size_t winograd_f32::scratchpad_size(const winograd_conf_t &wc) {
+    return wc.nthr * thr_ws_size(wc);
+}
+
+/* U = G g G^T, stored as alpha * alpha matrices of oc x ic */
+void winograd_f32::transform_weights(const float *weights,
+        const memory_desc_wrapper &weights_d, float *u) {
+    const auto &strides = weights_d.blocking_desc().strides[0];
+
+#   pragma omp parallel for collapse(2) schedule(static)
+    for (int i = 0; i < wc.ic; ++i) {
+        for (int o = 0; o < wc.oc; ++o) {
+            float g[3][3];
+            if (wc.flip_weights) {
+                const float *w = &weights[weights_d.off(i, o, 0, 0)];
+                for (int kh = 0; kh < 3; ++kh)
+                    for (int kw = 0; kw < 3; ++kw)
+                        g[2 - kh][2 - kw] = w[kh * strides[2]
+                            + kw * strides[3]];
+            } else {
+                const float *w = &weights[weights_d.off(o, i, 0, 0)];
+                for (int kh = 0; kh < 3; ++kh)
+                    for (int kw = 0; kw < 3; ++kw)
+                        g[kh][kw] = w[kh * strides[2] + kw * strides[3]];
+            }
+
+            float t[alpha][3];
+            for (int k = 0; k < 3; ++k) {
+                t[0][k] = g[0][k];
+                t[1][k] = 0.5f * (g[0][k] + g[1][k] + g[2][k]);
+                t[2][k] = 0.5f * (g[0][k] - g[1][k] + g[2][k]);
+                t[3][k] = g[2][k];
+            }
+
+            for (int j = 0; j < alpha; ++j) {
+                float r[alpha];
+                r[0] = t[j][0];
+                r[1] = 0.5f * (t[j][0] + t[j][1] + t[j][2]);
+                r[2] = 0.5f * (t[j][0] - t[j][1] + t[j][2]);
+                r[3] = t[j][2];
+                for (int k = 0; k < alpha; ++k)
+                    u[((size_t)(j * alpha + k) * wc.ic + i) * wc.oc + o] = r[k];
+            }
+        }
+    }
+}
+
+/* V = B^T d B, stored as alpha * alpha matrices of ic x tiles */
+void winograd_f32::transform_src(const float *src,
+        const memory_desc_wrapper &src_d, int tile_start, int tiles,
+        float *v) {
+    const int nb_ic = wc.ic / simd_w;
+    const int tiles_hw = wc.tiles_h * wc.tiles_w;
+
+    for (int tl = 0; tl < tiles; ++tl) {
+        const int t = tile_start + tl;
+        const int n = t / tiles_hw;
+        const int ty = (t % tiles_hw) / wc.tiles_w;
+        const int tx = t % wc.tiles_w;
+
+        for (int icb = 0; icb < nb_ic; ++icb) {
+            float d[alpha][alpha][simd_w];
+            for (int j = 0; j < alpha; ++j) {
+                const int iy = ty * tile - wc.t_pad + j;
+                for (int k = 0; k < alpha; ++k) {
+                    const int ix = tx * tile - wc.l_pad + k;
+                    if (iy < 0 || iy >= wc.ih || ix < 0 || ix >= wc.iw) {
+                        for (int c = 0; c < simd_w; ++c) d[j][k][c] = 0;
+                        continue;
+                    }
+                    const float *s = &src[src_d.blk_off(n, icb, iy, ix)];
+                    for (int c = 0; c < simd_w; ++c) d[j][k][c] = s[c];
+                }
+            }
+
+            float t[alpha][alpha][simd_w];
+            for (int k = 0; k < alpha; ++k) {
+                for (int c = 0; c < simd_w; ++c) {
+                    t[0][k][c] = d[0][k][c] - d[2][k][c];
+                    t[1][k][c] = d[1][k][c] + d[2][k][c];
+                    t[2][k][c] = d[2][k][c] - d[1][k][c];
+                    t[3][k][c] = d[1][k][c] - d[3][k][c];
+                }
+            }
+
+            for (int j = 0; j < alpha; ++j) {
+                float *v_j = &v[((size_t)(j * alpha) * tiles + tl) * wc.ic
+                    + icb * simd_w];
+                const size_t xi_stride = (size_t)tiles * wc.ic;
+                for (int c = 0; c < simd_w; ++c) {
+                    v_j[0 * xi_stride + c] = t[j][0][c] - t[j][2][c];
+                    v_j[1 * xi_stride + c] = t[j][1][c] + t[j][2][c];
+                    v_j[2 * xi_stride + c] = t[j][2][c] - t[j][1][c];
+                    v_j[3 * xi_stride + c] = t[j][1][c] - t[j][3][c];
+                }
+            }
+        }
+    }
+}
+
+/* y = A^T m A, m is stored as alpha * alpha matrices of oc x tiles */
+void winograd_f32::transform_dst(const float *m, const float *bias,
+        float *dst, const memory_desc_wrapper &dst_d, int tile_start,
+        int tiles) {
+    const int nb_oc = wc.oc / simd_w;
+    const int tiles_hw = wc.tiles_h * wc.tiles_w;
+    const size_t xi_stride = (size_t)tiles * wc.oc;
+
+    for (int tl = 0; tl < tiles; ++tl) {
+        const int t = tile_start + tl;
+        const int n = t / tiles_hw;
+        const int ty = (t % tiles_hw) / wc.tiles_w;
+        const int tx = t % wc.tiles_w;
+
+        for (int ocb = 0; ocb < nb_oc; ++ocb) {
+            float s[tile][alpha][simd_w];
+            for (int k = 0; k < alpha; ++k) {
+                const float *m_k = &m[((size_t)k * tiles + tl) * wc.oc
+                    + ocb * simd_w];
+                for (int c = 0; c < simd_w; ++c) {
+                    const float m0 = m_k[0 * alpha * xi_stride + c];
+                    const float m1 = m_k[1 * alpha * xi_stride + c];
+                    const float m2 = m_k[2 * alpha * xi_stride + c];
+                    const float m3 = m_k[3 * alpha * xi_stride + c];
+                    s[0][k][c] = m0 + m1 + m2;
+                    s[1][k][c] = m1 - m2 - m3;
+                }
+            }
+
+            float b[simd_w];
+            for (int c = 0; c < simd_w; ++c)
+                b[c] = bias ? bias[ocb * simd_w + c] : 0;
+
+            for (int j = 0; j < tile; ++j) {
+                const int oy = ty * tile + j;
+                if (oy >= wc.oh) break;
+                for (int k = 0; k < tile; ++k) {
+                    const int ox = tx * tile + k;
+                    if (ox >= wc.ow) break;
+                    float *y = &dst[dst_d.blk_off(n, ocb, oy, ox)];
+                    for (int c = 0; c < simd_w; ++c)
+                        y[c] = b[c] + (k == 0
+                            ? s[j][0][c] + s[j][1][c] + s[j][2][c]
+                            : s[j][1][c] - s[j][2][c] - s[j][3][c]);
+                }
+            }
+        }
+    }
+}
+
+void winograd_f32::execute(const float *src,
+        const memory_desc_wrapper &src_d, const float *u, const float *bias,
+        float *dst, const memory_desc_wrapper &dst_d, char *scratchpad) {
+#   pragma omp parallel num_threads(wc.nthr)
+    {
+#if defined(_OPENMP)
+        const int ithr = omp_get_thread_num();
+#else
+        const int ithr = 0;
+#endif
+        char *ws = scratchpad + ithr * thr_ws_size(wc);
+        float *v = reinterpret_cast<float *>(ws);
+        float *m = reinterpret_cast<float *>(ws + v_size(wc));
+        char *gemm_ws = ws + v_size(wc) + m_size(wc);
+
+#       pragma omp for schedule(static)
+        for (int tb = 0; tb < wc.nb_tile_blocks; ++tb) {
+            const int tile_start = tb * wc.tile_block;
+            const int tiles = nstl::min(wc.tile_block,
+                    wc.nb_tiles - tile_start);
+
+            transform_src(src, src_d, tile_start, tiles, v);
+            for (int xi = 0; xi < alpha * alpha; ++xi) {
+                sgemm_->sgemm(wc.oc, tiles, wc.ic, 1.0,
+                        &u[(size_t)xi * wc.ic * wc.oc], wc.oc,
+                        &v[(size_t)xi * tiles * wc.ic], wc.ic,
+                        &m[(size_t)xi * tiles * wc.oc], wc.oc, gemm_ws);
+            }
+            transform_dst(m, bias, dst, dst_d, tile_start, tiles);
+        }
+    }
+}
+
+status_t winograd_convolution_fwd_t::execute_forward(char *scratchpad) {
+    auto src = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto bias = reinterpret_cast<const data_t *>(this->input_memory(2));
+    auto dst = reinterpret_cast<data_t *>(this->memory());
+
+    const memory_desc_wrapper src_d(conf_.src_pd());
+    const memory_desc_wrapper dst_d(conf_.dst_pd());
+    const memory_desc_wrapper weights_d(conf_.weights_pd(0));
+    const memory_desc_wrapper bias_d(conf_.weights_pd(1));
+
+    if (bias) bias += bias_d.blk_off(0);
+
+    const float *u;
+    if (conf_.keep_weights()) {
+        std::lock_guard<std::mutex> guard(u_mutex_);
+        if (u_ == nullptr) {
+            u_ = (float *)malloc(winograd_f32::weights_size(conf_.wc_), 64);
+            if (u_ == nullptr) return out_of_memory;
+        }
+        if (u_weights_ != weights) {
+            winograd_.transform_weights(weights, weights_d, u_);
+            u_weights_ = weights;
+        }
+        u = u_;
+    } else {
+        float *ws_u = reinterpret_cast<float *>(scratchpad
+                + winograd_f32::scratchpad_size(conf_.wc_));
+        winograd_.transform_weights(weights, weights_d, ws_u);
+        u = ws_u;
+    }
+
+    winograd_.execute(src, src_d, u, bias, dst, dst_d, scratchpad);
+    return success;
+}
+
+void winograd_convolution_bwd_data_t::execute_backward_data(
+        char *scratchpad) {
+    auto diff_dst = reinterpret_cast<const data_t *>(this->input_memory(0));
+    auto weights = reinterpret_cast<const data_t *>(this->input_memory(1));
+    auto diff_src = reinterpret_cast<data_t *>(this->memory());
+
+    const memory_desc_wrapper diff_dst_d(conf_.diff_dst_pd());
+    const memory_desc_wrapper diff_src_d(conf_.diff_src_pd());
+    const memory_desc_wrapper weights_d(conf_.weights_pd(0));
+
+    float *u = reinterpret_cast<float *>(scratchpad
+            + winograd_f32::scratchpad_size(conf_.wc_));
+    winograd_.transform_weights(weights, weights_d, u);
+    winograd_.execute(diff_dst, diff_dst_d, u, nullptr, diff_src, diff_src_d,
+            scratchpad);
+}
+
+}
+}
+}
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
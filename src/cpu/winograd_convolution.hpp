@@ -0,0 +1,266 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_WINOGRAD_CONVOLUTION_HPP
+#define CPU_WINOGRAD_CONVOLUTION_HPP
+
+#include <mutex>
+
+#include "c_types_map.hpp"
+#include "cpu_convolution_pd.hpp"
+#include "cpu_engine.hpp"
+#include "jit_avx2_gemm_f32.hpp"
+#include "memory_desc_wrapper.hpp"
+
+namespace mkldnn {
+namespace impl {
+namespace cpu {
+
+struct winograd_conf_t {
+    int mb, ic, oc;
+    int ih, iw, oh, ow;
+    int t_pad, l_pad;
+    bool flip_weights; /* weights are oc x ic of the direct convolution */
+    int tiles_h, tiles_w, nb_tiles;
+    int tile_block, nb_tile_blocks;
+    int nthr;
+};
+
+/** winograd F(2x2, 3x3) convolution with stride 1 on nChw8c
+ *
+ * the input is split into 4x4 tiles overlapping by 2, each one giving a 2x2
+ * tile of the output. the transformed tiles are multiplied by the transformed
+ * filters as 16 independent gemms (one per element of a tile) over the
+ * channels, and the products are transformed back. the tiles are processed
+ * by blocks small enough for the transforms to stay in cache, a block per
+ * thread.
+ *
+ * the gemms are the jit sgemm, while the transforms are plain C++ loops over
+ * the 8 channels of a block, not jit code */
+struct winograd_f32 {
+    enum { alpha = 4, tile = 2, simd_w = 8 };
+
+    /** @p ic and @p oc are the input and output channels of the convolution
+     * the transform computes, i.e. they are swapped for backward data */
+    static status_t init_conf(winograd_conf_t &wc, int mb, int ic, int oc,
+            int ih, int iw, int oh, int ow, int t_pad, int l_pad,
+            bool flip_weights);
+    /** the size of the transformed weights */
+    static size_t weights_size(const winograd_conf_t &wc);
+    /** the size of the per thread buffers, the transformed weights are not
+     * included */
+    static size_t scratchpad_size(const winograd_conf_t &wc);
+
+    winograd_f32(const winograd_conf_t &wc)
+        : wc(wc), sgemm_(new jit_avx2_gemm_f32(false, false, 0.0)) {}
+    ~winograd_f32() { delete sgemm_; }
+
+    /** transforms @p weights to @p u of weights_size() bytes */
+    void transform_weights(const float *weights,
+            const memory_desc_wrapper &weights_d, float *u);
+    /** convolves @p src with the transformed weights @p u */
+    void execute(const float *src, const memory_desc_wrapper &src_d,
+            const float *u, const float *bias, float *dst,
+            const memory_desc_wrapper &dst_d, char *scratchpad);
+
+    const winograd_conf_t wc;
+
+private:
+    void transform_src(const float *src, const memory_desc_wrapper &src_d,
+            int tile_start, int tiles, float *v);
+    void transform_dst(const float *m, const float *bias, float *dst,
+            const memory_desc_wrapper &dst_d, int tile_start, int tiles);
+
+    jit_avx2_gemm_f32 *sgemm_;
+};
+
+struct winograd_convolution_fwd_t: public cpu_primitive_t {
+    struct pd_t: public cpu_convolution_fwd_pd_t {
+        pd_t(engine_t *engine, const convolution_desc_t *adesc,
+                const convolution_fwd_pd_t *hint_fwd_pd)
+            : cpu_convolution_fwd_pd_t(engine, adesc, hint_fwd_pd)
+            , wc_({}) {}
+
+        DECLARE_COMMON_PD_T(winograd_convolution_fwd_t);
+
+        virtual status_t init() override {
+            using namespace prop_kind;
+            using namespace memory_format;
+            assert(this->engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && mayiuse(avx2)
+                && this->set_default_params() == status::success
+                && utils::one_of(this->cdesc_().prop_kind, forward_training,
+                        forward_inference)
+                && this->cdesc_().alg_kind == alg_kind::convolution_winograd
+                && utils::everyone_is(data_type::f32,
+                        this->cdesc_().src_desc.data_type,
+                        this->cdesc_().weights_desc.data_type,
+                        this->cdesc_().dst_desc.data_type)
+                && utils::implication(this->with_bias(),
+                        data_type::f32 == this->cdesc_().bias_desc.data_type)
+                && !this->with_groups()
+                && this->KH() == 3 && this->KW() == 3
+                && this->KSH() == 1 && this->KSW() == 1
+                && this->src_pd_.desc()->format == nChw8c
+                && this->dst_pd_.desc()->format == nChw8c;
+            if (!ok) return status::unimplemented;
+
+            return winograd_f32::init_conf(wc_, this->MB(), this->IC(),
+                    this->OC(), this->IH(), this->IW(), this->OH(),
+                    this->OW(), this->padT(), this->padL(), false);
+        }
+
+        /** the transformed weights of inference are kept by the primitive,
+         * otherwise they go to the scratchpad */
+        virtual size_t scratchpad_size() const override {
+            return winograd_f32::scratchpad_size(wc_)
+                + (keep_weights() ? 0 : winograd_f32::weights_size(wc_));
+        }
+
+        bool keep_weights() const
+        { return this->cdesc_().prop_kind == prop_kind::forward_inference; }
+
+        winograd_conf_t wc_;
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (this->src_pd_.desc()->format == any)
+                CHECK(this->src_pd_.set_format(nChw8c));
+            if (this->dst_pd_.desc()->format == any)
+                CHECK(this->dst_pd_.set_format(nChw8c));
+            if (this->weights_pd_.desc()->format == any)
+                CHECK(this->weights_pd_.set_format(OIhw8i8o));
+            if (this->bias_pd_.desc()->format == any)
+                CHECK(this->bias_pd_.set_format(x));
+            return status::success;
+        }
+    };
+
+    winograd_convolution_fwd_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+        , winograd_(conf_.wc_), u_(nullptr), u_weights_(nullptr) {}
+    ~winograd_convolution_fwd_t() { free(u_); }
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        status_t status = execute_forward(scratchpad);
+        e->set_state(status == status::success
+                ? event_t::ready : event_t::error);
+    }
+
+private:
+    status_t execute_forward(char *scratchpad);
+    pd_t conf_;
+    winograd_f32 winograd_;
+
+    /* inference takes the weights as constant while their handle stays the
+     * same, hence they are transformed once per handle */
+    float *u_;
+    const data_t *u_weights_;
+    std::mutex u_mutex_;
+};
+
+struct winograd_convolution_bwd_data_t: public cpu_primitive_t {
+    struct pd_t: public cpu_convolution_bwd_data_pd_t {
+        pd_t(engine_t *engine, const convolution_desc_t *adesc,
+                const convolution_fwd_pd_t *hint_fwd_pd)
+            : cpu_convolution_bwd_data_pd_t(engine, adesc, hint_fwd_pd)
+            , wc_({}) {}
+
+        DECLARE_COMMON_PD_T(winograd_convolution_bwd_data_t);
+
+        virtual status_t init() override {
+            using namespace prop_kind;
+            using namespace memory_format;
+            assert(this->engine()->kind() == engine_kind::cpu);
+            bool ok = true
+                && mayiuse(avx2)
+                && this->set_default_params() == status::success
+                && this->desc()->prop_kind == backward_data
+                && this->desc()->alg_kind == alg_kind::convolution_winograd
+                && utils::everyone_is(data_type::f32,
+                        this->desc()->diff_src_desc.data_type,
+                        this->desc()->weights_desc.data_type,
+                        this->desc()->diff_dst_desc.data_type)
+                && !this->with_groups()
+                && this->KH() == 3 && this->KW() == 3
+                && this->KSH() == 1 && this->KSW() == 1
+                && this->diff_src_pd_.desc()->format == nChw8c
+                && this->diff_dst_pd_.desc()->format == nChw8c;
+            if (!ok) return status::unimplemented;
+
+            /* the gradient is the convolution of diff_dst with the rotated
+             * filters, padded by kh - 1 - pad */
+            return winograd_f32::init_conf(wc_, this->MB(), this->OC(),
+                    this->IC(), this->OH(), this->OW(), this->IH(),
+                    this->IW(), 2 - this->padT(), 2 - this->padL(), true);
+        }
+
+        virtual size_t scratchpad_size() const override {
+            return winograd_f32::scratchpad_size(wc_)
+                + winograd_f32::weights_size(wc_);
+        }
+
+        winograd_conf_t wc_;
+
+    protected:
+        virtual status_t set_default_params() override {
+            using namespace memory_format;
+            if (this->diff_src_pd_.desc()->format == any)
+                CHECK(this->diff_src_pd_.set_format(nChw8c));
+            if (this->diff_dst_pd_.desc()->format == any)
+                CHECK(this->diff_dst_pd_.set_format(nChw8c));
+            if (this->weights_pd_.desc()->format == any)
+                CHECK(this->weights_pd_.set_format(OIhw8o8i));
+            return status::success;
+        }
+    };
+
+    winograd_convolution_bwd_data_t(const pd_t *pd,
+            const input_vector &inputs, const output_vector &outputs)
+        : cpu_primitive_t(&conf_, inputs, outputs), conf_(*pd)
+        , winograd_(conf_.wc_) {}
+    typedef typename prec_trait<data_type::f32>::type data_t;
+
+    virtual void execute(event_t *e) { execute_with_own_scratchpad(e); }
+    virtual void execute(event_t *e, char *scratchpad) {
+        switch (conf_.desc()->prop_kind) {
+        case prop_kind::backward_data:
+            execute_backward_data(scratchpad);
+            break;
+        default:
+            assert(!"invalid prop_kind");
+        }
+        e->set_state(event_t::ready);
+    }
+
+private:
+    void execute_backward_data(char *scratchpad);
+    pd_t conf_;
+    winograd_f32 winograd_;
+};
+
+}
+}
+}
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
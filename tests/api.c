@@ -1,7 +1,14 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 #include "mkldnn.h"
 
@@ -178,6 +185,11 @@ void test2() {
                 mkldnn_primitive_desc_query_pd(
                     c3_pd, mkldnn_query_dst_pd, 0), c3_dst_pd));
 
+    ptrdiff_t c3_scratchpad_size = -1;
+    CHECK(mkldnn_primitive_desc_query(c3_pd,
+                mkldnn_query_memory_consumption_s64, 0, &c3_scratchpad_size));
+    CHECK_TRUE(c3_scratchpad_size >= 0);
+
     CHECK(mkldnn_primitive_desc_destroy(c3_src_pd));
     CHECK(mkldnn_primitive_desc_destroy(c3_weights_pd));
     CHECK(mkldnn_primitive_desc_destroy(c3_bias_pd));
@@ -279,7 +291,7 @@ void test3() {
 
     CHECK(mkldnn_lrn_forward_desc_init(&l2_desc,
                 mkldnn_forward_inference, mkldnn_lrn_across_channels,
-                &l2_data_md, 5, 1e-4, 0.75));
+                &l2_data_md, 5, 1e-4, 0.75, 1.0));
     CHECK(mkldnn_primitive_desc_create(&l2_pd, &l2_desc, engine, NULL));
     CHECK(mkldnn_primitive_create(&l2, l2_pd, l2_srcs, l2_dsts));
 
@@ -342,9 +354,1205 @@ void test3() {
     free(out_mem);
 }
 
+/* makes the memory the heap hands out next hold garbage depending on
+ * @p seed, so that the uninitialized bytes differ between allocations;
+ * a negative seed turns this off */
+static void dirty_heap(int seed) {
+#ifdef __GLIBC__
+    mallopt(M_PERTURB, seed < 0 ? 0 : 0x11 + seed);
+#else
+    for (size_t sz = 64; seed >= 0 && sz <= 64 * 1024; sz *= 2) {
+        char *p = (char *)malloc(sz);
+        if (p == NULL) continue;
+        memset(p, 0x11 + seed, sz);
+        free(p);
+    }
+#endif
+}
+
+void test4() {
+    /* primitives with the same configuration share the jit kernels, also
+     * when the configurations are built from scratch in dirty memory */
+    int src_sizes[4] = {2, 16, 7, 7};
+    int weights_sizes[4] = {32, 16, 3, 3};
+    int dst_sizes[4] = {2, 32, 7, 7};
+    int strides[] = {1, 1};
+    int32_t padding[] = {1, 1};
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+    CHECK(mkldnn_engine_set_primitive_desc_cache_capacity(engine, 0));
+
+    mkldnn_memory_desc_t src_md, weights_md, dst_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&weights_md, 4, weights_sizes, mkldnn_f32,
+                mkldnn_OIhw8i8o));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+
+    mkldnn_primitive_desc_t src_pd, weights_pd, dst_pd;
+    mkldnn_primitive_t src, weights, dst;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_primitive_create(&src, src_pd, NULL, NULL));
+    CHECK(mkldnn_memory_primitive_desc_create(&weights_pd, &weights_md,
+                engine));
+    CHECK(mkldnn_primitive_create(&weights, weights_pd, NULL, NULL));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+    CHECK(mkldnn_primitive_create(&dst, dst_pd, NULL, NULL));
+
+    mkldnn_primitive_at_t c_srcs[] = {
+        mkldnn_primitive_at(src, 0),
+        mkldnn_primitive_at(weights, 0)
+    };
+    const_mkldnn_primitive_t c_dsts[1] = {dst};
+
+    mkldnn_convolution_desc_t c_desc;
+    CHECK(mkldnn_convolution_forward_desc_init(&c_desc,
+                mkldnn_forward_inference, mkldnn_convolution_direct,
+                &src_md, &weights_md, NULL, &dst_md,
+                strides, padding, NULL, mkldnn_padding_zero));
+
+    /* pool: dst -> p_dst */
+    int p_kernel[] = {3, 3};
+    mkldnn_primitive_desc_t p_dst_pd;
+    mkldnn_primitive_t p_dst;
+    CHECK(mkldnn_memory_primitive_desc_create(&p_dst_pd, &dst_md, engine));
+    CHECK(mkldnn_primitive_create(&p_dst, p_dst_pd, NULL, NULL));
+    mkldnn_primitive_at_t p_srcs[] = { mkldnn_primitive_at(dst, 0) };
+    const_mkldnn_primitive_t p_dsts[1] = {p_dst};
+
+    mkldnn_pooling_desc_t p_desc;
+    CHECK(mkldnn_pooling_forward_desc_init(&p_desc, mkldnn_forward_inference,
+                mkldnn_pooling_max, &dst_md, &dst_md, strides, p_kernel,
+                padding, padding, mkldnn_padding_zero));
+
+    size_t hits[3], misses[3];
+    mkldnn_primitive_t c[2], p[2];
+    CHECK(mkldnn_jit_kernel_cache_get_stats(&hits[0], &misses[0]));
+    for (int i = 0; i < 2; ++i) {
+        mkldnn_primitive_desc_t c_pd, p_pd;
+        dirty_heap(i);
+        CHECK(mkldnn_primitive_desc_create(&c_pd, &c_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&c[i], c_pd, c_srcs, c_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd));
+        CHECK(mkldnn_primitive_desc_create(&p_pd, &p_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&p[i], p_pd, p_srcs, p_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(p_pd));
+        dirty_heap(-1);
+        CHECK(mkldnn_jit_kernel_cache_get_stats(&hits[i + 1],
+                    &misses[i + 1]));
+    }
+
+    /* the first primitives may or may not generate kernels (depending on
+     * whether previous tests have already produced them), while the second
+     * ones must reuse them */
+    CHECK_TRUE(hits[1] + misses[1] == hits[0] + misses[0] + 2);
+    CHECK_TRUE(hits[2] == hits[1] + 2);
+    CHECK_TRUE(misses[2] == misses[1]);
+
+    CHECK_TRUE(mkldnn_jit_kernel_cache_get_stats(NULL, &misses[0])
+            == mkldnn_invalid_arguments);
+
+    CHECK(mkldnn_primitive_destroy(c[0]));
+    CHECK(mkldnn_primitive_destroy(c[1]));
+    CHECK(mkldnn_primitive_destroy(p[0]));
+    CHECK(mkldnn_primitive_destroy(p[1]));
+    CHECK(mkldnn_primitive_desc_destroy(p_dst_pd));
+    CHECK(mkldnn_primitive_destroy(p_dst));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(weights_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_primitive_destroy(src));
+    CHECK(mkldnn_primitive_destroy(weights));
+    CHECK(mkldnn_primitive_destroy(dst));
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test5() {
+    /* the engine caches primitive descriptors, also when the descriptors
+     * are built from scratch in dirty memory */
+    int data_sizes[4] = {2, 16, 7, 7};
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    size_t hits[4], misses[4];
+    CHECK(mkldnn_engine_get_primitive_desc_cache_stats(engine, &hits[0],
+                &misses[0]));
+    CHECK_TRUE(hits[0] == 0 && misses[0] == 0);
+
+    for (int i = 0; i < 3; ++i) {
+        if (i == 2)
+            CHECK(mkldnn_engine_set_primitive_desc_cache_capacity(engine, 0));
+
+        dirty_heap(i);
+        mkldnn_memory_desc_t *data_md
+            = (mkldnn_memory_desc_t *)malloc(sizeof(*data_md));
+        mkldnn_relu_desc_t *r_desc
+            = (mkldnn_relu_desc_t *)malloc(sizeof(*r_desc));
+        dirty_heap(-1);
+        CHECK_TRUE(data_md && r_desc);
+        CHECK(mkldnn_memory_desc_init(data_md, 4, data_sizes, mkldnn_f32,
+                    mkldnn_nchw));
+        CHECK(mkldnn_relu_forward_desc_init(r_desc, mkldnn_forward_inference,
+                    data_md, 0.));
+
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_primitive_desc_create(&r_pd, r_desc, engine, NULL));
+        free(data_md);
+        free(r_desc);
+        CHECK_TRUE(mkldnn_memory_primitive_desc_equal(
+                    mkldnn_primitive_desc_query_pd(r_pd,
+                        mkldnn_query_src_pd, 0),
+                    mkldnn_primitive_desc_query_pd(r_pd,
+                        mkldnn_query_dst_pd, 0)));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+        CHECK(mkldnn_engine_get_primitive_desc_cache_stats(engine,
+                    &hits[i + 1], &misses[i + 1]));
+    }
+
+    /* miss, hit, and a miss once the cache is disabled */
+    CHECK_TRUE(hits[1] == 0 && misses[1] == 1);
+    CHECK_TRUE(hits[2] == 1 && misses[2] == 1);
+    CHECK_TRUE(hits[3] == 1 && misses[3] == 2);
+
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test6(mkldnn_prop_kind_t conv_kind) {
+    /* a lazy stream fuses conv + relu and removes the redundant reorders,
+     * while the final result stays the same. A training conv is not fused,
+     * as its result must stay available to the backward pass */
+    int src_sizes[4] = {2, 16, 7, 7};
+    int weights_sizes[4] = {32, 16, 3, 3};
+    int bias_sizes[1] = {32};
+    int dst_sizes[4] = {2, 32, 7, 7};
+    int strides[] = {1, 1};
+    int32_t padding[] = {1, 1};
+
+    real_t *src = (real_t*)calloc(product(src_sizes, 4), sizeof(real_t));
+    real_t *weights = (real_t*)calloc(product(weights_sizes, 4), sizeof(real_t));
+    real_t *bias = (real_t*)calloc(product(bias_sizes, 1), sizeof(real_t));
+    real_t *c_dst = (real_t*)calloc(product(dst_sizes, 4), sizeof(real_t));
+    real_t *r_dst = (real_t*)calloc(product(dst_sizes, 4), sizeof(real_t));
+    real_t *out0 = (real_t*)calloc(product(dst_sizes, 4), sizeof(real_t));
+    real_t *tmp = (real_t*)calloc(product(dst_sizes, 4), sizeof(real_t));
+    real_t *out1 = (real_t*)calloc(product(dst_sizes, 4), sizeof(real_t));
+    CHECK_TRUE(src && weights && bias && c_dst && r_dst && out0 && tmp && out1);
+
+    for (int i = 0; i < bias_sizes[0]; ++i) bias[i] = i - 16;
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, weights_md, bias_md, dst_md, out_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&weights_md, 4, weights_sizes, mkldnn_f32,
+                mkldnn_OIhw8i8o));
+    CHECK(mkldnn_memory_desc_init(&bias_md, 1, bias_sizes, mkldnn_f32,
+                mkldnn_x));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&out_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nchw));
+
+    mkldnn_primitive_desc_t src_pd, weights_pd, bias_pd, dst_pd, out_pd;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&weights_pd, &weights_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&bias_pd, &bias_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&out_pd, &out_md, engine));
+
+    mkldnn_primitive_t m[8];
+    mkldnn_primitive_desc_t m_pds[8] = {src_pd, weights_pd, bias_pd, dst_pd,
+        dst_pd, out_pd, dst_pd, out_pd};
+    real_t *m_data[8] = {src, weights, bias, c_dst, r_dst, out0, tmp, out1};
+    for (int i = 0; i < 8; ++i) {
+        CHECK(mkldnn_primitive_create(&m[i], m_pds[i], NULL, NULL));
+        CHECK(mkldnn_memory_set_data_handle(m[i], m_data[i]));
+    }
+
+    /* conv: m[0], m[1], m[2] -> m[3] */
+    mkldnn_primitive_t net[5];
+    {
+        mkldnn_primitive_at_t c_srcs[] = { mkldnn_primitive_at(m[0], 0),
+            mkldnn_primitive_at(m[1], 0), mkldnn_primitive_at(m[2], 0) };
+        const_mkldnn_primitive_t c_dsts[] = {m[3]};
+        mkldnn_convolution_desc_t c_desc;
+        mkldnn_primitive_desc_t c_pd;
+        CHECK(mkldnn_convolution_forward_desc_init(&c_desc,
+                    conv_kind, mkldnn_convolution_direct,
+                    &src_md, &weights_md, &bias_md, &dst_md,
+                    strides, padding, NULL, mkldnn_padding_zero));
+        CHECK(mkldnn_primitive_desc_create(&c_pd, &c_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&net[0], c_pd, c_srcs, c_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd));
+    }
+
+    /* relu: m[3] -> m[4] */
+    {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[3], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[4]};
+        mkldnn_relu_desc_t r_desc;
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_relu_forward_desc_init(&r_desc, mkldnn_forward_inference,
+                    &dst_md, 0.));
+        CHECK(mkldnn_primitive_desc_create(&r_pd, &r_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&net[1], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+
+    /* reorders: m[4] -> m[5] -> m[6] -> m[7] */
+    for (int i = 0; i < 3; ++i) {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[4 + i], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[5 + i]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, m_pds[4 + i],
+                    m_pds[5 + i]));
+        CHECK(mkldnn_primitive_create(&net[2 + i], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+
+    mkldnn_stream_t stream;
+    CHECK(mkldnn_stream_create(&stream, mkldnn_lazy));
+    CHECK(mkldnn_stream_submit(stream, 5, net, NULL));
+    for (int run = 0; run < 2; ++run) {
+        if (run > 0) {
+            memset(out1, 0, product(dst_sizes, 4) * sizeof(real_t));
+            CHECK(mkldnn_stream_rerun(stream, NULL));
+        }
+        CHECK(mkldnn_stream_wait(stream, 1, NULL));
+
+        const int N = dst_sizes[0], C = dst_sizes[1],
+              H = dst_sizes[2], W = dst_sizes[3];
+        for (int n = 0; n < N; ++n)
+        for (int c = 0; c < C; ++c)
+        for (int h = 0; h < H; ++h)
+        for (int w = 0; w < W; ++w)
+        {
+            size_t off = ((n*C + c)*H + h)*W + w;
+            CHECK_TRUE(out1[off] == (bias[c] > 0 ? bias[c] : 0));
+            if (conv_kind == mkldnn_forward_training) {
+                /* c_dst is nChw8c */
+                off = (((n*C/8 + c/8)*H + h)*W + w)*8 + c%8;
+                CHECK_TRUE(c_dst[off] == bias[c]);
+            }
+        }
+    }
+
+    CHECK(mkldnn_stream_destroy(stream));
+    for (int i = 0; i < 5; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 8; ++i)
+        CHECK(mkldnn_primitive_destroy(m[i]));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(weights_pd));
+    CHECK(mkldnn_primitive_desc_destroy(bias_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_primitive_desc_destroy(out_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+
+    free(src);
+    free(weights);
+    free(bias);
+    free(c_dst);
+    free(r_dst);
+    free(out0);
+    free(tmp);
+    free(out1);
+}
+
+void test7() {
+    /* two independent branches feeding a concat, executed by both eager
+     * (branches may run concurrently) and lazy (concat may be done in-place)
+     * streams, which are polled for completion. The nesting of OpenMP the
+     * concurrent branches need does not leak to the user */
+    int src_sizes[4] = {1, 8, 4, 4};
+    int dst_sizes[4] = {1, 16, 4, 4};
+    const size_t src_size = product(src_sizes, 4);
+    const size_t dst_size = product(dst_sizes, 4);
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, src_blk_md, dst_blk_md, dst_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&src_blk_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&dst_blk_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nchw));
+
+    mkldnn_primitive_desc_t src_pd, src_blk_pd, dst_blk_pd, dst_pd;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&src_blk_pd, &src_blk_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_blk_pd, &dst_blk_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+
+    /* m[0] -> m[2], m[1] -> m[3], concat(m[2], m[3]) -> m[4] -> m[5] */
+    real_t *data[6];
+    mkldnn_primitive_t m[6];
+    mkldnn_primitive_desc_t m_pds[6] = {src_pd, src_pd, src_blk_pd,
+        src_blk_pd, dst_blk_pd, dst_pd};
+    for (int i = 0; i < 6; ++i) {
+        data[i] = (real_t*)calloc(i < 4 ? src_size : dst_size,
+                sizeof(real_t));
+        CHECK_TRUE(data[i] != NULL);
+        CHECK(mkldnn_primitive_create(&m[i], m_pds[i], NULL, NULL));
+        CHECK(mkldnn_memory_set_data_handle(m[i], data[i]));
+    }
+    for (size_t i = 0; i < src_size; ++i) {
+        data[0][i] = i;
+        data[1][i] = 1000 + i;
+    }
+
+    mkldnn_primitive_t net[4];
+    for (int i = 0; i < 2; ++i) {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[i], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[2 + i]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, src_pd,
+                    src_blk_pd));
+        CHECK(mkldnn_primitive_create(&net[i], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+    {
+        mkldnn_primitive_at_t c_srcs[] = { mkldnn_primitive_at(m[2], 0),
+            mkldnn_primitive_at(m[3], 0) };
+        const_mkldnn_primitive_t c_dsts[] = {m[4]};
+        const_mkldnn_primitive_desc_t c_src_pds[] = {src_blk_pd, src_blk_pd};
+        mkldnn_primitive_desc_t c_pd;
+        CHECK(mkldnn_concat_primitive_desc_create(&c_pd, &dst_blk_md, 2, 1,
+                    c_src_pds));
+        CHECK(mkldnn_primitive_create(&net[2], c_pd, c_srcs, c_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd));
+    }
+    {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[4], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[5]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, dst_blk_pd,
+                    dst_pd));
+        CHECK(mkldnn_primitive_create(&net[3], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+
+#if defined(_OPENMP)
+    omp_set_max_active_levels(1);
+#endif
+    mkldnn_stream_kind_t kinds[2] = {mkldnn_eager, mkldnn_lazy};
+    for (int k = 0; k < 2; ++k) {
+        memset(data[5], 0, dst_size * sizeof(real_t));
+
+        mkldnn_stream_t stream;
+        CHECK(mkldnn_stream_create(&stream, kinds[k]));
+        CHECK(mkldnn_stream_submit(stream, 4, net, NULL));
+        if (kinds[k] == mkldnn_eager) {
+            /* computations go on in the background */
+            mkldnn_status_t s;
+            while ((s = mkldnn_stream_query(stream, NULL)) == mkldnn_try_again);
+            CHECK(s);
+            CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        } else {
+            /* a lazy stream does nothing until it is waited for */
+            CHECK_TRUE(mkldnn_stream_query(stream, NULL) == mkldnn_try_again);
+            mkldnn_status_t s;
+            while ((s = mkldnn_stream_wait(stream, 0, NULL))
+                    == mkldnn_try_again);
+            CHECK(s);
+        }
+        CHECK(mkldnn_stream_destroy(stream));
+#if defined(_OPENMP)
+        CHECK_TRUE(omp_get_max_active_levels() == 1);
+#endif
+
+        const int C = dst_sizes[1], HW = dst_sizes[2] * dst_sizes[3];
+        for (int c = 0; c < C; ++c)
+        for (int hw = 0; hw < HW; ++hw) {
+            real_t e = c < C / 2 ? c * HW + hw : 1000 + (c - C / 2) * HW + hw;
+            CHECK_TRUE(data[5][c * HW + hw] == e);
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 6; ++i) {
+        CHECK(mkldnn_primitive_destroy(m[i]));
+        free(data[i]);
+    }
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(src_blk_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_blk_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test8() {
+    /* intermediate memories get their data from a planned slab: relu works
+     * in-place, concat inputs live in the concat output */
+    int src_sizes[4] = {1, 8, 4, 4};
+    int dst_sizes[4] = {1, 16, 4, 4};
+    const size_t src_size = product(src_sizes, 4);
+    const size_t dst_size = product(dst_sizes, 4);
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, src_blk_md, dst_blk_md, dst_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&src_blk_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&dst_blk_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nchw));
+
+    mkldnn_primitive_desc_t src_pd, src_blk_pd, dst_blk_pd, dst_pd;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&src_blk_pd, &src_blk_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_blk_pd, &dst_blk_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+
+    /* m[0] -> m[1] -> relu -> m[2] -> m[3], m[0] -> m[4],
+     * concat(m[3], m[4]) -> m[5] -> m[6]; m[0] and m[6] are user's */
+    real_t *src = (real_t*)calloc(src_size, sizeof(real_t));
+    real_t *dst = (real_t*)calloc(dst_size, sizeof(real_t));
+    CHECK_TRUE(src != NULL && dst != NULL);
+    for (size_t i = 0; i < src_size; ++i)
+        src[i] = i % 2 ? (real_t)i : -(real_t)i;
+
+    mkldnn_primitive_t m[7];
+    mkldnn_primitive_desc_t m_pds[7] = {src_pd, src_blk_pd, src_blk_pd,
+        src_blk_pd, src_blk_pd, dst_blk_pd, dst_pd};
+    for (int i = 0; i < 7; ++i)
+        CHECK(mkldnn_primitive_create(&m[i], m_pds[i], NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m[0], src));
+    CHECK(mkldnn_memory_set_data_handle(m[6], dst));
+
+    mkldnn_primitive_t net[6];
+    int r_ios[4][3] = {{0, 1, 0}, {2, 3, 2}, {0, 4, 3}, {5, 6, 5}};
+    for (int i = 0; i < 4; ++i) {
+        const int in = r_ios[i][0], out = r_ios[i][1];
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[in], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[out]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, m_pds[in],
+                    m_pds[out]));
+        CHECK(mkldnn_primitive_create(&net[r_ios[i][2]], r_pd, r_srcs,
+                    r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+    {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[1], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[2]};
+        mkldnn_relu_desc_t r_desc;
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_relu_forward_desc_init(&r_desc, mkldnn_forward_inference,
+                    &src_blk_md, 0.));
+        CHECK(mkldnn_primitive_desc_create(&r_pd, &r_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&net[1], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+    {
+        mkldnn_primitive_at_t c_srcs[] = { mkldnn_primitive_at(m[3], 0),
+            mkldnn_primitive_at(m[4], 0) };
+        const_mkldnn_primitive_t c_dsts[] = {m[5]};
+        const_mkldnn_primitive_desc_t c_src_pds[] = {src_blk_pd, src_blk_pd};
+        mkldnn_primitive_desc_t c_pd;
+        CHECK(mkldnn_concat_primitive_desc_create(&c_pd, &dst_blk_md, 2, 1,
+                    c_src_pds));
+        CHECK(mkldnn_primitive_create(&net[4], c_pd, c_srcs, c_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd));
+    }
+
+    /* {m[1], m[2]} and {m[3], m[4], m[5]} are alive at the same time */
+    size_t slab_size;
+    CHECK(mkldnn_memory_plan(6, net, NULL, &slab_size));
+    CHECK_TRUE(slab_size == (src_size + dst_size) * sizeof(real_t));
+    char *slab = (char*)malloc(slab_size);
+    CHECK_TRUE(slab != NULL);
+    CHECK(mkldnn_memory_plan(6, net, slab, &slab_size));
+
+    void *m1_data, *m2_data, *m3_data, *m5_data;
+    CHECK(mkldnn_memory_get_data_handle(m[1], &m1_data));
+    CHECK(mkldnn_memory_get_data_handle(m[2], &m2_data));
+    CHECK(mkldnn_memory_get_data_handle(m[3], &m3_data));
+    CHECK(mkldnn_memory_get_data_handle(m[5], &m5_data));
+    CHECK_TRUE(m1_data == m2_data && m3_data == m5_data);
+
+    mkldnn_stream_kind_t kinds[2] = {mkldnn_eager, mkldnn_lazy};
+    for (int k = 0; k < 2; ++k) {
+        memset(dst, 0, dst_size * sizeof(real_t));
+
+        mkldnn_stream_t stream;
+        CHECK(mkldnn_stream_create(&stream, kinds[k]));
+        CHECK(mkldnn_stream_submit(stream, 6, net, NULL));
+        CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        CHECK(mkldnn_stream_destroy(stream));
+
+        const int C = dst_sizes[1], HW = dst_sizes[2] * dst_sizes[3];
+        for (int c = 0; c < C; ++c)
+        for (int hw = 0; hw < HW; ++hw) {
+            real_t s = src[(c % (C / 2)) * HW + hw];
+            real_t e = c < C / 2 && s < 0 ? 0 : s;
+            CHECK_TRUE(dst[c * HW + hw] == e);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 7; ++i)
+        CHECK(mkldnn_primitive_destroy(m[i]));
+    free(slab);
+    free(src);
+    free(dst);
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(src_blk_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_blk_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test9() {
+    /* a lazy stream runs global average pooling -> reorder -> inner product
+     * as one primitive, leaving the intermediate memories untouched */
+    int src_sizes[4] = {2, 16, 7, 7};
+    int pool_sizes[4] = {2, 16, 1, 1};
+    int weights_sizes[4] = {10, 16, 1, 1};
+    int bias_sizes[1] = {10};
+    int dst_sizes[2] = {2, 10};
+    int kernel[] = {7, 7};
+    int strides[] = {1, 1};
+    int32_t padding[] = {0, 0};
+    const int N = src_sizes[0], C = src_sizes[1], OC = dst_sizes[1],
+          HW = src_sizes[2] * src_sizes[3];
+
+    real_t *src = (real_t*)calloc(product(src_sizes, 4), sizeof(real_t));
+    real_t *pool_blk = (real_t*)calloc(product(pool_sizes, 4), sizeof(real_t));
+    real_t *pool = (real_t*)calloc(product(pool_sizes, 4), sizeof(real_t));
+    real_t *weights = (real_t*)calloc(product(weights_sizes, 4),
+            sizeof(real_t));
+    real_t *bias = (real_t*)calloc(product(bias_sizes, 1), sizeof(real_t));
+    real_t *dst = (real_t*)calloc(product(dst_sizes, 2), sizeof(real_t));
+    CHECK_TRUE(src && pool_blk && pool && weights && bias && dst);
+
+    for (size_t i = 0; i < product(src_sizes, 4); ++i)
+        src[i] = (real_t)(i % 13);
+    for (int i = 0; i < OC * C; ++i)
+        weights[i] = (real_t)(i % 5) - 2;
+    for (int i = 0; i < OC; ++i)
+        bias[i] = (real_t)i;
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, pool_blk_md, pool_md, weights_md, bias_md,
+                         dst_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&pool_blk_md, 4, pool_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&pool_md, 4, pool_sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&weights_md, 4, weights_sizes, mkldnn_f32,
+                mkldnn_oihw));
+    CHECK(mkldnn_memory_desc_init(&bias_md, 1, bias_sizes, mkldnn_f32,
+                mkldnn_x));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 2, dst_sizes, mkldnn_f32,
+                mkldnn_nc));
+
+    mkldnn_primitive_desc_t m_pds[6];
+    mkldnn_memory_desc_t *m_mds[6] = {&src_md, &pool_blk_md, &pool_md,
+        &weights_md, &bias_md, &dst_md};
+    real_t *m_data[6] = {src, pool_blk, pool, weights, bias, dst};
+    mkldnn_primitive_t m[6];
+    for (int i = 0; i < 6; ++i) {
+        CHECK(mkldnn_memory_primitive_desc_create(&m_pds[i], m_mds[i],
+                    engine));
+        CHECK(mkldnn_primitive_create(&m[i], m_pds[i], NULL, NULL));
+        CHECK(mkldnn_memory_set_data_handle(m[i], m_data[i]));
+    }
+
+    /* pool: m[0] -> m[1]; reorder: m[1] -> m[2]; ip: m[2], m[3], m[4] ->
+     * m[5] */
+    mkldnn_primitive_t net[3];
+    {
+        mkldnn_primitive_at_t p_srcs[] = { mkldnn_primitive_at(m[0], 0) };
+        const_mkldnn_primitive_t p_dsts[] = {m[1]};
+        mkldnn_pooling_desc_t p_desc;
+        mkldnn_primitive_desc_t p_pd;
+        CHECK(mkldnn_pooling_forward_desc_init(&p_desc,
+                    mkldnn_forward_inference, mkldnn_pooling_avg, &src_md,
+                    &pool_blk_md, strides, kernel, padding, padding,
+                    mkldnn_padding_zero));
+        CHECK(mkldnn_primitive_desc_create(&p_pd, &p_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&net[0], p_pd, p_srcs, p_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(p_pd));
+    }
+    {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[1], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[2]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, m_pds[1],
+                    m_pds[2]));
+        CHECK(mkldnn_primitive_create(&net[1], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+    {
+        mkldnn_primitive_at_t ip_srcs[] = { mkldnn_primitive_at(m[2], 0),
+            mkldnn_primitive_at(m[3], 0), mkldnn_primitive_at(m[4], 0) };
+        const_mkldnn_primitive_t ip_dsts[] = {m[5]};
+        mkldnn_inner_product_desc_t ip_desc;
+        mkldnn_primitive_desc_t ip_pd;
+        CHECK(mkldnn_inner_product_forward_desc_init(&ip_desc,
+                    mkldnn_forward_inference, &pool_md, &weights_md,
+                    &bias_md, &dst_md));
+        CHECK(mkldnn_primitive_desc_create(&ip_pd, &ip_desc, engine, NULL));
+        CHECK(mkldnn_primitive_create(&net[2], ip_pd, ip_srcs, ip_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(ip_pd));
+    }
+
+    mkldnn_stream_kind_t kinds[2] = {mkldnn_eager, mkldnn_lazy};
+    for (int k = 0; k < 2; ++k) {
+        for (int i = 0; i < N * C; ++i)
+            pool_blk[i] = pool[i] = -1;
+        memset(dst, 0, product(dst_sizes, 2) * sizeof(real_t));
+
+        mkldnn_stream_t stream;
+        CHECK(mkldnn_stream_create(&stream, kinds[k]));
+        CHECK(mkldnn_stream_submit(stream, 3, net, NULL));
+        CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        CHECK(mkldnn_stream_destroy(stream));
+
+        for (int n = 0; n < N; ++n)
+        for (int oc = 0; oc < OC; ++oc) {
+            real_t e = bias[oc];
+            for (int c = 0; c < C; ++c) {
+                real_t s = 0;
+                for (int hw = 0; hw < HW; ++hw)
+                    s += src[((n * C / 8 + c / 8) * HW + hw) * 8 + c % 8];
+                e += s / HW * weights[oc * C + c];
+            }
+            CHECK_TRUE(fabsf(dst[n * OC + oc] - e) <= 1e-4 * fabsf(e));
+        }
+        if (kinds[k] == mkldnn_lazy)
+            for (int i = 0; i < N * C; ++i)
+                CHECK_TRUE(pool_blk[i] == -1 && pool[i] == -1);
+    }
+
+    for (int i = 0; i < 3; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 6; ++i) {
+        CHECK(mkldnn_primitive_destroy(m[i]));
+        CHECK(mkldnn_primitive_desc_destroy(m_pds[i]));
+    }
+    CHECK(mkldnn_engine_destroy(engine));
+
+    free(src);
+    free(pool_blk);
+    free(pool);
+    free(weights);
+    free(bias);
+    free(dst);
+}
+
+void test10() {
+    /* in-place concat: reorders write directly to the views of the concat
+     * output, the concat itself does nothing */
+    int src_sizes[4] = {2, 8, 4, 4};
+    int dst_sizes[4] = {2, 16, 4, 4};
+    const size_t src_size = product(src_sizes, 4);
+    const size_t dst_size = product(dst_sizes, 4);
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, src_blk_md, dst_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&src_blk_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, dst_sizes, mkldnn_f32,
+                mkldnn_nchw));
+
+    mkldnn_primitive_desc_t src_pd, src_blk_pd, dst_pd;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&src_blk_pd, &src_blk_md,
+                engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+
+    mkldnn_primitive_desc_t c_pd;
+    const_mkldnn_primitive_desc_t c_src_pds[] = {src_blk_pd, src_blk_pd};
+    CHECK(mkldnn_concat_inplace_by_input_primitive_desc_create(&c_pd, 2, 1,
+                c_src_pds));
+    const_mkldnn_primitive_desc_t dst_blk_pd
+        = mkldnn_primitive_desc_query_pd(c_pd, mkldnn_query_dst_pd, 0);
+    CHECK_TRUE(dst_blk_pd != NULL);
+    CHECK_TRUE(mkldnn_primitive_desc_query_s32(c_pd,
+                mkldnn_query_num_of_inputs_s32, 0) == 2);
+
+    /* the same concat described by the output */
+    {
+        mkldnn_primitive_desc_t c_pd2;
+        int sizes[] = {8, 8};
+        CHECK(mkldnn_concat_inplace_by_output_primitive_desc_create(&c_pd2,
+                    dst_blk_pd, 2, 1, sizes));
+        for (int i = 0; i < 2; ++i)
+            CHECK_TRUE(mkldnn_memory_primitive_desc_equal(
+                    mkldnn_primitive_desc_query_pd(c_pd, mkldnn_query_src_pd,
+                        i),
+                    mkldnn_primitive_desc_query_pd(c_pd2, mkldnn_query_src_pd,
+                        i)));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd2));
+
+        /* the inputs of a blocked output must start on block boundaries */
+        int bad_sizes[] = {4, 12};
+        CHECK_TRUE(mkldnn_concat_inplace_by_output_primitive_desc_create(
+                    &c_pd2, dst_blk_pd, 2, 1, bad_sizes)
+                == mkldnn_unimplemented);
+    }
+
+    /* m[0] -> v[0], m[1] -> v[1], v[i] live in m[2]; m[2] -> m[3] */
+    real_t *data[4];
+    mkldnn_primitive_t m[4];
+    const_mkldnn_primitive_desc_t m_pds[4] = {src_pd, src_pd, dst_blk_pd,
+        dst_pd};
+    for (int i = 0; i < 4; ++i) {
+        data[i] = (real_t*)calloc(i < 2 ? src_size : dst_size,
+                sizeof(real_t));
+        CHECK_TRUE(data[i] != NULL);
+        CHECK(mkldnn_primitive_create(&m[i], m_pds[i], NULL, NULL));
+        CHECK(mkldnn_memory_set_data_handle(m[i], data[i]));
+    }
+    for (size_t i = 0; i < src_size; ++i) {
+        data[0][i] = i;
+        data[1][i] = 1000 + i;
+    }
+
+    mkldnn_primitive_t v[2], net[4];
+    for (int i = 0; i < 2; ++i) {
+        int offsets[4] = {0, i * src_sizes[1], 0, 0};
+        mkldnn_primitive_desc_t v_pd;
+        CHECK(mkldnn_view_primitive_desc_create(&v_pd, dst_blk_pd, src_sizes,
+                    offsets));
+        mkldnn_primitive_at_t v_srcs[] = { mkldnn_primitive_at(m[2], 0) };
+        CHECK(mkldnn_primitive_create(&v[i], v_pd, v_srcs, NULL));
+
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m[i], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {v[i]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, src_pd,
+                    mkldnn_primitive_desc_query_pd(v_pd, mkldnn_query_dst_pd,
+                        0)));
+        CHECK(mkldnn_primitive_create(&net[i], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+        CHECK(mkldnn_primitive_desc_destroy(v_pd));
+    }
+    {
+        mkldnn_primitive_at_t c_srcs[] = { mkldnn_primitive_at(net[0], 0),
+            mkldnn_primitive_at(net[1], 0) };
+        const_mkldnn_primitive_t c_dsts[] = {m[2]};
+        CHECK(mkldnn_primitive_create(&net[2], c_pd, c_srcs, c_dsts));
+
+        /* an input which does not live in the output is rejected */
+        mkldnn_primitive_t c;
+        c_srcs[1] = mkldnn_primitive_at(m[1], 0);
+        CHECK_TRUE(mkldnn_primitive_create(&c, c_pd, c_srcs, c_dsts)
+                == mkldnn_invalid_arguments);
+    }
+    {
+        mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(net[2], 0) };
+        const_mkldnn_primitive_t r_dsts[] = {m[3]};
+        mkldnn_primitive_desc_t r_pd;
+        CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, dst_blk_pd,
+                    dst_pd));
+        CHECK(mkldnn_primitive_create(&net[3], r_pd, r_srcs, r_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(r_pd));
+    }
+
+    mkldnn_stream_kind_t kinds[2] = {mkldnn_eager, mkldnn_lazy};
+    for (int k = 0; k < 2; ++k) {
+        memset(data[2], 0, dst_size * sizeof(real_t));
+        memset(data[3], 0, dst_size * sizeof(real_t));
+
+        mkldnn_stream_t stream;
+        CHECK(mkldnn_stream_create(&stream, kinds[k]));
+        CHECK(mkldnn_stream_submit(stream, 4, net, NULL));
+        CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        CHECK(mkldnn_stream_destroy(stream));
+
+        const int N = dst_sizes[0], C = dst_sizes[1],
+              HW = dst_sizes[2] * dst_sizes[3], SC = src_sizes[1];
+        for (int n = 0; n < N; ++n)
+        for (int c = 0; c < C; ++c)
+        for (int hw = 0; hw < HW; ++hw) {
+            real_t e = (c < SC ? 0 : 1000) + (n * SC + c % SC) * HW + hw;
+            CHECK_TRUE(data[3][(n * C + c) * HW + hw] == e);
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 2; ++i)
+        CHECK(mkldnn_primitive_destroy(v[i]));
+    for (int i = 0; i < 4; ++i) {
+        CHECK(mkldnn_primitive_destroy(m[i]));
+        free(data[i]);
+    }
+    CHECK(mkldnn_primitive_desc_destroy(c_pd));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(src_blk_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test11() {
+    /* a stream carves the scratch memory of its primitives from one arena:
+     * the chained lrns run one after another and share the same area */
+    int sizes[4] = {2, 16, 8, 8};
+    const size_t size = product(sizes, 4);
+
+    real_t *data[3];
+    for (int i = 0; i < 3; ++i) {
+        data[i] = (real_t*)calloc(size, sizeof(real_t));
+        CHECK_TRUE(data[i] != NULL);
+    }
+    for (size_t i = 0; i < size; ++i)
+        data[0][i] = (i % 13) + 1;
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t md;
+    mkldnn_primitive_desc_t m_pd;
+    CHECK(mkldnn_memory_desc_init(&md, 4, sizes, mkldnn_f32, mkldnn_nchw));
+    CHECK(mkldnn_memory_primitive_desc_create(&m_pd, &md, engine));
+
+    mkldnn_primitive_t m[3];
+    for (int i = 0; i < 3; ++i) {
+        CHECK(mkldnn_primitive_create(&m[i], m_pd, NULL, NULL));
+        CHECK(mkldnn_memory_set_data_handle(m[i], data[i]));
+    }
+
+    /* lrn: m[0] -> m[1] -> m[2] */
+    mkldnn_lrn_desc_t l_desc;
+    mkldnn_primitive_desc_t l_pd;
+    CHECK(mkldnn_lrn_forward_desc_init(&l_desc, mkldnn_forward_inference,
+                mkldnn_lrn_within_channel, &md, 3, 1e-4, 0.75, 1.0));
+    CHECK(mkldnn_primitive_desc_create(&l_pd, &l_desc, engine, NULL));
+
+    ptrdiff_t scratchpad_size = 0;
+    CHECK(mkldnn_primitive_desc_query(l_pd,
+                mkldnn_query_memory_consumption_s64, 0, &scratchpad_size));
+    CHECK_TRUE(scratchpad_size > 0);
+
+    mkldnn_primitive_t net[2];
+    for (int i = 0; i < 2; ++i) {
+        mkldnn_primitive_at_t l_srcs[] = { mkldnn_primitive_at(m[i], 0) };
+        const_mkldnn_primitive_t l_dsts[] = {m[i + 1]};
+        CHECK(mkldnn_primitive_create(&net[i], l_pd, l_srcs, l_dsts));
+    }
+
+    mkldnn_stream_t stream;
+    CHECK(mkldnn_stream_create(&stream, mkldnn_eager));
+    CHECK(mkldnn_stream_submit(stream, 2, net, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+    CHECK(mkldnn_stream_rerun(stream, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+
+    size_t arena_size, uses;
+    CHECK(mkldnn_stream_get_scratchpad_stats(stream, &arena_size, &uses));
+    CHECK_TRUE(arena_size >= (size_t)scratchpad_size);
+    CHECK_TRUE(arena_size < 2 * (size_t)scratchpad_size);
+    CHECK_TRUE(uses == 4);
+
+    /* the power of the tiny sums keeps the values almost unchanged */
+    for (size_t i = 0; i < size; ++i)
+        CHECK_TRUE(fabs(data[2][i] - data[0][i]) / data[0][i] < 0.0125);
+
+    CHECK(mkldnn_stream_destroy(stream));
+    for (int i = 0; i < 2; ++i)
+        CHECK(mkldnn_primitive_destroy(net[i]));
+    for (int i = 0; i < 3; ++i) {
+        CHECK(mkldnn_primitive_destroy(m[i]));
+        free(data[i]);
+    }
+    CHECK(mkldnn_primitive_desc_destroy(l_pd));
+    CHECK(mkldnn_primitive_desc_destroy(m_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+}
+
+void test12() {
+    /* the producer of a padded blocked memory leaves zeros in the padding,
+     * whatever the memory held before */
+    int sizes[4] = {2, 20, 3, 3};
+    const int N = sizes[0], C = sizes[1], HW = sizes[2] * sizes[3];
+    const int CB = (C + 7) / 8;
+
+    real_t *src = (real_t*)calloc(product(sizes, 4), sizeof(real_t));
+    real_t *dst = (real_t*)malloc(N * CB * 8 * HW * sizeof(real_t));
+    CHECK_TRUE(src && dst);
+    for (size_t i = 0; i < product(sizes, 4); ++i)
+        src[i] = i + 1;
+    for (int i = 0; i < N * CB * 8 * HW; ++i)
+        dst[i] = -1;
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, dst_md;
+    mkldnn_primitive_desc_t src_pd, dst_pd;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+    CHECK_TRUE(mkldnn_memory_primitive_desc_get_size(dst_pd)
+            == N * CB * 8 * HW * sizeof(real_t));
+
+    mkldnn_primitive_t m_src, m_dst;
+    CHECK(mkldnn_primitive_create(&m_src, src_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_src, src));
+    CHECK(mkldnn_primitive_create(&m_dst, dst_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_dst, dst));
+
+    /* setting the handle leaves the buffer as it is */
+    CHECK_TRUE(dst[N * CB * 8 * HW - 1] == -1);
+
+    mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m_src, 0) };
+    const_mkldnn_primitive_t r_dsts[] = {m_dst};
+    mkldnn_primitive_desc_t r_pd;
+    mkldnn_primitive_t r;
+    CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, src_pd, dst_pd));
+    CHECK(mkldnn_primitive_create(&r, r_pd, r_srcs, r_dsts));
+    CHECK(mkldnn_primitive_desc_destroy(r_pd));
+
+    mkldnn_stream_t stream;
+    CHECK(mkldnn_stream_create(&stream, mkldnn_eager));
+    CHECK(mkldnn_stream_submit(stream, 1, &r, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+    CHECK(mkldnn_stream_destroy(stream));
+
+    for (int n = 0; n < N; ++n)
+    for (int c = 0; c < CB * 8; ++c)
+    for (int hw = 0; hw < HW; ++hw) {
+        real_t e = c < C ? src[(n * C + c) * HW + hw] : 0;
+        CHECK_TRUE(dst[((n * CB + c / 8) * HW + hw) * 8 + c % 8] == e);
+    }
+
+    CHECK(mkldnn_primitive_destroy(r));
+    CHECK(mkldnn_primitive_destroy(m_src));
+    CHECK(mkldnn_primitive_destroy(m_dst));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+    free(src);
+    free(dst);
+}
+
+void test13() {
+    /* the worker thread of a stream runs the primitives with the number of
+     * OpenMP threads of the thread that submitted them */
+    int sizes[4] = {2, 16, 3, 3};
+
+    real_t *src = (real_t*)calloc(product(sizes, 4), sizeof(real_t));
+    real_t *dst = (real_t*)calloc(product(sizes, 4), sizeof(real_t));
+    CHECK_TRUE(src && dst);
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, dst_md;
+    mkldnn_primitive_desc_t src_pd, dst_pd;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, sizes, mkldnn_f32,
+                mkldnn_nchw));
+    CHECK(mkldnn_memory_desc_init(&dst_md, 4, sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&dst_pd, &dst_md, engine));
+
+    mkldnn_primitive_t m_src, m_dst;
+    CHECK(mkldnn_primitive_create(&m_src, src_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_src, src));
+    CHECK(mkldnn_primitive_create(&m_dst, dst_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_dst, dst));
+
+    mkldnn_primitive_at_t r_srcs[] = { mkldnn_primitive_at(m_src, 0) };
+    const_mkldnn_primitive_t r_dsts[] = {m_dst};
+    mkldnn_primitive_desc_t r_pd;
+    mkldnn_primitive_t r;
+    CHECK(mkldnn_reorder_primitive_desc_create(&r_pd, src_pd, dst_pd));
+    CHECK(mkldnn_primitive_create(&r, r_pd, r_srcs, r_dsts));
+    CHECK(mkldnn_primitive_desc_destroy(r_pd));
+
+    int num_threads;
+    mkldnn_stream_t stream;
+    CHECK(mkldnn_stream_create(&stream, mkldnn_eager));
+    CHECK(mkldnn_stream_get_num_threads(stream, &num_threads));
+    CHECK_TRUE(num_threads == 0);
+#if defined(_OPENMP)
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(3);
+    CHECK(mkldnn_stream_submit(stream, 1, &r, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+    CHECK(mkldnn_stream_get_num_threads(stream, &num_threads));
+    CHECK_TRUE(num_threads == 3);
+
+    omp_set_num_threads(2);
+    CHECK(mkldnn_stream_rerun(stream, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+    CHECK(mkldnn_stream_get_num_threads(stream, &num_threads));
+    CHECK_TRUE(num_threads == 2);
+    CHECK(mkldnn_stream_destroy(stream));
+
+    /* inside a parallel region of the user nesting is off, hence a single
+     * thread */
+    omp_set_max_active_levels(1);
+#   pragma omp parallel num_threads(2)
+    {
+#       pragma omp single
+        {
+            CHECK(mkldnn_stream_create(&stream, mkldnn_eager));
+            CHECK(mkldnn_stream_submit(stream, 1, &r, NULL));
+            CHECK(mkldnn_stream_wait(stream, 1, NULL));
+            CHECK(mkldnn_stream_get_num_threads(stream, &num_threads));
+            CHECK(mkldnn_stream_destroy(stream));
+        }
+    }
+    CHECK_TRUE(num_threads == 1);
+    omp_set_num_threads(max_threads);
+#else
+    CHECK(mkldnn_stream_submit(stream, 1, &r, NULL));
+    CHECK(mkldnn_stream_wait(stream, 1, NULL));
+    CHECK(mkldnn_stream_get_num_threads(stream, &num_threads));
+    CHECK_TRUE(num_threads == 1);
+    CHECK(mkldnn_stream_destroy(stream));
+#endif
+
+    CHECK(mkldnn_primitive_destroy(r));
+    CHECK(mkldnn_primitive_destroy(m_src));
+    CHECK(mkldnn_primitive_destroy(m_dst));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(dst_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+    free(src);
+    free(dst);
+}
+
+void test14() {
+    /* a winograd inference convolution transforms its weights once per
+     * weights handle */
+    int src_sizes[4] = {1, 8, 4, 4};
+    int weights_sizes[4] = {8, 8, 3, 3};
+    int strides[] = {1, 1};
+    int32_t padding[] = {1, 1};
+    const size_t src_size = product(src_sizes, 4);
+    const size_t weights_size = product(weights_sizes, 4);
+
+    real_t *src = (real_t*)calloc(src_size, sizeof(real_t));
+    real_t *weights[2];
+    real_t *dst = (real_t*)calloc(src_size, sizeof(real_t));
+    CHECK_TRUE(src && dst);
+    for (size_t i = 0; i < src_size; ++i) src[i] = 1;
+    for (int w = 0; w < 2; ++w) {
+        weights[w] = (real_t*)calloc(weights_size, sizeof(real_t));
+        CHECK_TRUE(weights[w] != NULL);
+        for (size_t i = 0; i < weights_size; ++i) weights[w][i] = w + 1;
+    }
+
+    mkldnn_engine_t engine;
+    CHECK(mkldnn_engine_create(&engine, mkldnn_cpu, 0));
+
+    mkldnn_memory_desc_t src_md, weights_md;
+    CHECK(mkldnn_memory_desc_init(&src_md, 4, src_sizes, mkldnn_f32,
+                mkldnn_nChw8c));
+    CHECK(mkldnn_memory_desc_init(&weights_md, 4, weights_sizes, mkldnn_f32,
+                mkldnn_OIhw8i8o));
+
+    mkldnn_primitive_desc_t src_pd, weights_pd;
+    mkldnn_primitive_t m_src, m_weights, m_dst;
+    CHECK(mkldnn_memory_primitive_desc_create(&src_pd, &src_md, engine));
+    CHECK(mkldnn_memory_primitive_desc_create(&weights_pd, &weights_md,
+                engine));
+    CHECK(mkldnn_primitive_create(&m_src, src_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_src, src));
+    CHECK(mkldnn_primitive_create(&m_weights, weights_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_weights, weights[0]));
+    CHECK(mkldnn_primitive_create(&m_dst, src_pd, NULL, NULL));
+    CHECK(mkldnn_memory_set_data_handle(m_dst, dst));
+
+    mkldnn_convolution_desc_t c_desc;
+    CHECK(mkldnn_convolution_forward_desc_init(&c_desc,
+                mkldnn_forward_inference, mkldnn_convolution_winograd,
+                &src_md, &weights_md, NULL, &src_md, strides, padding, NULL,
+                mkldnn_padding_zero));
+    mkldnn_primitive_desc_t c_pd;
+    if (mkldnn_primitive_desc_create(&c_pd, &c_desc, engine, NULL)
+            == mkldnn_success) {
+        mkldnn_primitive_at_t c_srcs[] = { mkldnn_primitive_at(m_src, 0),
+            mkldnn_primitive_at(m_weights, 0) };
+        const_mkldnn_primitive_t c_dsts[] = {m_dst};
+        mkldnn_primitive_t c;
+        CHECK(mkldnn_primitive_create(&c, c_pd, c_srcs, c_dsts));
+        CHECK(mkldnn_primitive_desc_destroy(c_pd));
+
+        mkldnn_stream_t stream;
+        CHECK(mkldnn_stream_create(&stream, mkldnn_eager));
+        CHECK(mkldnn_stream_submit(stream, 1, &c, NULL));
+        CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        for (int w = 0; w < 2; ++w) {
+            /* the inner pixels of the output see the whole 3x3 window */
+            const real_t e = 9 * src_sizes[1] * (w + 1);
+            CHECK_TRUE(dst[(1 * src_sizes[3] + 1) * 8] == e);
+            CHECK_TRUE(dst[(2 * src_sizes[3] + 2) * 8 + 7] == e);
+            if (w == 1) break;
+
+            CHECK(mkldnn_memory_set_data_handle(m_weights, weights[1]));
+            CHECK(mkldnn_stream_rerun(stream, NULL));
+            CHECK(mkldnn_stream_wait(stream, 1, NULL));
+        }
+        CHECK(mkldnn_stream_destroy(stream));
+        CHECK(mkldnn_primitive_destroy(c));
+    }
+
+    CHECK(mkldnn_primitive_destroy(m_src));
+    CHECK(mkldnn_primitive_destroy(m_weights));
+    CHECK(mkldnn_primitive_destroy(m_dst));
+    CHECK(mkldnn_primitive_desc_destroy(src_pd));
+    CHECK(mkldnn_primitive_desc_destroy(weights_pd));
+    CHECK(mkldnn_engine_destroy(engine));
+    free(src);
+    free(weights[0]);
+    free(weights[1]);
+    free(dst);
+}
+
 int main() {
-    test1();
-    test2();
-    test3();
+    fprintf(stderr, "t1\n"); test1();
+    fprintf(stderr, "t2\n"); test2();
+    fprintf(stderr, "t3\n"); test3();
+    fprintf(stderr, "t4\n"); test4();
+    fprintf(stderr, "t5\n"); test5();
+    fprintf(stderr, "t6\n"); test6(mkldnn_forward_inference);
+    fprintf(stderr, "t6\n"); test6(mkldnn_forward_training);
+    fprintf(stderr, "t7\n"); test7();
+    fprintf(stderr, "t8\n"); test8();
+    fprintf(stderr, "t9\n"); test9();
+    fprintf(stderr, "t10\n"); test10();
+    fprintf(stderr, "t11\n"); test11();
+    fprintf(stderr, "t12\n"); test12();
+    fprintf(stderr, "t13\n"); test13();
+    fprintf(stderr, "t14\n"); test14();
     return 0;
 }
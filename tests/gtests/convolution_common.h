@@ -10,25 +10,36 @@
 #ifdef DIRECTION_FORWARD
 #define FMT_WEIGHTS_BLOCKED OIhw8i8o
 #define FMT_WEIGHTS_BLOCKED_G gOIhw8i8o
+#define FMT_WEIGHTS_BLOCKED16 OIhw16i16o
+#define FMT_WEIGHTS_BLOCKED16_G gOIhw16i16o
 #define TEST_CASE_NAME_PREFIX Forward
 #elif defined DIRECTION_BACKWARD_DATA
 #define FMT_WEIGHTS_BLOCKED OIhw8o8i
 #define FMT_WEIGHTS_BLOCKED_G gOIhw8o8i
+#define FMT_WEIGHTS_BLOCKED16 OIhw16o16i
+#define FMT_WEIGHTS_BLOCKED16_G gOIhw16o16i
 #define TEST_CASE_NAME_PREFIX BackwardData
 #elif defined DIRECTION_BACKWARD_WEIGHTS
 #define FMT_WEIGHTS_BLOCKED OIhw8o8i
 #define FMT_WEIGHTS_BLOCKED_G gOIhw8o8i
+#define FMT_WEIGHTS_BLOCKED16 OIhw16i16o
+#define FMT_WEIGHTS_BLOCKED16_G gOIhw16i16o
 #define TEST_CASE_NAME_PREFIX BackwardWeights
 #endif
 
 #define FMT_BIAS x
 #define FMT_NO_BIAS undef
 #define FMT_DATA_BLOCKED nChw8c
+#define FMT_DATA_BLOCKED16 nChw16c
 
 #define PARAMS(src, weights, bias, dst, ...) \
     test_convolution_params_t { ENGINE, ALGORITHM, \
     EXPAND_FORMATS(src, weights, bias, dst), EXPAND_SIZES(__VA_ARGS__) }
 
+#define PARAMS_WINOGRAD(src, weights, bias, dst, ...) \
+    test_convolution_params_t { ENGINE, convolution_winograd, \
+    EXPAND_FORMATS(src, weights, bias, dst), EXPAND_SIZES(__VA_ARGS__) }
+
 #define CONCAT_WITH_UNDERSCORE_(a,b) a ## _ ## b
 #define CONCAT_WITH_UNDERSCORE(a,b) CONCAT_WITH_UNDERSCORE_(a,b)
 
@@ -42,3 +53,6 @@
 #include "convolution_googlenet_v1.h"
 #include "convolution_googlenet_v2.h"
 #include "convolution_cifar10.h"
+#if defined DIRECTION_FORWARD || defined DIRECTION_BACKWARD_DATA
+#include "convolution_winograd.h"
+#endif
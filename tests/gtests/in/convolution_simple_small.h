@@ -25,3 +25,71 @@ INST_TEST_CASE(SimpleSmall_Blocked,
     PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
         2, 1, 32, 13, 13, 48, 11, 11, 3, 3, 0, 0, 1, 1)
 );
+
+INST_TEST_CASE(SimpleSmall_Blocked_Strided,
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 32, 14, 14, 64, 7, 7, 3, 3, 1, 1, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 64, 15, 15, 32, 7, 7, 3, 3, 0, 0, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 16, 28, 28, 32, 14, 14, 1, 1, 0, 0, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 24, 23, 23, 16, 8, 8, 5, 5, 2, 2, 3, 3),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED_G, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 2, 32, 13, 13, 64, 7, 7, 3, 3, 1, 1, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        1, 1, 8, 5, 5, 8, 2, 2, 3, 3, 0, 0, 2, 2)
+);
+
+/* channels that are not a multiple of the block are zero-padded */
+INST_TEST_CASE(SimpleSmall_Blocked_Padded,
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 20, 13, 13, 36, 13, 13, 3, 3, 1, 1, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 36, 14, 14, 20, 7, 7, 3, 3, 1, 1, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 5, 10, 10, 13, 10, 10, 5, 5, 2, 2, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 16, 9, 9, 12, 9, 9, 3, 3, 1, 1, 1, 1)
+);
+
+#if defined(DIRECTION_BACKWARD_WEIGHTS)
+/* few channel blocks and a larger minibatch: the backward weights
+ * minibatch split kicks in when run with several threads */
+INST_TEST_CASE(SimpleSmall_Blocked_8i8o,
+    PARAMS(FMT_DATA_BLOCKED, OIhw8i8o, FMT_BIAS, FMT_DATA_BLOCKED,
+        8, 1, 16, 10, 10, 16, 10, 10, 3, 3, 1, 1, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, gOIhw8i8o, FMT_BIAS, FMT_DATA_BLOCKED,
+        5, 2, 32, 9, 9, 16, 9, 9, 3, 3, 1, 1, 1, 1)
+);
+#endif
+
+INST_TEST_CASE(SimpleSmall_Blocked_1x1,
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 32, 13, 13, 48, 13, 13, 1, 1, 0, 0, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        2, 1, 512, 7, 7, 128, 7, 7, 1, 1, 0, 0, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED_G, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 2, 64, 10, 10, 32, 10, 10, 1, 1, 0, 0, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS, FMT_DATA_BLOCKED,
+        1, 1, 256, 20, 20, 64, 20, 20, 1, 1, 0, 0, 1, 1)
+);
+
+INST_TEST_CASE(SimpleSmall_Blocked16,
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 32, 13, 13, 32, 11, 11, 3, 3, 0, 0, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 32, 13, 13, 48, 13, 13, 3, 3, 1, 1, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 16, 2, 2, 32, 2, 2, 3, 3, 1, 1, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 64, 14, 14, 64, 14, 14, 3, 3, 1, 1, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 64, 27, 27, 32, 27, 27, 5, 5, 2, 2, 1, 1),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 1, 32, 13, 13, 64, 6, 6, 3, 3, 0, 0, 2, 2),
+    PARAMS(FMT_DATA_BLOCKED16, FMT_WEIGHTS_BLOCKED16_G, FMT_BIAS,
+        FMT_DATA_BLOCKED16, 2, 2, 64, 13, 13, 96, 13, 13, 3, 3, 1, 1, 1, 1),
+    PARAMS(nchw, Ohwi16o, FMT_BIAS, FMT_DATA_BLOCKED16,
+        2, 1, 3, 32, 32, 32, 32, 32, 5, 5, 2, 2, 1, 1)
+);
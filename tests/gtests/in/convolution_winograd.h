@@ -0,0 +1,21 @@
+INST_TEST_CASE(Winograd_Blocked,
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 1, 32, 13, 13, 48, 13, 13, 3, 3, 1, 1, 1, 1),
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 1, 32, 13, 13, 32, 11, 11, 3, 3, 0, 0, 1, 1),
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 1, 32, 12, 12, 32, 12, 12, 3, 3, 1, 1, 1, 1),
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 1, 32, 3, 3, 32, 4, 4, 3, 3, 1, 1, 1, 1),
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, FMT_WEIGHTS_BLOCKED, FMT_BIAS,
+        FMT_DATA_BLOCKED, 3, 1, 64, 28, 28, 128, 28, 28, 3, 3, 1, 1, 1, 1),
+    PARAMS_WINOGRAD(FMT_DATA_BLOCKED, oihw, FMT_BIAS,
+        FMT_DATA_BLOCKED, 2, 1, 16, 7, 7, 24, 7, 7, 3, 3, 1, 1, 1, 1)
+);
+
+INST_TEST_CASE(Winograd_NCHW,
+    PARAMS_WINOGRAD(nchw, oihw, FMT_BIAS, nchw,
+        2, 1, 4, 4, 4, 6, 4, 4, 3, 3, 1, 1, 1, 1),
+    PARAMS_WINOGRAD(nchw, oihw, FMT_BIAS, nchw,
+        2, 1, 4, 9, 9, 6, 5, 5, 5, 5, 0, 0, 1, 1)
+);
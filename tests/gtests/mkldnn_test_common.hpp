@@ -83,14 +83,20 @@ inline mkldnn::memory::desc create_md(mkldnn::memory::dims dims,
     case f::nchw:
     case f::nhwc:
     case f::nChw8c:
+    case f::nChw16c:
     case f::oihw:
     case f::OIhw8i8o:
+    case f::OIhw16i16o:
     case f::OIhw8o8i:
+    case f::OIhw16o16i:
     case f::Ohwi8o:
+    case f::Ohwi16o:
         ndims = 4; break;
     case f::goihw:
     case f::gOIhw8i8o:
+    case f::gOIhw16i16o:
     case f::gOIhw8o8i:
+    case f::gOIhw16o16i:
         ndims = 5; break;
     case f::format_undef:
         ndims = 0; break;
@@ -138,6 +144,26 @@ static void fill_data(const int size, data_t *data, double sparsity = 1.)
     }
 }
 
+/* the blocked formats pad the channels up to the block with zeros, resets
+ * the padding of a buffer filled as a whole by fill_data() or written by a
+ * reference which skips the padding */
+template <typename data_t>
+static void zero_padding(mkldnn::memory &m)
+{
+    const auto md = m.get_primitive_desc().desc();
+    const size_t size = m.get_primitive_desc().get_size() / sizeof(data_t);
+    const size_t nelems = std::accumulate(md.data.dims,
+            md.data.dims + md.data.ndims, size_t(1),
+            std::multiplies<size_t>());
+    data_t *data = (data_t *)m.get_data_handle();
+
+    std::vector<bool> is_data(size, false);
+    for (size_t e = 0; e < nelems; ++e)
+        is_data[map_index(md, e)] = true;
+    for (size_t i = 0; i < size; ++i)
+        if (!is_data[i]) data[i] = data_t(0);
+}
+
 template <typename data_t>
 static void compare_data(mkldnn::memory& ref, mkldnn::memory& dst)
 {
@@ -101,8 +101,7 @@ protected:
             auto src_memory = memory(mpd);
             const size_t sz = src_memory.get_primitive_desc().get_size() / sizeof(data_t);
             auto s = (data_t *)src_memory.get_data_handle();
-            for (size_t j = 0; j < sz; ++j) s[j] = i;
-            // fill_data<data_t>(sz, (data_t *)src_memory.get_data_handle());
+            for (size_t j = 0; j < sz; ++j) s[j] = i * 100 + j % 97;
             srcs_pd.push_back(mpd);
             srcs.push_back(src_memory);
         }
@@ -167,7 +166,26 @@ INSTANTIATE_TEST_CASE_P(TestConcat, concat_test_float, ::testing::Values(
 
     concat_test_params_float{engine::kind::cpu, 1,
     {memory::format::nChw8c, memory::format::nChw8c}, memory::format::nChw8c,
-    {{2, 8, 1, 1}, {2, 8, 1, 1}}, {2, 16, 1, 1}}
+    {{2, 8, 1, 1}, {2, 8, 1, 1}}, {2, 16, 1, 1}},
+
+    concat_test_params_float{engine::kind::cpu, 1,
+    {memory::format::nchw, memory::format::nChw8c, memory::format::nhwc},
+    memory::format::nChw8c,
+    {{2, 4, 3, 5}, {2, 12, 3, 5}, {2, 16, 3, 5}}, {2, 32, 3, 5}},
+    concat_test_params_float{engine::kind::cpu, 1,
+    {memory::format::nChw8c, memory::format::nhwc, memory::format::nchw},
+    memory::format::nchw,
+    {{2, 16, 3, 5}, {2, 3, 3, 5}, {2, 5, 3, 5}}, {2, 24, 3, 5}},
+    concat_test_params_float{engine::kind::cpu, 2,
+    {memory::format::nChw8c, memory::format::nchw}, memory::format::nhwc,
+    {{2, 16, 3, 5}, {2, 16, 4, 5}}, {2, 16, 7, 5}},
+    concat_test_params_float{engine::kind::cpu, 3,
+    {memory::format::nchw, memory::format::nChw8c, memory::format::nchw},
+    memory::format::nChw8c,
+    {{2, 16, 3, 5}, {2, 16, 3, 2}, {2, 16, 3, 1}}, {2, 16, 3, 8}},
+    concat_test_params_float{engine::kind::cpu, 0,
+    {memory::format::nChw8c, memory::format::nchw}, memory::format::nChw8c,
+    {{1, 20, 3, 5}, {2, 20, 3, 5}}, {3, 20, 3, 5}}
 ));
 
 }
@@ -92,7 +92,8 @@ protected:
                 test_convolution_params_t>::GetParam();
 
         ASSERT_TRUE(p.engine_kind == engine::kind::cpu);
-        ASSERT_EQ(p.aalgorithm, convolution_direct);
+        ASSERT_TRUE(p.aalgorithm == convolution_direct
+                || p.aalgorithm == convolution_winograd);
         auto eng =  engine(p.engine_kind, 0);
         memory::data_type data_type = data_traits<data_t>::data_type;
         ASSERT_EQ(data_type, mkldnn::memory::data_type::f32);
@@ -148,6 +149,8 @@ protected:
         fill_data<data_t>(
                 c_diff_dst.get_primitive_desc().get_size() / sizeof(data_t),
                 (data_t *)c_diff_dst.get_data_handle());
+        zero_padding<data_t>(c_weights);
+        zero_padding<data_t>(c_diff_dst);
 
         auto conv_bwd_data =
                 convolution_backward_data(conv_bwd_data_primitive_desc,
@@ -160,6 +163,7 @@ protected:
         auto ref_memory = memory(memory::primitive_desc(c_src_desc, eng));
         compute_ref_conv_bwd_data<data_t>(
                 cd, ref_memory, c_weights, c_diff_dst);
+        zero_padding<data_t>(ref_memory);
         compare_data<data_t>(ref_memory, c_diff_src);
     }
 };
@@ -145,6 +145,8 @@ protected:
                 / sizeof(data_t), (data_t *)c_diff_dst.get_data_handle());
         fill_data<data_t>(c_src.get_primitive_desc().get_size()
                 / sizeof(data_t), (data_t *)c_src.get_data_handle());
+        zero_padding<data_t>(c_diff_dst);
+        zero_padding<data_t>(c_src);
 
         std::vector<int> padR = { cd.padh, cd.padw };
         for (int i = 0; i < 2; ++i) {
@@ -182,6 +184,7 @@ protected:
 
         compute_ref_conv_bwd_weights<data_t>(cd, c_src, c_diff_dst,
                 ref_diff_weights);
+        zero_padding<data_t>(ref_diff_weights);
         compare_data<data_t>(ref_diff_weights, c_diff_weights);
 
         compute_ref_conv_bwd_bias<data_t>(cd, c_diff_dst,
@@ -91,7 +91,8 @@ protected:
             = ::testing::TestWithParam<test_convolution_params_t>::GetParam();
 
         ASSERT_TRUE(p.engine_kind == engine::kind::cpu);
-        ASSERT_EQ(p.aalgorithm, algorithm::convolution_direct);
+        ASSERT_TRUE(p.aalgorithm == algorithm::convolution_direct
+                || p.aalgorithm == algorithm::convolution_winograd);
         auto eng = engine(p.engine_kind, 0);
         memory::data_type data_type = data_traits<data_t>::data_type;
         ASSERT_EQ(data_type, mkldnn::memory::data_type::f32);
@@ -150,6 +151,8 @@ protected:
                     c_bias.get_primitive_desc().get_size() / sizeof(data_t),
                     (data_t *)c_bias.get_data_handle());
         }
+        zero_padding<data_t>(c_src);
+        zero_padding<data_t>(c_weights);
 
         std::vector<int> padR = { cd.padh, cd.padw };
         for (int i = 0; i < 2; ++i) {
@@ -185,6 +188,7 @@ protected:
                 ref_dst_data);
         compute_ref_conv_fwd<data_t>(cd, c_src_desc, c_weights_desc,
                 c_bias_desc, c_dst_desc, c_src, c_weights, c_bias, ref_memory);
+        zero_padding<data_t>(ref_memory);
         compare_data<data_t>(ref_memory, c_dst);
     }
 };
@@ -98,7 +98,8 @@ protected:
                 test_convolution_params_t>::GetParam();
 
         ASSERT_TRUE(p.engine_kind == engine::kind::cpu);
-        ASSERT_EQ(p.aalgorithm, convolution_direct);
+        ASSERT_TRUE(p.aalgorithm == convolution_direct
+                || p.aalgorithm == convolution_winograd);
         auto eng = engine(p.engine_kind, 0);
         memory::data_type data_type = data_traits<data_t>::data_type;
         ASSERT_EQ(data_type, mkldnn::memory::data_type::f32);
@@ -138,6 +139,8 @@ protected:
                     c_bias.get_primitive_desc().get_size() / sizeof(data_t),
                     (data_t *)c_bias.get_data_handle());
         }
+        zero_padding<data_t>(c_src);
+        zero_padding<data_t>(c_weights);
 
         std::vector<int> padR = { cd.padh, cd.padw };
         for (int i = 0; i < 2; ++i) {
@@ -172,6 +175,7 @@ protected:
 
         compute_ref_conv_relu_fwd<data_t>(cd, c_src, c_weights, c_bias,
             dst_ref, with_bias);
+        zero_padding<data_t>(dst_ref);
         compare_data<data_t>(dst_ref, c_dst);
     }
 };
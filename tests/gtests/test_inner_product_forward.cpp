@@ -171,7 +171,11 @@ INSTANTIATE_TEST_CASE_P(
                 inprod_test_params_float{ prop_kind::forward, engine::kind::cpu,
                         memory::format::nc, memory::format::oi,
                         memory::format::format_undef, memory::format::nc,
-                        { 2, 2, 4, 1, 1 } }));
+                        { 2, 2, 4, 1, 1 } },
+                inprod_test_params_float{ prop_kind::forward, engine::kind::cpu,
+                        memory::format::nc, memory::format::oi,
+                        memory::format::format_undef, memory::format::nc,
+                        { 13, 300, 70, 1, 1 } }));
 
 INSTANTIATE_TEST_CASE_P(
         TestInnerProductForward, inner_product_test_float,
@@ -191,5 +195,9 @@ INSTANTIATE_TEST_CASE_P(
                 inprod_test_params_float{ prop_kind::forward, engine::kind::cpu,
                         memory::format::nc, memory::format::oi,
                         memory::format::x, memory::format::nc,
-                        { 2, 2, 4, 1, 1 } }));
+                        { 2, 2, 4, 1, 1 } },
+                inprod_test_params_float{ prop_kind::forward, engine::kind::cpu,
+                        memory::format::nc, memory::format::oi,
+                        memory::format::x, memory::format::nc,
+                        { 13, 300, 70, 1, 1 } }));
 }
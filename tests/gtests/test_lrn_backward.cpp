@@ -28,7 +28,7 @@ enum {ACROSS=0,WITHIN=1};
 struct test_lrn_desc_t {
     int mb, c;
     int h, w;
-    double alpha, beta;
+    double alpha, beta, k;
     int local_size;
     int kind; // 0 ac, 1 wc
 };
@@ -81,7 +81,8 @@ void check_lrn_fwd(const lrn_test_params &p, const memory &src, const memory &ds
                 }
             }
         }
-        data_t norm_coef = powf(1 + p.test_ld.alpha * sum / summands, p.test_ld.beta);
+        data_t norm_coef = powf(p.test_ld.k + p.test_ld.alpha * sum / summands,
+                p.test_ld.beta);
         data_t ref_out = src_ptr[map_index(src_d, off(n, oc, oh, ow))]/norm_coef;
         data_t eps = 1.e-7*(2*summands+5);
         data_t out = d[0];
@@ -144,7 +145,7 @@ void check_lrn_bwd(const lrn_test_params &p, const memory &src,
     auto ker = [=](data_t *d, int mb, int oc, int oh, int ow) {
         const double alpha = p.test_ld.alpha;
         const double beta = p.test_ld.beta;
-        const double k = 1.0;
+        const double k = p.test_ld.k;
         const int kernel_size = p.test_ld.local_size;
         int ks_start = kernel_size/2 > oc ? kernel_size/2 - oc : 0;
         int ks_stop = C - oc <= kernel_size/2 ? C - oc + kernel_size/2 : kernel_size;
@@ -166,7 +167,12 @@ void check_lrn_bwd(const lrn_test_params &p, const memory &src,
             * diff_dst_ptr[map_index(diff_dst_d, off(mb, oc, oh, ow))];
         B *= src_ptr[map_index(src_d, off(mb, oc, oh, ow))];
         B *= (2.0f * alpha * beta) / kernel_size;
-        *d = A - B;
+        data_t ref_out = A - B;
+        data_t eps = 1.e-6 * (2 * kernel_size + 5);
+        data_t out = d[0];
+        data_t norm_max = std::max(fabs(out), fabs(ref_out));
+        if (norm_max < eps) norm_max = 1.;
+        EXPECT_NEAR(out, ref_out, eps * norm_max);
     };
 
 #   pragma omp parallel for collapse(4) schedule(static)
@@ -213,7 +219,6 @@ protected:
         ASSERT_EQ(data_type, mkldnn::memory::data_type::f32);
 
         test_lrn_desc_t ld = p.test_ld;
-        // TODO: think of workspace for backward
         with_workspace = p.aprop_kind == prop_kind::forward_training;
 
         src_desc.reset(new memory::desc({ ld.mb, ld.c, ld.h, ld.w },
@@ -232,7 +237,8 @@ protected:
     void Forward()
     {
         auto lrn_desc = lrn_forward::desc(p.aprop_kind, p.aalgorithm, *src_desc,
-                p.test_ld.local_size, p.test_ld.alpha, p.test_ld.beta);
+                p.test_ld.local_size, p.test_ld.alpha, p.test_ld.beta,
+                p.test_ld.k);
         lrn_fwd_prim_desc.reset(new lrn_forward::primitive_desc(lrn_desc, *eng));
 
         src.reset(new memory({*src_desc, *eng}));
@@ -264,10 +270,13 @@ protected:
     {
         auto lrn_desc = lrn_backward::desc(p.aalgorithm,
                 *src_desc, *diff_dst_desc,
-                p.test_ld.local_size, p.test_ld.alpha, p.test_ld.beta);
+                p.test_ld.local_size, p.test_ld.alpha, p.test_ld.beta,
+                p.test_ld.k);
         diff_src.reset(new memory({*diff_src_desc, *eng}));
         diff_dst.reset(new memory({*diff_dst_desc, *eng}));
-        auto lrn_prim_desc = lrn_backward::primitive_desc(lrn_desc, *eng);
+        auto lrn_prim_desc = with_workspace
+            ? lrn_backward::primitive_desc(lrn_desc, *eng, *lrn_fwd_prim_desc)
+            : lrn_backward::primitive_desc(lrn_desc, *eng);
 
         fill_data<data_t>(diff_dst->get_primitive_desc().get_size()
                 / sizeof(data_t), (data_t *)diff_dst->get_data_handle());
@@ -276,9 +285,6 @@ protected:
         std::vector<primitive> pipeline;
         auto s = stream(stream::kind::lazy);
         if (with_workspace) {
-            auto workspace_primitive_desc =
-                lrn_fwd_prim_desc->workspace_primitive_desc();
-            workspace.reset(new memory(workspace_primitive_desc));
             auto l = lrn_backward(lrn_prim_desc, *src, *diff_dst, *workspace,
                     *diff_src);
             pipeline.push_back(l);
@@ -304,30 +310,65 @@ INSTANTIATE_TEST_CASE_P(TestLRN, lrn_test_float,
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 10, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 10, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 10, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 10, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             ));
 
 INSTANTIATE_TEST_CASE_P(TestLRNNHWC, lrn_test_float,
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-            memory::format::nhwc, { 2, 10, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nhwc, { 2, 10, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-            memory::format::nhwc, { 2, 10, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nhwc, { 2, 10, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             ));
 
 INSTANTIATE_TEST_CASE_P(TestLRNBlocked, lrn_test_float,
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 16, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nChw8c, { 2, 16, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 16, 4, 4, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nChw8c, { 2, 16, 4, 4, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(TestLRNTail, lrn_test_float,
+        ::testing::Values(
+            lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
+            memory::format::nchw, { 2, 16, 5, 5, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
+            memory::format::nchw, { 1, 24, 3, 7, 1.0e-1, 0.75, 1.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 24, 5, 3, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
+            memory::format::nChw8c, { 1, 32, 3, 7, 1.0e-1, 0.75, 1.0, 5, ACROSS } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(TestLRNGeneral, lrn_test_float,
+        ::testing::Values(
+            lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
+            memory::format::nchw, { 2, 16, 5, 5, 1.0, 0.6, 2.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 24, 3, 5, 0.5, 1.0, 1.5, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
+            memory::format::nChw8c, { 1, 16, 4, 4, 1.0, 0.75, 3.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
+            memory::format::nhwc, { 1, 10, 3, 3, 1.0, 0.6, 2.0, 5, ACROSS } }
+            , lrn_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
+            memory::format::nchw, { 1, 10, 3, 3, 1.0, 0.8, 1.0, 3, ACROSS } }
             ));
 
 INSTANTIATE_TEST_CASE_P(
@@ -335,16 +376,16 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nchw,
-            memory::format::nchw, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nchw, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             ));
 
 INSTANTIATE_TEST_CASE_P(
@@ -352,16 +393,16 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(
                 lrn_test_params_float{ prop_kind::forward_training,
                 engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-                memory::format::nhwc, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } },
+                memory::format::nhwc, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
                 lrn_test_params_float{ prop_kind::forward_scoring,
                 engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-                memory::format::nhwc, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } },
+                memory::format::nhwc, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
                 lrn_test_params_float{ prop_kind::forward_training,
                 engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-                memory::format::nhwc, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } },
+                memory::format::nhwc, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
                 lrn_test_params_float{ prop_kind::forward_scoring,
                 engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nhwc,
-                memory::format::nhwc, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } }
+                memory::format::nhwc, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             ));
 
 INSTANTIATE_TEST_CASE_P(
@@ -369,16 +410,16 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } },
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
             lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, ACROSS } },
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } },
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } },
             lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_across_channels, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, ACROSS } }
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, ACROSS } }
             ));
 
 // Backward does not support WITHIN yet.
@@ -388,28 +429,28 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Values(
             lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 3, WITHIN } }
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 3, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 3, WITHIN } }
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 3, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 3, WITHIN } }
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 3, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 3, WITHIN } }
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 3, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, WITHIN } }
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 5, WITHIN } }
+            memory::format::nChw8c, { 2, 96, 55, 55, 1.0e-4, 0.75, 1.0, 5, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_training,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, WITHIN } }
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, WITHIN } }
             , lrn_test_params_float{ prop_kind::forward_scoring,
             engine::kind::cpu, algorithm::lrn_within_channel, memory::format::nChw8c,
-            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 5, WITHIN } }
+            memory::format::nChw8c, { 2, 256, 27, 27, 1.0e-4, 0.75, 1.0, 5, WITHIN } }
             ));
 */
 }
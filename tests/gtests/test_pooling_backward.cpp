@@ -98,12 +98,19 @@ void check_pool_bwd(const pool_bwd_test_params &p, const memory &diff_src,
 {
     data_t *diff_src_data = (data_t *)diff_src.get_data_handle();
     data_t *diff_dst_data = (data_t *)diff_dst.get_data_handle();
-    int *ws_data = (int *)ws.get_data_handle();
 
     const memory::desc diff_src_d = diff_src.get_primitive_desc().desc();
     const memory::desc diff_dst_d = diff_dst.get_primitive_desc().desc();
     const memory::desc ws_d = ws.get_primitive_desc().desc();
 
+    /* small windows keep the max positions in bytes */
+    auto ws_data = [&](size_t idx) -> int {
+        auto ws_dt = static_cast<memory::data_type>(ws_d.data.data_type);
+        return ws_dt == memory::data_type::u8
+            ? ((unsigned char *)ws.get_data_handle())[idx]
+            : ((int *)ws.get_data_handle())[idx];
+    };
+
     auto pd = p.test_pd;
     data_t *ref_diff_src = new data_t[pd.mb*pd.c*pd.ih*pd.iw];
 
@@ -129,8 +136,8 @@ void check_pool_bwd(const pool_bwd_test_params &p, const memory &diff_src,
                             + oh * pd.ow + ow;
                     data_t diff_dst = diff_dst_data[map_index(diff_dst_d, oidx)];
                     if (p.aalgorithm == algorithm::pooling_max) {
-                        int kh_max = ws_data[map_index(ws_d, oidx)] / pd.kw;
-                        int kw_max = ws_data[map_index(ws_d, oidx)] % pd.kw;
+                        int kh_max = ws_data(map_index(ws_d, oidx)) / pd.kw;
+                        int kw_max = ws_data(map_index(ws_d, oidx)) % pd.kw;
                         for (int kh = 0; kh < pd.kh; kh++) {
                             for (int kw = 0; kw < pd.kw; kw++) {
                                 int iw = ow * pd.strw - pd.padw + kw;
@@ -311,6 +318,60 @@ INSTANTIATE_TEST_CASE_P(
             memory::format::nchw, { 2, 64, 8, 8, 4, 4, 3, 3, 0, 0, 2, 2 } }
             ));
 
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingBackwardMaxBlocked, pooling_bwd_test_float, ::testing::Values(
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 55, 55, 27, 27, 3, 3, 0, 0, 2, 2 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 32, 13, 13, 13, 13, 3, 3, 1, 1, 1, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 64, 56, 56, 29, 29, 3, 3, 1, 1, 2, 2 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 32, 16, 16, 8, 8, 2, 2, 0, 0, 2, 2 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 20, 20, 4, 4, 17, 17, 0, 0, 1, 1 } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingBackwardAvgBlocked, pooling_bwd_test_float, ::testing::Values(
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 55, 55, 27, 27, 3, 3, 0, 0, 2, 2 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 32, 13, 13, 13, 13, 3, 3, 1, 1, 1, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 64, 8, 8, 4, 4, 3, 3, 0, 0, 2, 2 } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingBackwardRectBlocked, pooling_bwd_test_float, ::testing::Values(
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 9, 13, 9, 13, 3, 5, 1, 2, 1, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 13, 12, 6, 10, 3, 3, 0, 0, 2, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 11, 11, 6, 6, 3, 3, 1, 1, 2, 2 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 9, 13, 9, 13, 3, 5, 1, 2, 1, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 13, 12, 6, 10, 3, 3, 0, 0, 2, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 11, 11, 6, 6, 3, 3, 1, 1, 2, 2 } }
+            ));
+
 INSTANTIATE_TEST_CASE_P(
         TestPoolingBackward, pooling_bwd_test_float, ::testing::Values(
             pool_bwd_test_params_float{ engine::kind::cpu,
@@ -321,7 +382,10 @@ INSTANTIATE_TEST_CASE_P(
             memory::format::nchw, { 2, 2, 2, 2, 1, 1, 2, 2, 0, 0, 1, 1 } },
             pool_bwd_test_params_float{ engine::kind::cpu,
             pooling_max, memory::format::nchw,
-            memory::format::nchw, { 2, 4, 4, 4, 4, 4, 3, 3, 1, 1, 1, 1 } }
+            memory::format::nchw, { 2, 4, 4, 4, 4, 4, 3, 3, 1, 1, 1, 1 } },
+            pool_bwd_test_params_float{ engine::kind::cpu,
+            pooling_max, memory::format::nchw,
+            memory::format::nchw, { 2, 4, 18, 18, 2, 2, 17, 17, 0, 0, 1, 1 } }
             ));
 
 }
@@ -433,6 +433,56 @@ INSTANTIATE_TEST_CASE_P(
             memory::format::nChw8c, { 2, 1024, 7, 7, 1, 1, 7, 7, 0, 0, 1, 1 } }
             ));
 
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingRectBlocked, pooling_test_float, ::testing::Values(
+            pool_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 9, 13, 9, 13, 3, 5, 1, 2, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 9, 13, 9, 13, 3, 5, 1, 2, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 9, 13, 9, 13, 3, 5, 1, 2, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 12, 10, 12, 8, 1, 3, 0, 0, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 12, 10, 12, 8, 1, 3, 0, 0, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 12, 10, 12, 8, 1, 3, 0, 0, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 13, 12, 6, 10, 3, 3, 0, 0, 2, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 13, 12, 6, 10, 3, 3, 0, 0, 2, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 13, 12, 6, 10, 3, 3, 0, 0, 2, 1 } },
+            pool_test_params_float{ prop_kind::forward_training,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 11, 11, 6, 6, 3, 3, 1, 1, 2, 2 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_max, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 11, 11, 6, 6, 3, 3, 1, 1, 2, 2 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 16, 11, 11, 6, 6, 3, 3, 1, 1, 2, 2 } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(
+        TestAvgPoolingGlobalBlocked, pooling_test_float, ::testing::Values(
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 32, 7, 5, 1, 1, 7, 5, 0, 0, 1, 1 } },
+            pool_test_params_float{ prop_kind::forward_scoring,
+            engine::kind::cpu, algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::nChw8c, { 2, 32, 14, 14, 1, 1, 14, 14, 0, 0, 1, 1 } }
+            ));
+
 INSTANTIATE_TEST_CASE_P(
         TestAvgPoolingResnet50NCHW, pooling_test_float, ::testing::Values(
             pool_test_params_float{ prop_kind::forward_training,
@@ -0,0 +1,241 @@
+/*******************************************************************************
+* Copyright 2016 Intel Corporation
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "mkldnn_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "mkldnn.hpp"
+
+namespace mkldnn {
+
+struct test_pool_ip_desc_t {
+    int mb, c;
+    int ih, iw;
+    int oh, ow;
+    int kh, kw;
+    int padh, padw;
+    int strh, strw;
+    int oc;
+};
+
+struct pool_ip_test_params {
+    const engine::kind engine_kind;
+    algorithm aalgorithm;
+    memory::format src_format;
+    memory::format weights_format;
+    memory::format bias_format;
+    test_pool_ip_desc_t test_pd;
+};
+
+template <typename data_t>
+void compute_ref_pool_ip_fwd(const pool_ip_test_params &p,
+        const memory &src, const memory &weights, const memory &bias,
+        const memory &dst)
+{
+    data_t *src_data = (data_t *)src.get_data_handle();
+    data_t *weights_data = (data_t *)weights.get_data_handle();
+    data_t *bias_data = (data_t *)bias.get_data_handle();
+    data_t *dst_data = (data_t *)dst.get_data_handle();
+
+    const memory::desc src_d = src.get_primitive_desc().desc();
+    const memory::desc weights_d = weights.get_primitive_desc().desc();
+    const memory::desc bias_d = bias.get_primitive_desc().desc();
+    const memory::desc dst_d = dst.get_primitive_desc().desc();
+
+    auto pd = p.test_pd;
+    const int sp = pd.oh * pd.ow;
+    std::vector<data_t> pooled(pd.mb * pd.c * sp);
+
+#pragma omp parallel for collapse(4) schedule(static)
+    for (int n = 0; n < pd.mb; n++) {
+        for (int c = 0; c < pd.c; c++) {
+            for (int oh = 0; oh < pd.oh; oh++) {
+                for (int ow = 0; ow < pd.ow; ow++) {
+                    data_t out = data_t(0);
+                    bool is_initialized = false;
+                    for (int kh = 0; kh < pd.kh; kh++) {
+                        for (int kw = 0; kw < pd.kw; kw++) {
+                            int iw = ow * pd.strw - pd.padw + kw;
+                            int ih = oh * pd.strh - pd.padh + kh;
+                            if (iw < 0 || iw >= pd.iw) continue;
+                            if (ih < 0 || ih >= pd.ih) continue;
+                            int iidx = n * pd.c * pd.ih * pd.iw
+                                    + c * pd.ih * pd.iw + ih * pd.iw + iw;
+
+                            data_t d = src_data[map_index(src_d, iidx)];
+                            if (p.aalgorithm == algorithm::pooling_max) {
+                                if (!is_initialized || out < d)
+                                    out = d;
+                                is_initialized = true;
+                            } else {
+                                out += d;
+                            }
+                        }
+                    }
+                    if (p.aalgorithm == algorithm::pooling_avg)
+                        out /= pd.kw * pd.kh;
+                    pooled[(n * pd.c + c) * sp + oh * pd.ow + ow] = out;
+                }
+            }
+        }
+    }
+
+    bool with_bias = p.bias_format != memory::format::format_undef;
+#pragma omp parallel for collapse(2) schedule(static)
+    for (int n = 0; n < pd.mb; n++) {
+        for (int oc = 0; oc < pd.oc; oc++) {
+            data_t out = with_bias ? bias_data[map_index(bias_d, oc)] : 0;
+            for (int i = 0; i < pd.c * sp; i++)
+                out += pooled[n * pd.c * sp + i]
+                    * weights_data[map_index(weights_d, oc * pd.c * sp + i)];
+            dst_data[map_index(dst_d, n * pd.oc + oc)] = out;
+        }
+    }
+}
+
+template <typename data_t>
+class pooling_inner_product_test
+    : public ::testing::TestWithParam<pool_ip_test_params> {
+protected:
+    virtual void SetUp()
+    {
+        pool_ip_test_params p
+                = ::testing::TestWithParam<pool_ip_test_params>::GetParam();
+
+        ASSERT_TRUE(p.engine_kind == engine::kind::cpu);
+        auto eng = engine(p.engine_kind, 0);
+        memory::data_type data_type = data_traits<data_t>::data_type;
+        ASSERT_EQ(data_type, mkldnn::memory::data_type::f32);
+
+        test_pool_ip_desc_t pd = p.test_pd;
+        const bool ip_2d = p.weights_format == memory::format::oi;
+        const bool with_bias
+            = p.bias_format != memory::format::format_undef;
+
+        auto src_desc = create_md({ pd.mb, pd.c, pd.ih, pd.iw }, data_type,
+                p.src_format);
+        auto pool_dst_desc = create_md({ pd.mb, pd.c, pd.oh, pd.ow },
+                data_type, memory::format::nchw);
+        auto ip_src_desc = ip_2d
+            ? create_md({ pd.mb, pd.c }, data_type, memory::format::nc)
+            : pool_dst_desc;
+        auto weights_desc = ip_2d
+            ? create_md({ pd.oc, pd.c }, data_type, p.weights_format)
+            : create_md({ pd.oc, pd.c, pd.oh, pd.ow }, data_type,
+                    p.weights_format);
+        auto bias_desc = with_bias
+            ? create_md({ pd.oc }, data_type, p.bias_format)
+            : create_md({}, data_type, p.bias_format);
+        auto dst_desc = create_md({ pd.mb, pd.oc }, data_type,
+                memory::format::nc);
+
+        std::vector<int> padR = { pd.padh, pd.padw };
+        for (int i = 0; i < 2; ++i) {
+        if ((pd.ih + pd.padh + padR[0] - pd.kh + pd.strh-1)/pd.strh + 1 < pd.oh) ++padR[0];
+        if ((pd.iw + pd.padw + padR[1] - pd.kw + pd.strw-1)/pd.strw + 1 < pd.ow) ++padR[1];
+        }
+
+        auto pool_desc = pooling_forward::desc(prop_kind::forward_scoring,
+                p.aalgorithm, src_desc, pool_dst_desc, { pd.strh, pd.strw },
+                { pd.kh, pd.kw }, { pd.padh, pd.padw }, padR,
+                padding_kind::zero);
+        auto ip_desc = with_bias
+            ? inner_product_forward::desc(prop_kind::forward_scoring,
+                    ip_src_desc, weights_desc, bias_desc, dst_desc)
+            : inner_product_forward::desc(prop_kind::forward_scoring,
+                    ip_src_desc, weights_desc, dst_desc);
+
+        auto pool_ip_desc
+            = pooling_inner_product_forward::desc(pool_desc, ip_desc);
+        auto pool_ip_prim_desc
+            = pooling_inner_product_forward::primitive_desc(pool_ip_desc,
+                    eng);
+
+        auto src = memory({src_desc, eng});
+        auto weights = memory({weights_desc, eng});
+        auto bias = memory({bias_desc, eng});
+        auto dst = memory({dst_desc, eng});
+        auto dst_ref = memory({dst_desc, eng});
+
+        fill_data<data_t>(src.get_primitive_desc().get_size()
+                / sizeof(data_t), (data_t *)src.get_data_handle());
+        fill_data<data_t>(weights.get_primitive_desc().get_size()
+                / sizeof(data_t), (data_t *)weights.get_data_handle());
+        if (with_bias)
+            fill_data<data_t>(bias.get_primitive_desc().get_size()
+                    / sizeof(data_t), (data_t *)bias.get_data_handle());
+
+        auto pool_ip = with_bias
+            ? pooling_inner_product_forward(pool_ip_prim_desc, src, weights,
+                    bias, dst)
+            : pooling_inner_product_forward(pool_ip_prim_desc, src, weights,
+                    dst);
+
+        std::vector<primitive> pipeline;
+        pipeline.push_back(pool_ip);
+        stream(stream::kind::lazy).submit(pipeline).wait();
+
+        compute_ref_pool_ip_fwd<data_t>(p, src, weights, bias, dst_ref);
+        compare_data<data_t>(dst_ref, dst);
+    }
+};
+
+using pooling_inner_product_test_float = pooling_inner_product_test<float>;
+using pool_ip_test_params_float = pool_ip_test_params;
+
+TEST_P(pooling_inner_product_test_float, TestsPoolingInnerProduct)
+{
+}
+
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingInnerProductGlobalAvg, pooling_inner_product_test_float,
+        ::testing::Values(
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::oi, memory::format::x,
+            { 2, 64, 7, 7, 1, 1, 7, 7, 0, 0, 1, 1, 100 } },
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::oIhw8i, memory::format::x,
+            { 2, 64, 7, 7, 1, 1, 7, 7, 0, 0, 1, 1, 100 } },
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nChw16c,
+            memory::format::oi, memory::format::format_undef,
+            { 3, 32, 5, 6, 1, 1, 5, 6, 0, 0, 1, 1, 17 } },
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nchw,
+            memory::format::oihw, memory::format::x,
+            { 2, 20, 7, 7, 1, 1, 7, 7, 0, 0, 1, 1, 10 } },
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nhwc,
+            memory::format::oi, memory::format::x,
+            { 2, 20, 6, 6, 1, 1, 6, 6, 0, 0, 1, 1, 10 } }
+            ));
+
+INSTANTIATE_TEST_CASE_P(
+        TestPoolingInnerProduct, pooling_inner_product_test_float,
+        ::testing::Values(
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_max, memory::format::nchw,
+            memory::format::oihw, memory::format::x,
+            { 2, 16, 9, 9, 4, 4, 3, 3, 0, 0, 2, 2, 10 } },
+            pool_ip_test_params_float{ engine::kind::cpu,
+            algorithm::pooling_avg, memory::format::nChw8c,
+            memory::format::oihw, memory::format::format_undef,
+            { 2, 16, 8, 8, 4, 4, 2, 2, 0, 0, 2, 2, 10 } }
+            ));
+
+}
@@ -70,9 +70,6 @@ protected:
                 size_t(1), std::multiplies<size_t>());
         ASSERT_EQ(nelems_i, nelems_o);
 
-        auto src_data = new data_i_t[nelems_i];
-        auto dst_data = new data_o_t[nelems_o];
-
         memory::data_type prec_i = data_traits<data_i_t>::data_type;
         memory::data_type prec_o = data_traits<data_o_t>::data_type;
         auto mpd_i = memory::primitive_desc({p.dims, prec_i, p.fmt_i},
@@ -80,6 +77,10 @@ protected:
         auto mpd_o = memory::primitive_desc({p.dims, prec_o, p.fmt_o},
                 eng);
 
+        /* blocked formats may be padded, hence the physical sizes */
+        auto src_data = new data_i_t[mpd_i.get_size() / sizeof(data_i_t)];
+        auto dst_data = new data_o_t[mpd_o.get_size() / sizeof(data_o_t)];
+
         /* initialize input data */
         for (size_t i = 0; i < nelems_i; ++i)
             src_data[map_index(mpd_i.desc(), i)] = data_i_t(i);
@@ -113,14 +114,30 @@ INSTANTIATE_TEST_CASE_P(TestReorder, reorder_simple_test_f32_f32,
             cfg{eng::cpu, fmt::nhwc, fmt::nhwc, {10, 10, 10, 10}},
             cfg{eng::cpu, fmt::nchw, fmt::nChw8c, {2, 32, 4, 4}},
             cfg{eng::cpu, fmt::nChw8c, fmt::nchw, {2, 32, 4, 4}},
+            cfg{eng::cpu, fmt::nchw, fmt::nChw8c, {2, 20, 4, 4}},
+            cfg{eng::cpu, fmt::nChw8c, fmt::nchw, {2, 20, 4, 4}},
             cfg{eng::cpu, fmt::oihw, fmt::OIhw8i8o, {32, 32, 3, 3}},
             cfg{eng::cpu, fmt::OIhw8i8o, fmt::oihw, {32, 32, 3, 3}},
             cfg{eng::cpu, fmt::OIhw8i8o, fmt::OIhw8o8i, {32, 32, 3, 3}},
             cfg{eng::cpu, fmt::OIhw8o8i, fmt::OIhw8i8o, {32, 32, 3, 3}},
+            cfg{eng::cpu, fmt::oihw, fmt::OIhw8i8o, {20, 12, 3, 3}},
+            cfg{eng::cpu, fmt::OIhw8i8o, fmt::OIhw8o8i, {20, 12, 3, 3}},
             cfg{eng::cpu, fmt::goihw, fmt::gOIhw8i8o, {2, 32, 32, 3, 3}},
             cfg{eng::cpu, fmt::gOIhw8i8o, fmt::goihw, {2, 32, 32, 3, 3}},
             cfg{eng::cpu, fmt::gOIhw8i8o, fmt::gOIhw8o8i, {2, 32, 32, 3, 3}},
-            cfg{eng::cpu, fmt::gOIhw8o8i, fmt::gOIhw8i8o, {2, 32, 32, 3, 3}}
+            cfg{eng::cpu, fmt::gOIhw8o8i, fmt::gOIhw8i8o, {2, 32, 32, 3, 3}},
+            cfg{eng::cpu, fmt::nchw, fmt::nChw16c, {2, 64, 4, 4}},
+            cfg{eng::cpu, fmt::nChw16c, fmt::nchw, {2, 64, 4, 4}},
+            cfg{eng::cpu, fmt::oihw, fmt::OIhw16i16o, {64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::OIhw16i16o, fmt::oihw, {64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::OIhw16i16o, fmt::OIhw16o16i, {64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::OIhw16o16i, fmt::OIhw16i16o, {64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::goihw, fmt::gOIhw16i16o, {2, 64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::gOIhw16i16o, fmt::goihw, {2, 64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::gOIhw16i16o, fmt::gOIhw16o16i, {2, 64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::gOIhw16o16i, fmt::gOIhw16i16o, {2, 64, 64, 3, 3}},
+            cfg{eng::cpu, fmt::oihw, fmt::Ohwi16o, {64, 3, 3, 3}},
+            cfg{eng::cpu, fmt::Ohwi16o, fmt::oihw, {64, 3, 3, 3}}
             )
         );
 
@@ -14,6 +14,8 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <cstring>
+
 #include "mkldnn_test_common.hpp"
 #include "gtest/gtest.h"
 
@@ -28,6 +30,7 @@ struct sum_test_params {
     std::vector<memory::dims> srcs_cds;
     memory::dims dst_cds;
     std::vector<double> scale;
+    bool inplace; /* dst is src[1] */
 };
 
 
@@ -61,9 +64,9 @@ class sum_test: public ::testing::TestWithParam<sum_test_params> {
 
             }
             auto dst_idx = w
-                + dst_dims[3]
-                + dst_dims[2]
-                + dst_dims[1];
+                + dst_dims[3]*h
+                + dst_dims[2]*dst_dims[3]*c
+                + dst_dims[1]*dst_dims[2]*dst_dims[3]*n;
 
             EXPECT_NEAR(src_sum,
                         dst_data[map_index(dst_d, dst_idx)],
@@ -97,15 +100,23 @@ protected:
                 src_memory.get_primitive_desc().get_size() / sizeof(data_t);
             auto s = (data_t *)src_memory.get_data_handle();
 #           pragma omp parallel for
-            for (size_t j = 0; j < sz; ++j) s[j] = i + 1;
-            // fill_data<data_t>(sz, (data_t *)src_memory.get_data_handle());
+            for (size_t j = 0; j < sz; ++j) s[j] = (i + 1) * 100 + j % 97;
             srcs_pd.push_back(mpd);
             srcs.push_back(src_memory);
         }
 
         auto dst_desc = memory::desc(p.dst_cds, data_type, p.dst_format);
         auto sum_pd = sum::primitive_desc(dst_desc, p.scale, srcs_pd);
-        auto dst = memory(sum_pd.dst_primitive_desc());
+        auto dst = p.inplace ? srcs[1] : memory(sum_pd.dst_primitive_desc());
+
+        /* the reference reads a copy of the input which gets overwritten */
+        auto ref_srcs = srcs;
+        if (p.inplace) {
+            ASSERT_TRUE(p.srcs_format[1] == p.dst_format);
+            ref_srcs[1] = memory(srcs_pd[1]);
+            memcpy(ref_srcs[1].get_data_handle(), srcs[1].get_data_handle(),
+                    srcs_pd[1].get_size());
+        }
 
         std::vector<primitive::at> inputs;
         for (size_t i = 0; i < p.srcs_cds.size(); i++) {
@@ -123,7 +134,7 @@ protected:
         auto s = stream(stream::kind::eager);
         s.submit(pipeline).wait();
 
-        check_data(srcs, p.scale, dst);
+        check_data(ref_srcs, p.scale, dst);
     }
 };
 
@@ -167,7 +178,58 @@ INSTANTIATE_TEST_CASE_P(TestSum, sum_test_float, ::testing::Values(
     {{2, 8, 3, 4}, {2, 8, 3, 4}}, {2, 8, 3, 4}, {2.0, 3.0}},
     sum_test_params_float{engine::kind::cpu,
     {memory::format::nchw, memory::format::nChw8c}, memory::format::nchw,
-    {{32, 32, 13, 14}, {32, 32, 13, 14}}, {32, 32, 13, 14}, {2.0, 3.0}}
+    {{32, 32, 13, 14}, {32, 32, 13, 14}}, {32, 32, 13, 14}, {2.0, 3.0}},
+
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nChw8c, memory::format::nchw, memory::format::nhwc},
+    memory::format::nChw8c,
+    {{2, 20, 3, 5}, {2, 20, 3, 5}, {2, 20, 3, 5}}, {2, 20, 3, 5},
+    {1.0, 2.0, 0.5}},
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nhwc, memory::format::nChw8c, memory::format::nchw},
+    memory::format::nchw,
+    {{3, 16, 7, 9}, {3, 16, 7, 9}, {3, 16, 7, 9}}, {3, 16, 7, 9},
+    {2.0, 1.0, 3.0}},
+
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nchw, memory::format::nchw, memory::format::nchw},
+    memory::format::nchw,
+    {{3, 5, 7, 9}, {3, 5, 7, 9}, {3, 5, 7, 9}}, {3, 5, 7, 9},
+    {1.0, -2.0, 0.5}},
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nChw8c, memory::format::nChw8c}, memory::format::nChw8c,
+    {{2, 20, 3, 5}, {2, 20, 3, 5}}, {2, 20, 3, 5}, {2.0, 3.0}},
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nchw, memory::format::nchw, memory::format::nchw,
+        memory::format::nchw, memory::format::nchw, memory::format::nchw,
+        memory::format::nchw, memory::format::nchw, memory::format::nchw,
+        memory::format::nchw, memory::format::nchw, memory::format::nchw},
+    memory::format::nchw,
+    {{2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5},
+        {2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5}, {2, 8, 3, 5},
+        {2, 8, 3, 5}, {2, 8, 3, 5}}, {2, 8, 3, 5},
+    {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0}},
+
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nchw, memory::format::nChw8c, memory::format::nhwc},
+    memory::format::nChw8c,
+    {{2, 20, 3, 5}, {2, 20, 3, 5}, {2, 20, 3, 5}}, {2, 20, 3, 5},
+    {1.0, 2.0, 0.5}, true},
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nChw8c, memory::format::nchw}, memory::format::nchw,
+    {{3, 16, 7, 9}, {3, 16, 7, 9}}, {3, 16, 7, 9}, {2.0, -1.0}, true},
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nchw, memory::format::nchw, memory::format::nchw},
+    memory::format::nchw,
+    {{3, 5, 7, 9}, {3, 5, 7, 9}, {3, 5, 7, 9}}, {3, 5, 7, 9},
+    {1.0, -2.0, 0.5}, true},
+
+    /* dst of 128 MB and a tail of 6 elements: larger than the last level
+     * cache of most machines, so the streaming stores are used */
+    sum_test_params_float{engine::kind::cpu,
+    {memory::format::nchw, memory::format::nchw}, memory::format::nchw,
+    {{2, 1, 1, 16777219}, {2, 1, 1, 16777219}}, {2, 1, 1, 16777219},
+    {2.0, 3.0}}
 ));
 
 }